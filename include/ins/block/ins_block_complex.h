@@ -0,0 +1,162 @@
+#ifndef INS_BLOCK_COMPLEX_H_
+#define INS_BLOCK_COMPLEX_H_
+
+#include <stdlib.h>
+#include <ins/ins_errno.h>
+#include <ins/ins_allocator.h>
+#include <ins/ins_container.h>
+#include <ins/ins_async.h>
+#include <ins/ins_direct.h>
+#include <ins/ins_complex.h>
+
+// The `ins_block_complex_struct` structure contains two components, the
+// `size` and the `data`. `size` is the number of complex numbers in the block
+// and `data` is the pointer pointing to the allocated memory, which holds
+// `2 * size` doubles with the real and imaginary parts interleaved.
+struct ins_block_complex_struct {
+  size_t size;
+  double * data;
+
+  // Releases `data` when the block is freed. A null `release` means that
+  // `data` was allocated by the block itself through `allocator`; otherwise
+  // `release(data, release_ctx)` is called instead (e.g. to unmap a
+  // memory-mapped file).
+  void (*release)(void * data, void * release_ctx);
+  void * release_ctx;
+
+  // The tag the elements are counted under (see `ins/ins_memory.h`), if
+  // they were allocated by the block.
+  int tag;
+
+  // The allocator of `data` (see `ins/ins_allocator.h`), if it was
+  // allocated by the block.
+  const ins_allocator * allocator;
+};
+
+typedef struct ins_block_complex_struct ins_block_complex;
+
+/* Allocation */
+
+// Allocates memory for a block of `count` complex numbers and returns a
+// pointer to the block struct. The block is not initialized and so the values
+// of its elements are undefined.
+// Zero-count requests are valid and return a non-null result.
+// A `NULL` pointer is returned if there is not enough memory to create a block.
+ins_block_complex * ins_block_complex_alloc(const size_t count);
+
+// Similar to `ins_block_complex_alloc` but this functions initializes all
+// elements of the block to zero.
+ins_block_complex * ins_block_complex_calloc(const size_t count);
+
+// Similar to `ins_block_complex_alloc` and `ins_block_complex_calloc`, but
+// these functions allocate the elements through `allocator`, or through the
+// process-wide allocator if `allocator` is null.
+ins_block_complex * ins_block_complex_alloc_with_allocator(
+    const size_t count, const ins_allocator * allocator);
+ins_block_complex * ins_block_complex_calloc_with_allocator(
+    const size_t count, const ins_allocator * allocator);
+
+// Creates a block over the real and imaginary parts of `count` complex numbers
+// in turn at `data`, which the caller owns, without copying them. When the
+// block is freed, `release(data, release_ctx)` is called if `release` is not
+// null, and otherwise the memory is left to the caller. The elements are not
+// counted by the memory accounting (see `ins/ins_memory.h`). A `NULL` pointer
+// is returned if there is not enough memory for the block struct.
+ins_block_complex * ins_block_complex_wrap(
+    double * data, const size_t count,
+    void (*release)(void * data, void * release_ctx), void * release_ctx);
+
+// Frees the memory used by a block `block` previously allocated with either
+// `ins_block_complex_alloc` or `ins_block_complex_calloc`.
+void ins_block_complex_free(ins_block_complex * block);
+
+/* Operation */
+
+// Reads into the block `block` from the given open stream `stream` in binary
+// format. The block `block` must be preallocated with the correct length
+// since the function uses the size of `block` to determine how many bytes to
+// read. The return value is `0` for success and `INS_EFAILED` if there was a
+// problem reading from the file. (`man fread` for more details).
+int ins_block_complex_fread(ins_block_complex * block, FILE * stream);
+
+// Writes the elements of the given `block` to the specified stream `stream`
+// in binary format. The return value is `0` for success and `INS_EFAILED`
+// if there was a problem writing to the file. (`man fwrite` for more details).
+int ins_block_complex_fwrite(const ins_block_complex * block, FILE * stream);
+
+// Writes elements of the given block `block` line-by-line to the specified
+// stream `stream` using the format specifier `format`, which should be one of
+// `%g`, `%e` or `%f`. Each line holds the real part and the imaginary part of
+// one element separated by a space. If `format` is null, numbers are written in
+// the shortest form that reads back to the same value. The return value is `0`
+// for success and `INS_EFAILED` if there was a problem writing to the file.
+int ins_block_complex_fprintf(const ins_block_complex * block, FILE * stream,
+                              const char * format);
+
+// Reads formatted data from the given stream `stream` into the specified
+// block `block`, expecting pairs of real and imaginary parts as written by
+// `ins_block_complex_fprintf`. The block `block` must be preallocated with
+// the correct length since the function uses the size of `block` to
+// determine how many numbers to read. The function returns `0` for success
+// and `INS_EFAILED` if there was a problem reading from the file.
+int ins_block_complex_fscanf(ins_block_complex * block, FILE * stream);
+
+/* Containers */
+
+// Writes the block `block` to the stream `stream` as a self-describing
+// `.ins` container (see `ins/ins_container.h`): a header recording the
+// element type, the number of elements, the byte order and a checksum,
+// followed by the page-aligned elements. The return value is `0` for success
+// and `INS_EFAILED` if there was a problem writing to the file.
+int ins_block_complex_fwrite_ins(const ins_block_complex * block,
+                                 FILE * stream);
+
+// Reads a `.ins` container from the stream `stream` into the block `block`,
+// which must be preallocated with the number of elements recorded in the
+// container. Payloads written with a foreign byte order are converted. If
+// `flags` contains `INS_CONTAINER_VERIFY` the payload checksum is verified.
+// The return value is `0` for success, `INS_EINVAL` if the container holds
+// another element type, `INS_EBADLEN` if it holds another number of
+// elements, and `INS_EFAILED` if reading fails or the checksum mismatches.
+int ins_block_complex_fread_ins(ins_block_complex * block,
+                                FILE * stream,
+                                const int flags);
+
+/* Asynchronous I/O */
+
+// Starts reading the elements of the block `block` from the file descriptor
+// `fd`, `offset` bytes into the file, in the raw layout written by
+// `ins_block_complex_fwrite` (see `ins/ins_async.h`). Returns a handle to pass
+// to `ins_async_wait`, or a null pointer if the read cannot be started.
+ins_async * ins_block_complex_read_async(ins_block_complex * block,
+                                         const int fd,
+                                         const size_t offset);
+
+// Starts writing the elements of the block `block` to the file descriptor `fd`,
+// `offset` bytes into the file, in the raw layout written by
+// `ins_block_complex_fwrite`. Returns a handle to pass to `ins_async_wait`, or
+// a null pointer if the write cannot be started.
+ins_async * ins_block_complex_write_async(const ins_block_complex * block,
+                                          const int fd,
+                                          const size_t offset);
+
+/* Direct I/O */
+
+// Reads the elements of the block `block` from the file at `path`, `offset`
+// bytes into the file, in the raw layout written by `ins_block_complex_fwrite`,
+// bypassing the page cache (see `ins/ins_direct.h`). Returns `INS_SUCCESS` for
+// success and `INS_EFAILED` if the file cannot be read or is too short.
+int ins_block_complex_read_direct(ins_block_complex * block,
+                                  const char * path,
+                                  const size_t offset);
+
+// Writes the elements of the block `block` to the file at `path`, `offset`
+// bytes into the file, in the raw layout written by `ins_block_complex_fwrite`,
+// bypassing the page cache. The file is created if it does not exist, and is
+// neither truncated nor written outside the range of the elements. Returns
+// `INS_SUCCESS` for success and `INS_EFAILED` if the file cannot be written.
+int ins_block_complex_write_direct(const ins_block_complex * block,
+                                   const char * path,
+                                   const size_t offset);
+
+#endif // INS_BLOCK_COMPLEX_H_
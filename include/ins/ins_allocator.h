@@ -0,0 +1,43 @@
+#ifndef INS_ALLOCATOR_H_
+#define INS_ALLOCATOR_H_
+
+#include <stddef.h>
+
+// Allocators.
+//
+// The elements of blocks are allocated through an allocator: the allocator
+// given to `ins_block_[type]_alloc_with_allocator` and
+// `ins_block_[type]_calloc_with_allocator`, or otherwise the process-wide
+// allocator, which is `malloc` and `free` until it is replaced with
+// `ins_set_allocator`. A block remembers its allocator and returns its
+// elements to it when freed, whatever the process-wide allocator is then,
+// so an allocator must stay valid until all blocks allocated through it are
+// freed. Allocators are called from any thread that allocates or frees
+// blocks.
+
+typedef struct {
+  // Returns `size` bytes of memory, or null if there is not enough memory.
+  void * (*alloc)(size_t size, void * context);
+
+  // Returns `size` bytes of memory at a multiple of `alignment`, a power of
+  // two, or null if there is not enough memory. It may be null, in which
+  // case blocks large enough to be aligned for direct I/O (see
+  // `ins/ins_direct.h`) are allocated with `alloc` instead.
+  void * (*aligned_alloc)(size_t alignment, size_t size, void * context);
+
+  // Releases the memory at `ptr` returned by `alloc` or `aligned_alloc`.
+  void (*free)(void * ptr, void * context);
+
+  // The context passed to the functions.
+  void * context;
+} ins_allocator;
+
+// Returns the process-wide allocator.
+const ins_allocator * ins_get_allocator(void);
+
+// Sets the process-wide allocator to `allocator`, or back to `malloc` and
+// `free` if `allocator` is null, and returns the previous one. Blocks
+// allocated before keep their allocators.
+const ins_allocator * ins_set_allocator(const ins_allocator * allocator);
+
+#endif // INS_ALLOCATOR_H_
@@ -0,0 +1,38 @@
+#ifndef INS_ASYNC_H_
+#define INS_ASYNC_H_
+
+// Asynchronous reads and writes of blocks and vectors.
+//
+// The `*_read_async` and `*_write_async` functions start moving the
+// elements of a block or a vector between memory and a file descriptor, at
+// a given byte offset in the file, and return at once with a completion
+// handle. The elements are stored in the raw binary layout written by
+// `fwrite`. Large transfers are split into pieces of at least a megabyte
+// that are in flight at the same time.
+//
+// The transfers are submitted through io_uring where the kernel supports
+// it, and otherwise run on a small pool of threads calling `pread` and
+// `pwrite`. Setting the environment variable `INSIGHT_ASYNC_BACKEND` to
+// `threads` forces the thread pool; the choice is made at the first
+// asynchronous operation of the process.
+//
+// The block or vector, and the file descriptor, must stay valid and must
+// not be used by the caller until the operation has been waited for with
+// `ins_async_wait`. For reads into strided vectors the elements are read
+// into a staging buffer and only stored into the vector by
+// `ins_async_wait`.
+
+// A completion handle for an asynchronous operation.
+typedef struct ins_async ins_async;
+
+// Returns non-zero if the operation `op` has finished, successfully or not,
+// so that `ins_async_wait` will not block.
+int ins_async_done(const ins_async * op);
+
+// Waits for the operation `op` to finish, releases its handle and returns
+// its status: `INS_SUCCESS` if all elements were transferred, and
+// `INS_EFAILED` if reading or writing failed or a read reached the end of
+// the file early.
+int ins_async_wait(ins_async * op);
+
+#endif // INS_ASYNC_H_
@@ -4,5 +4,9 @@
 #include "ins/block/ins_block_double.h"
 #include "ins/block/ins_block_float.h"
 #include "ins/block/ins_block_int.h"
+#include "ins/block/ins_block_f16.h"
+#include "ins/block/ins_block_bf16.h"
+#include "ins/block/ins_block_complex.h"
+#include "ins/block/ins_block_complex_float.h"
 
 #endif /* INS_BLOCK_H_ */
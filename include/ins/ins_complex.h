@@ -0,0 +1,23 @@
+#ifndef INS_COMPLEX_H_
+#define INS_COMPLEX_H_
+
+// Complex numbers are stored as two consecutive values, the real part
+// followed by the imaginary part. This matches the layout of C99 `_Complex`
+// types and of the complex types expected by BLAS.
+typedef struct {
+  double dat[2];
+} ins_complex;
+
+typedef struct {
+  float dat[2];
+} ins_complex_float;
+
+// Accessors for the real and imaginary parts of a complex number `z`.
+#define INS_REAL(z) ((z).dat[0])
+#define INS_IMAG(z) ((z).dat[1])
+
+// Sets the real and imaginary parts of the complex number pointed to by `zp`.
+#define INS_SET_COMPLEX(zp, x, y)                                            \
+  do { (zp)->dat[0] = (x); (zp)->dat[1] = (y); } while (0)
+
+#endif // INS_COMPLEX_H_
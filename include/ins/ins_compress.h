@@ -0,0 +1,95 @@
+#ifndef INS_COMPRESS_H_
+#define INS_COMPRESS_H_
+
+#include <stddef.h>
+
+// Compressed vector files.
+//
+// The `*_fwrite_compressed` functions store the elements of a vector as a
+// sequence of independently compressed chunks. Each chunk is first passed
+// through a filter that groups the bytes (or bits) of equal significance of
+// all its values together, which turns the slowly varying high-order bytes
+// of numeric data into long runs, and is then compressed with a codec. A
+// file starts with a fixed-size header
+//
+//   offset  size  field
+//        0     8  magic "\x89INZ\r\n\x1a\n"
+//        8     4  byte order mark 0x01020304, in the writer's byte order
+//       12     4  format version
+//       16     4  element type (one of `ins_type`)
+//       20     4  element size in bytes
+//       24     8  number of elements
+//       32     8  number of elements per chunk
+//       40     4  filter (one of `INS_FILTER_*`)
+//       44     4  codec (one of `INS_CODEC_*`)
+//       48     8  number of chunks
+//       56     8  reserved, zero
+//
+// followed by an index holding the compressed size of every chunk, 8 bytes
+// each, the checksum of the stored bytes of every chunk (see
+// `ins_container_checksum`), 8 bytes each, and then the chunks. The top bit
+// of an index entry is set for chunks that the codec could not make smaller
+// and that are stored filtered but uncompressed. All fields and elements are
+// stored in the writer's byte order; readers detect and undo foreign byte
+// orders.
+//
+// Readers verify the checksum of every chunk they decompress, so that
+// corrupt chunks are reported rather than decoded into wrong elements.
+// Files of version 1 have no checksums, and their chunks are not verified.
+//
+// The chunks of a file are decompressed in parallel, and a range of
+// elements can be read without decompressing the chunks outside of it.
+
+// Current version of the compressed format.
+#define INS_COMPRESS_VERSION 2
+
+// Size of the fixed header in bytes.
+#define INS_COMPRESS_HEADER_SIZE 64
+
+// Filters applied to the values of a chunk before compression. Filters
+// work on the real and imaginary parts of complex values separately.
+enum {
+  // `INS_FILTER_SHUFFLE`.
+  INS_FILTER_DEFAULT = 0,
+  INS_FILTER_NONE = 1,
+  // Stores the first byte of all values, then the second byte, and so on.
+  INS_FILTER_SHUFFLE = 2,
+  // Stores the first bit of all values, then the second bit, and so on.
+  // Compresses better than `INS_FILTER_SHUFFLE` when only a few low-order
+  // bits vary, at a higher cost.
+  INS_FILTER_BITSHUFFLE = 3
+};
+
+// Codecs compressing the filtered chunks.
+enum {
+  // The best codec of this build: zstd, otherwise LZ4, otherwise RLE.
+  INS_CODEC_DEFAULT = 0,
+  INS_CODEC_NONE = 1,
+  // The built-in run-length codec, always available.
+  INS_CODEC_RLE = 2,
+  INS_CODEC_LZ4 = 3,
+  INS_CODEC_ZSTD = 4
+};
+
+// Parameters of `*_fwrite_compressed`. A zero-initialized structure, or a
+// null pointer, selects the defaults.
+typedef struct {
+  // One of `INS_FILTER_*`.
+  int filter;
+
+  // One of `INS_CODEC_*`.
+  int codec;
+
+  // Compression level of the codec, or 0 for the codec's default. Only
+  // zstd and LZ4 (as the acceleration factor) use it.
+  int level;
+
+  // Number of elements per chunk, or 0 for chunks of about 256 KiB.
+  size_t chunk_size;
+} ins_compress_params;
+
+// Returns non-zero if this build of Insight can write and read files
+// compressed with `codec`.
+int ins_compress_codec_available(int codec);
+
+#endif // INS_COMPRESS_H_
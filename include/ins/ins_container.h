@@ -0,0 +1,95 @@
+#ifndef INS_CONTAINER_H_
+#define INS_CONTAINER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// The `.ins` container is a self-describing binary format for blocks and
+// vectors. A container starts with a fixed-size header
+//
+//   offset  size  field
+//        0     8  magic "\x89INS\r\n\x1a\n"
+//        8     4  byte order mark 0x01020304, in the writer's byte order
+//       12     4  format version
+//       16     4  element type (one of `ins_type`)
+//       20     4  element size in bytes
+//       24     8  number of elements
+//       32     8  payload offset from the start of the container
+//       40     8  payload size in bytes
+//       48     8  payload checksum (see `ins_container_checksum`)
+//       56     4  payload alignment
+//       60     4  reserved, zero
+//
+// followed by zero padding up to the payload offset, which is a multiple of
+// `INS_CONTAINER_ALIGNMENT` so that the payload of a container stored at the
+// start of a file can be memory-mapped directly. The payload holds the
+// elements contiguously in the raw layout written by `fwrite`, in the
+// writer's byte order. All header fields are stored in the writer's byte
+// order as well; readers detect and undo foreign byte orders.
+
+// Current version of the container format.
+#define INS_CONTAINER_VERSION 1
+
+// Size of the fixed header in bytes.
+#define INS_CONTAINER_HEADER_SIZE 64
+
+// Alignment of the payload in bytes. This is the common page size. It is
+// part of the format rather than taken from the host, so that files are the
+// same everywhere; on hosts with larger pages, such as 16 KiB, the payload
+// is still mapped in place from the page that contains it.
+#define INS_CONTAINER_ALIGNMENT 4096
+
+// Element type codes stored in the container header.
+typedef enum {
+  INS_TYPE_DOUBLE        = 1,
+  INS_TYPE_FLOAT         = 2,
+  INS_TYPE_INT           = 3,
+  INS_TYPE_F16           = 4,
+  INS_TYPE_BF16          = 5,
+  INS_TYPE_COMPLEX       = 6,
+  INS_TYPE_COMPLEX_FLOAT = 7
+} ins_type;
+
+// Flags accepted by the container read functions. They do not overlap with
+// the `INS_MMAP_*` flags, so both can be combined for `*_mmap_ins`.
+enum {
+  // Verify the payload checksum after reading, and fail with `INS_EFAILED`
+  // if it does not match the header.
+  INS_CONTAINER_VERIFY = 1 << 8
+};
+
+// The decoded header of a container. Fields are in the host byte order;
+// `big_endian` tells the byte order of the payload.
+typedef struct {
+  uint32_t version;
+  uint32_t type;
+  uint32_t elem_size;
+  uint32_t alignment;
+  uint64_t count;
+  uint64_t payload_offset;
+  uint64_t payload_size;
+  uint64_t checksum;
+  int big_endian;
+} ins_container_header;
+
+// Reads and validates the header of the container starting at the current
+// position of the stream `stream`, storing it in `header`. The payload is
+// not read; the stream is left positioned right after the fixed header. The
+// function returns `INS_SUCCESS` for success, `INS_EFAILED` if the header
+// cannot be read or is not a valid container header, and `INS_EUNSUP` if the
+// container was written by a newer version of the format.
+int ins_container_read_header(FILE * stream, ins_container_header * header);
+
+// Opens the file at `path` and reads the header of the container stored at
+// its start, without loading the payload. The return values are those of
+// `ins_container_read_header`.
+int ins_container_query(const char * path, ins_container_header * header);
+
+// Computes the payload checksum of the `nbytes` bytes at `data`. The
+// checksum runs eight independent Fletcher-64 lanes over the little-endian
+// 32-bit words of the data, so it vectorizes well and verifies at memory
+// bandwidth.
+uint64_t ins_container_checksum(const void * data, size_t nbytes);
+
+#endif // INS_CONTAINER_H_
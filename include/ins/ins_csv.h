@@ -0,0 +1,42 @@
+#ifndef INS_CSV_H_
+#define INS_CSV_H_
+
+#include <stddef.h>
+
+// Loading columns of delimited text files.
+//
+// The `*_read_csv` functions load selected columns of a CSV, TSV or other
+// delimited text file into one vector per column. Every line of the file is
+// a row of fields separated by a delimiter character. Fields may be
+// surrounded by blanks and by double quotes (quoted fields may contain the
+// delimiter, and `""` stands for a quote), and numbers are read in the "C"
+// locale like `*_fscanf` reads them. Empty fields are read as NaN into
+// floating point vectors and are an error for integer vectors. Empty lines
+// are skipped, lines may end with "\r\n", and a UTF-8 byte order mark at the
+// start of the file is ignored.
+//
+// The file is memory-mapped and split into ranges of whole lines that are
+// parsed in parallel, each thread storing its rows directly into the
+// vectors.
+
+// Options of the `*_read_csv` functions. A zero-initialized structure, or a
+// null pointer, reads comma-separated files from the first line on into
+// vectors for the first columns.
+typedef struct {
+  // The field delimiter, or 0 for a comma.
+  char delimiter;
+
+  // The number of lines at the start of the file, such as a header, that
+  // are skipped.
+  size_t skip_lines;
+
+  // The 0-based indices of the columns loaded into the vectors, one per
+  // vector. If null, vector `i` receives column `i`.
+  const size_t * columns;
+
+  // The number of threads parsing the file, or 0 for the number of threads
+  // of the tuning (see `ins/ins_tuning.h`), one per processor by default.
+  int threads;
+} ins_csv_options;
+
+#endif // INS_CSV_H_
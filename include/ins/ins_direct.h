@@ -0,0 +1,32 @@
+#ifndef INS_DIRECT_H_
+#define INS_DIRECT_H_
+
+// Direct I/O of blocks and vectors.
+//
+// The `*_read_direct` and `*_write_direct` functions move the elements of a
+// block or a vector between memory and a file, at a given byte offset in the
+// file, in the raw binary layout written by `fwrite`. The file is opened with
+// `O_DIRECT` (or `F_NOCACHE` where there is no `O_DIRECT`), so the data goes
+// straight between the device and memory instead of being copied through the
+// page cache, which would double the memory traffic of very large transfers
+// and evict data the process still needs.
+//
+// Direct transfers must start and end at multiples of `INS_DIRECT_ALIGNMENT`
+// in the file and in memory. The aligned middle part of a transfer is done
+// with direct I/O, in place if the memory is aligned like the file offset and
+// otherwise through an aligned bounce buffer, while the unaligned head and
+// tail are read or written through the page cache. Where the file system
+// does not support direct I/O, the whole transfer is buffered and the range
+// is dropped from the page cache afterwards.
+
+// The alignment in bytes of direct transfers. It is a multiple of the
+// logical block size of common devices.
+#define INS_DIRECT_ALIGNMENT 4096
+
+// Blocks of at least this many bytes are allocated at a multiple of
+// `INS_DIRECT_ALIGNMENT`, so that whole blocks and contiguous vectors
+// starting at their first element are transferred in place when the file
+// offset is aligned.
+#define INS_DIRECT_MIN_SIZE (1 << 20)
+
+#endif // INS_DIRECT_H_
@@ -47,31 +47,61 @@ enum {
 // Similar to std:strerror()
 const char* ins_strerror(const int error_code);
 
+/* THREADS */
+
+// The stream handler, the stream and the error handler are kept per thread.
+// A thread that has not set its own uses the process-wide defaults, which
+// are set with the `ins_set_default_*` functions. Changing the state of one
+// thread, such as turning the error handler off around a call that may fail,
+// does not affect other threads. Each thread also records its last error in
+// an `ins_error_record` (see LAST ERROR below).
+//
+// In earlier versions, `ins_set_error_handler`, `ins_set_error_handler_off`,
+// `ins_set_stream_handler` and `ins_set_stream` changed the whole process.
+// They now only change the calling thread, so code that sets a handler for
+// all threads must use the `ins_set_default_*` functions instead. The
+// threads that Insight starts to run the work of a call, such as those of
+// `ins_graph_run`, use the handlers and stream of the calling thread.
+
 /* STREAM HANDLER */
 
 // Insight stream handler type
 typedef void (ins_stream_handler_t)(const char*, const char*, int, const char*);
 
-// Sets the global variable `ins_stream_handler` to the `new_handler` and
-// returns the previous stream handler.
+// Returns the stream handler of the calling thread.
+ins_stream_handler_t* ins_get_stream_handler(void);
+
+// Sets the stream handler of the calling thread to the `new_handler` and
+// returns the previous stream handler of the thread.
 ins_stream_handler_t*
 ins_set_stream_handler(ins_stream_handler_t* new_handler);
 
-// Sets the global variable `ins_stream` to the given `new_stream` and
-// returns the previous stream.
+// Sets the default stream handler of all threads to the `new_handler` and
+// returns the previous default.
+ins_stream_handler_t*
+ins_set_default_stream_handler(ins_stream_handler_t* new_handler);
+
+// Returns the stream of the calling thread (default to stderr).
+FILE* ins_get_stream(void);
+
+// Sets the stream of the calling thread to the given `new_stream` and
+// returns the previous stream of the thread.
 FILE* ins_set_stream(FILE* new_stream);
 
-// If the global variable `ins_stream_handler` is defined, then this
-// function equivalent to invoking
+// Sets the default stream of all threads to the given `new_stream` and
+// returns the previous default.
+FILE* ins_set_default_stream(FILE* new_stream);
+
+// If the calling thread has a stream handler, then this function is
+// equivalent to invoking
 //
-//   `ins_stream_handler(label, file, line, reason)`.
+//   `handler(label, file, line, reason)`.
 //
 // Otherwise, it's equivalent to
 //
-//   `fprintf(ins_stream, "gsl: %s:%d: %s: %s\n", file, line, label, reason)`
+//   `fprintf(stream, "ins: %s:%d: %s: %s\n", file, line, label, reason)`
 //
-// in which `ins_stream` is a global variable pointing to a stream.
-// (default to stderr).
+// in which `stream` is the stream of the calling thread.
 void ins_stream_printf(const char* label, const char* file, int line,
                        const char* reason);
 
@@ -81,23 +111,57 @@ void ins_stream_printf(const char* label, const char* file, int line,
 typedef void (ins_error_handler_t)(const char* reason, const char* file,
                                    int line, int error_code);
 
-// Sets the global variable `ins_error_handler` to the `new_handler` and
-// returns the previous handler.
+// Returns the error handler of the calling thread.
+ins_error_handler_t* ins_get_error_handler(void);
+
+// Sets the error handler of the calling thread to the `new_handler` and
+// returns the previous handler of the thread.
 ins_error_handler_t*
 ins_set_error_handler(ins_error_handler_t* new_handler);
 
-// Sets the global variable `ins_error_handler` to the "do nothing" handler
-// and returns the previous handler.
+// Sets the error handler of the calling thread to the "do nothing" handler
+// and returns the previous handler of the thread.
 ins_error_handler_t* ins_set_error_handler_off(void);
 
-// If the global variable `ins_error_handler` is not NULL, then this
-// function is equivalent to invoking
+// Sets the default error handler of all threads to the `new_handler` and
+// returns the previous default.
+ins_error_handler_t*
+ins_set_default_error_handler(ins_error_handler_t* new_handler);
+
+// Records the error as the last error of the calling thread. Then, if the
+// calling thread has an error handler, this function is equivalent to
+// invoking
 //
-//   `ins_error_handler(reason, file, line, error_code)`
+//   `handler(reason, file, line, error_code)`
 //
-// Otherwise, it flushes the output to stderr.
+// Otherwise, it prints the error to the stream, flushes the output to stderr
+// and aborts.
 void ins_error(const char* reason, const char* file, int line, int error_code);
 
+/* LAST ERROR */
+
+// The last error of a thread. `error_code` is `INS_SUCCESS` and the other
+// fields are null if no error has been recorded since the thread started or
+// called `ins_clear_error`.
+typedef struct {
+  int error_code;
+  const char* reason;
+  const char* file;
+  int line;
+} ins_error_record;
+
+// Records the error as the last error of the calling thread, without
+// invoking any handler. It only stores a few fields of thread-local storage,
+// so hot paths and worker threads can report errors with it cheaply.
+void ins_record_error(const char* reason, const char* file, int line,
+                      int error_code);
+
+// Returns the last error of the calling thread.
+const ins_error_record* ins_last_error(void);
+
+// Clears the last error of the calling thread.
+void ins_clear_error(void);
+
 /* CONVINIENT MACROS */
 
 // INS_ERROR: call the error handler, and return the error code
@@ -121,4 +185,12 @@ void ins_error(const char* reason, const char* file, int line, int error_code);
     return;                                             \
   } while (0)
 
+// INS_ERROR_RECORD: record the error without calling the error handler, and
+// return the error code
+#define INS_ERROR_RECORD(reason, error_code)                    \
+  do {                                                          \
+    ins_record_error(reason, __FILE__, __LINE__, error_code);   \
+    return error_code;                                          \
+  } while (0)
+
 #endif /* INS_ERRNO_H_ */
@@ -0,0 +1,86 @@
+#ifndef INS_GRAPH_H_
+#define INS_GRAPH_H_
+
+#include <stddef.h>
+
+// Task graphs.
+//
+// A graph records vector operations, such as `ins_vector_graph_dot` or
+// `ins_vector_float_graph_axpy`, and tasks of the caller as its nodes, and
+// runs them with `ins_graph_run` on a pool of threads. A node depends on
+// the nodes recorded before it that write the elements or scalars it reads
+// or writes, or read the ones it writes, so that the graph computes the
+// same results as calling the operations in the order they were recorded,
+// while independent nodes run at the same time. Scalars are passed by
+// pointer and read when the node runs, so that the result of a reduction
+// can feed a later operation:
+//
+//   ins_vector_graph_dot(graph, x, y, &xy);
+//   ins_vector_graph_dot(graph, x, x, &xx);
+//   ins_vector_graph_minmax(graph, z, &min, &max);
+//   ins_vector_graph_axpy(graph, &xy, x, y);  // after the first dot
+//
+// Each thread of the pool keeps the nodes that became ready on it in a
+// deque, runs the newest one first and steals the oldest one of another
+// thread when its own deque is empty.
+//
+// With fusion turned on, a chain of elementwise operations on vectors of
+// the same length, in which each node is the only one depending on the
+// previous node, runs as one task that applies the whole chain to a slice
+// of the vectors at a time, while the slice is in cache. The slices are
+// sized for the L2 cache of the tuning (see `ins/ins_tuning.h`).
+//
+// A graph may be run any number of times, and must not be changed or freed
+// while it runs.
+
+// A task graph.
+typedef struct ins_graph ins_graph;
+
+// A node of a task graph.
+typedef struct ins_graph_node ins_graph_node;
+
+// A task of the caller, called with its context.
+typedef int (ins_graph_task_t)(void * context);
+
+// Allocates an empty graph. Returns null if there is not enough memory.
+ins_graph * ins_graph_alloc(void);
+
+// Frees the graph `graph` and its nodes, but not the vectors and scalars
+// they refer to.
+void ins_graph_free(ins_graph * graph);
+
+// Turns fusion of elementwise operations on if `enabled` is non-zero, and
+// off otherwise, which is the default.
+void ins_graph_set_fusion(ins_graph * graph, int enabled);
+
+// Records a node that calls `task(context)`, which returns `INS_SUCCESS` or
+// an error code. Since the graph does not know what the task reads and
+// writes, it depends on no other node, and no node recorded later depends
+// on it, unless given dependencies with `ins_graph_depend`. Returns null if
+// there is not enough memory.
+ins_graph_node * ins_graph_task(ins_graph * graph, ins_graph_task_t * task,
+                                void * context);
+
+// Makes `node` run after `before`, which must have been recorded before it
+// in the same graph. Returns `INS_SUCCESS`, `INS_EINVAL` otherwise, or
+// `INS_ENOMEM` if there is not enough memory.
+int ins_graph_depend(ins_graph_node * node, ins_graph_node * before);
+
+// Returns the number of nodes of the graph `graph`.
+size_t ins_graph_size(const ins_graph * graph);
+
+// Runs the nodes of the graph `graph` on `threads` threads, including the
+// calling one, or as many as the tuning (see `ins/ins_tuning.h`) gives if
+// `threads` is 0, and returns when all have finished. Returns `INS_SUCCESS`,
+// the error code of the first node that failed, after which the nodes that
+// have not started are skipped, or `INS_ENOMEM` if there is not enough
+// memory. Threads that cannot be started leave their share of the nodes to
+// the others.
+//
+// The other threads use the error handler, stream handler and stream of
+// the calling thread (see `ins/ins_errno.h`), so errors in nodes are
+// handled as in the calling thread. The error of the first node that failed
+// is also recorded as the last error of the calling thread.
+int ins_graph_run(ins_graph * graph, int threads);
+
+#endif // INS_GRAPH_H_
@@ -0,0 +1,84 @@
+#ifndef INS_MEMORY_H_
+#define INS_MEMORY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Memory accounting.
+//
+// The bytes of elements allocated by `ins_block_[type]_alloc` and
+// `ins_block_[type]_calloc`, and so by the vectors that allocate their own
+// blocks, are counted process-wide, per thread and per tag until the blocks
+// are freed. Blocks whose elements are mapped from files are not counted.
+//
+// A tag is a number in `[0, INS_MEMORY_TAGS)` that attributes allocations
+// to a subsystem or tenant. Each thread allocates under its current tag, 0
+// until it sets another one, and a block is counted under the tag it was
+// allocated with wherever it is freed.
+//
+// Budgets bound the live bytes process-wide and per tag. An allocation that
+// would exceed a budget calls the budget handler, and fails with
+// `INS_ENOMEM` unless the handler allows it, before any memory is taken.
+
+// The number of tags.
+#define INS_MEMORY_TAGS 64
+
+typedef struct {
+  // The bytes of the blocks that are allocated and not yet freed, and the
+  // highest value they have reached since start-up or the last reset.
+  size_t live_bytes;
+  size_t peak_bytes;
+
+  // The numbers of blocks allocated and freed.
+  uint64_t allocations;
+  uint64_t frees;
+} ins_memory_usage;
+
+// Stores the process-wide usage into `usage`.
+void ins_get_memory_usage(ins_memory_usage * usage);
+
+// Stores the usage of the calling thread into `usage`: the blocks it
+// allocated and freed, with the bytes of the blocks it freed taken from
+// the bytes it allocated, down to 0.
+void ins_get_thread_memory_usage(ins_memory_usage * usage);
+
+// Stores the usage of the blocks allocated under `tag` into `usage`.
+// Returns `INS_SUCCESS`, or `INS_EINVAL` if `tag` is out of range.
+int ins_get_tag_memory_usage(int tag, ins_memory_usage * usage);
+
+// Sets the peaks of the process, of the calling thread and of all tags to
+// their live bytes.
+void ins_reset_memory_peak(void);
+
+// Returns the tag the calling thread allocates under.
+int ins_get_memory_tag(void);
+
+// Sets the tag the calling thread allocates under to `tag`. Returns
+// `INS_SUCCESS`, or `INS_EINVAL` if `tag` is out of range.
+int ins_set_memory_tag(int tag);
+
+// Sets the budget of the live bytes of the process to `bytes`, or removes
+// it if `bytes` is 0.
+void ins_set_memory_budget(size_t bytes);
+
+// Sets the budget of the live bytes of `tag` to `bytes`, or removes it if
+// `bytes` is 0. Returns `INS_SUCCESS`, or `INS_EINVAL` if `tag` is out of
+// range.
+int ins_set_tag_memory_budget(int tag, size_t bytes);
+
+// Budget handler type. It is called with the size in bytes of an
+// allocation under `tag` that would exceed `budget`, the process-wide
+// budget or the budget of `tag`, and returns non-zero to allow it anyway
+// (e.g. after releasing caches), or 0 to fail it.
+typedef int (ins_memory_budget_handler_t)(size_t bytes, int tag,
+                                          size_t budget);
+
+// Returns the budget handler, null by default, which fails allocations.
+ins_memory_budget_handler_t * ins_get_memory_budget_handler(void);
+
+// Sets the budget handler of all threads to `handler` and returns the
+// previous handler.
+ins_memory_budget_handler_t *
+ins_set_memory_budget_handler(ins_memory_budget_handler_t * handler);
+
+#endif // INS_MEMORY_H_
@@ -0,0 +1,37 @@
+#ifndef INS_MMAP_H_
+#define INS_MMAP_H_
+
+// Flags accepted by the `ins_vector_*_mmap` functions. They can be combined
+// with bitwise or.
+enum {
+  // Map the file read-only. Writing to the elements of a read-only mapped
+  // vector is undefined behavior (it usually raises SIGSEGV).
+  INS_MMAP_READ       = 0,
+
+  // Map the file read-write and shared: stores to the vector elements are
+  // carried through to the file and are visible to every other process
+  // mapping the same file.
+  INS_MMAP_WRITE      = 1 << 0,
+
+  // Prefault the whole mapping when it is created (`MAP_POPULATE`). Ignored
+  // on systems that do not support it.
+  INS_MMAP_POPULATE   = 1 << 1,
+
+  // Advise the kernel that the elements will be accessed sequentially
+  // (`MADV_SEQUENTIAL`), which enables aggressive read-ahead.
+  INS_MMAP_SEQUENTIAL = 1 << 2,
+
+  // Advise the kernel that the elements will be accessed in random order
+  // (`MADV_RANDOM`), which disables read-ahead.
+  INS_MMAP_RANDOM     = 1 << 3,
+
+  // Advise the kernel that the elements will be needed soon
+  // (`MADV_WILLNEED`), which starts reading them in the background.
+  INS_MMAP_WILLNEED   = 1 << 4,
+
+  // Back the mapping with huge pages where the kernel supports transparent
+  // huge pages for the file (`MADV_HUGEPAGE`).
+  INS_MMAP_HUGEPAGE   = 1 << 5
+};
+
+#endif // INS_MMAP_H_
@@ -0,0 +1,52 @@
+#ifndef INS_SHM_H_
+#define INS_SHM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Vectors in POSIX shared memory.
+//
+// A publisher creates a named shared-memory segment with
+// `ins_vector_[type]_shm_create` and fills its elements. Other processes on
+// the same host attach to it with `ins_vector_[type]_shm_open`, which maps
+// the same pages without copying them. A segment starts with a fixed-size
+// header
+//
+//   offset  size  field
+//        0     8  magic "\x89INSSHM\n"
+//        8     4  format version
+//       12     4  element type (one of `ins_type`)
+//       16     4  element size in bytes
+//       20     4  reserved, zero
+//       24     8  number of elements
+//       32     8  epoch
+//       40    24  reserved, zero
+//
+// followed by the elements, contiguous and in the host byte order.
+//
+// The epoch versions the elements. It is even while they are stable, and
+// the publisher makes it odd for the duration of an update with
+// `ins_vector_[type]_shm_begin_publish` and even again with
+// `ins_vector_[type]_shm_end_publish`. Readers never block the publisher:
+// they read the epoch before and after using the elements, and retry if it
+// was odd or has changed in between, as in
+//
+//   do {
+//     ins_vector_shm_epoch(v, &before);
+//     ... read the elements of v ...
+//     ins_vector_shm_epoch(v, &after);
+//   } while (before % 2 != 0 || before != after);
+
+// Current version of the segment format.
+#define INS_SHM_VERSION 1
+
+// Size of the header in bytes. The elements start at this offset, which is
+// a multiple of the size of every element type.
+#define INS_SHM_HEADER_SIZE 64
+
+// Removes the shared-memory segment `name`. Vectors already mapped over it
+// stay valid, and the memory is released when the last of them is freed.
+// Returns `INS_SUCCESS`, or `INS_EFAILED` if the segment cannot be removed.
+int ins_shm_unlink(const char * name);
+
+#endif // INS_SHM_H_
@@ -0,0 +1,52 @@
+#ifndef INS_STATS_H_
+#define INS_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Operation counters.
+//
+// When Insight is configured with `INSIGHT_ENABLE_STATS`, the entry points of
+// blocks and vectors (operations, reductions, allocating, viewing, wrapping,
+// mapping and freeing, and reading and writing files) count their calls, the
+// elements they process, the bytes of elements they read and write, and the
+// time they take in cycles of the processor's time stamp counter (or
+// nanoseconds where there is none). Element accessors are not counted, and
+// neither are the `ins_vector_[type]_graph_*` functions, which only add
+// nodes; the operations of the nodes are counted when the graph runs.
+// Counting starts when `ins_stats_enable` turns it on, or at start-up if the
+// environment variable `INSIGHT_STATS` is set to `1`.
+//
+// Each thread counts into its own table, without locks or atomic
+// read-modify-write operations, and the tables are merged when they are read.
+// The counts of threads that have exited are kept. Without
+// `INSIGHT_ENABLE_STATS` the entry points contain no trace of the counters.
+
+// The counters of one operation, such as "ins_vector_float_add".
+typedef struct {
+  const char * name;
+  uint64_t calls;
+  uint64_t elements;
+  uint64_t bytes;
+  uint64_t cycles;
+} ins_stats_entry;
+
+// Turns counting on if `enabled` is non-zero, and off otherwise. Returns
+// `INS_SUCCESS`, or `INS_EUNSUP` if Insight was configured without
+// `INSIGHT_ENABLE_STATS`.
+int ins_stats_enable(int enabled);
+
+// Returns non-zero if operations are being counted.
+int ins_stats_enabled(void);
+
+// Stores the counters of the operations called since the last reset, merged
+// over all threads, into `entries[0, capacity)` in the order in which the
+// operations were first called, and returns their number, which may be
+// larger than `capacity`.
+size_t ins_stats_snapshot(ins_stats_entry * entries, size_t capacity);
+
+// Sets all counters to zero. Operations running in other threads during a
+// reset may still count into the old values.
+void ins_stats_reset(void);
+
+#endif // INS_STATS_H_
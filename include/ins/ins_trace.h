@@ -0,0 +1,84 @@
+#ifndef INS_TRACE_H_
+#define INS_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Tracing of operations.
+//
+// When Insight is configured with `INSIGHT_ENABLE_TRACE` (off by default), the
+// entry points that count their calls with `INSIGHT_ENABLE_STATS` (see
+// `ins/ins_stats.h`) also report the start and the end of every call to the
+// trace handler, while one is set. The handler is process-wide and is called
+// in the thread making the call, so that it can record operations next to
+// the spans of the application. Without a handler each entry point only
+// tests a flag.
+//
+// Timestamps are nanoseconds of `CLOCK_MONOTONIC`, the clock of most
+// profilers on Linux.
+//
+// A built-in handler records complete events into a ring buffer per thread,
+// preallocated when it starts, and writes them as a Chrome trace-event JSON
+// file, which chrome://tracing, Perfetto and speedscope open directly.
+
+// A traced call, such as of "ins_vector_float_add" on vectors of `size`
+// elements. `stride` is the stride of the first vector argument, and 1 for
+// blocks. `bytes` is the number of bytes of elements read and written.
+// `end` is 0 until the call returns.
+typedef struct {
+  const char * name;
+  size_t size;
+  ptrdiff_t stride;
+  size_t bytes;
+  uint64_t begin;
+  uint64_t end;
+} ins_trace_event;
+
+// Trace callback type. `context` is the context of the handler.
+typedef void (ins_trace_callback_t)(const ins_trace_event * event,
+                                    void * context);
+
+// A trace handler. `begin` is called when a call starts and `end` when it
+// returns, with the same event. Either may be null.
+typedef struct {
+  ins_trace_callback_t * begin;
+  ins_trace_callback_t * end;
+  void * context;
+} ins_trace_handler;
+
+// Returns the trace handler, or null if tracing is off.
+const ins_trace_handler * ins_get_trace_handler(void);
+
+// Sets the trace handler to `new_handler`, or turns tracing off if it is
+// null, and returns the previous handler. The handler is not copied and
+// must stay valid until calls that started before it was replaced have
+// returned. If Insight was configured without `INSIGHT_ENABLE_TRACE`, calls
+// the error handler with `INS_EUNSUP` and returns null.
+const ins_trace_handler *
+ins_set_trace_handler(const ins_trace_handler * new_handler);
+
+/* CHROME TRACE */
+
+// Allocates ring buffers for `threads` threads of `events` events each and
+// sets the trace handler to the built-in one, which records every call that
+// returns into the buffer of its thread. When a buffer is full, the oldest
+// events are overwritten; threads beyond the first `threads` to make a call
+// are not recorded. Events of a previous start are discarded, and calls
+// it is still recording in other threads must have returned. Returns
+// `INS_SUCCESS`, `INS_EINVAL` if `threads` or `events` is 0, `INS_ENOMEM`
+// if allocation fails, or `INS_EUNSUP` without `INSIGHT_ENABLE_TRACE`.
+int ins_trace_chrome_start(size_t threads, size_t events);
+
+// Turns tracing off if the built-in handler is set. The recorded events are
+// kept until the next start.
+void ins_trace_chrome_stop(void);
+
+// Writes the recorded events, oldest first per thread, as a Chrome
+// trace-event JSON object to `stream`. Events are in microseconds, with the
+// process and system thread ids, and the size, stride and bytes of each
+// call as arguments. Returns `INS_SUCCESS`, or `INS_EFAILED` if writing
+// fails. Events recorded while writing may be torn; stop first.
+int ins_trace_chrome_write(FILE * stream);
+
+#endif // INS_TRACE_H_
@@ -0,0 +1,81 @@
+#ifndef INS_TUNING_H_
+#define INS_TUNING_H_
+
+#include <stddef.h>
+
+// Tuning profiles.
+//
+// The choices that depend on the host, such as from which length the vector
+// operations of `double` and `float` vectors call BLAS instead of a plain
+// loop, and how many threads the parallel loaders and decompressors use,
+// are read from the process-wide tuning. It starts with defaults that keep
+// the behaviour of untuned builds, and is replaced by a tuning profile
+// written by the `insight_tune` program for the host, loaded at start-up
+// from the file named by the environment variable `INSIGHT_TUNING` or later
+// with `ins_load_tuning`.
+//
+// A profile is a text file of `key = value` lines; blank lines and lines
+// starting with `#` are ignored. The keys are the fields of `ins_tuning`,
+// with the crossovers written as `blas_min.<type>.<op>`, such as
+// `blas_min.double.axpy`. Keys missing from a profile keep their current
+// values, and unknown keys are skipped, so that profiles stay readable
+// across versions.
+
+// The vector operations that can call BLAS, as indices of the crossovers.
+enum {
+  INS_TUNING_SCALE = 0,
+  INS_TUNING_AXPY = 1,
+  INS_TUNING_SWAP = 2,
+  INS_TUNING_COPY = 3,
+  INS_TUNING_DOT = 4,
+  INS_TUNING_BLAS_OPS = 5
+};
+
+typedef struct {
+  // The sizes in bytes of the data caches of one core, and the bandwidth of
+  // main memory in bytes per second, as measured by `insight_tune`. They
+  // are 0 if unknown. The library only reads `l2_cache`, which sizes the
+  // slices that fused chains of task graphs run on (see `ins/ins_graph.h`);
+  // the others are informational.
+  size_t l1_cache;
+  size_t l2_cache;
+  size_t l3_cache;
+  double memory_bandwidth;
+
+  // The number of threads of parallel operations that are not given one,
+  // or 0 for one per online processor. The one value is used by the CSV
+  // loaders, the decompressors, the asynchronous I/O pool and task graph
+  // runs alike, although `insight_tune` only times CSV loads to choose it.
+  int threads;
+
+  // The minimum number of bytes of text one thread of a parallel loader
+  // parses, so that small files are not split into more ranges than are
+  // worth starting a thread for.
+  size_t parallel_min_bytes;
+
+  // The vector operations of `double` and `float` vectors at least this
+  // long call BLAS, shorter ones run a plain loop.
+  size_t blas_min_double[INS_TUNING_BLAS_OPS];
+  size_t blas_min_float[INS_TUNING_BLAS_OPS];
+} ins_tuning;
+
+// Stores the default tuning into `tuning`.
+void ins_default_tuning(ins_tuning * tuning);
+
+// Stores the current tuning into `tuning`.
+void ins_get_tuning(ins_tuning * tuning);
+
+// Replaces the current tuning by `tuning`. Operations running in other
+// threads may still use the previous values.
+void ins_set_tuning(const ins_tuning * tuning);
+
+// Loads the tuning profile at `path` into the current tuning. Returns
+// `INS_SUCCESS`, `INS_EFAILED` if the file cannot be read, or `INS_EINVAL`
+// if a line is malformed, in which case the current tuning is unchanged.
+int ins_load_tuning(const char * path);
+
+// Writes `tuning` as a tuning profile to `path`. Returns `INS_SUCCESS` or
+// `INS_EFAILED` if writing fails.
+int ins_save_tuning(const ins_tuning * tuning, const char * path);
+
+#endif // INS_TUNING_H_
@@ -2,5 +2,11 @@
 #define INS_VECTOR_H_
 
 #include "ins/vector/ins_vector_double.h"
+#include "ins/vector/ins_vector_float.h"
+#include "ins/vector/ins_vector_int.h"
+#include "ins/vector/ins_vector_f16.h"
+#include "ins/vector/ins_vector_bf16.h"
+#include "ins/vector/ins_vector_complex.h"
+#include "ins/vector/ins_vector_complex_float.h"
 
 #endif /* INS_VECTOR_H_ */
@@ -0,0 +1,290 @@
+#ifndef INS_VECTOR_COMPLEX_FLOAT_H_
+#define INS_VECTOR_COMPLEX_FLOAT_H_
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <ins/ins_errno.h>
+#include <ins/ins_container.h>
+#include <ins/ins_async.h>
+#include <ins/ins_direct.h>
+#include <ins/ins_compress.h>
+#include <ins/ins_complex.h>
+#include <ins/block/ins_block_complex_float.h>
+
+struct ins_vector_complex_float_struct {
+  // Number of complex elements in the vector.
+  size_t size;
+
+  // The step-size from one element to the next in physical memory, counted
+  // in complex numbers. Each element takes two floats, the real part
+  // followed by the imaginary part, so the element `i` starts at
+  // `data[2 * i * stride]`. As for real vectors, a negative `stride` walks
+  // the memory backwards, starting from `data`, and `stride` is never zero.
+  ptrdiff_t stride;
+
+  // The location of the real part of the first element of the vector.
+  float * data;
+
+  // The location of the memory block in which the vector elements are
+  // located (if any). If the vector owns this block then the `owner` field is
+  // set to one and the block will be deallocated when the vector is freed.
+  ins_block_complex_float * block;
+  int owner;
+};
+
+typedef struct ins_vector_complex_float_struct ins_vector_complex_float;
+
+/* Allocation
+ --------------------------------------------------------------------------*/
+
+// Creates a vector of `n` complex numbers and returns a pointer to the newly
+// created vector struct. The block is "owned" by the vector and will be
+// deallocated when the vector is freed.
+// Zero-size requests are valid and return a non-null result.
+ins_vector_complex_float * ins_vector_complex_float_alloc(const size_t n);
+
+// Allocates memory for a vector of length `n` and initializes all the elements
+// of the vector to zero.
+ins_vector_complex_float * ins_vector_complex_float_calloc(const size_t n);
+
+// Allocates memory for a vector of length `n` that shares its elements with
+// the given block `b`, i.e.
+//
+//   `v[i] = b[offset + i * stride] for i = 0, 1, ... n-1`,
+//
+// where `offset` and `stride` count complex numbers. The block `b` will not
+// be deallocated when the vector is freed.
+ins_vector_complex_float *
+ins_vector_complex_float_alloc_from_block(ins_block_complex_float * b,
+                                          const size_t offset,
+                                          const size_t n,
+                                          const ptrdiff_t stride);
+
+// Allocates memory for a vector of length `n` that shares its elements with
+// another vector `v`, i.e.
+//
+//   `v'[i] = v[offset + i * stride] for i = 0, 1, ... n-1`.
+//
+// The underlying block owned by the input vector `v` will not be deallocated
+// when the output vector is freed.
+ins_vector_complex_float *
+ins_vector_complex_float_alloc_from_vector(ins_vector_complex_float * v,
+                                           const size_t offset,
+                                           const size_t n,
+                                           const ptrdiff_t stride);
+
+// Allocates memory for a vector that views the elements of the vector `v`
+// in reverse order. No elements are copied.
+ins_vector_complex_float *
+ins_vector_complex_float_alloc_reverse(ins_vector_complex_float * v);
+
+// Creates a vector of length `n` over memory the caller owns, without copying
+// it: the complex number `i` of the vector is the complex number `i * stride`
+// of `data`, where `stride` may be negative and must not be zero. The vector
+// owns a block over the memory it spans (see `ins_block_complex_float_wrap`)
+// that leaves the memory to the caller; to run a deleter when the memory is no
+// longer used, wrap a block and create vectors over it with
+// `ins_vector_complex_float_alloc_from_block` instead.
+ins_vector_complex_float *
+ins_vector_complex_float_wrap(float * data,
+                              const size_t n,
+                              const ptrdiff_t stride);
+
+// Frees a previously allocated vector `v`. The underlying block is only
+// deallocated if it is owned by the vector.
+void ins_vector_complex_float_free(ins_vector_complex_float * v);
+
+/* Accessing vector elements
+ --------------------------------------------------------------------------*/
+
+// Returns the element of the vector `v` at the index `i`. No bounds checking
+// is performed.
+ins_complex_float
+ins_vector_complex_float_get(const ins_vector_complex_float * v,
+                             const size_t i);
+
+// Sets the element of the vector `v` at the index `i` to `z`. No bounds
+// checking is performed.
+void
+ins_vector_complex_float_set(ins_vector_complex_float * v,
+                             const size_t i,
+                             ins_complex_float z);
+
+/* Initializing vector elements
+ --------------------------------------------------------------------------*/
+
+// Set all elements of the vector `v` to zero.
+void ins_vector_complex_float_set_zero(ins_vector_complex_float * v);
+
+// Set all elements of the vector `v` to the value `z`.
+void
+ins_vector_complex_float_set_all(ins_vector_complex_float * v,
+                                 ins_complex_float z);
+
+// Set all elements of the vector `v` to zero except for the i-th element
+// which is set to one. No bounds checking are performed.
+void ins_vector_complex_float_set_basis(ins_vector_complex_float * v, size_t i);
+
+/* Vector operations
+ ---------------------------------------------------------------------------*/
+
+// Adds the elements of the vector `y` to the elements of the vector `x`.
+// The two vectors must have the same length.
+int
+ins_vector_complex_float_add(ins_vector_complex_float * x,
+                             const ins_vector_complex_float * y);
+
+// Subtracts the elements of the vector `y` from the elements of the vector
+// `x`. The two vectors must have the same length.
+int
+ins_vector_complex_float_sub(ins_vector_complex_float * x,
+                             const ins_vector_complex_float * y);
+
+// Multiplies the elements of the vector `x` by the elements of the vector
+// `y` as complex numbers. The result is stored in `x` and `y` remains
+// unchanged. The two vectors must have the same length.
+int
+ins_vector_complex_float_mul(ins_vector_complex_float * x,
+                             const ins_vector_complex_float * y);
+
+// Multiplies the elements of the vector `x` by the complex factor `alpha`.
+int
+ins_vector_complex_float_scale(ins_vector_complex_float * x,
+                               ins_complex_float alpha);
+
+// Performs the operation `y <- alpha * x + y`. The vectors `x` and `y` must
+// have the same length.
+int
+ins_vector_complex_float_axpy(ins_complex_float alpha,
+                              const ins_vector_complex_float * x,
+                              ins_vector_complex_float * y);
+
+// Exchanges the elements of the vectors `v` and `w` by copying. The function
+// returns `INS_EINVAL` if two vectors have different lengths.
+int
+ins_vector_complex_float_swap(ins_vector_complex_float * v,
+                              ins_vector_complex_float * w);
+
+// Copies the elements of the vector `src` into the vector `dst`. The function
+// returns `INS_EINVAL` if two vectors have different lengths.
+int
+ins_vector_complex_float_copy(ins_vector_complex_float * dst,
+                              const ins_vector_complex_float * src);
+
+// Computes the unconjugated dot product `sum_i v_i * w_i` of the two vectors
+// `v` and `w`. The two vectors must have the same length.
+ins_complex_float
+ins_vector_complex_float_dotu(const ins_vector_complex_float * v,
+                              const ins_vector_complex_float * w);
+
+// Computes the conjugated dot product `sum_i conj(v_i) * w_i` of the two
+// vectors `v` and `w`. The two vectors must have the same length.
+ins_complex_float
+ins_vector_complex_float_dotc(const ins_vector_complex_float * v,
+                              const ins_vector_complex_float * w);
+
+// Computes and returns the Euclidean norm of the vector `v`.
+float ins_vector_complex_float_nrm2(const ins_vector_complex_float * v);
+
+/* Containers
+   -----------------------------------------------------------------------*/
+
+// Writes the elements of the vector `v` to the stream `stream` as a
+// self-describing `.ins` container (see `ins/ins_container.h`). Strided
+// vectors are written contiguously. The return value is `INS_SUCCESS` for
+// success and `INS_EFAILED` if there was a problem writing to the file.
+int ins_vector_complex_float_fwrite_ins(const ins_vector_complex_float * v,
+                                        FILE * stream);
+
+// Reads a `.ins` container from the stream `stream` into the vector `v`,
+// which must be preallocated with the number of elements recorded in the
+// container. Payloads written with a foreign byte order are converted. If
+// `flags` contains `INS_CONTAINER_VERIFY` the payload checksum is verified.
+// The function returns `INS_EINVAL` if the container holds another element
+// type, `INS_EBADLEN` if it holds another number of elements, and
+// `INS_EFAILED` if reading fails or the checksum mismatches.
+int ins_vector_complex_float_fread_ins(ins_vector_complex_float * v,
+                                       FILE * stream,
+                                       const int flags);
+
+/* Compressed files
+   -----------------------------------------------------------------------*/
+
+// Writes the elements of the vector `v` to the stream `stream` as a compressed
+// file (see `ins/ins_compress.h`), using the filter, codec and chunk size of
+// `params`, or the defaults if `params` is null. The stream must be seekable.
+// The return value is `INS_SUCCESS` for success, `INS_EINVAL` for invalid
+// parameters, `INS_EUNSUP` if the codec is not available in this build, and
+// `INS_EFAILED` if there was a problem writing to the file.
+int
+ins_vector_complex_float_fwrite_compressed(const ins_vector_complex_float * v,
+                                           FILE * stream,
+                                           const ins_compress_params * params);
+
+// Reads a compressed file from the stream `stream` into the vector `v`, which
+// must be preallocated with the number of elements of the file. The chunks are
+// decompressed in parallel. The function returns `INS_EINVAL` if the file holds
+// another element type, `INS_EBADLEN` if it holds another number of elements,
+// `INS_EUNSUP` if its codec is not available in this build, and `INS_EFAILED`
+// if reading fails or the file is corrupt.
+int ins_vector_complex_float_fread_compressed(ins_vector_complex_float * v,
+                                              FILE * stream);
+
+// Reads the elements `offset` to `offset + v->size - 1` of the compressed file
+// at the current position of the stream `stream` into the vector `v`,
+// decompressing only the chunks holding them. The stream is left after the end
+// of the file, as by `ins_vector_complex_float_fread_compressed`, whose return
+// values this function shares; `INS_EBADLEN` is returned if the range extends
+// past the last element of the file.
+int
+ins_vector_complex_float_fread_compressed_range(ins_vector_complex_float * v,
+                                                FILE * stream,
+                                                const size_t offset);
+
+/* Asynchronous I/O
+   -----------------------------------------------------------------------*/
+
+// Starts reading the elements of the vector `v` from the file descriptor `fd`,
+// `offset` bytes into the file, in the raw layout written by
+// `ins_block_complex_float_fwrite` (see `ins/ins_async.h`). Returns a handle
+// to pass to `ins_async_wait`, or a null pointer if the read cannot be started.
+ins_async * ins_vector_complex_float_read_async(ins_vector_complex_float * v,
+                                                const int fd,
+                                                const size_t offset);
+
+// Starts writing the elements of the vector `v` to the file descriptor `fd`,
+// `offset` bytes into the file, in the raw layout written by
+// `ins_block_complex_float_fwrite`. Strided vectors are copied to a staging
+// buffer before the function returns. Returns a handle to pass to
+// `ins_async_wait`, or a null pointer if the write cannot be started.
+ins_async *
+ins_vector_complex_float_write_async(const ins_vector_complex_float * v,
+                                     const int fd,
+                                     const size_t offset);
+
+/* Direct I/O
+   -----------------------------------------------------------------------*/
+
+// Reads the elements of the vector `v` from the file at `path`, `offset` bytes
+// into the file, in the raw layout written by
+// `ins_block_complex_float_fwrite`, bypassing the page cache (see
+// `ins/ins_direct.h`). Strided vectors go through an aligned staging buffer, a
+// few megabytes at a time. Returns `INS_SUCCESS` for success, `INS_ENOMEM` if a
+// staging buffer cannot be allocated, and `INS_EFAILED` if the file cannot be
+// read or is too short.
+int ins_vector_complex_float_read_direct(ins_vector_complex_float * v,
+                                         const char * path,
+                                         const size_t offset);
+
+// Writes the elements of the vector `v` to the file at `path`, `offset` bytes
+// into the file, in the raw layout written by
+// `ins_block_complex_float_fwrite`, bypassing the page cache. The file is
+// created if it does not exist, and is neither truncated nor written outside
+// the range of the elements. Returns `INS_SUCCESS` for success, `INS_ENOMEM` if
+// a staging buffer cannot be allocated, and `INS_EFAILED` if the file cannot be
+// written.
+int ins_vector_complex_float_write_direct(const ins_vector_complex_float * v,
+                                          const char * path,
+                                          const size_t offset);
+
+#endif  // INS_VECTOR_COMPLEX_FLOAT_H_
@@ -0,0 +1,228 @@
+#ifndef INS_VECTOR_F16_H_
+#define INS_VECTOR_F16_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <ins/ins_errno.h>
+#include <ins/ins_container.h>
+#include <ins/ins_async.h>
+#include <ins/ins_direct.h>
+#include <ins/ins_compress.h>
+#include <ins/block/ins_block_f16.h>
+#include <ins/vector/ins_vector_float.h>
+
+// A vector of IEEE 754 half precision numbers. The elements are stored as
+// their raw 16-bit patterns, a quarter of the bytes of a double, while all
+// arithmetic is done in single precision: elements are converted to `float`
+// when they are read and rounded back to half precision when they are
+// written. The fields have the same meaning as the ones of `ins_vector`.
+struct ins_vector_f16_struct {
+  size_t size;
+  ptrdiff_t stride;
+  uint16_t * data;
+  ins_block_f16 * block;
+  int owner;
+};
+
+typedef struct ins_vector_f16_struct ins_vector_f16;
+
+/* Allocation
+ --------------------------------------------------------------------------*/
+
+// Creates a vector of length `n` that owns a newly allocated block. See
+// `ins_vector_alloc`.
+ins_vector_f16 * ins_vector_f16_alloc(const size_t n);
+
+// Allocates memory for a vector of lenght `n` and initializes all the elements
+// of the vector to zero.
+ins_vector_f16 * ins_vector_f16_calloc(const size_t n);
+
+// Creates a vector of length `n` over the elements of the block `b` with
+// `v[i] = b[offset + i * stride]`. See `ins_vector_alloc_from_block`.
+ins_vector_f16 *
+ins_vector_f16_alloc_from_block(ins_block_f16 * b,
+                                const size_t offset,
+                                const size_t n,
+                                const ptrdiff_t stride);
+
+// Creates a vector of length `n` over the elements of the vector `v` with
+// `v'[i] = v[offset + i * stride]`. See `ins_vector_alloc_from_vector`.
+ins_vector_f16 *
+ins_vector_f16_alloc_from_vector(ins_vector_f16 * v,
+                                 const size_t offset,
+                                 const size_t n,
+                                 const ptrdiff_t stride);
+
+// Creates a view of the elements of the vector `v` in reverse order.
+ins_vector_f16 * ins_vector_f16_alloc_reverse(ins_vector_f16 * v);
+
+// Creates a vector of length `n` over memory the caller owns, without copying
+// it: the element `i` of the vector is the element `i * stride` of `data`,
+// where `stride` may be negative and must not be zero. The vector owns a block
+// over the memory it spans (see `ins_block_f16_wrap`) that leaves the memory to
+// the caller; to run a deleter when the memory is no longer used, wrap a block
+// and create vectors over it with `ins_vector_f16_alloc_from_block` instead.
+ins_vector_f16 * ins_vector_f16_wrap(uint16_t * data,
+                                     const size_t n,
+                                     const ptrdiff_t stride);
+
+// Frees a previously allocated vector `v`, and its block if the vector owns
+// it.
+void ins_vector_f16_free(ins_vector_f16 * v);
+
+// Returns the element of the vector `v` at index `i` in single precision.
+float ins_vector_f16_get(const ins_vector_f16 * v, const size_t i);
+
+// Rounds `x` to half precision and stores it at index `i` of the vector `v`.
+void ins_vector_f16_set(ins_vector_f16 * v, const size_t i, float x);
+
+/* Initializing vector elements
+ --------------------------------------------------------------------------*/
+
+// Set all elements of the vector `v` to zero.
+void ins_vector_f16_set_zero(ins_vector_f16 * v);
+
+// Set all elements of the vector `v` to the value `x` rounded to half
+// precision.
+void ins_vector_f16_set_all(ins_vector_f16 * v, float x);
+
+// Set all elements of the vector `v` to zero except for the i-th element
+// which is set to one. No bounds checking are performed.
+void ins_vector_f16_set_basis(ins_vector_f16 * v, size_t i);
+
+/* Conversions
+ --------------------------------------------------------------------------*/
+
+// Rounds the elements of the single precision vector `src` to half precision
+// and stores them in the vector `dst`. The two vectors must have the same
+// length. The function returns `INS_SUCCESS` for success and `INS_EBADLEN`
+// if two vectors have different lengths.
+int ins_vector_f16_from_float(ins_vector_f16 * dst,
+                              const ins_vector_float * src);
+
+// Converts the elements of the vector `src` to single precision and stores
+// them in the vector `dst`. The two vectors must have the same length. The
+// function returns `INS_SUCCESS` for success and `INS_EBADLEN` if two vectors
+// have different lengths.
+int ins_vector_f16_to_float(ins_vector_float * dst,
+                            const ins_vector_f16 * src);
+
+/* Vector operations
+ ---------------------------------------------------------------------------*/
+
+// Returns the sum of the elements of the vector `x`, accumulated in single
+// precision.
+float ins_vector_f16_sum(const ins_vector_f16 * x);
+
+// Performs the operation `y <- alpha * x + y` in single precision and rounds
+// the result to half precision. The vectors `x` and `y` must have the same
+// length.
+int ins_vector_f16_axpy(float alpha,
+                        const ins_vector_f16 * x,
+                        ins_vector_f16 * y);
+
+// Computes the dot product of the two vectors `v` and `w` in single
+// precision. The two vectors must have the same length.
+float ins_vector_f16_dot(const ins_vector_f16 *v, const ins_vector_f16 *w);
+
+// Computes and returns the Euclidean norm of the vector `v` in single
+// precision.
+float ins_vector_f16_nrm2(const ins_vector_f16 *v);
+
+/* Containers
+   -----------------------------------------------------------------------*/
+
+// Writes the elements of the vector `v` to the stream `stream` as a
+// self-describing `.ins` container (see `ins/ins_container.h`). Strided
+// vectors are written contiguously. The return value is `INS_SUCCESS` for
+// success and `INS_EFAILED` if there was a problem writing to the file.
+int ins_vector_f16_fwrite_ins(const ins_vector_f16 * v, FILE * stream);
+
+// Reads a `.ins` container from the stream `stream` into the vector `v`,
+// which must be preallocated with the number of elements recorded in the
+// container. Payloads written with a foreign byte order are converted. If
+// `flags` contains `INS_CONTAINER_VERIFY` the payload checksum is verified.
+// The function returns `INS_EINVAL` if the container holds another element
+// type, `INS_EBADLEN` if it holds another number of elements, and
+// `INS_EFAILED` if reading fails or the checksum mismatches.
+int ins_vector_f16_fread_ins(ins_vector_f16 * v,
+                             FILE * stream,
+                             const int flags);
+
+/* Compressed files
+   -----------------------------------------------------------------------*/
+
+// Writes the elements of the vector `v` to the stream `stream` as a compressed
+// file (see `ins/ins_compress.h`), using the filter, codec and chunk size of
+// `params`, or the defaults if `params` is null. The stream must be seekable.
+// The return value is `INS_SUCCESS` for success, `INS_EINVAL` for invalid
+// parameters, `INS_EUNSUP` if the codec is not available in this build, and
+// `INS_EFAILED` if there was a problem writing to the file.
+int ins_vector_f16_fwrite_compressed(const ins_vector_f16 * v,
+                                     FILE * stream,
+                                     const ins_compress_params * params);
+
+// Reads a compressed file from the stream `stream` into the vector `v`, which
+// must be preallocated with the number of elements of the file. The chunks are
+// decompressed in parallel. The function returns `INS_EINVAL` if the file holds
+// another element type, `INS_EBADLEN` if it holds another number of elements,
+// `INS_EUNSUP` if its codec is not available in this build, and `INS_EFAILED`
+// if reading fails or the file is corrupt.
+int ins_vector_f16_fread_compressed(ins_vector_f16 * v,
+                                    FILE * stream);
+
+// Reads the elements `offset` to `offset + v->size - 1` of the compressed file
+// at the current position of the stream `stream` into the vector `v`,
+// decompressing only the chunks holding them. The stream is left after the end
+// of the file, as by `ins_vector_f16_fread_compressed`, whose return values
+// this function shares; `INS_EBADLEN` is returned if the range extends past the
+// last element of the file.
+int ins_vector_f16_fread_compressed_range(ins_vector_f16 * v,
+                                          FILE * stream,
+                                          const size_t offset);
+
+/* Asynchronous I/O
+   -----------------------------------------------------------------------*/
+
+// Starts reading the elements of the vector `v` from the file descriptor `fd`,
+// `offset` bytes into the file, in the raw layout written by
+// `ins_block_f16_fwrite` (see `ins/ins_async.h`). Returns a handle to pass to
+// `ins_async_wait`, or a null pointer if the read cannot be started.
+ins_async * ins_vector_f16_read_async(ins_vector_f16 * v,
+                                      const int fd,
+                                      const size_t offset);
+
+// Starts writing the elements of the vector `v` to the file descriptor `fd`,
+// `offset` bytes into the file, in the raw layout written by
+// `ins_block_f16_fwrite`. Strided vectors are copied to a staging buffer
+// before the function returns. Returns a handle to pass to `ins_async_wait`, or
+// a null pointer if the write cannot be started.
+ins_async * ins_vector_f16_write_async(const ins_vector_f16 * v,
+                                       const int fd,
+                                       const size_t offset);
+
+/* Direct I/O
+   -----------------------------------------------------------------------*/
+
+// Reads the elements of the vector `v` from the file at `path`, `offset` bytes
+// into the file, in the raw layout written by `ins_block_f16_fwrite`,
+// bypassing the page cache (see `ins/ins_direct.h`). Strided vectors go through
+// an aligned staging buffer, a few megabytes at a time. Returns `INS_SUCCESS`
+// for success, `INS_ENOMEM` if a staging buffer cannot be allocated, and
+// `INS_EFAILED` if the file cannot be read or is too short.
+int ins_vector_f16_read_direct(ins_vector_f16 * v,
+                               const char * path,
+                               const size_t offset);
+
+// Writes the elements of the vector `v` to the file at `path`, `offset` bytes
+// into the file, in the raw layout written by `ins_block_f16_fwrite`,
+// bypassing the page cache. The file is created if it does not exist, and is
+// neither truncated nor written outside the range of the elements. Returns
+// `INS_SUCCESS` for success, `INS_ENOMEM` if a staging buffer cannot be
+// allocated, and `INS_EFAILED` if the file cannot be written.
+int ins_vector_f16_write_direct(const ins_vector_f16 * v,
+                                const char * path,
+                                const size_t offset);
+
+#endif  // INS_VECTOR_F16_H_
@@ -0,0 +1,551 @@
+#ifndef INS_VECTOR_INT_H_
+#define INS_VECTOR_INT_H_
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <ins/ins_errno.h>
+#include <ins/ins_container.h>
+#include <ins/ins_async.h>
+#include <ins/ins_direct.h>
+#include <ins/ins_compress.h>
+#include <ins/ins_csv.h>
+#include <ins/ins_graph.h>
+#include <ins/ins_mmap.h>
+#include <ins/ins_shm.h>
+#include <ins/block/ins_block_int.h>
+
+struct ins_vector_int_struct {
+  // Number of elements in the vector.
+  size_t size;
+
+  // The step-size from one element to the next in physical memory. `stride`
+  // should be `1` if elements of the vector are sitting right next to each
+  // other without any gaps in between, and it should be greater than `1`
+  // otherwise. The following is an example of a vector that has 3 elements
+  // and 2 as its stride:
+  //
+  //   +------+------+------+------+------+
+  //   | 1    | xxxx | 2    | xxxx | 3    |
+  //   +------+------+------+------+------+
+  //   ^             ^
+  //   | stride = 2  | it takes two ints to get from the first element to
+  //   +-------------+ the second element.
+  //
+  // A negative `stride` walks the memory backwards, starting from `data`.
+  // This is how reversed views are expressed without copying: a vector with
+  // `stride = -1` whose `data` points to the last element of a block sees
+  // the elements of the block in reverse order. `stride` is never zero.
+  ptrdiff_t stride;
+
+  // The location of the first element of the vector in memory.
+  int * data;
+
+  // The location of the memory block in which the vector elemenst are located
+  // (if any). If the vector owns this block then the `owner` field is set to
+  // one and the block will be deallocated when the vector is freed. If the
+  // vector points to a block owned by another object then the `owner` field
+  // is set to zero and the underlying block will not be deallcoated with the
+  // vector.
+  ins_block_int * block;
+  int owner;
+};
+
+typedef struct ins_vector_int_struct ins_vector_int;
+
+/* Allocation
+ --------------------------------------------------------------------------*/
+
+// Creates a vector of length `n` and returns a pointer to the newly created
+// vector struct. A new block is allocated for the elements of the vector, and
+// stored in the `block` component of the vector struct. The block is "owned"
+// by the vector and will be deallocated when the vector is freed.
+// Zero-size requests are valid and return a non-null result.
+ins_vector_int * ins_vector_int_alloc(const size_t n);
+
+// Allocates memory for a vector of lenght `n` and initializes all the elements
+// of the vector to zero.
+ins_vector_int * ins_vector_int_calloc(const size_t n);
+
+// Allocates memory for a vector of length `n` and returns a pointer to the
+// newly created block struct. The vector shares its elements with the given
+// block `b` starting at the given `offset`, and the distance between two
+// consecutive elements are given by `stride`. In other words,
+//
+//   `v[i] = b[offset + i * stride] for i = 0, 1, ... n-1`.
+//
+// `stride` may be negative, in which case `offset` is the index of the
+// first vector element and the vector runs backwards through the block.
+// The block `b` will not be deallocated when the vector is freed.
+ins_vector_int *
+ins_vector_int_alloc_from_block(ins_block_int * b,
+                                const size_t offset,
+                                const size_t n,
+                                const ptrdiff_t stride);
+
+// Allocates memory for a vector of length `n` and returns a pointer to the
+// newly created block struct. The vector shares its elements with another
+// vector `v` starting at the given `offset`, and the distance between two
+// consecutive elements are given by `stride`. In other words,
+//
+//   `v'[i] = v[offset + i * stride] for i = 0, 1, ... n-1`.
+//
+// `stride` may be negative, in which case the output vector runs backwards
+// through `v` starting at the element at `offset`.
+// The underlying block owned by the input vector `v` will not be deallocated
+// when the output vector is freed.
+ins_vector_int *
+ins_vector_int_alloc_from_vector(ins_vector_int * v,
+                                 const size_t offset,
+                                 const size_t n,
+                                 const ptrdiff_t stride);
+
+// Allocates memory for a vector that views the elements of the vector `v`
+// in reverse order, i.e. `v'[i] = v[n-1-i]` where `n` is the length of `v`.
+// No elements are copied: writing to the output vector writes to `v`. The
+// underlying block of `v` will not be deallocated when the output vector is
+// freed.
+ins_vector_int * ins_vector_int_alloc_reverse(ins_vector_int * v);
+
+// Creates a vector of length `n` over memory the caller owns, without copying
+// it: the element `i` of the vector is the element `i * stride` of `data`,
+// where `stride` may be negative and must not be zero. The vector owns a block
+// over the memory it spans (see `ins_block_int_wrap`) that leaves the memory to
+// the caller; to run a deleter when the memory is no longer used, wrap a block
+// and create vectors over it with `ins_vector_int_alloc_from_block` instead.
+ins_vector_int * ins_vector_int_wrap(int * data,
+                                     const size_t n,
+                                     const ptrdiff_t stride);
+
+// Frees a previously allocated vector `v`. If the vector was created using
+// `ins_vector_int_alloc` or `ins_vector_int_calloc` then the underlying block
+// will also be deallocated. If the vector has been created from another object
+// the the memory is still owned by that object and will not be deallocated.
+void ins_vector_int_free(ins_vector_int * v);
+
+// A function-like macro that returns the element of the vector at the
+// specified index.
+// TODO(linh): how about make it as an inline function instead?
+#define ins_vector_int_get(v, i) ((v)->data[(ptrdiff_t) (i) * (v)->stride])
+
+// A function-like macro that sets the element of the vector at the
+// specified index to some new value.
+// TODO(linh): how about make it as an inline function instead?
+#define ins_vector_int_set(v, i, x)                      \
+  (v)->data[(ptrdiff_t) (i) * (v)->stride] = (x);
+
+/* Initializing vector elements
+ --------------------------------------------------------------------------*/
+
+// Set all elements of the vector `v` to zero.
+void ins_vector_int_set_zero(ins_vector_int * v);
+
+// Set all elements of the vector `v` to the value `x`.
+void ins_vector_int_set_all(ins_vector_int * v, int x);
+
+// Set all elements of the vector `v` to zero except for the i-th element
+// which is set to one. No bounds checking are performed, therefore clients
+// have to make sure that the given index `i` is within bounds, i.e.,
+// `0 <= i < v->size`.
+void ins_vector_int_set_basis(ins_vector_int * v, size_t i);
+
+/* Vector operations
+ ---------------------------------------------------------------------------*/
+
+// Adds the elements of the vector `y` to the elements of the vector `x`.
+// The result `x_i <- x_i + y_i` is stored in `x` and `y` remains unchanged.
+// The two vectors must have the same length.
+int ins_vector_int_add(ins_vector_int * x, const ins_vector_int * y);
+
+// Subtracts the elements of the vector `y` from the elements of the vector
+// `x`. The result `x_i <- x_i - y_i` is stored in `x` and `y` remains
+// unchanged. The two vectors must have the same length.
+int ins_vector_int_sub(ins_vector_int * x, const ins_vector_int * y);
+
+
+// Multiplies the elements of the vector `y` by the elements of the vector
+// `x`. The result `x_i <- x_i * y_i` is stored in `x` and `y` remains
+// unchanged. The two vectors must have the same length.
+int ins_vector_int_mul(ins_vector_int * x, const ins_vector_int * y);
+
+// Divides the elements of the vector `x` by the elements of the vector `y`.
+// The result `x_i <- x_i / y_i` is stored in `x` and `y` remains unchanged.
+// The division is an integer division, truncating towards zero. The two
+// vectors must have the same length.
+int ins_vector_int_div(ins_vector_int * x, const ins_vector_int * y);
+
+// Multiplies the elements of the vector `x` by a constant factor `alpha`.
+// The result `x_i <- alpha * x_i` is stored in `x`.
+int ins_vector_int_scale(ins_vector_int * x, int alpha);
+
+// Adds the constant value `alpha` to the elements of the vector `x`. The
+// result `x_i <- x_i + alpha` is stored in x.
+int ins_vector_int_add_constant(ins_vector_int * x, int alpha);
+
+// Returns the sum of the emements of the vector `x`.
+int ins_vector_int_sum(const ins_vector_int * x);
+
+// Performs the operation `y <- alpha * x + y`. The vectors `x` and `y` must
+// have the same length.
+int ins_vector_int_axpy(int alpha,
+                        const ins_vector_int * x,
+                        ins_vector_int * y);
+
+// Exchanges the elements of the vectors `v` and `w` by copying. The two
+// vectors must have the same length. The function returns `INS_SUCCESS`
+// for success and `INS_EINVAL` if two vectors have different lengths.
+int ins_vector_int_swap(ins_vector_int *v, ins_vector_int *w);
+
+// Copies the elements of the vector `src` into the vector `dst`. The two
+// vectors must have the same length. The return value is `INS_SUCCESS`
+// for success and `INS_EINVAL` if two vectors have different lengths.
+int ins_vector_int_copy(ins_vector_int *dst, const ins_vector_int *src);
+
+// Computes the dot product of the two vectors `v` and `w`. The two vectors
+// must have the same length.
+int ins_vector_int_dot(const ins_vector_int *v, const ins_vector_int *w);
+
+// Computes and returns the Euclidean norm of the vector `v`. The norm of an
+// integer vector is generally not an integer, so it is computed and returned
+// in double precision.
+double ins_vector_int_nrm2(const ins_vector_int *v);
+
+/* Maximum and mininum elements
+   -----------------------------------------------------------------------*/
+
+// Returns the minimum value in the vector `v`.
+int ins_vector_int_min(const ins_vector_int *v);
+
+// Returns the maximum value in the vector `v`.
+int ins_vector_int_max(const ins_vector_int *v);
+
+// Returns the minimum and the maximum values in the vector `v`, storing
+// them in `min_out` and `max_out`, respectively.
+void ins_vector_int_minmax(const ins_vector_int *v,
+                           int *min_out,
+                           int *max_out);
+
+// Returns the index of the minimum value in the vector `v`. When there
+// are several equal minimum elements then the lowest index is returned.
+size_t ins_vector_int_min_index(const ins_vector_int *v);
+
+// Returns the index of the maximum value in the vector `v`. When there
+// are several equal maximum elements then the lowest index is returned.
+size_t ins_vector_int_max_index(const ins_vector_int *v);
+
+// Returns the indices of the minimum and the maximum values in the vector
+// `v`, storing them in `imin_out` and `imax_out`, respectively.
+// When there are several equal minimum or maximum elements then the lowest
+// indices are returned.
+void ins_vector_int_minmax_index(const ins_vector_int * v,
+                                 size_t * imin_out,
+                                 size_t * imax_out);
+
+/* Reading and writing vectors
+   -----------------------------------------------------------------------*/
+
+// Reads into the vector `v` from the open stream `stream` in binary format.
+// The vector `v` must be preallocated with the correct length since the
+// function uses the size of `v` to determine how many bytes to read.
+// The return value is `INS_SUCCESS` for success and `INS_EFAILED` if there
+// was a problem reading from the file.
+int ins_vector_int_fread(ins_vector_int *v, FILE *stream);
+
+// Writes the elements of the vector `v` to the stream `stream` in binary
+// format. The return value is `INS_SUCCESS` for success and `INS_EFAILED`
+// if there was a problem writing to the file.
+int ins_vector_int_fwrite(const ins_vector_int *v, FILE *stream);
+
+// Writes the elements of the vector `v` line-by-line to the open stream
+// `stream` using the format specifier `format`, which should be one of `%g`,
+// `%e`, or `%f` formats for floating point numbers and `%d` for integers. If
+// `format` is null, numbers are written in the shortest form that reads back to
+// the same value. The function returns `INS_SUCCESS` for success and
+// `INS_EFAILED` if there was a problem writing to the file.
+int ins_vector_int_fprintf(const ins_vector_int *v,
+                           FILE *stream,
+                           const char *format);
+
+// Reads formatted data from the stream `stream` into the vector `v`. The
+// vector `v` must be preallocated with the correct length since the function
+// uses the size of `v` to determine how many bytes to read. The function
+// returns `INS_SUCCESS` for success and `INS_EFAILED` if there was a problem
+// reading from the file.
+int ins_vector_int_fscanf(ins_vector_int *v, FILE *stream);
+
+/* Memory-mapped vectors
+   -----------------------------------------------------------------------*/
+
+// Maps `n` elements of the file at `path`, starting `offset` bytes into the
+// file, into memory and returns a vector over them. The file holds the
+// elements in the raw binary layout written by `ins_vector_int_fwrite`, so
+// nothing is copied: the elements are paged in on demand and shared through
+// the page cache with every other process mapping the same file. `flags` is
+// a combination of the `INS_MMAP_*` flags; it selects a read-only or a
+// read-write mapping and optional prefaulting and access pattern advice.
+//
+// The vector owns the mapping, which is unmapped when the vector is freed.
+// `offset` must be a multiple of the element size. A null pointer is
+// returned if the file cannot be opened or mapped, or if it is too short to
+// hold the requested elements.
+ins_vector_int *
+ins_vector_int_mmap(const char * path,
+                    const size_t offset,
+                    const size_t n,
+                    const int flags);
+
+/* Shared memory
+   -----------------------------------------------------------------------*/
+
+// Creates the POSIX shared-memory segment `name`, which starts with a slash,
+// for `n` elements and returns a vector over them, mapped read-write and
+// zeroed, with epoch 0 (see `ins/ins_shm.h`). The vector owns the mapping,
+// which is unmapped when it is freed; the segment lasts until it is removed
+// with `ins_shm_unlink`. A null pointer is returned if the segment already
+// exists or cannot be created.
+ins_vector_int * ins_vector_int_shm_create(const char * name, const size_t n);
+
+// Maps the shared-memory segment `name` read-only and returns a vector over its
+// elements, without copying them. Writing to the elements is undefined
+// behavior. A null pointer is returned if the segment cannot be opened, if it
+// was not created by `ins_vector_int_shm_create`, or if it holds another
+// element type.
+ins_vector_int * ins_vector_int_shm_open(const char * name);
+
+// Stores the epoch of the shared-memory segment of `v` in `epoch`. The return
+// value is `INS_SUCCESS`, or `INS_EINVAL` if `v` is not a view of a
+// shared-memory vector.
+int ins_vector_int_shm_epoch(const ins_vector_int * v, uint64_t * epoch);
+
+// Start and end the publication of an update to the elements of the
+// shared-memory vector `v`, which must have been created by
+// `ins_vector_int_shm_create`: the epoch is odd in between, so that readers
+// know to retry. The return value is `INS_SUCCESS`, or `INS_EINVAL` if `v` is
+// read-only or not in shared memory, or if the calls are not paired.
+int ins_vector_int_shm_begin_publish(ins_vector_int * v);
+int ins_vector_int_shm_end_publish(ins_vector_int * v);
+
+/* Containers
+   -----------------------------------------------------------------------*/
+
+// Writes the elements of the vector `v` to the stream `stream` as a
+// self-describing `.ins` container (see `ins/ins_container.h`). Strided
+// vectors are written contiguously. The return value is `INS_SUCCESS` for
+// success and `INS_EFAILED` if there was a problem writing to the file.
+int ins_vector_int_fwrite_ins(const ins_vector_int * v, FILE * stream);
+
+// Reads a `.ins` container from the stream `stream` into the vector `v`,
+// which must be preallocated with the number of elements recorded in the
+// container. Payloads written with a foreign byte order are converted. If
+// `flags` contains `INS_CONTAINER_VERIFY` the payload checksum is verified.
+// The function returns `INS_EINVAL` if the container holds another element
+// type, `INS_EBADLEN` if it holds another number of elements, and
+// `INS_EFAILED` if reading fails or the checksum mismatches.
+int ins_vector_int_fread_ins(ins_vector_int * v,
+                             FILE * stream,
+                             const int flags);
+
+// Maps the payload of the `.ins` container stored in the file at `path` and
+// returns a vector over it, as `ins_vector_int_mmap` does for raw files.
+// `flags` combines the `INS_MMAP_*` flags with `INS_CONTAINER_VERIFY`, which
+// verifies the payload checksum once the file is mapped. A null pointer is
+// returned if the container holds another element type or was written with
+// a foreign byte order.
+ins_vector_int * ins_vector_int_mmap_ins(const char * path, const int flags);
+
+/* Compressed files
+   -----------------------------------------------------------------------*/
+
+// Writes the elements of the vector `v` to the stream `stream` as a compressed
+// file (see `ins/ins_compress.h`), using the filter, codec and chunk size of
+// `params`, or the defaults if `params` is null. The stream must be seekable.
+// The return value is `INS_SUCCESS` for success, `INS_EINVAL` for invalid
+// parameters, `INS_EUNSUP` if the codec is not available in this build, and
+// `INS_EFAILED` if there was a problem writing to the file.
+int ins_vector_int_fwrite_compressed(const ins_vector_int * v,
+                                     FILE * stream,
+                                     const ins_compress_params * params);
+
+// Reads a compressed file from the stream `stream` into the vector `v`, which
+// must be preallocated with the number of elements of the file. The chunks are
+// decompressed in parallel. The function returns `INS_EINVAL` if the file holds
+// another element type, `INS_EBADLEN` if it holds another number of elements,
+// `INS_EUNSUP` if its codec is not available in this build, and `INS_EFAILED`
+// if reading fails or the file is corrupt.
+int ins_vector_int_fread_compressed(ins_vector_int * v,
+                                    FILE * stream);
+
+// Reads the elements `offset` to `offset + v->size - 1` of the compressed file
+// at the current position of the stream `stream` into the vector `v`,
+// decompressing only the chunks holding them. The stream is left after the end
+// of the file, as by `ins_vector_int_fread_compressed`, whose return values
+// this function shares; `INS_EBADLEN` is returned if the range extends past the
+// last element of the file.
+int ins_vector_int_fread_compressed_range(ins_vector_int * v,
+                                          FILE * stream,
+                                          const size_t offset);
+
+/* Asynchronous I/O
+   -----------------------------------------------------------------------*/
+
+// Starts reading the elements of the vector `v` from the file descriptor `fd`,
+// `offset` bytes into the file, in the raw layout written by
+// `ins_vector_int_fwrite` (see `ins/ins_async.h`). Returns a handle to pass to
+// `ins_async_wait`, or a null pointer if the read cannot be started.
+ins_async * ins_vector_int_read_async(ins_vector_int * v,
+                                      const int fd,
+                                      const size_t offset);
+
+// Starts writing the elements of the vector `v` to the file descriptor `fd`,
+// `offset` bytes into the file, in the raw layout written by
+// `ins_vector_int_fwrite`. Strided vectors are copied to a staging buffer
+// before the function returns. Returns a handle to pass to `ins_async_wait`, or
+// a null pointer if the write cannot be started.
+ins_async * ins_vector_int_write_async(const ins_vector_int * v,
+                                       const int fd,
+                                       const size_t offset);
+
+/* Direct I/O
+   -----------------------------------------------------------------------*/
+
+// Reads the elements of the vector `v` from the file at `path`, `offset` bytes
+// into the file, in the raw layout written by `ins_vector_int_fwrite`,
+// bypassing the page cache (see `ins/ins_direct.h`). Strided vectors go through
+// an aligned staging buffer, a few megabytes at a time. Returns `INS_SUCCESS`
+// for success, `INS_ENOMEM` if a staging buffer cannot be allocated, and
+// `INS_EFAILED` if the file cannot be read or is too short.
+int ins_vector_int_read_direct(ins_vector_int * v,
+                               const char * path,
+                               const size_t offset);
+
+// Writes the elements of the vector `v` to the file at `path`, `offset` bytes
+// into the file, in the raw layout written by `ins_vector_int_fwrite`,
+// bypassing the page cache. The file is created if it does not exist, and is
+// neither truncated nor written outside the range of the elements. Returns
+// `INS_SUCCESS` for success, `INS_ENOMEM` if a staging buffer cannot be
+// allocated, and `INS_EFAILED` if the file cannot be written.
+int ins_vector_int_write_direct(const ins_vector_int * v,
+                                const char * path,
+                                const size_t offset);
+
+/* Reductions over files
+   -----------------------------------------------------------------------*/
+
+// The following functions reduce `n` elements stored contiguously in the raw
+// binary layout written by `ins_vector_int_fwrite`, starting `offset` bytes
+// into the file at `path`, without loading them into a vector. The file is read
+// sequentially in chunks of a few megabytes, the next chunk being read while
+// the current one is reduced, so files larger than memory can be processed. The
+// results are those of the in-memory functions of the same name, up to the
+// rounding of the partial results of the chunks. The functions return
+// `INS_SUCCESS` for success, `INS_EINVAL` if the file is too short, and
+// `INS_EFAILED` if it cannot be read; the result is only stored on success.
+
+// Computes the sum of the elements.
+int ins_vector_int_file_sum(const char * path,
+                            const size_t offset,
+                            const size_t n,
+                            int * result);
+
+// Computes the dot product of the `n` elements at byte `x_offset` of the file
+// at `x_path` and the `n` elements at byte `y_offset` of the file at `y_path`.
+int ins_vector_int_file_dot(const char * x_path,
+                            const size_t x_offset,
+                            const char * y_path,
+                            const size_t y_offset,
+                            const size_t n,
+                            int * result);
+
+// Computes the Euclidean norm of the elements.
+int ins_vector_int_file_nrm2(const char * path,
+                             const size_t offset,
+                             const size_t n,
+                             double * result);
+
+// Computes the minimum and the maximum of the elements. `n` must not be zero.
+int ins_vector_int_file_minmax(const char * path,
+                               const size_t offset,
+                               const size_t n,
+                               int * min_out,
+                               int * max_out);
+
+// Computes the index of the maximum element, counted from the first of the `n`
+// elements. The lowest index is returned for equal elements. `n` must not be
+// zero.
+int ins_vector_int_file_max_index(const char * path,
+                                  const size_t offset,
+                                  const size_t n,
+                                  size_t * imax_out);
+
+// Computes the indices of the minimum and the maximum elements, as
+// `ins_vector_int_file_max_index` does.
+int ins_vector_int_file_minmax_index(const char * path,
+                                     const size_t offset,
+                                     const size_t n,
+                                     size_t * imin_out,
+                                     size_t * imax_out);
+
+/* Delimited text files
+   -----------------------------------------------------------------------*/
+
+// Loads columns of the delimited text file at `path` into the `n` vectors
+// `vectors[0, n)`, one element per non-empty line after the lines skipped by
+// `options` (see `ins/ins_csv.h`; `options` may be null). Vector `i` receives
+// the column `options->columns[i]`, or column `i`. A null `vectors[i]` is set
+// to a newly allocated vector with one element per row; other vectors must have
+// one element per row. Empty fields are an error. Returns `INS_SUCCESS` for
+// success, `INS_EBADLEN` if a vector has the wrong length, `INS_ENOMEM` if a
+// vector cannot be allocated, and `INS_EFAILED` if the file cannot be read, a
+// row lacks a column or a field is not a number. On failure the vectors
+// allocated by the function are freed and set to null again.
+int ins_vector_int_read_csv(const char * path,
+                            const ins_csv_options * options,
+                            ins_vector_int ** vectors,
+                            const size_t n);
+
+/* Task graphs
+   -----------------------------------------------------------------------*/
+
+// These functions record the operations of the same names as nodes of the
+// task graph `graph` (see `ins/ins_graph.h`) and return them, or call the
+// error handler and return null if the vectors have different lengths
+// (`INS_EBADLEN`) or there is not enough memory (`INS_ENOMEM`). Scalars are
+// read and results written through the pointers when the nodes run. `add`,
+// `sub`, `mul`, `div`, `scale`, `add_constant`, `axpy` and `copy` are
+// elementwise and can be fused.
+ins_graph_node * ins_vector_int_graph_add(ins_graph * graph,
+                                          ins_vector_int * x,
+                                          const ins_vector_int * y);
+ins_graph_node * ins_vector_int_graph_sub(ins_graph * graph,
+                                          ins_vector_int * x,
+                                          const ins_vector_int * y);
+ins_graph_node * ins_vector_int_graph_mul(ins_graph * graph,
+                                          ins_vector_int * x,
+                                          const ins_vector_int * y);
+ins_graph_node * ins_vector_int_graph_div(ins_graph * graph,
+                                          ins_vector_int * x,
+                                          const ins_vector_int * y);
+ins_graph_node * ins_vector_int_graph_scale(ins_graph * graph,
+                                            ins_vector_int * x,
+                                            const int * alpha);
+ins_graph_node * ins_vector_int_graph_add_constant(ins_graph * graph,
+                                                   ins_vector_int * x,
+                                                   const int * alpha);
+ins_graph_node * ins_vector_int_graph_axpy(ins_graph * graph,
+                                           const int * alpha,
+                                           const ins_vector_int * x,
+                                           ins_vector_int * y);
+ins_graph_node * ins_vector_int_graph_copy(ins_graph * graph,
+                                           ins_vector_int * dst,
+                                           const ins_vector_int * src);
+ins_graph_node * ins_vector_int_graph_dot(ins_graph * graph,
+                                          const ins_vector_int * x,
+                                          const ins_vector_int * y,
+                                          int * result);
+ins_graph_node * ins_vector_int_graph_sum(ins_graph * graph,
+                                          const ins_vector_int * x,
+                                          int * result);
+ins_graph_node * ins_vector_int_graph_minmax(ins_graph * graph,
+                                             const ins_vector_int * x,
+                                             int * min_out, int * max_out);
+
+#endif  // INS_VECTOR_INT_H_
@@ -0,0 +1,47 @@
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "ins/ins_allocator_io.h"
+
+static void * ins_malloc_alloc(const size_t size, void * context) {
+  (void) context;
+  return malloc(size);
+}
+
+static void * ins_malloc_aligned_alloc(const size_t alignment,
+                                       const size_t size, void * context) {
+  void * ptr;
+  (void) context;
+  return posix_memalign(&ptr, alignment, size) == 0 ? ptr : 0;
+}
+
+static void ins_malloc_free(void * ptr, void * context) {
+  (void) context;
+  free(ptr);
+}
+
+const ins_allocator ins_malloc_allocator = {
+  ins_malloc_alloc, ins_malloc_aligned_alloc, ins_malloc_free, 0
+};
+
+void * ins_pages_alloc(const size_t size) {
+  void * ptr = mmap(0, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return ptr == MAP_FAILED ? 0 : ptr;
+}
+
+void ins_pages_free(void * ptr, const size_t size) {
+  munmap(ptr, size);
+}
+
+// The process-wide allocator, read and written atomically.
+static const ins_allocator * ins_allocator_current = &ins_malloc_allocator;
+
+const ins_allocator * ins_get_allocator(void) {
+  return __atomic_load_n(&ins_allocator_current, __ATOMIC_ACQUIRE);
+}
+
+const ins_allocator * ins_set_allocator(const ins_allocator * allocator) {
+  return __atomic_exchange_n(&ins_allocator_current,
+                             allocator ? allocator : &ins_malloc_allocator,
+                             __ATOMIC_ACQ_REL);
+}
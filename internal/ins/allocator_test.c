@@ -0,0 +1,142 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+#include <ins/ins_allocator.h>
+
+// An allocator that counts its calls and returns memory filled with ones.
+typedef struct {
+  size_t allocs;
+  size_t aligned_allocs;
+  size_t frees;
+  size_t live;
+} counting_pool;
+
+static void * counting_alloc(size_t size, void * context) {
+  counting_pool * pool = (counting_pool *) context;
+  void * ptr = malloc(size > 0 ? size : 1);
+  ++pool->allocs;
+  ++pool->live;
+  memset(ptr, 0xff, size);
+  return ptr;
+}
+
+static void * counting_aligned_alloc(size_t alignment, size_t size,
+                                     void * context) {
+  counting_pool * pool = (counting_pool *) context;
+  void * ptr;
+  if (posix_memalign(&ptr, alignment, size) != 0) { return 0; }
+  ++pool->aligned_allocs;
+  ++pool->live;
+  memset(ptr, 0xff, size);
+  return ptr;
+}
+
+static void counting_free(void * ptr, void * context) {
+  counting_pool * pool = (counting_pool *) context;
+  ++pool->frees;
+  --pool->live;
+  free(ptr);
+}
+
+static void * failing_alloc(size_t size, void * context) {
+  (void) size;
+  (void) context;
+  return 0;
+}
+
+static void test_per_allocation(void **state) {
+  (void) state;
+
+  counting_pool pool = {0, 0, 0, 0};
+  const ins_allocator allocator = {
+    counting_alloc, counting_aligned_alloc, counting_free, &pool
+  };
+  const size_t large = (1 << 20) / sizeof(double);
+  ins_block * a = ins_block_alloc_with_allocator(10, &allocator);
+  ins_block * b = ins_block_calloc_with_allocator(large, &allocator);
+  ins_block_int * c = ins_block_int_calloc_with_allocator(5, &allocator);
+  ins_block * d = ins_block_alloc(10);
+  size_t i;
+
+  assert_non_null(a);
+  assert_non_null(b);
+  assert_non_null(c);
+  assert_int_equal(pool.allocs, 2);
+  assert_int_equal(pool.aligned_allocs, 1);
+  assert_ptr_equal(a->allocator, &allocator);
+  assert_ptr_equal(d->allocator, ins_get_allocator());
+
+  // Large blocks are aligned, and `calloc` zeroes memory the allocator
+  // does not.
+  assert_int_equal((uintptr_t) b->data % INS_DIRECT_ALIGNMENT, 0);
+  for (i = 0; i < large; ++i) {
+    assert_true(b->data[i] == 0.0);
+  }
+  for (i = 0; i < 5; ++i) {
+    assert_int_equal(c->data[i], 0);
+  }
+
+  ins_block_free(a);
+  ins_block_free(b);
+  ins_block_int_free(c);
+  ins_block_free(d);
+  assert_int_equal(pool.frees, 3);
+  assert_int_equal(pool.live, 0);
+}
+
+static void test_process_wide(void **state) {
+  (void) state;
+
+  counting_pool pool = {0, 0, 0, 0};
+  const ins_allocator allocator = {
+    counting_alloc, 0, counting_free, &pool
+  };
+  const ins_allocator * previous = ins_set_allocator(&allocator);
+  ins_vector * v = ins_vector_calloc((1 << 20) / sizeof(double));
+  ins_block_float * b = ins_block_float_alloc(7);
+  ins_block_int * c = ins_block_int_calloc_with_allocator(3, 0);
+
+  // Without `aligned_alloc`, large blocks come from `alloc`. A null
+  // allocator stands for the process-wide one.
+  assert_ptr_equal(ins_get_allocator(), &allocator);
+  assert_int_equal(pool.allocs, 3);
+  assert_int_equal(pool.aligned_allocs, 0);
+  assert_true(ins_vector_get(v, 0) == 0.0);
+
+  // Blocks go back to their allocators after the process-wide one changes.
+  assert_ptr_equal(ins_set_allocator(previous), &allocator);
+  ins_vector_free(v);
+  ins_block_float_free(b);
+  ins_block_int_free(c);
+  assert_int_equal(pool.frees, 3);
+
+  assert_ptr_equal(ins_set_allocator(0), previous);
+  assert_non_null(ins_get_allocator());
+  assert_non_null(ins_get_allocator()->alloc);
+}
+
+static void test_failure(void **state) {
+  (void) state;
+
+  const ins_allocator allocator = {failing_alloc, 0, counting_free, 0};
+
+  ins_error_handler_t *h = ins_set_error_handler_off();
+  assert_null(ins_block_alloc_with_allocator(10, &allocator));
+  assert_int_equal(ins_last_error()->error_code, INS_ENOMEM);
+  ins_set_error_handler(h);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_per_allocation),
+    cmocka_unit_test(test_process_wide),
+    cmocka_unit_test(test_failure)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
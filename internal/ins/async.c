@@ -0,0 +1,605 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_async_io.h"
+#include "ins/ins_tuning_io.h"
+#include "ins/internal/config.h"
+
+#ifdef INSIGHT_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+// Transfers are split into at most `INS_ASYNC_MAX_PIECES` pieces whose size
+// is a multiple of `INS_ASYNC_MIN_PIECE` bytes and at most
+// `INS_ASYNC_MAX_PIECE` bytes, so that a single read or write never exceeds
+// what the kernel transfers in one call.
+#define INS_ASYNC_MIN_PIECE (1UL << 20)
+#define INS_ASYNC_MAX_PIECE (1UL << 30)
+#define INS_ASYNC_MAX_PIECES 16
+
+// The number of submission queue entries, which also bounds the number of
+// pieces in flight through io_uring.
+#define INS_ASYNC_QUEUE_DEPTH 64
+
+// The maximum number of threads of the fallback pool.
+#define INS_ASYNC_MAX_THREADS 4
+
+enum {
+  INS_ASYNC_NONE,
+  INS_ASYNC_URING,
+  INS_ASYNC_THREADS
+};
+
+typedef struct ins_async_piece ins_async_piece;
+
+// A contiguous part of an operation: `length` bytes at `data`, to be
+// transferred to or from the file at byte `offset`, of which `done` bytes
+// have been transferred so far.
+struct ins_async_piece {
+  ins_async * op;
+  char * data;
+  size_t length;
+  size_t offset;
+  size_t done;
+
+  // The next piece in the queue of the thread pool.
+  ins_async_piece * next;
+};
+
+struct ins_async {
+  int fd;
+  int write;
+  int owned;
+  int status;
+
+  // The number of pieces that have not finished yet.
+  size_t pending;
+
+  void * buffer;
+  ins_async_finish * finish;
+  void * ctx;
+
+  ins_async_piece * pieces;
+};
+
+static pthread_once_t ins_async_once = PTHREAD_ONCE_INIT;
+static int ins_async_backend = INS_ASYNC_NONE;
+
+// Guards the `pending` and `status` fields of all operations, the queue of
+// the thread pool and the number of pieces in flight through io_uring.
+static pthread_mutex_t ins_async_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Signaled when a piece finishes.
+static pthread_cond_t ins_async_finished = PTHREAD_COND_INITIALIZER;
+
+/* Pieces
+ -----------------------------------------------------------------------------*/
+
+// Records that `piece` has finished, successfully unless `failed` is set.
+static void ins_async_complete(ins_async_piece * piece, const int failed) {
+  ins_async * op = piece->op;
+
+  pthread_mutex_lock(&ins_async_mutex);
+
+  if (failed) {
+    op->status = INS_EFAILED;
+  }
+
+  --op->pending;
+  pthread_cond_broadcast(&ins_async_finished);
+  pthread_mutex_unlock(&ins_async_mutex);
+}
+
+// Transfers the rest of `piece` with blocking `pread` or `pwrite` calls.
+// Returns 0 on success and -1 on failure, including the end of the file.
+static int ins_async_transfer(ins_async_piece * piece) {
+  const ins_async * op = piece->op;
+
+  while (piece->done < piece->length) {
+    char * data = piece->data + piece->done;
+    const size_t length = piece->length - piece->done;
+    const off_t offset = (off_t) (piece->offset + piece->done);
+
+    const ssize_t n = op->write ? pwrite(op->fd, data, length, offset)
+                                : pread(op->fd, data, length, offset);
+
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (n <= 0) {
+      return -1;
+    }
+
+    piece->done += (size_t) n;
+  }
+
+  return 0;
+}
+
+/* Thread pool
+ -----------------------------------------------------------------------------*/
+
+static ins_async_piece * ins_async_queue_head = 0;
+static ins_async_piece * ins_async_queue_tail = 0;
+
+// Signaled when a piece is queued.
+static pthread_cond_t ins_async_queued = PTHREAD_COND_INITIALIZER;
+
+static void * ins_async_worker(void * arg) {
+  (void) arg;
+
+  for (;;) {
+    ins_async_piece * piece;
+
+    pthread_mutex_lock(&ins_async_mutex);
+
+    while (ins_async_queue_head == 0) {
+      pthread_cond_wait(&ins_async_queued, &ins_async_mutex);
+    }
+
+    piece = ins_async_queue_head;
+    ins_async_queue_head = piece->next;
+
+    if (ins_async_queue_head == 0) {
+      ins_async_queue_tail = 0;
+    }
+
+    pthread_mutex_unlock(&ins_async_mutex);
+
+    ins_async_complete(piece, ins_async_transfer(piece) != 0);
+  }
+
+  return 0;
+}
+
+// Starts the worker threads, one per thread of the tuning (see
+// `ins/ins_tuning.h`) up to `INS_ASYNC_MAX_THREADS` but at least two so that
+// pieces overlap. Returns 0 if at least one thread is running.
+static int ins_async_start_threads(void) {
+  long count = ins_tuning_threads();
+  long started = 0;
+  long i;
+
+  if (count < 2) {
+    count = 2;
+  } else if (count > INS_ASYNC_MAX_THREADS) {
+    count = INS_ASYNC_MAX_THREADS;
+  }
+
+  for (i = 0; i < count; ++i) {
+    pthread_t thread;
+
+    if (pthread_create(&thread, 0, ins_async_worker, 0) == 0) {
+      pthread_detach(thread);
+      ++started;
+    }
+  }
+
+  return started > 0 ? 0 : -1;
+}
+
+static void ins_async_enqueue(ins_async_piece * piece) {
+  pthread_mutex_lock(&ins_async_mutex);
+
+  piece->next = 0;
+
+  if (ins_async_queue_tail == 0) {
+    ins_async_queue_head = piece;
+  } else {
+    ins_async_queue_tail->next = piece;
+  }
+
+  ins_async_queue_tail = piece;
+  pthread_cond_signal(&ins_async_queued);
+  pthread_mutex_unlock(&ins_async_mutex);
+}
+
+/* io_uring
+ -----------------------------------------------------------------------------*/
+
+#ifdef INSIGHT_HAVE_IO_URING
+
+// The rings shared with the kernel. Pieces are submitted from the threads
+// starting operations, and from the reaper thread when a transfer comes back
+// short, under `ins_uring_submit_mutex`; completions are only consumed by
+// the reaper thread.
+typedef struct {
+  int fd;
+
+  unsigned * sq_tail;
+  unsigned * sq_mask;
+  unsigned * sq_array;
+  struct io_uring_sqe * sqes;
+  unsigned sq_entries;
+
+  unsigned * cq_head;
+  unsigned * cq_tail;
+  unsigned * cq_mask;
+  struct io_uring_cqe * cqes;
+
+  // The number of pieces submitted and not yet reaped.
+  unsigned in_flight;
+} ins_uring;
+
+static ins_uring ins_async_ring;
+static pthread_mutex_t ins_uring_submit_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int ins_uring_enter(const unsigned to_submit,
+                           const unsigned min_complete,
+                           const unsigned flags) {
+  return (int) syscall(__NR_io_uring_enter, ins_async_ring.fd, to_submit,
+                       min_complete, flags, 0, 0);
+}
+
+// Submits the rest of `piece`. Returns 0 on success and -1 if the kernel
+// refused the submission, in which case the ring is left as it was.
+static int ins_uring_submit(ins_async_piece * piece) {
+  ins_uring * ring = &ins_async_ring;
+  const ins_async * op = piece->op;
+
+  struct io_uring_sqe * sqe;
+  unsigned tail;
+  unsigned index;
+  int ret;
+
+  pthread_mutex_lock(&ins_uring_submit_mutex);
+
+  tail = *ring->sq_tail;
+  index = tail & *ring->sq_mask;
+  sqe = &ring->sqes[index];
+
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = op->write ? IORING_OP_WRITE : IORING_OP_READ;
+  sqe->fd = op->fd;
+  sqe->off = piece->offset + piece->done;
+  sqe->addr = (uint64_t) (uintptr_t) (piece->data + piece->done);
+  sqe->len = (uint32_t) (piece->length - piece->done);
+  sqe->user_data = (uint64_t) (uintptr_t) piece;
+
+  ring->sq_array[index] = index;
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  do {
+    ret = ins_uring_enter(1, 0, 0);
+  } while (ret < 0 && (errno == EINTR || errno == EAGAIN));
+
+  if (ret != 1) {
+    // The kernel did not consume the entry, so it can be taken back.
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+  }
+
+  pthread_mutex_unlock(&ins_uring_submit_mutex);
+
+  return ret == 1 ? 0 : -1;
+}
+
+// Finishes `piece` once it is no longer in flight.
+static void ins_uring_retire(ins_async_piece * piece, const int failed) {
+  pthread_mutex_lock(&ins_async_mutex);
+  --ins_async_ring.in_flight;
+  pthread_mutex_unlock(&ins_async_mutex);
+
+  ins_async_complete(piece, failed);
+}
+
+// Handles the completion `res` of a submission of `piece`.
+static void ins_uring_reap_piece(ins_async_piece * piece, const int res) {
+  int failed = 0;
+
+  if (res > 0) {
+    // Short transfers are resubmitted for the remaining bytes.
+    piece->done += (size_t) res;
+
+    if (piece->done < piece->length && ins_uring_submit(piece) == 0) {
+      return;
+    }
+  } else if (res == -EAGAIN || res == -EINTR) {
+    if (ins_uring_submit(piece) == 0) {
+      return;
+    }
+  } else if (res != -EINVAL && res != -EOPNOTSUPP) {
+    // A read of zero bytes is the end of the file. Kernels without the read
+    // and write opcodes answer `EINVAL`; those pieces are transferred below.
+    failed = 1;
+  }
+
+  if (!failed) {
+    failed = ins_async_transfer(piece) != 0;
+  }
+
+  ins_uring_retire(piece, failed);
+}
+
+static void * ins_uring_reaper(void * arg) {
+  ins_uring * ring = &ins_async_ring;
+
+  (void) arg;
+
+  for (;;) {
+    unsigned head = *ring->cq_head;
+    const unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+      ins_uring_enter(0, 1, IORING_ENTER_GETEVENTS);
+      continue;
+    }
+
+    while (head != tail) {
+      const struct io_uring_cqe * cqe = &ring->cqes[head & *ring->cq_mask];
+      ins_async_piece * piece = (ins_async_piece *) (uintptr_t) cqe->user_data;
+      const int res = cqe->res;
+
+      ++head;
+      __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+      ins_uring_reap_piece(piece, res);
+    }
+  }
+
+  return 0;
+}
+
+// Sets up the rings and starts the reaper thread. Returns 0 on success.
+static int ins_uring_setup(void) {
+  ins_uring * ring = &ins_async_ring;
+
+  struct io_uring_params params;
+  size_t sq_size;
+  size_t cq_size;
+  char * sq;
+  char * cq;
+  void * sqes;
+  pthread_t thread;
+
+  memset(&params, 0, sizeof(params));
+  ring->fd = (int) syscall(__NR_io_uring_setup, INS_ASYNC_QUEUE_DEPTH,
+                           &params);
+
+  if (ring->fd < 0) {
+    return -1;
+  }
+
+  sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_size = params.cq_off.cqes +
+            params.cq_entries * sizeof(struct io_uring_cqe);
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    sq_size = cq_size = sq_size > cq_size ? sq_size : cq_size;
+  }
+
+  sq = (char *) mmap(0, sq_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+
+  if (sq == MAP_FAILED) {
+    close(ring->fd);
+    return -1;
+  }
+
+  cq = sq;
+
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+    cq = (char *) mmap(0, cq_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring->fd,
+                       IORING_OFF_CQ_RING);
+
+    if (cq == MAP_FAILED) {
+      munmap(sq, sq_size);
+      close(ring->fd);
+      return -1;
+    }
+  }
+
+  sqes = mmap(0, params.sq_entries * sizeof(struct io_uring_sqe),
+              PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+              IORING_OFF_SQES);
+
+  if (sqes == MAP_FAILED) {
+    if (cq != sq) {
+      munmap(cq, cq_size);
+    }
+    munmap(sq, sq_size);
+    close(ring->fd);
+    return -1;
+  }
+
+  ring->sq_tail = (unsigned *) (sq + params.sq_off.tail);
+  ring->sq_mask = (unsigned *) (sq + params.sq_off.ring_mask);
+  ring->sq_array = (unsigned *) (sq + params.sq_off.array);
+  ring->sqes = (struct io_uring_sqe *) sqes;
+  ring->sq_entries = params.sq_entries;
+
+  ring->cq_head = (unsigned *) (cq + params.cq_off.head);
+  ring->cq_tail = (unsigned *) (cq + params.cq_off.tail);
+  ring->cq_mask = (unsigned *) (cq + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+
+  ring->in_flight = 0;
+
+  if (pthread_create(&thread, 0, ins_uring_reaper, 0) != 0) {
+    munmap(sqes, params.sq_entries * sizeof(struct io_uring_sqe));
+    if (cq != sq) {
+      munmap(cq, cq_size);
+    }
+    munmap(sq, sq_size);
+    close(ring->fd);
+    return -1;
+  }
+
+  pthread_detach(thread);
+  return 0;
+}
+
+// Submits `piece`, waiting while the submission queue is full. Pieces the
+// kernel refuses are transferred synchronously.
+static void ins_uring_start(ins_async_piece * piece) {
+  pthread_mutex_lock(&ins_async_mutex);
+
+  while (ins_async_ring.in_flight >= ins_async_ring.sq_entries) {
+    pthread_cond_wait(&ins_async_finished, &ins_async_mutex);
+  }
+
+  ++ins_async_ring.in_flight;
+  pthread_mutex_unlock(&ins_async_mutex);
+
+  if (ins_uring_submit(piece) != 0) {
+    ins_uring_retire(piece, ins_async_transfer(piece) != 0);
+  }
+}
+
+#endif // INSIGHT_HAVE_IO_URING
+
+/* Operations
+ -----------------------------------------------------------------------------*/
+
+static void ins_async_init(void) {
+  const char * backend = getenv("INSIGHT_ASYNC_BACKEND");
+  const int threads = backend != 0 && strcmp(backend, "threads") == 0;
+
+#ifdef INSIGHT_HAVE_IO_URING
+  if (!threads && ins_uring_setup() == 0) {
+    ins_async_backend = INS_ASYNC_URING;
+    return;
+  }
+#else
+  (void) threads;
+#endif
+
+  if (ins_async_start_threads() == 0) {
+    ins_async_backend = INS_ASYNC_THREADS;
+  }
+}
+
+ins_async * ins_async_submit(const int fd, const size_t offset,
+                             void * buffer, const size_t nbytes,
+                             const int write, const int owned,
+                             ins_async_finish * finish, void * ctx) {
+  size_t piece_size;
+  size_t num_pieces;
+  size_t i;
+  ins_async * op;
+
+  pthread_once(&ins_async_once, ins_async_init);
+
+  if (ins_async_backend == INS_ASYNC_NONE) {
+    if (owned) {
+      free(buffer);
+    }
+    INS_ERROR_VAL("failed to start asynchronous I/O", INS_EFAILED, 0);
+  }
+
+  piece_size = (nbytes + INS_ASYNC_MAX_PIECES - 1) / INS_ASYNC_MAX_PIECES;
+  piece_size = (piece_size + INS_ASYNC_MIN_PIECE - 1) / INS_ASYNC_MIN_PIECE *
+               INS_ASYNC_MIN_PIECE;
+
+  if (piece_size > INS_ASYNC_MAX_PIECE) {
+    piece_size = INS_ASYNC_MAX_PIECE;
+  }
+
+  num_pieces = nbytes == 0 ? 0 : (nbytes + piece_size - 1) / piece_size;
+
+  op = (ins_async *) malloc(sizeof(ins_async));
+
+  if (op == 0) {
+    if (owned) {
+      free(buffer);
+    }
+    INS_ERROR_VAL("failed to allocate space for asynchronous operation",
+                  INS_ENOMEM, 0);
+  }
+
+  op->pieces = 0;
+
+  if (num_pieces > 0) {
+    op->pieces =
+        (ins_async_piece *) malloc(num_pieces * sizeof(ins_async_piece));
+
+    if (op->pieces == 0) {
+      free(op);
+      if (owned) {
+        free(buffer);
+      }
+      INS_ERROR_VAL("failed to allocate space for asynchronous operation",
+                    INS_ENOMEM, 0);
+    }
+  }
+
+  op->fd = fd;
+  op->write = write;
+  op->owned = owned;
+  op->status = INS_SUCCESS;
+  op->pending = num_pieces;
+  op->buffer = buffer;
+  op->finish = finish;
+  op->ctx = ctx;
+
+  for (i = 0; i < num_pieces; ++i) {
+    ins_async_piece * piece = &op->pieces[i];
+    const size_t start = i * piece_size;
+
+    piece->op = op;
+    piece->data = (char *) buffer + start;
+    piece->length = nbytes - start < piece_size ? nbytes - start : piece_size;
+    piece->offset = offset + start;
+    piece->done = 0;
+    piece->next = 0;
+  }
+
+  for (i = 0; i < num_pieces; ++i) {
+#ifdef INSIGHT_HAVE_IO_URING
+    if (ins_async_backend == INS_ASYNC_URING) {
+      ins_uring_start(&op->pieces[i]);
+      continue;
+    }
+#endif
+    ins_async_enqueue(&op->pieces[i]);
+  }
+
+  return op;
+}
+
+int ins_async_done(const ins_async * op) {
+  int done;
+
+  pthread_mutex_lock(&ins_async_mutex);
+  done = op->pending == 0;
+  pthread_mutex_unlock(&ins_async_mutex);
+
+  return done;
+}
+
+int ins_async_wait(ins_async * op) {
+  int status;
+
+  pthread_mutex_lock(&ins_async_mutex);
+
+  while (op->pending > 0) {
+    pthread_cond_wait(&ins_async_finished, &ins_async_mutex);
+  }
+
+  status = op->status;
+  pthread_mutex_unlock(&ins_async_mutex);
+
+  if (status == INS_SUCCESS && op->finish != 0) {
+    op->finish(op->ctx, op->buffer);
+  }
+
+  if (op->owned) {
+    free(op->buffer);
+  }
+
+  free(op->pieces);
+  free(op);
+
+  if (status != INS_SUCCESS) {
+    INS_ERROR("asynchronous I/O failed", status);
+  }
+
+  return INS_SUCCESS;
+}
@@ -0,0 +1,162 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cmocka.h>
+#include <ins/ins_block.h>
+#include <ins/ins_vector.h>
+
+static int async_file(void) {
+  return open("async.dat", O_RDWR | O_CREAT | O_TRUNC, 0644);
+}
+
+static void test_block_round_trip(void **state) {
+  (void) state;
+
+  const size_t n = 1000;
+  ins_block_int *a = ins_block_int_alloc(n);
+  ins_block_int *b = ins_block_int_calloc(n);
+  ins_block_complex *c = ins_block_complex_alloc(2);
+  ins_block_complex *d = ins_block_complex_calloc(2);
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    a->data[i] = (int) (i * i);
+  }
+  for (i = 0; i < 4; ++i) {
+    c->data[i] = 0.5 * (double) i;
+  }
+
+  int fd = async_file();
+
+  // Both writes are in flight at the same time.
+  ins_async *w1 = ins_block_int_write_async(a, fd, 0);
+  ins_async *w2 = ins_block_complex_write_async(c, fd, n * sizeof(int));
+  assert_non_null(w1);
+  assert_non_null(w2);
+  assert_int_equal(ins_async_wait(w2), INS_SUCCESS);
+  assert_int_equal(ins_async_wait(w1), INS_SUCCESS);
+
+  ins_async *r = ins_block_complex_read_async(d, fd, n * sizeof(int));
+  assert_int_equal(ins_async_wait(r), INS_SUCCESS);
+  r = ins_block_int_read_async(b, fd, 0);
+  assert_int_equal(ins_async_wait(r), INS_SUCCESS);
+  close(fd);
+
+  assert_memory_equal(b->data, a->data, n * sizeof(int));
+  assert_memory_equal(d->data, c->data, 4 * sizeof(double));
+
+  ins_block_complex_free(d);
+  ins_block_complex_free(c);
+  ins_block_int_free(b);
+  ins_block_int_free(a);
+}
+
+static void test_vector_many_pieces(void **state) {
+  (void) state;
+
+  // Large enough to be split into several pieces.
+  const size_t n = 3 * 1024 * 1024 + 7;
+  ins_vector *v = ins_vector_alloc(n);
+  ins_vector *w = ins_vector_calloc(n);
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    ins_vector_set(v, i, (double) i - 0.25);
+  }
+
+  int fd = async_file();
+
+  ins_async *op = ins_vector_write_async(v, fd, 8);
+  assert_non_null(op);
+  assert_int_equal(ins_async_wait(op), INS_SUCCESS);
+
+  op = ins_vector_read_async(w, fd, 8);
+  assert_non_null(op);
+  while (!ins_async_done(op)) {
+    // The caller is free to do other work here.
+  }
+  assert_int_equal(ins_async_wait(op), INS_SUCCESS);
+  close(fd);
+
+  assert_memory_equal(w->data, v->data, n * sizeof(double));
+
+  ins_vector_free(w);
+  ins_vector_free(v);
+}
+
+static void test_vector_strided(void **state) {
+  (void) state;
+
+  const size_t n = 100;
+  ins_vector_float *v = ins_vector_float_alloc(2 * n);
+  ins_vector_float *u = ins_vector_float_calloc(3 * n);
+  size_t i;
+
+  for (i = 0; i < 2 * n; ++i) {
+    ins_vector_float_set(v, i, (float) i);
+  }
+
+  // Every other element of `v` is written, and read back into every third
+  // element of `u`.
+  ins_vector_float *a = ins_vector_float_alloc_from_vector(v, 1, n, 2);
+  ins_vector_float *b = ins_vector_float_alloc_from_vector(u, 0, n, 3);
+
+  int fd = async_file();
+  assert_int_equal(ins_async_wait(ins_vector_float_write_async(a, fd, 0)),
+                   INS_SUCCESS);
+  assert_int_equal(ins_async_wait(ins_vector_float_read_async(b, fd, 0)),
+                   INS_SUCCESS);
+  close(fd);
+
+  for (i = 0; i < n; ++i) {
+    assert_true(ins_vector_float_get(u, 3 * i) == (float) (2 * i + 1));
+    assert_true(ins_vector_float_get(u, 3 * i + 1) == 0.0F);
+  }
+
+  ins_vector_float_free(b);
+  ins_vector_float_free(a);
+  ins_vector_float_free(u);
+  ins_vector_float_free(v);
+}
+
+static void test_short_file(void **state) {
+  (void) state;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+
+  ins_vector *v = ins_vector_calloc(16);
+  int fd = async_file();
+
+  assert_int_equal(write(fd, v->data, 8 * sizeof(double)),
+                   8 * sizeof(double));
+
+  // The file ends before the last element.
+  ins_async *op = ins_vector_read_async(v, fd, 0);
+  assert_non_null(op);
+  assert_int_equal(ins_async_wait(op), INS_EFAILED);
+
+  // An empty vector needs no I/O at all.
+  ins_vector *e = ins_vector_alloc(0);
+  op = ins_vector_read_async(e, fd, 1000);
+  assert_true(ins_async_done(op));
+  assert_int_equal(ins_async_wait(op), INS_SUCCESS);
+  close(fd);
+
+  ins_set_error_handler(handler);
+
+  ins_vector_free(e);
+  ins_vector_free(v);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_block_round_trip),
+    cmocka_unit_test(test_vector_many_pieces),
+    cmocka_unit_test(test_vector_strided),
+    cmocka_unit_test(test_short_file)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
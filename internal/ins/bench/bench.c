@@ -0,0 +1,241 @@
+// insight_bench: microbenchmarks of the vector operations.
+//
+// Every operation of every element type is timed on vectors of 8 up to 10^9
+// elements, at strides 1, 2 and 7 (allocation at stride 1 only). A case is
+// repeated until it has run for at least the minimum time, and its time per
+// call is reported with the bandwidth of the bytes of elements it reads and
+// writes, and its rate of floating point (or integer) operations.
+//
+// Usage: insight_bench [options]
+//
+//   --json            write the results as a JSON object
+//   --min-time=S      minimum time of a case in seconds (default 0.1)
+//   --max-size=N      largest number of elements (default 16777216)
+//   --max-memory=B    skip cases needing more bytes (default half of memory)
+//   --filter=TEXT     run only cases whose "type/op" contains TEXT
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ins/ins_vector.h"
+#include "ins/ins_half.h"
+
+typedef struct {
+  double min_time;
+  size_t max_size;
+  double max_memory;
+  const char * filter;
+  int json;
+
+  // The number of results written so far.
+  size_t count;
+} bench_options;
+
+// The sizes and strides of the cases.
+static const size_t bench_sizes[] = {
+  8, 64, 512, 4096, 32768, 262144, 2097152, 16777216, 134217728, 1000000000
+};
+static const ptrdiff_t bench_strides[] = {1, 2, 7};
+
+#define BENCH_NUM_SIZES (sizeof(bench_sizes) / sizeof(bench_sizes[0]))
+#define BENCH_NUM_STRIDES (sizeof(bench_strides) / sizeof(bench_strides[0]))
+
+// Results of reductions are stored here, so that they are not optimized
+// away.
+static volatile double bench_sink;
+
+static double bench_now(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+static int bench_selected(const bench_options * options, const char * type,
+                          const char * op) {
+  char name[64];
+
+  if (options->filter == 0) {
+    return 1;
+  }
+
+  snprintf(name, sizeof(name), "%s/%s", type, op);
+  return strstr(name, options->filter) != 0;
+}
+
+// Returns the number of runs of the next timing loop, given that `runs`
+// runs took `seconds`. Loops grow at most a hundredfold and aim a little
+// past the minimum time.
+static uint64_t bench_next_runs(const bench_options * options,
+                                const uint64_t runs, const double seconds) {
+  double next = 100.0 * (double) runs;
+
+  if (seconds > 0 && 1.2 * options->min_time / seconds * runs < next) {
+    next = 1.2 * options->min_time / seconds * runs;
+  }
+
+  return next > runs ? (uint64_t) next : runs + 1;
+}
+
+static void bench_report(bench_options * options, const char * type,
+                         const char * op, const size_t n,
+                         const ptrdiff_t stride, const uint64_t runs,
+                         const double seconds, const double bytes,
+                         const double flops) {
+  const double time = seconds / (double) runs;
+  const double gbs = bytes / time * 1e-9;
+  const double gflops = flops / time * 1e-9;
+
+  if (options->json) {
+    printf("%s\n    {\"type\": \"%s\", \"op\": \"%s\", \"size\": %zu, "
+           "\"stride\": %td, \"runs\": %llu, \"ns_per_op\": %.3f, "
+           "\"gb_per_s\": %.4f, \"gflop_per_s\": %.4f}",
+           options->count == 0 ? "" : ",", type, op, n, stride,
+           (unsigned long long) runs, time * 1e9, gbs, gflops);
+  } else {
+    printf("%-14s %-16s %11zu %6td %14.1f %10.3f %10.3f\n", type, op, n,
+           stride, time * 1e9, gbs, gflops);
+  }
+
+  fflush(stdout);
+  ++options->count;
+}
+
+// Times `statement` on vectors of `n` elements at `stride`, with `bytes`
+// bytes of elements moved and `flops` operations done per run. The loop
+// doubles as warm-up: only the time of the last, long enough loop counts.
+#define BENCH(options, type, op, n, stride, bytes, flops, statement)       \
+  do {                                                                     \
+    if (bench_selected(options, type, op)) {                               \
+      uint64_t runs_ = 1, i_;                                              \
+      double seconds_;                                                     \
+      for (;;) {                                                           \
+        const double start_ = bench_now();                                 \
+        for (i_ = 0; i_ < runs_; ++i_) {                                   \
+          statement;                                                       \
+        }                                                                  \
+        seconds_ = bench_now() - start_;                                   \
+        if (seconds_ >= (options)->min_time) {                             \
+          break;                                                           \
+        }                                                                  \
+        runs_ = bench_next_runs(options, runs_, seconds_);                 \
+      }                                                                    \
+      bench_report(options, type, op, n, stride, runs_, seconds_,          \
+                   (double) (bytes), (double) (flops));                    \
+    }                                                                      \
+  } while (0)
+
+#define BENCH_STRING(x) BENCH_STRING_(x)
+#define BENCH_STRING_(x) #x
+
+#define INS_BASE_DOUBLE
+#include "ins/templates_on.h"
+#include "ins/bench/bench_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/bench/bench_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/bench/bench_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
+
+#define INS_BASE_F16
+#include "ins/templates_on.h"
+#include "ins/bench/bench_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_F16
+
+#define INS_BASE_BF16
+#include "ins/templates_on.h"
+#include "ins/bench/bench_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_BF16
+
+#define INS_BASE_COMPLEX
+#include "ins/templates_on.h"
+#include "ins/bench/bench_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX
+
+#define INS_BASE_COMPLEX_FLOAT
+#include "ins/templates_on.h"
+#include "ins/bench/bench_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX_FLOAT
+
+// Returns the value of the option `name` in `arg`, or null if `arg` is
+// another option.
+static const char * bench_option(const char * arg, const char * name) {
+  const size_t length = strlen(name);
+
+  if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+    return 0;
+  }
+
+  return arg + length + 1;
+}
+
+int main(int argc, char * argv[]) {
+  bench_options options = {0.1, 16777216, 0, 0, 0, 0};
+  const long pages = sysconf(_SC_PHYS_PAGES);
+  const long page_size = sysconf(_SC_PAGESIZE);
+  const char * value;
+  int i;
+
+  options.max_memory = pages > 0 && page_size > 0
+                           ? 0.5 * (double) pages * (double) page_size
+                           : HUGE_VAL;
+
+  for (i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--json") == 0) {
+      options.json = 1;
+    } else if ((value = bench_option(argv[i], "--min-time")) != 0) {
+      options.min_time = atof(value);
+    } else if ((value = bench_option(argv[i], "--max-size")) != 0) {
+      options.max_size = (size_t) atof(value);
+    } else if ((value = bench_option(argv[i], "--max-memory")) != 0) {
+      options.max_memory = atof(value);
+    } else if ((value = bench_option(argv[i], "--filter")) != 0) {
+      options.filter = value;
+    } else {
+      fprintf(stderr,
+              "usage: %s [--json] [--min-time=S] [--max-size=N] "
+              "[--max-memory=B] [--filter=TEXT]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Cases whose allocation fails are skipped.
+  ins_set_error_handler_off();
+
+  if (options.json) {
+    printf("{\n  \"benchmarks\": [");
+  } else {
+    printf("%-14s %-16s %11s %6s %14s %10s %10s\n", "type", "op", "size",
+           "stride", "ns/op", "GB/s", "GFLOP/s");
+  }
+
+  bench_all(&options);
+  bench_float_all(&options);
+  bench_int_all(&options);
+  bench_f16_all(&options);
+  bench_bf16_all(&options);
+  bench_complex_all(&options);
+  bench_complex_float_all(&options);
+
+  if (options.json) {
+    printf("\n  ]\n}\n");
+  }
+
+  return EXIT_SUCCESS;
+}
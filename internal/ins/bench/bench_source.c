@@ -0,0 +1,190 @@
+// Template for the benchmarks of ins_vector_[type] types.
+
+// Times the operations on the vectors `x` and `y` of `n` elements at
+// `stride`, whose elements are all one.
+static void INS_FUNC(bench, ops)(bench_options * options, const size_t n,
+                                 const ptrdiff_t stride, INS_VECTOR_TYPE * x,
+                                 INS_VECTOR_TYPE * y) {
+  const char * type = BENCH_STRING(INS_SHORT);
+  const double size = (double) n * sizeof(INS_BASE);
+  const INS_SCALAR one = INS_TO_SCALAR(INS_ONE);
+  FILE * file;
+
+  if (stride == 1) {
+    BENCH(options, type, "alloc_free", n, stride, 0, 0,
+          INS_VECTOR_FUNC(free)(INS_VECTOR_FUNC(alloc)(n)));
+    BENCH(options, type, "calloc_free", n, stride, size, 0,
+          INS_VECTOR_FUNC(free)(INS_VECTOR_FUNC(calloc)(n)));
+  }
+
+  BENCH(options, type, "set_all", n, stride, size, 0,
+        INS_VECTOR_FUNC(set_all)(y, one));
+
+#if defined(INS_HALF_PRECISION)
+  {
+    ins_vector_float * f = ins_vector_float_calloc(n);
+
+    if (f != 0) {
+      BENCH(options, type, "to_float", n, stride,
+            n * (sizeof(INS_BASE) + sizeof(float)), 0,
+            INS_VECTOR_FUNC(to_float)(f, x));
+      BENCH(options, type, "from_float", n, stride,
+            n * (sizeof(INS_BASE) + sizeof(float)), 0,
+            INS_VECTOR_FUNC(from_float)(y, f));
+      ins_vector_float_free(f);
+    }
+  }
+
+  BENCH(options, type, "sum", n, stride, size, n,
+        bench_sink = INS_VECTOR_FUNC(sum)(x));
+  BENCH(options, type, "axpy", n, stride, 3 * size, 2 * n,
+        INS_VECTOR_FUNC(axpy)(one, x, y));
+  BENCH(options, type, "dot", n, stride, 2 * size, 2 * n,
+        bench_sink = INS_VECTOR_FUNC(dot)(x, y));
+  BENCH(options, type, "nrm2", n, stride, size, 2 * n,
+        bench_sink = INS_VECTOR_FUNC(nrm2)(x));
+#elif defined(INS_COMPLEX)
+  BENCH(options, type, "add", n, stride, 3 * size, 2 * n,
+        INS_VECTOR_FUNC(add)(y, x));
+  BENCH(options, type, "sub", n, stride, 3 * size, 2 * n,
+        INS_VECTOR_FUNC(sub)(y, x));
+  BENCH(options, type, "mul", n, stride, 3 * size, 6 * n,
+        INS_VECTOR_FUNC(mul)(y, x));
+  BENCH(options, type, "scale", n, stride, 2 * size, 6 * n,
+        INS_VECTOR_FUNC(scale)(y, one));
+  BENCH(options, type, "axpy", n, stride, 3 * size, 8 * n,
+        INS_VECTOR_FUNC(axpy)(one, x, y));
+  BENCH(options, type, "swap", n, stride, 4 * size, 0,
+        INS_VECTOR_FUNC(swap)(x, y));
+  BENCH(options, type, "copy", n, stride, 2 * size, 0,
+        INS_VECTOR_FUNC(copy)(y, x));
+  BENCH(options, type, "dotu", n, stride, 2 * size, 8 * n,
+        bench_sink = INS_VECTOR_FUNC(dotu)(x, y).dat[0]);
+  BENCH(options, type, "dotc", n, stride, 2 * size, 8 * n,
+        bench_sink = INS_VECTOR_FUNC(dotc)(x, y).dat[0]);
+  BENCH(options, type, "nrm2", n, stride, size, 4 * n,
+        bench_sink = INS_VECTOR_FUNC(nrm2)(x));
+#else
+  {
+    INS_BASE min, max;
+    size_t imin, imax;
+
+    // `x` is one until `swap`, so `y` changes by one per run of `add`, `sub`
+    // and `axpy`, which stays far from overflow for any number of runs.
+    BENCH(options, type, "add", n, stride, 3 * size, n,
+          INS_VECTOR_FUNC(add)(y, x));
+    BENCH(options, type, "sub", n, stride, 3 * size, n,
+          INS_VECTOR_FUNC(sub)(y, x));
+    BENCH(options, type, "mul", n, stride, 3 * size, n,
+          INS_VECTOR_FUNC(mul)(y, x));
+    BENCH(options, type, "div", n, stride, 3 * size, n,
+          INS_VECTOR_FUNC(div)(y, x));
+    BENCH(options, type, "scale", n, stride, 2 * size, n,
+          INS_VECTOR_FUNC(scale)(y, one));
+    BENCH(options, type, "add_constant", n, stride, 2 * size, n,
+          INS_VECTOR_FUNC(add_constant)(y, INS_ZERO));
+    BENCH(options, type, "sum", n, stride, size, n,
+          bench_sink = INS_VECTOR_FUNC(sum)(x));
+    BENCH(options, type, "axpy", n, stride, 3 * size, 2 * n,
+          INS_VECTOR_FUNC(axpy)(one, x, y));
+    BENCH(options, type, "swap", n, stride, 4 * size, 0,
+          INS_VECTOR_FUNC(swap)(x, y));
+    BENCH(options, type, "copy", n, stride, 2 * size, 0,
+          INS_VECTOR_FUNC(copy)(y, x));
+    BENCH(options, type, "dot", n, stride, 2 * size, 2 * n,
+          bench_sink = INS_VECTOR_FUNC(dot)(x, y));
+    BENCH(options, type, "nrm2", n, stride, size, 2 * n,
+          bench_sink = INS_VECTOR_FUNC(nrm2)(x));
+#if defined(INS_BASE_FLOAT)
+    BENCH(options, type, "dsum", n, stride, size, n,
+          bench_sink = INS_VECTOR_FUNC(dsum)(x));
+    BENCH(options, type, "dsdot", n, stride, 2 * size, 2 * n,
+          bench_sink = INS_VECTOR_FUNC(dsdot)(x, y));
+    BENCH(options, type, "dnrm2", n, stride, size, 2 * n,
+          bench_sink = INS_VECTOR_FUNC(dnrm2)(x));
+#endif
+    BENCH(options, type, "min", n, stride, size, n,
+          bench_sink = INS_VECTOR_FUNC(min)(x));
+    BENCH(options, type, "max", n, stride, size, n,
+          bench_sink = INS_VECTOR_FUNC(max)(x));
+    BENCH(options, type, "minmax", n, stride, size, 2 * n,
+          INS_VECTOR_FUNC(minmax)(x, &min, &max));
+    BENCH(options, type, "min_index", n, stride, size, n,
+          bench_sink = INS_VECTOR_FUNC(min_index)(x));
+    BENCH(options, type, "max_index", n, stride, size, n,
+          bench_sink = INS_VECTOR_FUNC(max_index)(x));
+    BENCH(options, type, "minmax_index", n, stride, size, 2 * n,
+          INS_VECTOR_FUNC(minmax_index)(x, &imin, &imax));
+  }
+#endif
+
+  // Files are rewritten and reread in place, so that they stay as large as
+  // one vector.
+  file = tmpfile();
+  if (file == 0) {
+    return;
+  }
+
+#if !defined(INS_HALF_PRECISION) && !defined(INS_COMPLEX)
+  BENCH(options, type, "fwrite", n, stride, size, 0,
+        (rewind(file), INS_VECTOR_FUNC(fwrite)(x, file)));
+  BENCH(options, type, "fread", n, stride, size, 0,
+        (rewind(file), INS_VECTOR_FUNC(fread)(y, file)));
+#endif
+
+  BENCH(options, type, "fwrite_ins", n, stride, size, 0,
+        (rewind(file), INS_VECTOR_FUNC(fwrite_ins)(x, file)));
+  BENCH(options, type, "fread_ins", n, stride, size, 0,
+        (rewind(file), INS_VECTOR_FUNC(fread_ins)(y, file, 0)));
+
+  fclose(file);
+}
+
+// Allocates the vectors of a case in blocks of `n * stride` elements, and
+// times the operations on them unless allocation fails.
+static void INS_FUNC(bench, case)(bench_options * options, const size_t n,
+                                  const ptrdiff_t stride) {
+  const INS_SCALAR one = INS_TO_SCALAR(INS_ONE);
+  INS_BLOCK_TYPE * bx = INS_BLOCK_FUNC(calloc)(n * (size_t) stride);
+  INS_BLOCK_TYPE * by = INS_BLOCK_FUNC(calloc)(n * (size_t) stride);
+  INS_VECTOR_TYPE * x =
+      bx != 0 ? INS_VECTOR_FUNC(alloc_from_block)(bx, 0, n, stride) : 0;
+  INS_VECTOR_TYPE * y =
+      by != 0 ? INS_VECTOR_FUNC(alloc_from_block)(by, 0, n, stride) : 0;
+
+  if (x != 0 && y != 0) {
+    INS_VECTOR_FUNC(set_all)(x, one);
+    INS_VECTOR_FUNC(set_all)(y, one);
+    INS_FUNC(bench, ops)(options, n, stride, x, y);
+  }
+
+  INS_VECTOR_FUNC(free)(y);
+  INS_VECTOR_FUNC(free)(x);
+  INS_BLOCK_FUNC(free)(by);
+  INS_BLOCK_FUNC(free)(bx);
+}
+
+// Runs the cases of all sizes and strides that fit into the limits.
+static void INS_FUNC(bench, all)(bench_options * options) {
+  size_t i, j;
+
+  for (i = 0; i < BENCH_NUM_SIZES; ++i) {
+    const size_t n = bench_sizes[i];
+
+    if (n > options->max_size) {
+      break;
+    }
+
+    for (j = 0; j < BENCH_NUM_STRIDES; ++j) {
+      const ptrdiff_t stride = bench_strides[j];
+
+      // Two vectors, and a third one while allocation is timed.
+      if (3.0 * (double) n * (double) stride * sizeof(INS_BASE) >
+          options->max_memory) {
+        continue;
+      }
+
+      INS_FUNC(bench, case)(options, n, stride);
+    }
+  }
+}
@@ -0,0 +1,453 @@
+// insight_tune: calibrates a tuning profile for this host.
+//
+// The program finds the sizes of the data caches, measures the bandwidth of
+// main memory, the lengths from which the vector operations of `double` and
+// `float` vectors are faster with BLAS than with a plain loop, and the
+// number of threads and bytes per thread at which parallel loading pays
+// off. It writes them as a tuning profile (see `ins/ins_tuning.h`), to be
+// loaded through `INSIGHT_TUNING=<path>` or with `ins_load_tuning`.
+//
+// Usage: insight_tune [--output=PATH] [--quick]
+//
+//   --output=PATH     the profile to write (default insight.tuning)
+//   --quick           measure for a tenth of the time, less precisely
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ins/ins_vector.h"
+#include "ins/ins_tuning.h"
+
+// The longest vectors whose crossover is measured. From there on all
+// operations are bound by memory, and BLAS is kept.
+#define TUNE_MAX_CROSSOVER 65536
+
+// The size in bytes of the text file of the parallel loading measurements.
+#define TUNE_CSV_SIZE (16 << 20)
+
+// A loop of BLAS is accepted up to this much slower than the plain loop,
+// so that noise does not move the crossover away from BLAS.
+#define TUNE_TOLERANCE 1.05
+
+static double tune_min_time = 0.002;
+static volatile double tune_sink;
+
+static double tune_now(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double) now.tv_sec + 1e-9 * (double) now.tv_nsec;
+}
+
+/* Caches */
+
+// Returns the size in bytes of the data or unified cache of `level` of the
+// first processor as listed in sysfs, or 0.
+static size_t tune_sysfs_cache(const int level) {
+  char path[128];
+  char text[32];
+  int index;
+
+  for (index = 0; index < 8; ++index) {
+    FILE * stream;
+    int found_level = 0;
+    size_t size = 0;
+    char unit = 0;
+
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu0/cache/index%d/level", index);
+    stream = fopen(path, "r");
+    if (stream == 0) {
+      break;
+    }
+    if (fscanf(stream, "%d", &found_level) != 1) {
+      found_level = 0;
+    }
+    fclose(stream);
+
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu0/cache/index%d/type", index);
+    stream = fopen(path, "r");
+    if (stream == 0 || fscanf(stream, "%31s", text) != 1) {
+      text[0] = '\0';
+    }
+    if (stream != 0) {
+      fclose(stream);
+    }
+
+    if (found_level != level || strcmp(text, "Instruction") == 0) {
+      continue;
+    }
+
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu0/cache/index%d/size", index);
+    stream = fopen(path, "r");
+    if (stream != 0 && fscanf(stream, "%zu%c", &size, &unit) >= 1) {
+      size *= unit == 'K' ? 1024 : unit == 'M' ? 1024 * 1024 : 1;
+    }
+    if (stream != 0) {
+      fclose(stream);
+    }
+
+    return size;
+  }
+
+  return 0;
+}
+
+// Returns the size in bytes of the data cache of `level`, or 0 if unknown.
+static size_t tune_cache(const int level) {
+  size_t size = tune_sysfs_cache(level);
+
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+  if (size == 0) {
+    const long value = sysconf(level == 1   ? _SC_LEVEL1_DCACHE_SIZE
+                               : level == 2 ? _SC_LEVEL2_CACHE_SIZE
+                                            : _SC_LEVEL3_CACHE_SIZE);
+    size = value > 0 ? (size_t) value : 0;
+  }
+#endif
+
+  return size;
+}
+
+/* Memory bandwidth */
+
+// Returns the bandwidth of copying a buffer much larger than the last
+// cache, in bytes read and written per second.
+static double tune_memory_bandwidth(const size_t l3_cache) {
+  size_t size = 4 * l3_cache;
+  double best = 0.0;
+  char * src;
+  char * dst;
+  int i;
+
+  // Large shared caches are bounded, so that both buffers fit into memory.
+  if (size < ((size_t) 1 << 26)) {
+    size = (size_t) 1 << 26;
+  } else if (size > ((size_t) 1 << 29)) {
+    size = (size_t) 1 << 29;
+  }
+
+  src = (char *) malloc(size);
+  dst = (char *) malloc(size);
+  if (src == 0 || dst == 0) {
+    free(src);
+    free(dst);
+    return 0.0;
+  }
+
+  memset(src, 1, size);
+  memset(dst, 0, size);
+
+  for (i = 0; i < 5; ++i) {
+    const double start = tune_now();
+    double seconds;
+
+    memcpy(dst, src, size);
+    seconds = tune_now() - start;
+    if (seconds > 0 && 2.0 * (double) size / seconds > best) {
+      best = 2.0 * (double) size / seconds;
+    }
+  }
+
+  tune_sink = dst[size - 1];
+  free(src);
+  free(dst);
+
+  return best;
+}
+
+/* Crossovers */
+
+// Returns the time of one call of the operation `op` on `x` and `y`, the
+// best of three loops of at least the minimum time.
+static double tune_time_double(const int op, ins_vector * x, ins_vector * y) {
+  double best = 0.0;
+  int k;
+
+  for (k = 0; k < 3; ++k) {
+    uint64_t runs = 0;
+    const double start = tune_now();
+    double seconds;
+
+    do {
+      switch (op) {
+        case INS_TUNING_SCALE: ins_vector_scale(x, 1.0); break;
+        case INS_TUNING_AXPY: ins_vector_axpy(0.0, x, y); break;
+        case INS_TUNING_SWAP: ins_vector_swap(x, y); break;
+        case INS_TUNING_COPY: ins_vector_copy(y, x); break;
+        default: tune_sink = ins_vector_dot(x, y); break;
+      }
+      ++runs;
+      seconds = tune_now() - start;
+    } while (seconds < tune_min_time);
+
+    if (k == 0 || seconds / (double) runs < best) {
+      best = seconds / (double) runs;
+    }
+  }
+
+  return best;
+}
+
+static double tune_time_float(const int op, ins_vector_float * x,
+                              ins_vector_float * y) {
+  double best = 0.0;
+  int k;
+
+  for (k = 0; k < 3; ++k) {
+    uint64_t runs = 0;
+    const double start = tune_now();
+    double seconds;
+
+    do {
+      switch (op) {
+        case INS_TUNING_SCALE: ins_vector_float_scale(x, 1.0F); break;
+        case INS_TUNING_AXPY: ins_vector_float_axpy(0.0F, x, y); break;
+        case INS_TUNING_SWAP: ins_vector_float_swap(x, y); break;
+        case INS_TUNING_COPY: ins_vector_float_copy(y, x); break;
+        default: tune_sink = ins_vector_float_dot(x, y); break;
+      }
+      ++runs;
+      seconds = tune_now() - start;
+    } while (seconds < tune_min_time);
+
+    if (k == 0 || seconds / (double) runs < best) {
+      best = seconds / (double) runs;
+    }
+  }
+
+  return best;
+}
+
+// Times `op` of vectors of `n` elements of the type `is_float` with the
+// plain loop and with BLAS, and returns non-zero if BLAS is not slower.
+static int tune_blas_wins(ins_tuning * tuning, const int is_float,
+                          const int op, const size_t n) {
+  double loop, blas;
+
+  if (is_float) {
+    ins_vector_float * x = ins_vector_float_calloc(n);
+    ins_vector_float * y = ins_vector_float_calloc(n);
+
+    tuning->blas_min_float[op] = SIZE_MAX;
+    ins_set_tuning(tuning);
+    loop = tune_time_float(op, x, y);
+    tuning->blas_min_float[op] = 0;
+    ins_set_tuning(tuning);
+    blas = tune_time_float(op, x, y);
+
+    ins_vector_float_free(y);
+    ins_vector_float_free(x);
+  } else {
+    ins_vector * x = ins_vector_calloc(n);
+    ins_vector * y = ins_vector_calloc(n);
+
+    tuning->blas_min_double[op] = SIZE_MAX;
+    ins_set_tuning(tuning);
+    loop = tune_time_double(op, x, y);
+    tuning->blas_min_double[op] = 0;
+    ins_set_tuning(tuning);
+    blas = tune_time_double(op, x, y);
+
+    ins_vector_free(y);
+    ins_vector_free(x);
+  }
+
+  return blas <= TUNE_TOLERANCE * loop;
+}
+
+// Returns the shortest length from which BLAS is not slower than the plain
+// loop at every measured length, halving from `TUNE_MAX_CROSSOVER` down.
+static size_t tune_crossover(ins_tuning * tuning, const int is_float,
+                             const int op) {
+  size_t crossover = TUNE_MAX_CROSSOVER;
+  size_t n;
+
+  for (n = TUNE_MAX_CROSSOVER; n >= 1; n /= 2) {
+    if (!tune_blas_wins(tuning, is_float, op, n)) {
+      break;
+    }
+    crossover = n;
+  }
+
+  return crossover <= 1 ? 0 : crossover;
+}
+
+/* Parallel loading */
+
+static void * tune_idle(void * arg) {
+  return arg;
+}
+
+// Returns the time of starting and joining a thread.
+static double tune_thread_cost(void) {
+  double best = 1.0;
+  int i;
+
+  for (i = 0; i < 20; ++i) {
+    pthread_t thread;
+    const double start = tune_now();
+
+    if (pthread_create(&thread, 0, tune_idle, 0) != 0) {
+      break;
+    }
+    pthread_join(thread, 0);
+
+    if (tune_now() - start < best) {
+      best = tune_now() - start;
+    }
+  }
+
+  return best;
+}
+
+// Returns the time of loading the two columns of the text file at `path`
+// with `threads` threads, the best of three loads.
+static double tune_load_time(const char * path, const int threads) {
+  ins_csv_options options = {0, 0, 0, threads};
+  double best = 0.0;
+  int k;
+
+  for (k = 0; k < 3; ++k) {
+    ins_vector * vectors[2] = {0, 0};
+    const double start = tune_now();
+    double seconds;
+
+    if (ins_vector_read_csv(path, &options, vectors, 2) != INS_SUCCESS) {
+      return 0.0;
+    }
+    seconds = tune_now() - start;
+
+    ins_vector_free(vectors[1]);
+    ins_vector_free(vectors[0]);
+
+    if (k == 0 || seconds < best) {
+      best = seconds;
+    }
+  }
+
+  return best;
+}
+
+// Sets the threads of `tuning` to the number, up to one per processor, that
+// loads a text file the fastest, and the bytes per thread to what one
+// thread parses in ten times the cost of starting it. The file is written
+// to `TMPDIR`, or to `/tmp` if it is not set.
+static void tune_parallel(ins_tuning * tuning) {
+  const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  const char * tmp = getenv("TMPDIR");
+  char path[4096];
+  int fd;
+  FILE * stream;
+  double best = 0.0;
+  double rate;
+  size_t bytes = 0;
+  int threads;
+
+  snprintf(path, sizeof(path), "%s/insight_tune_XXXXXX",
+           tmp != 0 && *tmp != '\0' ? tmp : "/tmp");
+  fd = mkstemp(path);
+  stream = fd >= 0 ? fdopen(fd, "w") : 0;
+
+  if (stream == 0) {
+    return;
+  }
+
+  while (bytes < TUNE_CSV_SIZE) {
+    const int written = fprintf(stream, "%zu.25,%zu\n", bytes, bytes % 97);
+    bytes += written > 0 ? (size_t) written : 1;
+  }
+  fclose(stream);
+
+  // The first load brings the file into the page cache, the second one is
+  // timed.
+  rate = tune_load_time(path, 1) > 0 ? tune_load_time(path, 1) : 0.0;
+  rate = rate > 0 ? (double) bytes / rate : 0.0;
+
+  // Powers of two are tried, and then all processors, whose number need not
+  // be one.
+  tuning->threads = 1;
+  threads = 1;
+  for (;;) {
+    const double seconds = tune_load_time(path, threads);
+
+    if (seconds > 0 && (best == 0.0 || seconds < best)) {
+      best = seconds;
+      tuning->threads = threads;
+    }
+
+    if (threads >= processors) {
+      break;
+    }
+    threads = 2 * threads < processors ? 2 * threads : (int) processors;
+  }
+
+  if (rate > 0) {
+    size_t min_bytes = 4096;
+
+    while ((double) min_bytes < 10.0 * tune_thread_cost() * rate &&
+           min_bytes < ((size_t) 1 << 24)) {
+      min_bytes *= 2;
+    }
+    tuning->parallel_min_bytes = min_bytes;
+  }
+
+  remove(path);
+}
+
+int main(int argc, char * argv[]) {
+  static const char * const ops[INS_TUNING_BLAS_OPS] = {
+    "scale", "axpy", "swap", "copy", "dot"
+  };
+  const char * output = "insight.tuning";
+  ins_tuning tuning;
+  int i, op;
+
+  for (i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--output=", 9) == 0) {
+      output = argv[i] + 9;
+    } else if (strcmp(argv[i], "--quick") == 0) {
+      tune_min_time /= 10;
+    } else {
+      fprintf(stderr, "usage: %s [--output=PATH] [--quick]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  ins_default_tuning(&tuning);
+
+  tuning.l1_cache = tune_cache(1);
+  tuning.l2_cache = tune_cache(2);
+  tuning.l3_cache = tune_cache(3);
+  printf("caches: L1 %zu, L2 %zu, L3 %zu bytes\n", tuning.l1_cache,
+         tuning.l2_cache, tuning.l3_cache);
+
+  tuning.memory_bandwidth = tune_memory_bandwidth(tuning.l3_cache);
+  printf("memory bandwidth: %.2f GB/s\n", tuning.memory_bandwidth * 1e-9);
+
+  for (op = 0; op < INS_TUNING_BLAS_OPS; ++op) {
+    tuning.blas_min_double[op] = tune_crossover(&tuning, 0, op);
+    tuning.blas_min_float[op] = tune_crossover(&tuning, 1, op);
+    printf("BLAS from length: %-5s double %zu, float %zu\n", ops[op],
+           tuning.blas_min_double[op], tuning.blas_min_float[op]);
+  }
+
+  tune_parallel(&tuning);
+  printf("parallel loading: %d threads, %zu bytes per thread\n",
+         tuning.threads, tuning.parallel_min_bytes);
+
+  ins_set_tuning(&tuning);
+
+  if (ins_save_tuning(&tuning, output) != INS_SUCCESS) {
+    return EXIT_FAILURE;
+  }
+
+  printf("wrote %s\n", output);
+
+  return EXIT_SUCCESS;
+}
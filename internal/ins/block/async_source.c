@@ -0,0 +1,22 @@
+// Template for asynchronous reads and writes of ins_block_[qualifier] types.
+
+ins_async * INS_BLOCK_FUNC(read_async)(INS_BLOCK_TYPE * block, const int fd,
+                                       const size_t offset) {
+  INS_STATS(INS_BLOCK_FUNC(read_async), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  const size_t nbytes = INS_MULTIPLICITY * sizeof(INS_ATOMIC) * block->size;
+
+  return ins_async_submit(fd, offset, block->data, nbytes, 0, 0, 0, 0);
+}
+
+ins_async * INS_BLOCK_FUNC(write_async)(const INS_BLOCK_TYPE * block,
+                                        const int fd, const size_t offset) {
+  INS_STATS(INS_BLOCK_FUNC(write_async), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  const size_t nbytes = INS_MULTIPLICITY * sizeof(INS_ATOMIC) * block->size;
+
+  return ins_async_submit(fd, offset, (void *) block->data, nbytes, 1, 0, 0,
+                          0);
+}
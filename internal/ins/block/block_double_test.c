@@ -29,6 +29,31 @@ static void calloc_success(void **state) {
   ins_block_free(block);
 }
 
+static void count_release(void * data, void * release_ctx) {
+  (void) data;
+  ++*(int *) release_ctx;
+}
+
+static void wrap_success(void **state) {
+  (void) state; /* unused */
+
+  double data[] = {1.0, 2.0, 3.0};
+  int releases = 0;
+
+  ins_block * block = ins_block_wrap(data, 3, count_release, &releases);
+  assert_non_null(block);
+  assert_ptr_equal(block->data, data);
+  assert_int_equal(block->size, 3);
+  ins_block_free(block);
+  assert_int_equal(releases, 1);
+
+  // Without a release function the memory is left to the caller.
+  block = ins_block_wrap(data, 3, 0, 0);
+  assert_non_null(block);
+  ins_block_free(block);
+  assert_true(data[2] == 3.0);
+}
+
 static void fwrite_success(void **state) {
   (void) state; /* unused */
 
@@ -113,6 +138,7 @@ int main(void) {
   const struct CMUnitTest tests[] = {
     cmocka_unit_test(alloc_success),
     cmocka_unit_test(calloc_success),
+    cmocka_unit_test(wrap_success),
     cmocka_unit_test(fwrite_success),
     cmocka_unit_test(fread_success),
     cmocka_unit_test(fprintf_success),
@@ -0,0 +1,75 @@
+// Template for reading and writing ins_block_[qualifier] types as `.ins`
+// containers.
+
+int INS_BLOCK_FUNC(fwrite_ins)(const INS_BLOCK_TYPE * block, FILE * stream) {
+  INS_STATS(INS_BLOCK_FUNC(fwrite_ins), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  const size_t size = block->size;
+  const size_t elem_size = INS_MULTIPLICITY * sizeof(INS_ATOMIC);
+  const uint64_t checksum =
+    ins_container_checksum(block->data, size * elem_size);
+
+  int status;
+
+  status = ins_container_write_header(stream, INS_TYPE_ID,
+                                      (uint32_t) elem_size, size, checksum);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  if (fwrite(block->data, elem_size, size, stream) != size) {
+    INS_ERROR("fwrite failed", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+int INS_BLOCK_FUNC(fread_ins)(INS_BLOCK_TYPE * block, FILE * stream,
+                              const int flags) {
+  INS_STATS(INS_BLOCK_FUNC(fread_ins), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  const size_t size = block->size;
+  const size_t elem_size = INS_MULTIPLICITY * sizeof(INS_ATOMIC);
+
+  ins_container_header header;
+  int status;
+
+  status = ins_container_read_header(stream, &header);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  status = ins_container_check_type(&header, INS_TYPE_ID,
+                                    (uint32_t) elem_size);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  if (header.count != size) {
+    INS_ERROR("container length does not match block size", INS_EBADLEN);
+  }
+
+  status = ins_container_skip_padding(stream, &header);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  if (fread(block->data, elem_size, size, stream) != size) {
+    INS_ERROR("fread failed", INS_EFAILED);
+  }
+
+  // The checksum covers the payload as stored, i.e. before any byte swap.
+  if ((flags & INS_CONTAINER_VERIFY) &&
+      ins_container_checksum(block->data, size * elem_size)
+      != header.checksum) {
+    INS_ERROR("container checksum mismatch", INS_EFAILED);
+  }
+
+  if (header.big_endian != ins_host_big_endian()) {
+    ins_byteswap(block->data, INS_MULTIPLICITY * size, sizeof(INS_ATOMIC));
+  }
+
+  return INS_SUCCESS;
+}
@@ -0,0 +1,45 @@
+#include <ins/ins_block.h>
+#include "ins/ins_direct_io.h"
+#include "ins/ins_stats_io.h"
+
+#define INS_BASE_DOUBLE
+#include "ins/templates_on.h"
+#include "ins/block/direct_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/block/direct_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/block/direct_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
+
+#define INS_BASE_F16
+#include "ins/templates_on.h"
+#include "ins/block/direct_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_F16
+
+#define INS_BASE_BF16
+#include "ins/templates_on.h"
+#include "ins/block/direct_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_BF16
+
+#define INS_BASE_COMPLEX
+#include "ins/templates_on.h"
+#include "ins/block/direct_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX
+
+#define INS_BASE_COMPLEX_FLOAT
+#include "ins/templates_on.h"
+#include "ins/block/direct_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX_FLOAT
@@ -0,0 +1,50 @@
+// Template for direct reads and writes of ins_block_[qualifier] types.
+
+int INS_BLOCK_FUNC(read_direct)(INS_BLOCK_TYPE * block, const char * path,
+                                const size_t offset) {
+  INS_STATS(INS_BLOCK_FUNC(read_direct), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  const size_t nbytes = INS_MULTIPLICITY * sizeof(INS_ATOMIC) * block->size;
+
+  ins_direct_file file;
+  int status;
+
+  status = ins_direct_open(&file, path, 0);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  status = ins_direct_transfer(&file, offset, block->data, nbytes, 0);
+
+  if (ins_direct_close(&file) != INS_SUCCESS) {
+    status = INS_EFAILED;
+  }
+
+  return status;
+}
+
+int INS_BLOCK_FUNC(write_direct)(const INS_BLOCK_TYPE * block,
+                                 const char * path, const size_t offset) {
+  INS_STATS(INS_BLOCK_FUNC(write_direct), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  const size_t nbytes = INS_MULTIPLICITY * sizeof(INS_ATOMIC) * block->size;
+
+  ins_direct_file file;
+  int status;
+
+  status = ins_direct_open(&file, path, 1);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  status = ins_direct_transfer(&file, offset, (void *) block->data, nbytes,
+                               1);
+
+  if (ins_direct_close(&file) != INS_SUCCESS) {
+    status = INS_EFAILED;
+  }
+
+  return status;
+}
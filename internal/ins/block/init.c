@@ -1,4 +1,11 @@
+#include <stdint.h>
+#include <string.h>
 #include <ins/ins_block.h>
+#include "ins/ins_half.h"
+#include "ins/ins_text.h"
+#include "ins/ins_allocator_io.h"
+#include "ins/ins_memory_io.h"
+#include "ins/ins_stats_io.h"
 
 #define INS_BASE_DOUBLE
 #include "ins/templates_on.h"
@@ -17,3 +24,27 @@
 #include "ins/block/init_source.c"
 #include "ins/templates_off.h"
 #undef INS_BASE_INT
+
+#define INS_BASE_F16
+#include "ins/templates_on.h"
+#include "ins/block/init_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_F16
+
+#define INS_BASE_BF16
+#include "ins/templates_on.h"
+#include "ins/block/init_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_BF16
+
+#define INS_BASE_COMPLEX
+#include "ins/templates_on.h"
+#include "ins/block/init_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX
+
+#define INS_BASE_COMPLEX_FLOAT
+#include "ins/templates_on.h"
+#include "ins/block/init_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX_FLOAT
@@ -4,53 +4,106 @@
 // If allocation failed, call the error handler, and return 0 as the result.
 static INS_BLOCK_TYPE * INS_BLOCK_FUNC(allocate_empty)();
 
-INS_BLOCK_TYPE * INS_BLOCK_FUNC(alloc)(const size_t count) {
-  // Allocate memory for block struct.
-  INS_BLOCK_TYPE * block = INS_BLOCK_FUNC(allocate_empty)();
-  if (block == 0) { return 0; }
+// Allocates space for `count` elements through `allocator`, initialized to 0
+// if `zero` is non-zero, and counts it under the tag stored into `tag` (see
+// `ins/ins_memory.h`). Large blocks are aligned for direct I/O (see
+// `ins/ins_direct.h`). Returns 0 if allocation failed or a memory budget
+// does not allow it.
+static INS_ATOMIC * INS_BLOCK_FUNC(allocate_data)(
+    const size_t count, const int zero, const ins_allocator * allocator,
+    int * tag);
 
-  // Allocate memory for the block elements.
-  block->data = (INS_BASE *) malloc(count * sizeof(INS_BASE));
+// Returns whether the elements of a block of `nbytes` bytes allocated
+// through `allocator`, initialized to 0 if `zero` is non-zero, are mapped
+// with `ins_pages_alloc`.
+static int INS_BLOCK_FUNC(maps_data)(const size_t nbytes, const int zero,
+                                     const ins_allocator * allocator);
 
-  // If block data allocation failed, free the allocated block, call the error
-  // handler, and return 0 as the result.
-  if (block->data == 0 && count > 0) {
-    free(block);
-    INS_ERROR_VAL("failed to allocate space for block data", INS_ENOMEM, 0);
-  }
+// The release function of blocks whose elements are mapped with
+// `ins_pages_alloc`, where `release_ctx` is the block.
+static void INS_BLOCK_FUNC(unmap_data)(void * data, void * release_ctx);
 
-  block->size = count;
-  return block;
+// Allocates a block of `count` elements through `allocator`, initialized to
+// 0 if `zero` is non-zero. If allocation failed, calls the error handler and
+// returns 0.
+static INS_BLOCK_TYPE * INS_BLOCK_FUNC(allocate)(
+    const size_t count, const int zero, const ins_allocator * allocator);
+
+INS_BLOCK_TYPE * INS_BLOCK_FUNC(alloc)(const size_t count) {
+  INS_STATS(INS_BLOCK_FUNC(alloc), count, 1, 0);
+  return INS_BLOCK_FUNC(allocate)(count, 0, ins_get_allocator());
 }
 
 INS_BLOCK_TYPE * INS_BLOCK_FUNC(calloc)(const size_t count) {
-  // Allocate memory for block struct.
-  INS_BLOCK_TYPE * block = INS_BLOCK_FUNC(allocate_empty)();
-  if (block == 0) { return 0; }
+  INS_STATS(INS_BLOCK_FUNC(calloc), count, 1,
+            count * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+  return INS_BLOCK_FUNC(allocate)(count, 1, ins_get_allocator());
+}
 
-  // Allocate memory for the block elements and initialize elements to 0
-  block->data = (INS_BASE *) calloc(count, sizeof(INS_BASE));
+INS_BLOCK_TYPE *
+INS_BLOCK_FUNC(alloc_with_allocator)(const size_t count,
+                                     const ins_allocator * allocator) {
+  INS_STATS(INS_BLOCK_FUNC(alloc_with_allocator), count, 1, 0);
+  return INS_BLOCK_FUNC(allocate)(
+      count, 0, allocator != 0 ? allocator : ins_get_allocator());
+}
 
-  // If block data allocation failed, free the allocated block, call the error
-  // handler, and return 0 as the result.
-  if (block->data == 0 && count > 0) {
-    free(block);
-    INS_ERROR_VAL("failed to allocate space for block data", INS_ENOMEM, 0);
-  }
+INS_BLOCK_TYPE *
+INS_BLOCK_FUNC(calloc_with_allocator)(const size_t count,
+                                      const ins_allocator * allocator) {
+  INS_STATS(INS_BLOCK_FUNC(calloc_with_allocator), count, 1,
+            count * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+  return INS_BLOCK_FUNC(allocate)(
+      count, 1, allocator != 0 ? allocator : ins_get_allocator());
+}
+
+// The release function of wrapped blocks without one, which leaves the
+// elements to their owner.
+static void INS_BLOCK_FUNC(keep_data)(void * data, void * release_ctx) {
+  (void) data;
+  (void) release_ctx;
+}
+
+INS_BLOCK_TYPE * INS_BLOCK_FUNC(wrap)(
+    INS_ATOMIC * data, const size_t count,
+    void (*release)(void * data, void * release_ctx), void * release_ctx) {
+  INS_STATS(INS_BLOCK_FUNC(wrap), count, 1, 0);
+
+  INS_BLOCK_TYPE * block = INS_BLOCK_FUNC(allocate_empty)();
+  if (block == 0) { return 0; }
 
   block->size = count;
+  block->data = data;
+  block->release = release ? release : INS_BLOCK_FUNC(keep_data);
+  block->release_ctx = release_ctx;
+
   return block;
 }
 
 void INS_BLOCK_FUNC(free)(INS_BLOCK_TYPE * block) {
+  INS_STATS(INS_BLOCK_FUNC(free), block != 0 ? block->size : 0, 1, 0);
+
   if (block == 0) { return; }
-  free(block->data);
+
+  if (block->release) {
+    block->release(block->data, block->release_ctx);
+  } else {
+    if (block->data != 0) {
+      block->allocator->free(block->data, block->allocator->context);
+    }
+    ins_memory_release(INS_MULTIPLICITY * block->size * sizeof(INS_ATOMIC),
+                       block->tag);
+  }
+
   free(block);
 }
 
 int INS_BLOCK_FUNC(fread)(INS_BLOCK_TYPE * block, FILE * stream) {
-  const size_t nitems = block->size;
-  const size_t size = sizeof(INS_BASE);
+  INS_STATS(INS_BLOCK_FUNC(fread), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  const size_t nitems = INS_MULTIPLICITY * block->size;
+  const size_t size = sizeof(INS_ATOMIC);
   const size_t nitems_read = fread(block->data, size, nitems, stream);
 
   // If the number of items read from the stream is not equal to the number
@@ -64,8 +117,11 @@ int INS_BLOCK_FUNC(fread)(INS_BLOCK_TYPE * block, FILE * stream) {
 }
 
 int INS_BLOCK_FUNC(fwrite)(const INS_BLOCK_TYPE * block, FILE * stream) {
-  const size_t nitems = block->size;
-  const size_t size = sizeof(INS_BASE);
+  INS_STATS(INS_BLOCK_FUNC(fwrite), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  const size_t nitems = INS_MULTIPLICITY * block->size;
+  const size_t size = sizeof(INS_ATOMIC);
   const size_t nitems_written = fwrite(block->data, size, nitems, stream);
 
   // If the number of items written to the stream is not equal to the number
@@ -80,39 +136,85 @@ int INS_BLOCK_FUNC(fwrite)(const INS_BLOCK_TYPE * block, FILE * stream) {
 
 int INS_BLOCK_FUNC(fprintf)(const INS_BLOCK_TYPE * block, FILE * stream,
                             const char * format) {
+  INS_STATS(INS_BLOCK_FUNC(fprintf), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
   const size_t size = block->size;
-  const INS_BASE * data = block->data;
+  const INS_ATOMIC * data = block->data;
 
+  ins_text_writer writer;
+  ins_text_format spec;
   size_t i;
+  int status = 0;
+
+  // The elements are formatted into a buffer that is written to the stream
+  // whenever it fills up.
+  ins_text_format_init(&spec, format);
+  ins_text_writer_init(&writer, stream);
+
+  for (i = 0; i < size && status == 0; ++i) {
+#if defined(INS_COMPLEX)
+    // Complex elements are written as the real part, a space, and the
+    // imaginary part on one line.
+    status = INS_TEXT_WRITE(&writer, &spec, data[2 * i]);
+
+    if (status == 0) {
+      status = ins_text_write_char(&writer, ' ');
+    }
 
-  for (i = 0; i < size; ++i) {
-    // Writes the next element of the block to the stream. If fprintf fails,
-    // call the error handler and return the status code `INS_EFAILED`.
-    if (fprintf(stream, format, data[i]) < 0) {
-      INS_ERROR("fprintf failed", INS_EFAILED);
+    if (status == 0) {
+      status = INS_TEXT_WRITE(&writer, &spec, data[2 * i + 1]);
     }
+#else
+    status = INS_TEXT_WRITE(&writer, &spec, INS_TO_SCALAR(data[i]));
+#endif
 
-    // Writes the next newline character to the stream. If putc fails, call
-    // the error handler and return the status code `INS_EFAILED`.
-    if (putc('\n', stream) == EOF) {
-      INS_ERROR("putc failed", INS_EFAILED);
+    if (status == 0) {
+      status = ins_text_write_char(&writer, '\n');
     }
   }
 
+  if (status == 0) {
+    status = ins_text_writer_flush(&writer);
+  }
+
+  if (status != 0) {
+    INS_ERROR("fprintf failed", INS_EFAILED);
+  }
+
   return INS_SUCCESS;
 }
 
 int INS_BLOCK_FUNC(fscanf)(INS_BLOCK_TYPE * block, FILE * stream) {
-  const size_t size = block->size;
+  INS_STATS(INS_BLOCK_FUNC(fscanf), block->size, 1,
+            block->size * INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  // Complex elements are read as their real and imaginary parts in turn.
+  const size_t count = INS_MULTIPLICITY * block->size;
 
   size_t i;
-  INS_BASE tmp;
+  int status = 0;
 
-  for (i = 0; i < size; ++i) {
-    if (fscanf(stream, INS_INPUT_FORMAT, &tmp) != 1) {
-      INS_ERROR("fscanf failed", INS_EFAILED);
+  // The numbers are parsed straight out of the stdio buffer, so the stream
+  // is locked once for the whole block rather than once per element.
+  flockfile(stream);
+
+  for (i = 0; i < count && status == 0; ++i) {
+#if defined(INS_HALF_PRECISION)
+    INS_SCALAR tmp;
+    status = INS_TEXT_READ(stream, &tmp);
+    if (status == 0) {
+      block->data[i] = INS_FROM_SCALAR(tmp);
     }
-    block->data[i] = tmp;
+#else
+    status = INS_TEXT_READ(stream, &block->data[i]);
+#endif
+  }
+
+  funlockfile(stream);
+
+  if (status != 0) {
+    INS_ERROR("fscanf failed", INS_EFAILED);
   }
 
   return INS_SUCCESS;
@@ -128,5 +230,92 @@ static INS_BLOCK_TYPE * INS_BLOCK_FUNC(allocate_empty)() {
     INS_ERROR_VAL("failed to allocate space for block struct", INS_ENOMEM, 0);
   }
 
+  block->release = 0;
+  block->release_ctx = 0;
+  block->tag = 0;
+  block->allocator = 0;
+
   return block;
 }
+
+static INS_BLOCK_TYPE * INS_BLOCK_FUNC(allocate)(
+    const size_t count, const int zero, const ins_allocator * allocator) {
+  // Allocate memory for block struct.
+  INS_BLOCK_TYPE * block = INS_BLOCK_FUNC(allocate_empty)();
+  if (block == 0) { return 0; }
+
+  // Allocate memory for the block elements, initialized to 0 if asked for.
+  block->data = INS_BLOCK_FUNC(allocate_data)(count, zero, allocator,
+                                              &block->tag);
+
+  // If block data allocation failed, free the allocated block, call the error
+  // handler, and return 0 as the result.
+  if (block->data == 0 && count > 0) {
+    free(block);
+    INS_ERROR_VAL("failed to allocate space for block data", INS_ENOMEM, 0);
+  }
+
+  block->size = count;
+  block->allocator = allocator;
+
+  // Mapped elements are unmapped by the release function.
+  if (INS_BLOCK_FUNC(maps_data)(
+          INS_MULTIPLICITY * count * sizeof(INS_ATOMIC), zero, allocator)) {
+    block->release = INS_BLOCK_FUNC(unmap_data);
+    block->release_ctx = block;
+  }
+
+  return block;
+}
+
+static int INS_BLOCK_FUNC(maps_data)(const size_t nbytes, const int zero,
+                                     const ins_allocator * allocator) {
+  return zero && nbytes >= INS_DIRECT_MIN_SIZE &&
+         allocator == &ins_malloc_allocator;
+}
+
+static void INS_BLOCK_FUNC(unmap_data)(void * data, void * release_ctx) {
+  const INS_BLOCK_TYPE * block = (const INS_BLOCK_TYPE *) release_ctx;
+  const size_t nbytes = INS_MULTIPLICITY * block->size * sizeof(INS_ATOMIC);
+
+  ins_pages_free(data, nbytes);
+  ins_memory_release(nbytes, block->tag);
+}
+
+static INS_ATOMIC * INS_BLOCK_FUNC(allocate_data)(
+    const size_t count, const int zero, const ins_allocator * allocator,
+    int * tag) {
+  const size_t nitems = INS_MULTIPLICITY * count;
+  const size_t nbytes = nitems * sizeof(INS_ATOMIC);
+  void * data;
+
+  // The check is on `count`, since `nitems` itself may have wrapped for
+  // multi-atom types.
+  if (count > SIZE_MAX / (INS_MULTIPLICITY * sizeof(INS_ATOMIC)) ||
+      ins_memory_reserve(nbytes, tag) != 0) {
+    return 0;
+  }
+
+  if (INS_BLOCK_FUNC(maps_data)(nbytes, zero, allocator)) {
+    // Fresh pages read as zero without being written, and are aligned for
+    // direct I/O.
+    data = ins_pages_alloc(nbytes);
+  } else if (zero && allocator == &ins_malloc_allocator) {
+    // `calloc` may get zeroed pages without writing them.
+    data = calloc(nitems, sizeof(INS_ATOMIC));
+  } else {
+    data = nbytes < INS_DIRECT_MIN_SIZE || allocator->aligned_alloc == 0
+               ? allocator->alloc(nbytes, allocator->context)
+               : allocator->aligned_alloc(INS_DIRECT_ALIGNMENT, nbytes,
+                                          allocator->context);
+
+    if (zero && data != 0) {
+      memset(data, 0, nbytes);
+    }
+  }
+
+  // Zero-count blocks may hold a null pointer, and are counted all the same.
+  ins_memory_commit(nbytes, *tag, data != 0 || nitems == 0);
+
+  return (INS_ATOMIC *) data;
+}
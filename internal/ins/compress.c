@@ -0,0 +1,894 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_container_io.h"
+#include "ins/ins_compress_io.h"
+#include "ins/ins_tuning_io.h"
+#include "ins/internal/config.h"
+
+#ifdef INSIGHT_USE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef INSIGHT_USE_ZSTD
+#include <zstd.h>
+#endif
+
+static const unsigned char ins_compress_magic[8] = {
+  0x89, 'I', 'N', 'Z', '\r', '\n', 0x1a, '\n'
+};
+
+static const uint32_t ins_compress_bom = 0x01020304;
+
+// Flag of the index entries of chunks stored uncompressed.
+#define INS_COMPRESS_STORED (UINT64_C(1) << 63)
+
+// Maximum number of threads decompressing chunks.
+#define INS_COMPRESS_MAX_THREADS 8
+
+int ins_compress_codec_available(const int codec) {
+  switch (codec) {
+    case INS_CODEC_DEFAULT:
+    case INS_CODEC_NONE:
+    case INS_CODEC_RLE:
+      return 1;
+#ifdef INSIGHT_USE_LZ4
+    case INS_CODEC_LZ4:
+      return 1;
+#endif
+#ifdef INSIGHT_USE_ZSTD
+    case INS_CODEC_ZSTD:
+      return 1;
+#endif
+    default:
+      return 0;
+  }
+}
+
+/* Filters
+ --------------------------------------------------------------------------*/
+
+// Byte shuffle of `n` values of `size` bytes: byte `b` of value `i` moves to
+// `dst[b * n + i]`. The size is a constant in each call below so that the
+// inner loops are specialized.
+static inline void ins_shuffle_n(const unsigned char * src,
+                                 unsigned char * dst, const size_t n,
+                                 const size_t size) {
+  size_t b, i;
+
+  for (b = 0; b < size; ++b) {
+    const unsigned char * s = src + b;
+    unsigned char * d = dst + b * n;
+
+    for (i = 0; i < n; ++i) {
+      d[i] = s[i * size];
+    }
+  }
+}
+
+static inline void ins_unshuffle_n(const unsigned char * src,
+                                   unsigned char * dst, const size_t n,
+                                   const size_t size) {
+  size_t b, i;
+
+  for (b = 0; b < size; ++b) {
+    const unsigned char * s = src + b * n;
+    unsigned char * d = dst + b;
+
+    for (i = 0; i < n; ++i) {
+      d[i * size] = s[i];
+    }
+  }
+}
+
+static void ins_shuffle(const unsigned char * src, unsigned char * dst,
+                        const size_t n, const size_t size) {
+  switch (size) {
+    case 2: ins_shuffle_n(src, dst, n, 2); break;
+    case 4: ins_shuffle_n(src, dst, n, 4); break;
+    case 8: ins_shuffle_n(src, dst, n, 8); break;
+    default: ins_shuffle_n(src, dst, n, size); break;
+  }
+}
+
+static void ins_unshuffle(const unsigned char * src, unsigned char * dst,
+                          const size_t n, const size_t size) {
+  switch (size) {
+    case 2: ins_unshuffle_n(src, dst, n, 2); break;
+    case 4: ins_unshuffle_n(src, dst, n, 4); break;
+    case 8: ins_unshuffle_n(src, dst, n, 8); break;
+    default: ins_unshuffle_n(src, dst, n, size); break;
+  }
+}
+
+// Transposes the 8x8 bit matrix whose row `i` is byte `i` of `x`. The
+// transpose is its own inverse.
+static uint64_t ins_transpose8(uint64_t x) {
+  uint64_t t;
+
+  t = (x ^ (x >> 7)) & UINT64_C(0x00AA00AA00AA00AA);
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & UINT64_C(0x0000CCCC0000CCCC);
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & UINT64_C(0x00000000F0F0F0F0);
+  x ^= t ^ (t << 28);
+
+  return x;
+}
+
+// Bit shuffle of byte-shuffled data: each of the `size` byte planes of `n`
+// bytes is split into eight bit planes. The bytes of the planes past the
+// last multiple of eight values are copied as they are. With `inverse` set
+// the bit planes are merged back.
+static void ins_bitshuffle(const unsigned char * src, unsigned char * dst,
+                           const size_t n, const size_t size,
+                           const int inverse) {
+  const size_t groups = n / 8;
+
+  size_t b, g, j;
+
+  for (b = 0; b < size; ++b) {
+    const unsigned char * s = src + b * n;
+    unsigned char * d = dst + b * n;
+
+    for (g = 0; g < groups; ++g) {
+      uint64_t x = 0;
+
+      for (j = 0; j < 8; ++j) {
+        x |= (uint64_t) (inverse ? s[j * groups + g] : s[8 * g + j])
+             << (8 * j);
+      }
+
+      x = ins_transpose8(x);
+
+      for (j = 0; j < 8; ++j) {
+        const unsigned char byte = (unsigned char) (x >> (8 * j));
+        if (inverse) {
+          d[8 * g + j] = byte;
+        } else {
+          d[j * groups + g] = byte;
+        }
+      }
+    }
+
+    memcpy(d + 8 * groups, s + 8 * groups, n - 8 * groups);
+  }
+}
+
+/* Run-length codec
+ --------------------------------------------------------------------------*/
+
+// The stream is a sequence of tokens. A control byte `c` below 128 is
+// followed by `c + 1` literal bytes; otherwise the next byte is repeated
+// `c - 125` times, i.e. runs of 3 to 130 bytes.
+
+#define INS_RLE_MIN_RUN 3
+#define INS_RLE_MAX_RUN 130
+#define INS_RLE_MAX_LITERALS 128
+
+// Appends the literals `src[0, n)` to `dst`. Returns the new output size, or
+// 0 if the output would exceed `capacity`.
+static size_t ins_rle_literals(const unsigned char * src, size_t n,
+                               unsigned char * dst, size_t o,
+                               const size_t capacity) {
+  while (n > 0) {
+    const size_t m = n < INS_RLE_MAX_LITERALS ? n : INS_RLE_MAX_LITERALS;
+
+    if (capacity - o < m + 1) {
+      return 0;
+    }
+
+    dst[o++] = (unsigned char) (m - 1);
+    memcpy(dst + o, src, m);
+    o += m;
+    src += m;
+    n -= m;
+  }
+
+  return o;
+}
+
+// Returns the size of the encoding of `src[0, n)`, or 0 if it would exceed
+// `capacity` bytes.
+static size_t ins_rle_encode(const unsigned char * src, const size_t n,
+                             unsigned char * dst, const size_t capacity) {
+  size_t i = 0;
+  size_t literals = 0;
+  size_t o = 0;
+
+  while (i < n) {
+    const size_t limit = n - i < INS_RLE_MAX_RUN ? n - i : INS_RLE_MAX_RUN;
+    size_t run = 1;
+
+    while (run < limit && src[i + run] == src[i]) {
+      ++run;
+    }
+
+    if (run < INS_RLE_MIN_RUN) {
+      i += run;
+      continue;
+    }
+
+    if (i > literals) {
+      o = ins_rle_literals(src + literals, i - literals, dst, o, capacity);
+      if (o == 0) {
+        return 0;
+      }
+    }
+
+    if (capacity - o < 2) {
+      return 0;
+    }
+
+    dst[o++] = (unsigned char) (run - INS_RLE_MIN_RUN + 128);
+    dst[o++] = src[i];
+    i += run;
+    literals = i;
+  }
+
+  if (n > literals) {
+    o = ins_rle_literals(src + literals, n - literals, dst, o, capacity);
+  }
+
+  return o;
+}
+
+// Decodes `src[0, n)` into exactly `size` bytes. Returns 0 on success and -1
+// if the input is corrupt.
+static int ins_rle_decode(const unsigned char * src, const size_t n,
+                          unsigned char * dst, const size_t size) {
+  size_t i = 0;
+  size_t o = 0;
+
+  while (i < n) {
+    const unsigned c = src[i++];
+
+    if (c < 128) {
+      const size_t m = c + 1;
+      if (n - i < m || size - o < m) {
+        return -1;
+      }
+      memcpy(dst + o, src + i, m);
+      i += m;
+      o += m;
+    } else {
+      const size_t m = c - 128 + INS_RLE_MIN_RUN;
+      if (i == n || size - o < m) {
+        return -1;
+      }
+      memset(dst + o, src[i++], m);
+      o += m;
+    }
+  }
+
+  return o == size ? 0 : -1;
+}
+
+/* Chunks
+ --------------------------------------------------------------------------*/
+
+// Compresses `src[0, n)` into `dst` with `codec`. Returns the compressed
+// size, or 0 if it would not be smaller than `n`.
+static size_t ins_compress_chunk(const uint32_t codec, const int level,
+                                 const unsigned char * src, const size_t n,
+                                 unsigned char * dst) {
+  switch (codec) {
+    case INS_CODEC_RLE:
+      return ins_rle_encode(src, n, dst, n - 1);
+#ifdef INSIGHT_USE_LZ4
+    case INS_CODEC_LZ4: {
+      const int size = LZ4_compress_fast((const char *) src, (char *) dst,
+                                         (int) n, (int) n - 1,
+                                         level > 0 ? level : 1);
+      return size > 0 ? (size_t) size : 0;
+    }
+#endif
+#ifdef INSIGHT_USE_ZSTD
+    case INS_CODEC_ZSTD: {
+      const size_t size = ZSTD_compress(dst, n - 1, src, n, level);
+      return ZSTD_isError(size) ? 0 : size;
+    }
+#endif
+    default:
+      (void) level;
+      return 0;
+  }
+}
+
+// Decompresses the `n` bytes at `src` into exactly `size` bytes at `dst`.
+// Returns 0 on success and -1 if the input is corrupt.
+static int ins_decompress_chunk(const uint32_t codec,
+                                const unsigned char * src, const size_t n,
+                                unsigned char * dst, const size_t size) {
+  switch (codec) {
+    case INS_CODEC_RLE:
+      return ins_rle_decode(src, n, dst, size);
+#ifdef INSIGHT_USE_LZ4
+    case INS_CODEC_LZ4:
+      return LZ4_decompress_safe((const char *) src, (char *) dst, (int) n,
+                                 (int) size) == (int) size ? 0 : -1;
+#endif
+#ifdef INSIGHT_USE_ZSTD
+    case INS_CODEC_ZSTD:
+      return ZSTD_decompress(dst, size, src, n) == size ? 0 : -1;
+#endif
+    default:
+      return -1;
+  }
+}
+
+/* Writer
+ --------------------------------------------------------------------------*/
+
+int ins_compress_writer_init(ins_compress_writer * writer, FILE * stream,
+                             const uint32_t type, const uint32_t elem_size,
+                             const uint32_t value_size, const uint64_t count,
+                             const ins_compress_params * params) {
+  const ins_compress_params defaults = {0, 0, 0, 0};
+  const uint32_t version = INS_COMPRESS_VERSION;
+  const uint64_t reserved = 0;
+
+  unsigned char header[INS_COMPRESS_HEADER_SIZE];
+  size_t chunk_bytes;
+  uint64_t i;
+
+  if (params == 0) {
+    params = &defaults;
+  }
+
+  if (params->filter < INS_FILTER_DEFAULT ||
+      params->filter > INS_FILTER_BITSHUFFLE ||
+      params->codec < INS_CODEC_DEFAULT || params->codec > INS_CODEC_ZSTD) {
+    INS_ERROR("invalid compression parameters", INS_EINVAL);
+  }
+
+  if (!ins_compress_codec_available(params->codec)) {
+    INS_ERROR("compression codec is not available", INS_EUNSUP);
+  }
+
+  writer->stream = stream;
+  writer->elem_size = elem_size;
+  writer->value_size = value_size;
+  writer->filter = params->filter == INS_FILTER_DEFAULT
+                       ? INS_FILTER_SHUFFLE
+                       : (uint32_t) params->filter;
+  writer->level = params->level;
+  writer->codec = (uint32_t) params->codec;
+
+  if (params->codec == INS_CODEC_DEFAULT) {
+#if defined(INSIGHT_USE_ZSTD)
+    writer->codec = INS_CODEC_ZSTD;
+#elif defined(INSIGHT_USE_LZ4)
+    writer->codec = INS_CODEC_LZ4;
+#else
+    writer->codec = INS_CODEC_RLE;
+#endif
+  }
+
+  writer->chunk_size = params->chunk_size;
+
+  if (writer->chunk_size == 0) {
+    writer->chunk_size = INS_COMPRESS_CHUNK / elem_size;
+  }
+
+  // Chunk sizes are bounded by what the codecs take in one call.
+  if (writer->chunk_size > (1U << 30) / elem_size) {
+    INS_ERROR("compression chunk size is too large", INS_EINVAL);
+  }
+
+  writer->num_chunks = (count + writer->chunk_size - 1) / writer->chunk_size;
+  writer->next = 0;
+
+  chunk_bytes = (size_t) writer->chunk_size * elem_size;
+
+  writer->index = (uint64_t *) malloc(
+      (writer->num_chunks > 0 ? 2 * writer->num_chunks : 1) *
+      sizeof(uint64_t));
+  writer->checksums = writer->index + writer->num_chunks;
+  writer->scratch = (unsigned char *) malloc(chunk_bytes);
+  writer->out = (unsigned char *) malloc(chunk_bytes);
+
+  if (writer->index == 0 || writer->scratch == 0 || writer->out == 0) {
+    free(writer->index);
+    free(writer->scratch);
+    free(writer->out);
+    INS_ERROR("failed to allocate space for compression buffers",
+              INS_ENOMEM);
+  }
+
+  memcpy(header, ins_compress_magic, 8);
+  memcpy(header + 8, &ins_compress_bom, 4);
+  memcpy(header + 12, &version, 4);
+  memcpy(header + 16, &type, 4);
+  memcpy(header + 20, &elem_size, 4);
+  memcpy(header + 24, &count, 8);
+  memcpy(header + 32, &writer->chunk_size, 8);
+  memcpy(header + 40, &writer->filter, 4);
+  memcpy(header + 44, &writer->codec, 4);
+  memcpy(header + 48, &writer->num_chunks, 8);
+  memcpy(header + 56, &reserved, 8);
+
+  if (fwrite(header, 1, INS_COMPRESS_HEADER_SIZE, stream)
+      != INS_COMPRESS_HEADER_SIZE) {
+    ins_compress_writer_finish(writer, INS_EFAILED);
+    INS_ERROR("fwrite failed", INS_EFAILED);
+  }
+
+  writer->index_position = ftello(stream);
+
+  if (writer->index_position < 0) {
+    ins_compress_writer_finish(writer, INS_EFAILED);
+    INS_ERROR("fwrite failed", INS_EFAILED);
+  }
+
+  // The index and the checksums are rewritten once the chunks are known.
+  for (i = 0; i < writer->num_chunks; ++i) {
+    if (fwrite(&reserved, 8, 1, stream) != 1 ||
+        fwrite(&reserved, 8, 1, stream) != 1) {
+      ins_compress_writer_finish(writer, INS_EFAILED);
+      INS_ERROR("fwrite failed", INS_EFAILED);
+    }
+  }
+
+  return INS_SUCCESS;
+}
+
+int ins_compress_writer_put(ins_compress_writer * writer, const void * data,
+                            const size_t n) {
+  const size_t nbytes = n * writer->elem_size;
+  const size_t nvalues = nbytes / writer->value_size;
+
+  const unsigned char * src = (const unsigned char *) data;
+  size_t size;
+
+  switch (writer->filter) {
+    case INS_FILTER_SHUFFLE:
+      ins_shuffle(src, writer->scratch, nvalues, writer->value_size);
+      src = writer->scratch;
+      break;
+    case INS_FILTER_BITSHUFFLE:
+      ins_shuffle(src, writer->out, nvalues, writer->value_size);
+      ins_bitshuffle(writer->out, writer->scratch, nvalues,
+                     writer->value_size, 0);
+      src = writer->scratch;
+      break;
+    default:
+      break;
+  }
+
+  size = ins_compress_chunk(writer->codec, writer->level, src, nbytes,
+                            writer->out);
+
+  if (size > 0) {
+    writer->index[writer->next] = size;
+    src = writer->out;
+  } else {
+    writer->index[writer->next] = nbytes | INS_COMPRESS_STORED;
+    size = nbytes;
+  }
+
+  writer->checksums[writer->next] = ins_container_checksum(src, size);
+  ++writer->next;
+
+  if (fwrite(src, 1, size, writer->stream) != size) {
+    INS_ERROR("fwrite failed", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+int ins_compress_writer_finish(ins_compress_writer * writer,
+                               const int status) {
+  const size_t num_chunks = (size_t) writer->num_chunks;
+
+  int failed;
+
+  if (status != INS_SUCCESS) {
+    free(writer->index);
+    free(writer->scratch);
+    free(writer->out);
+    return status;
+  }
+
+  failed =
+      fseeko(writer->stream, writer->index_position, SEEK_SET) != 0 ||
+      fwrite(writer->index, 8, num_chunks, writer->stream) != num_chunks ||
+      fwrite(writer->checksums, 8, num_chunks, writer->stream)
+          != num_chunks ||
+      fseeko(writer->stream, 0, SEEK_END) != 0;
+
+  free(writer->index);
+  free(writer->scratch);
+  free(writer->out);
+
+  if (failed) {
+    INS_ERROR("failed to write compressed file index", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+/* Reader
+ --------------------------------------------------------------------------*/
+
+static uint32_t ins_compress_load32(const unsigned char * p, const int swap) {
+  uint32_t x;
+
+  memcpy(&x, p, 4);
+  if (swap) {
+    ins_byteswap(&x, 1, 4);
+  }
+
+  return x;
+}
+
+static uint64_t ins_compress_load64(const unsigned char * p, const int swap) {
+  uint64_t x;
+
+  memcpy(&x, p, 8);
+  if (swap) {
+    ins_byteswap(&x, 1, 8);
+  }
+
+  return x;
+}
+
+// Skips `nbytes` bytes of `stream`, reading them if the stream cannot seek.
+static int ins_compress_skip(FILE * stream, uint64_t nbytes) {
+  unsigned char buf[4096];
+
+  if (nbytes == 0 || fseeko(stream, (off_t) nbytes, SEEK_CUR) == 0) {
+    return 0;
+  }
+
+  while (nbytes > 0) {
+    const size_t n = nbytes < sizeof(buf) ? (size_t) nbytes : sizeof(buf);
+    if (fread(buf, 1, n, stream) != n) {
+      return -1;
+    }
+    nbytes -= n;
+  }
+
+  return 0;
+}
+
+int ins_compress_reader_open(ins_compress_reader * reader, FILE * stream,
+                             const uint32_t type, const uint32_t elem_size,
+                             const uint32_t value_size) {
+  unsigned char header[INS_COMPRESS_HEADER_SIZE];
+  uint32_t bom;
+  uint32_t version;
+  uint64_t i;
+  int swap;
+
+  if (fread(header, 1, INS_COMPRESS_HEADER_SIZE, stream)
+      != INS_COMPRESS_HEADER_SIZE) {
+    INS_ERROR("fread failed", INS_EFAILED);
+  }
+
+  if (memcmp(header, ins_compress_magic, 8) != 0) {
+    INS_ERROR("not an insight compressed file", INS_EFAILED);
+  }
+
+  memcpy(&bom, header + 8, 4);
+  swap = bom != ins_compress_bom;
+
+  if (ins_compress_load32(header + 8, swap) != ins_compress_bom) {
+    INS_ERROR("invalid compressed file byte order mark", INS_EFAILED);
+  }
+
+  version = ins_compress_load32(header + 12, swap);
+
+  if (version > INS_COMPRESS_VERSION) {
+    INS_ERROR("unsupported compressed file version", INS_EUNSUP);
+  }
+
+  if (ins_compress_load32(header + 16, swap) != type ||
+      ins_compress_load32(header + 20, swap) != elem_size) {
+    INS_ERROR("compressed file element type does not match", INS_EINVAL);
+  }
+
+  reader->stream = stream;
+  reader->elem_size = elem_size;
+  reader->value_size = value_size;
+  reader->count = ins_compress_load64(header + 24, swap);
+  reader->chunk_size = ins_compress_load64(header + 32, swap);
+  reader->filter = ins_compress_load32(header + 40, swap);
+  reader->codec = ins_compress_load32(header + 44, swap);
+  reader->num_chunks = ins_compress_load64(header + 48, swap);
+  reader->swap = swap;
+
+  if (reader->filter < INS_FILTER_NONE ||
+      reader->filter > INS_FILTER_BITSHUFFLE ||
+      reader->codec < INS_CODEC_NONE || reader->codec > INS_CODEC_ZSTD ||
+      reader->chunk_size == 0 ||
+      reader->chunk_size > (1U << 30) / elem_size ||
+      reader->num_chunks != reader->count / reader->chunk_size +
+                                (reader->count % reader->chunk_size != 0)) {
+    INS_ERROR("corrupt compressed file header", INS_EFAILED);
+  }
+
+  if (!ins_compress_codec_available((int) reader->codec)) {
+    INS_ERROR("compression codec is not available", INS_EUNSUP);
+  }
+
+  reader->offsets = (uint64_t *) malloc(
+      (size_t) (reader->num_chunks + 1) * sizeof(uint64_t));
+  reader->stored = (unsigned char *) malloc(
+      (size_t) (reader->num_chunks > 0 ? reader->num_chunks : 1));
+  reader->checksums = 0;
+
+  // Files of the first version have no checksums.
+  if (version >= 2) {
+    reader->checksums = (uint64_t *) malloc(
+        (size_t) (reader->num_chunks > 0 ? reader->num_chunks : 1) *
+        sizeof(uint64_t));
+  }
+
+  if (reader->offsets == 0 || reader->stored == 0 ||
+      (version >= 2 && reader->checksums == 0)) {
+    ins_compress_reader_close(reader);
+    INS_ERROR("failed to allocate space for compressed file index",
+              INS_ENOMEM);
+  }
+
+  if (fread(reader->offsets + 1, 8, (size_t) reader->num_chunks, stream)
+      != reader->num_chunks ||
+      (reader->checksums != 0 &&
+       fread(reader->checksums, 8, (size_t) reader->num_chunks, stream)
+       != reader->num_chunks)) {
+    ins_compress_reader_close(reader);
+    INS_ERROR("fread failed", INS_EFAILED);
+  }
+
+  if (reader->checksums != 0 && swap) {
+    ins_byteswap(reader->checksums, (size_t) reader->num_chunks, 8);
+  }
+
+  reader->offsets[0] = 0;
+
+  for (i = 0; i < reader->num_chunks; ++i) {
+    const uint64_t raw = (i + 1 < reader->num_chunks
+                              ? reader->chunk_size
+                              : reader->count - i * reader->chunk_size) *
+                         elem_size;
+    uint64_t entry = reader->offsets[i + 1];
+
+    if (swap) {
+      ins_byteswap(&entry, 1, 8);
+    }
+
+    reader->stored[i] = (entry & INS_COMPRESS_STORED) != 0;
+    entry &= ~INS_COMPRESS_STORED;
+
+    // A chunk is never larger than its elements.
+    if (entry > raw || (reader->stored[i] && entry != raw)) {
+      ins_compress_reader_close(reader);
+      INS_ERROR("corrupt compressed file index", INS_EFAILED);
+    }
+
+    reader->offsets[i + 1] = reader->offsets[i] + entry;
+  }
+
+  return INS_SUCCESS;
+}
+
+void ins_compress_reader_close(ins_compress_reader * reader) {
+  free(reader->offsets);
+  free(reader->stored);
+  free(reader->checksums);
+}
+
+// The chunks of a read, shared by the decompressing threads.
+typedef struct {
+  const ins_compress_reader * reader;
+
+  // The compressed bytes of chunks `[first_chunk, last_chunk]`.
+  const unsigned char * payload;
+  uint64_t first_chunk;
+  uint64_t last_chunk;
+
+  // The elements `[first, first + n)` are stored at `data`.
+  uint64_t first;
+  uint64_t n;
+  unsigned char * data;
+
+  // The next chunk to decompress, and the status of the read.
+  uint64_t next;
+  int status;
+} ins_compress_job;
+
+// Decompresses chunk `c` into the `nbytes` bytes at `dst`, using the two
+// scratch buffers `a` and `b` of one chunk each.
+static int ins_compress_decode(const ins_compress_job * job, const uint64_t c,
+                               unsigned char * dst, const size_t nbytes,
+                               unsigned char * a, unsigned char * b) {
+  const ins_compress_reader * reader = job->reader;
+  const unsigned char * src =
+      job->payload + (reader->offsets[c] - reader->offsets[job->first_chunk]);
+  const size_t size = (size_t) (reader->offsets[c + 1] - reader->offsets[c]);
+  const size_t nvalues = nbytes / reader->value_size;
+
+  unsigned char * filtered = reader->filter == INS_FILTER_NONE ? dst : a;
+
+  if (reader->checksums != 0 &&
+      ins_container_checksum(src, size) != reader->checksums[c]) {
+    return -1;
+  }
+
+  if (reader->stored[c]) {
+    if (reader->filter == INS_FILTER_NONE) {
+      memcpy(dst, src, nbytes);
+    } else {
+      filtered = (unsigned char *) src;
+    }
+  } else if (ins_decompress_chunk(reader->codec, src, size, filtered,
+                                  nbytes) != 0) {
+    return -1;
+  }
+
+  switch (reader->filter) {
+    case INS_FILTER_SHUFFLE:
+      ins_unshuffle(filtered, dst, nvalues, reader->value_size);
+      break;
+    case INS_FILTER_BITSHUFFLE:
+      ins_bitshuffle(filtered, b, nvalues, reader->value_size, 1);
+      ins_unshuffle(b, dst, nvalues, reader->value_size);
+      break;
+    default:
+      break;
+  }
+
+  if (reader->swap) {
+    ins_byteswap(dst, nvalues, reader->value_size);
+  }
+
+  return 0;
+}
+
+static void * ins_compress_worker(void * arg) {
+  ins_compress_job * job = (ins_compress_job *) arg;
+  const ins_compress_reader * reader = job->reader;
+  const size_t elem_size = reader->elem_size;
+  const size_t chunk_bytes = (size_t) reader->chunk_size * elem_size;
+
+  unsigned char * scratch = (unsigned char *) malloc(3 * chunk_bytes);
+
+  if (scratch == 0) {
+    __atomic_store_n(&job->status, INS_ENOMEM, __ATOMIC_RELAXED);
+    return 0;
+  }
+
+  for (;;) {
+    const uint64_t c = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+    uint64_t begin, end, lo, hi;
+    unsigned char * dst;
+
+    if (c > job->last_chunk) {
+      break;
+    }
+
+    begin = c * reader->chunk_size;
+    end = begin + reader->chunk_size < reader->count
+              ? begin + reader->chunk_size
+              : reader->count;
+    lo = begin > job->first ? begin : job->first;
+    hi = end < job->first + job->n ? end : job->first + job->n;
+
+    // Chunks inside the range are decompressed in place; the chunks at the
+    // ends of a range go through the third scratch buffer.
+    dst = lo == begin && hi == end
+              ? job->data + (size_t) (begin - job->first) * elem_size
+              : scratch + 2 * chunk_bytes;
+
+    if (ins_compress_decode(job, c, dst, (size_t) (end - begin) * elem_size,
+                            scratch, scratch + chunk_bytes) != 0) {
+      __atomic_store_n(&job->status, INS_EFAILED, __ATOMIC_RELAXED);
+      break;
+    }
+
+    if (dst == scratch + 2 * chunk_bytes) {
+      memcpy(job->data + (size_t) (lo - job->first) * elem_size,
+             dst + (size_t) (lo - begin) * elem_size,
+             (size_t) (hi - lo) * elem_size);
+    }
+  }
+
+  free(scratch);
+  return 0;
+}
+
+int ins_compress_reader_read(ins_compress_reader * reader,
+                             const uint64_t first, const size_t n,
+                             void * data) {
+  ins_compress_job job;
+  pthread_t threads[INS_COMPRESS_MAX_THREADS];
+  unsigned char * payload;
+  uint64_t num_threads;
+  uint64_t started = 0;
+  uint64_t i;
+  size_t size;
+  long cpus;
+
+  if (n == 0) {
+    const int failed = ins_compress_skip(reader->stream,
+                                         reader->offsets[reader->num_chunks]);
+    ins_compress_reader_close(reader);
+    if (failed) {
+      INS_ERROR("fread failed", INS_EFAILED);
+    }
+    return INS_SUCCESS;
+  }
+
+  job.reader = reader;
+  job.first_chunk = first / reader->chunk_size;
+  job.last_chunk = (first + n - 1) / reader->chunk_size;
+  job.first = first;
+  job.n = n;
+  job.data = (unsigned char *) data;
+  job.next = job.first_chunk;
+  job.status = INS_SUCCESS;
+
+  size = (size_t) (reader->offsets[job.last_chunk + 1] -
+                   reader->offsets[job.first_chunk]);
+  payload = (unsigned char *) malloc(size > 0 ? size : 1);
+
+  if (payload == 0) {
+    ins_compress_reader_close(reader);
+    INS_ERROR("failed to allocate space for compressed chunks", INS_ENOMEM);
+  }
+
+  // Only the chunks of the range are read, and the stream is left after the
+  // last chunk of the file.
+  if (ins_compress_skip(reader->stream, reader->offsets[job.first_chunk]) ||
+      fread(payload, 1, size, reader->stream) != size ||
+      ins_compress_skip(reader->stream,
+                        reader->offsets[reader->num_chunks] -
+                            reader->offsets[job.last_chunk + 1])) {
+    free(payload);
+    ins_compress_reader_close(reader);
+    INS_ERROR("fread failed", INS_EFAILED);
+  }
+
+  job.payload = payload;
+
+  cpus = ins_tuning_threads();
+  num_threads = job.last_chunk - job.first_chunk + 1;
+
+  if (cpus > 0 && num_threads > (uint64_t) cpus) {
+    num_threads = (uint64_t) cpus;
+  }
+
+  if (num_threads > INS_COMPRESS_MAX_THREADS) {
+    num_threads = INS_COMPRESS_MAX_THREADS;
+  }
+
+  // The calling thread is one of the workers.
+  for (i = 1; i < num_threads; ++i) {
+    if (pthread_create(&threads[started], 0, ins_compress_worker, &job)
+        == 0) {
+      ++started;
+    }
+  }
+
+  ins_compress_worker(&job);
+
+  for (i = 0; i < started; ++i) {
+    pthread_join(threads[i], 0);
+  }
+
+  free(payload);
+  ins_compress_reader_close(reader);
+
+  if (job.status == INS_ENOMEM) {
+    INS_ERROR("failed to allocate space for decompression", INS_ENOMEM);
+  }
+
+  if (job.status != INS_SUCCESS) {
+    INS_ERROR("corrupt compressed chunk", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
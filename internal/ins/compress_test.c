@@ -0,0 +1,223 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+
+static void fill(ins_vector *v) {
+  size_t i;
+  for (i = 0; i < v->size; ++i) {
+    // Slowly varying values with a few noisy low-order bits.
+    ins_vector_set(v, i, 1000.0 + 0.001 * (double) i + (double) (i % 7) / 64);
+  }
+}
+
+static void test_round_trip(void **state) {
+  (void) state;
+
+  static const int filters[] = {
+    INS_FILTER_DEFAULT, INS_FILTER_NONE, INS_FILTER_SHUFFLE,
+    INS_FILTER_BITSHUFFLE
+  };
+  static const int codecs[] = {
+    INS_CODEC_DEFAULT, INS_CODEC_NONE, INS_CODEC_RLE, INS_CODEC_LZ4,
+    INS_CODEC_ZSTD
+  };
+
+  const size_t n = 10007;
+  ins_vector *v = ins_vector_alloc(n);
+  ins_vector *w = ins_vector_alloc(n);
+  size_t f, c;
+
+  fill(v);
+
+  for (f = 0; f < sizeof(filters) / sizeof(filters[0]); ++f) {
+    for (c = 0; c < sizeof(codecs) / sizeof(codecs[0]); ++c) {
+      ins_compress_params params = {0, 0, 0, 0};
+      params.filter = filters[f];
+      params.codec = codecs[c];
+      params.chunk_size = 1000;
+
+      if (!ins_compress_codec_available(params.codec)) {
+        continue;
+      }
+
+      FILE *file = fopen("compress.dat", "w+b");
+      assert_int_equal(ins_vector_fwrite_compressed(v, file, &params),
+                       INS_SUCCESS);
+      const long size = ftell(file);
+
+      rewind(file);
+      ins_vector_set_zero(w);
+      assert_int_equal(ins_vector_fread_compressed(w, file), INS_SUCCESS);
+      assert_int_equal(ftell(file), size);
+      fclose(file);
+
+      assert_memory_equal(w->data, v->data, n * sizeof(double));
+
+      // The high-order bytes compress with every codec.
+      if (params.codec != INS_CODEC_NONE &&
+          params.filter != INS_FILTER_NONE) {
+        assert_true((size_t) size < n * sizeof(double) * 3 / 4);
+      }
+    }
+  }
+
+  ins_vector_free(w);
+  ins_vector_free(v);
+}
+
+static void test_strided_and_complex(void **state) {
+  (void) state;
+
+  const size_t n = 999;
+  ins_vector_float *v = ins_vector_float_alloc(3 * n);
+  ins_vector_float *w = ins_vector_float_calloc(2 * n);
+  size_t i;
+
+  for (i = 0; i < 3 * n; ++i) {
+    ins_vector_float_set(v, i, (float) (i / 10));
+  }
+
+  ins_vector_float *a = ins_vector_float_alloc_from_vector(v, 2, n, 3);
+  ins_vector_float *b = ins_vector_float_alloc_from_vector(w, 1, n, 2);
+  ins_compress_params params = {INS_FILTER_BITSHUFFLE, INS_CODEC_RLE, 0, 100};
+
+  ins_vector_complex *c = ins_vector_complex_alloc(300);
+  ins_vector_complex *d = ins_vector_complex_alloc(300);
+  for (i = 0; i < 600; ++i) {
+    c->data[i] = (double) (i % 5) - 2.5;
+  }
+
+  // Both files are written to and read from the same stream.
+  FILE *file = fopen("compress.dat", "w+b");
+  assert_int_equal(ins_vector_float_fwrite_compressed(a, file, &params),
+                   INS_SUCCESS);
+  assert_int_equal(ins_vector_complex_fwrite_compressed(c, file, NULL),
+                   INS_SUCCESS);
+  rewind(file);
+  assert_int_equal(ins_vector_float_fread_compressed(b, file), INS_SUCCESS);
+  assert_int_equal(ins_vector_complex_fread_compressed(d, file),
+                   INS_SUCCESS);
+  fclose(file);
+
+  for (i = 0; i < n; ++i) {
+    assert_true(ins_vector_float_get(w, 2 * i + 1) ==
+                ins_vector_float_get(v, 3 * i + 2));
+    assert_true(ins_vector_float_get(w, 2 * i) == 0.0F);
+  }
+  assert_memory_equal(d->data, c->data, 600 * sizeof(double));
+
+  ins_vector_complex_free(d);
+  ins_vector_complex_free(c);
+  ins_vector_float_free(b);
+  ins_vector_float_free(a);
+  ins_vector_float_free(w);
+  ins_vector_float_free(v);
+}
+
+static void test_range(void **state) {
+  (void) state;
+
+  const size_t n = 5000;
+  ins_vector_int *v = ins_vector_int_alloc(n);
+  ins_compress_params params = {0, 0, 0, 128};
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    ins_vector_int_set(v, i, (int) (i * 3));
+  }
+
+  FILE *file = fopen("compress.dat", "w+b");
+  assert_int_equal(ins_vector_int_fwrite_compressed(v, file, &params),
+                   INS_SUCCESS);
+  const long size = ftell(file);
+
+  // Ranges inside one chunk, across chunk boundaries, and at the ends.
+  static const size_t ranges[][2] = {
+    {0, 1}, {5, 50}, {100, 300}, {128, 128}, {4990, 10}, {0, 5000}, {77, 0}
+  };
+  size_t r;
+  for (r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r) {
+    ins_vector_int *w = ins_vector_int_alloc(ranges[r][1]);
+    rewind(file);
+    assert_int_equal(ins_vector_int_fread_compressed_range(w, file,
+                                                           ranges[r][0]),
+                     INS_SUCCESS);
+    assert_int_equal(ftell(file), size);
+    for (i = 0; i < w->size; ++i) {
+      assert_int_equal(ins_vector_int_get(w, i), 3 * (int) (ranges[r][0] + i));
+    }
+    ins_vector_int_free(w);
+  }
+
+  fclose(file);
+  ins_vector_int_free(v);
+}
+
+static void test_errors(void **state) {
+  (void) state;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+
+  ins_vector *v = ins_vector_alloc(100);
+  ins_vector *w = ins_vector_alloc(101);
+  ins_vector_float *f = ins_vector_float_alloc(100);
+  ins_compress_params params = {0, 0, 0, 0};
+  fill(v);
+
+  FILE *file = fopen("compress.dat", "w+b");
+  params.codec = 99;
+  assert_int_equal(ins_vector_fwrite_compressed(v, file, &params),
+                   INS_EINVAL);
+  assert_int_equal(ftell(file), 0);
+
+  assert_int_equal(ins_vector_fwrite_compressed(v, file, NULL), INS_SUCCESS);
+
+  rewind(file);
+  assert_int_equal(ins_vector_fread_compressed(w, file), INS_EBADLEN);
+  rewind(file);
+  assert_int_equal(ins_vector_fread_compressed_range(v, file, 1),
+                   INS_EBADLEN);
+  rewind(file);
+  assert_int_equal(ins_vector_float_fread_compressed(f, file), INS_EINVAL);
+
+  // A corrupt chunk is detected.
+  fseek(file, -3, SEEK_END);
+  fputc(0xff, file);
+  fputc(0xff, file);
+  rewind(file);
+  assert_int_equal(ins_vector_fread_compressed(v, file), INS_EFAILED);
+  fclose(file);
+
+  // So is a changed byte of a chunk stored without compression, whose
+  // length does not depend on its contents.
+  file = tmpfile();
+  params.codec = INS_CODEC_NONE;
+  assert_int_equal(ins_vector_fwrite_compressed(v, file, &params),
+                   INS_SUCCESS);
+  fseek(file, -8, SEEK_END);
+  fputc(0x5a, file);
+  rewind(file);
+  assert_int_equal(ins_vector_fread_compressed(v, file), INS_EFAILED);
+  fclose(file);
+
+  ins_set_error_handler(handler);
+
+  ins_vector_float_free(f);
+  ins_vector_free(w);
+  ins_vector_free(v);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_round_trip),
+    cmocka_unit_test(test_strided_and_complex),
+    cmocka_unit_test(test_range),
+    cmocka_unit_test(test_errors)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
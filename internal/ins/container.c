@@ -0,0 +1,304 @@
+#include <string.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_container_io.h"
+
+static const unsigned char ins_container_magic[8] = {
+  0x89, 'I', 'N', 'S', '\r', '\n', 0x1a, '\n'
+};
+
+static const uint32_t ins_container_bom = 0x01020304;
+
+/* Byte order
+ --------------------------------------------------------------------------*/
+
+int ins_host_big_endian(void) {
+  const uint32_t one = 1;
+  unsigned char first;
+
+  memcpy(&first, &one, 1);
+  return first == 0;
+}
+
+static uint16_t ins_bswap16(const uint16_t x) {
+  return (uint16_t) ((x >> 8) | (x << 8));
+}
+
+static uint32_t ins_bswap32(const uint32_t x) {
+  return ((x & 0x000000ffU) << 24) | ((x & 0x0000ff00U) << 8) |
+         ((x & 0x00ff0000U) >> 8) | ((x & 0xff000000U) >> 24);
+}
+
+static uint64_t ins_bswap64(const uint64_t x) {
+  return ((uint64_t) ins_bswap32((uint32_t) x) << 32) |
+         ins_bswap32((uint32_t) (x >> 32));
+}
+
+void ins_byteswap(void * data, const size_t count, const size_t size) {
+  unsigned char * p = (unsigned char *) data;
+
+  size_t i;
+
+  // Values are moved through `memcpy` so that `data` needs no alignment.
+  if (size == 2) {
+    uint16_t x;
+    for (i = 0; i < count; ++i, p += 2) {
+      memcpy(&x, p, 2);
+      x = ins_bswap16(x);
+      memcpy(p, &x, 2);
+    }
+  } else if (size == 4) {
+    uint32_t x;
+    for (i = 0; i < count; ++i, p += 4) {
+      memcpy(&x, p, 4);
+      x = ins_bswap32(x);
+      memcpy(p, &x, 4);
+    }
+  } else if (size == 8) {
+    uint64_t x;
+    for (i = 0; i < count; ++i, p += 8) {
+      memcpy(&x, p, 8);
+      x = ins_bswap64(x);
+      memcpy(p, &x, 8);
+    }
+  }
+}
+
+/* Checksum
+ --------------------------------------------------------------------------*/
+
+void ins_checksum_init(ins_checksum_state * state) {
+  memset(state, 0, sizeof(ins_checksum_state));
+}
+
+// Runs the lanes over `nblocks` full blocks of `INS_CHECKSUM_BLOCK` bytes.
+// The lanes are independent, so the inner loop maps onto vector registers.
+static void ins_checksum_blocks(ins_checksum_state * state,
+                                const unsigned char * data,
+                                const size_t nblocks,
+                                const int swap) {
+  uint64_t a[INS_CHECKSUM_LANES];
+  uint64_t b[INS_CHECKSUM_LANES];
+  uint32_t w[INS_CHECKSUM_LANES];
+
+  size_t i;
+  int l;
+
+  memcpy(a, state->a, sizeof(a));
+  memcpy(b, state->b, sizeof(b));
+
+  for (i = 0; i < nblocks; ++i, data += INS_CHECKSUM_BLOCK) {
+    memcpy(w, data, INS_CHECKSUM_BLOCK);
+
+    if (swap) {
+      for (l = 0; l < INS_CHECKSUM_LANES; ++l) {
+        w[l] = ins_bswap32(w[l]);
+      }
+    }
+
+    for (l = 0; l < INS_CHECKSUM_LANES; ++l) {
+      a[l] += w[l];
+      b[l] += a[l];
+    }
+  }
+
+  memcpy(state->a, a, sizeof(a));
+  memcpy(state->b, b, sizeof(b));
+}
+
+void ins_checksum_update(ins_checksum_state * state, const void * data,
+                         const size_t nbytes) {
+  const unsigned char * p = (const unsigned char *) data;
+  const size_t nblocks = nbytes / INS_CHECKSUM_BLOCK;
+  const size_t tail = nbytes % INS_CHECKSUM_BLOCK;
+  const int swap = ins_host_big_endian();
+
+  ins_checksum_blocks(state, p, nblocks, swap);
+
+  // The trailing partial block is zero-padded.
+  if (tail > 0) {
+    unsigned char last[INS_CHECKSUM_BLOCK] = {0};
+    memcpy(last, p + nblocks * INS_CHECKSUM_BLOCK, tail);
+    ins_checksum_blocks(state, last, 1, swap);
+  }
+
+  state->nbytes += nbytes;
+}
+
+uint64_t ins_checksum_final(const ins_checksum_state * state) {
+  // Folds the lanes together with the FNV-1a 64-bit prime, and the length
+  // so that trailing zeros are not lost in the padding.
+  const uint64_t prime = 0x100000001b3ULL;
+  uint64_t h = 0xcbf29ce484222325ULL ^ state->nbytes;
+
+  int l;
+
+  for (l = 0; l < INS_CHECKSUM_LANES; ++l) {
+    h = (h ^ state->a[l]) * prime;
+    h = (h ^ state->b[l]) * prime;
+  }
+
+  return h;
+}
+
+uint64_t ins_container_checksum(const void * data, const size_t nbytes) {
+  ins_checksum_state state;
+
+  ins_checksum_init(&state);
+  ins_checksum_update(&state, data, nbytes);
+  return ins_checksum_final(&state);
+}
+
+/* Header
+ --------------------------------------------------------------------------*/
+
+// Returns the offset of the payload, i.e. the header size rounded up to the
+// payload alignment.
+static uint64_t ins_container_payload_offset(void) {
+  return (INS_CONTAINER_HEADER_SIZE + INS_CONTAINER_ALIGNMENT - 1) /
+         INS_CONTAINER_ALIGNMENT * INS_CONTAINER_ALIGNMENT;
+}
+
+int ins_container_write_header(FILE * stream, const uint32_t type,
+                               const uint32_t elem_size, const uint64_t count,
+                               const uint64_t checksum) {
+  const uint32_t version = INS_CONTAINER_VERSION;
+  const uint32_t alignment = INS_CONTAINER_ALIGNMENT;
+  const uint32_t reserved = 0;
+  const uint64_t payload_offset = ins_container_payload_offset();
+  const uint64_t payload_size = count * elem_size;
+
+  unsigned char header[INS_CONTAINER_HEADER_SIZE];
+  unsigned char zeros[256] = {0};
+  uint64_t padding;
+
+  memcpy(header, ins_container_magic, 8);
+  memcpy(header + 8, &ins_container_bom, 4);
+  memcpy(header + 12, &version, 4);
+  memcpy(header + 16, &type, 4);
+  memcpy(header + 20, &elem_size, 4);
+  memcpy(header + 24, &count, 8);
+  memcpy(header + 32, &payload_offset, 8);
+  memcpy(header + 40, &payload_size, 8);
+  memcpy(header + 48, &checksum, 8);
+  memcpy(header + 56, &alignment, 4);
+  memcpy(header + 60, &reserved, 4);
+
+  if (fwrite(header, 1, INS_CONTAINER_HEADER_SIZE, stream)
+      != INS_CONTAINER_HEADER_SIZE) {
+    INS_ERROR("fwrite failed", INS_EFAILED);
+  }
+
+  padding = payload_offset - INS_CONTAINER_HEADER_SIZE;
+
+  while (padding > 0) {
+    const size_t n = padding < sizeof(zeros) ? (size_t) padding
+                                             : sizeof(zeros);
+    if (fwrite(zeros, 1, n, stream) != n) {
+      INS_ERROR("fwrite failed", INS_EFAILED);
+    }
+    padding -= n;
+  }
+
+  return INS_SUCCESS;
+}
+
+int ins_container_read_header(FILE * stream, ins_container_header * header) {
+  unsigned char raw[INS_CONTAINER_HEADER_SIZE];
+  uint32_t bom;
+  int swap;
+
+  if (fread(raw, 1, INS_CONTAINER_HEADER_SIZE, stream)
+      != INS_CONTAINER_HEADER_SIZE) {
+    INS_ERROR("fread failed", INS_EFAILED);
+  }
+
+  if (memcmp(raw, ins_container_magic, 8) != 0) {
+    INS_ERROR("not an insight container", INS_EFAILED);
+  }
+
+  memcpy(&bom, raw + 8, 4);
+
+  if (bom == ins_container_bom) {
+    swap = 0;
+  } else if (bom == ins_bswap32(ins_container_bom)) {
+    swap = 1;
+  } else {
+    INS_ERROR("invalid container byte order mark", INS_EFAILED);
+  }
+
+  memcpy(&header->version, raw + 12, 4);
+  memcpy(&header->type, raw + 16, 4);
+  memcpy(&header->elem_size, raw + 20, 4);
+  memcpy(&header->count, raw + 24, 8);
+  memcpy(&header->payload_offset, raw + 32, 8);
+  memcpy(&header->payload_size, raw + 40, 8);
+  memcpy(&header->checksum, raw + 48, 8);
+  memcpy(&header->alignment, raw + 56, 4);
+
+  if (swap) {
+    header->version = ins_bswap32(header->version);
+    header->type = ins_bswap32(header->type);
+    header->elem_size = ins_bswap32(header->elem_size);
+    header->count = ins_bswap64(header->count);
+    header->payload_offset = ins_bswap64(header->payload_offset);
+    header->payload_size = ins_bswap64(header->payload_size);
+    header->checksum = ins_bswap64(header->checksum);
+    header->alignment = ins_bswap32(header->alignment);
+  }
+
+  header->big_endian = swap ? !ins_host_big_endian() : ins_host_big_endian();
+
+  if (header->version > INS_CONTAINER_VERSION) {
+    INS_ERROR("unsupported container version", INS_EUNSUP);
+  }
+
+  if (header->payload_offset < INS_CONTAINER_HEADER_SIZE ||
+      header->elem_size == 0 ||
+      header->payload_size / header->elem_size != header->count ||
+      header->payload_size % header->elem_size != 0) {
+    INS_ERROR("corrupt container header", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+int ins_container_query(const char * path, ins_container_header * header) {
+  FILE * stream = fopen(path, "rb");
+  int status;
+
+  if (stream == 0) {
+    INS_ERROR("failed to open file", INS_EFAILED);
+  }
+
+  status = ins_container_read_header(stream, header);
+  fclose(stream);
+
+  return status;
+}
+
+int ins_container_check_type(const ins_container_header * header,
+                             const uint32_t type, const uint32_t elem_size) {
+  if (header->type != type || header->elem_size != elem_size) {
+    INS_ERROR("container element type does not match", INS_EINVAL);
+  }
+
+  return INS_SUCCESS;
+}
+
+int ins_container_skip_padding(FILE * stream,
+                               const ins_container_header * header) {
+  unsigned char buf[256];
+  uint64_t padding = header->payload_offset - INS_CONTAINER_HEADER_SIZE;
+
+  // The padding is read rather than skipped with `fseek` so that containers
+  // can be read from pipes.
+  while (padding > 0) {
+    const size_t n = padding < sizeof(buf) ? (size_t) padding : sizeof(buf);
+    if (fread(buf, 1, n, stream) != n) {
+      INS_ERROR("fread failed", INS_EFAILED);
+    }
+    padding -= n;
+  }
+
+  return INS_SUCCESS;
+}
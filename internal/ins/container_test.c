@@ -0,0 +1,257 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <string.h>
+#include <cmocka.h>
+#include <ins/ins_block.h>
+#include <ins/ins_vector.h>
+#include <ins/ins_container.h>
+
+static void test_block_round_trip(void **state) {
+  (void) state;
+
+  ins_block_float *b = ins_block_float_alloc(5);
+  size_t i;
+  for (i = 0; i < 5; ++i) {
+    b->data[i] = 0.5F * (float) i - 1.0F;
+  }
+
+  FILE *file = fopen("container_block.ins", "wb");
+  assert_int_equal(ins_block_float_fwrite_ins(b, file), INS_SUCCESS);
+  fclose(file);
+
+  ins_container_header header;
+  assert_int_equal(ins_container_query("container_block.ins", &header),
+                   INS_SUCCESS);
+  assert_int_equal(header.version, INS_CONTAINER_VERSION);
+  assert_int_equal(header.type, INS_TYPE_FLOAT);
+  assert_int_equal(header.elem_size, sizeof(float));
+  assert_int_equal(header.count, 5);
+  assert_int_equal(header.payload_offset % INS_CONTAINER_ALIGNMENT, 0);
+  assert_int_equal(header.payload_size, 5 * sizeof(float));
+  assert_true(header.checksum ==
+              ins_container_checksum(b->data, 5 * sizeof(float)));
+
+  ins_block_float *c = ins_block_float_calloc(5);
+  file = fopen("container_block.ins", "rb");
+  assert_int_equal(ins_block_float_fread_ins(c, file, INS_CONTAINER_VERIFY),
+                   INS_SUCCESS);
+  fclose(file);
+  assert_memory_equal(c->data, b->data, 5 * sizeof(float));
+
+  ins_block_float_free(c);
+  ins_block_float_free(b);
+}
+
+static void test_vector_strided_round_trip(void **state) {
+  (void) state;
+
+  // Large enough to span several staging chunks.
+  const size_t n = 20000;
+  ins_vector *v = ins_vector_alloc(2 * n);
+  ins_vector *s = ins_vector_alloc_from_vector(v, 1, n, 2);
+  size_t i;
+  for (i = 0; i < n; ++i) {
+    ins_vector_set(s, i, (double) i * 0.25);
+  }
+
+  FILE *file = fopen("container_vector.ins", "wb");
+  assert_int_equal(ins_vector_fwrite_ins(s, file), INS_SUCCESS);
+  fclose(file);
+
+  // Contiguous read.
+  ins_vector *w = ins_vector_calloc(n);
+  file = fopen("container_vector.ins", "rb");
+  assert_int_equal(ins_vector_fread_ins(w, file, INS_CONTAINER_VERIFY),
+                   INS_SUCCESS);
+  fclose(file);
+  for (i = 0; i < n; ++i) {
+    assert_double_equal(ins_vector_get(w, i), (double) i * 0.25, 0.0);
+  }
+
+  // Strided, reversed read.
+  ins_vector *u = ins_vector_calloc(2 * n);
+  ins_vector *t = ins_vector_alloc_from_vector(u, 2 * n - 1, n, -2);
+  file = fopen("container_vector.ins", "rb");
+  assert_int_equal(ins_vector_fread_ins(t, file, INS_CONTAINER_VERIFY),
+                   INS_SUCCESS);
+  fclose(file);
+  for (i = 0; i < n; ++i) {
+    assert_double_equal(ins_vector_get(t, i), (double) i * 0.25, 0.0);
+  }
+
+  // The payload can be mapped directly.
+  ins_vector *m = ins_vector_mmap_ins("container_vector.ins",
+                                      INS_MMAP_READ | INS_CONTAINER_VERIFY);
+  assert_non_null(m);
+  assert_int_equal(m->size, n);
+  assert_memory_equal(m->data, w->data, n * sizeof(double));
+
+  ins_vector_free(m);
+  ins_vector_free(t);
+  ins_vector_free(u);
+  ins_vector_free(w);
+  ins_vector_free(s);
+  ins_vector_free(v);
+}
+
+static void test_mismatches(void **state) {
+  (void) state;
+
+  ins_vector_int *v = ins_vector_int_calloc(3);
+  FILE *file = fopen("container_int.ins", "wb");
+  assert_int_equal(ins_vector_int_fwrite_ins(v, file), INS_SUCCESS);
+  fclose(file);
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+
+  ins_vector_float *f = ins_vector_float_calloc(3);
+  file = fopen("container_int.ins", "rb");
+  assert_int_equal(ins_vector_float_fread_ins(f, file, 0), INS_EINVAL);
+  fclose(file);
+
+  ins_vector_int *w = ins_vector_int_calloc(4);
+  file = fopen("container_int.ins", "rb");
+  assert_int_equal(ins_vector_int_fread_ins(w, file, 0), INS_EBADLEN);
+  fclose(file);
+
+  assert_null(ins_vector_float_mmap_ins("container_int.ins", INS_MMAP_READ));
+
+  // Corrupt the last payload byte.
+  file = fopen("container_int.ins", "r+b");
+  fseek(file, -1, SEEK_END);
+  fputc(1, file);
+  fclose(file);
+
+  file = fopen("container_int.ins", "rb");
+  assert_int_equal(ins_vector_int_fread_ins(v, file, INS_CONTAINER_VERIFY),
+                   INS_EFAILED);
+  fclose(file);
+
+  file = fopen("container_int.ins", "rb");
+  assert_int_equal(ins_vector_int_fread_ins(v, file, 0), INS_SUCCESS);
+  fclose(file);
+  assert_int_equal(ins_vector_int_get(v, 2), 1 << 24);
+
+  // Raw files are not containers.
+  file = fopen("container_raw.dat", "wb");
+  assert_int_equal(ins_vector_int_fwrite(w, file), INS_SUCCESS);
+  fclose(file);
+  ins_container_header header;
+  assert_int_equal(ins_container_query("container_raw.dat", &header),
+                   INS_EFAILED);
+
+  ins_set_error_handler(handler);
+
+  ins_vector_int_free(w);
+  ins_vector_float_free(f);
+  ins_vector_int_free(v);
+}
+
+static void swap_bytes(unsigned char *p, size_t size) {
+  size_t i;
+  for (i = 0; i < size / 2; ++i) {
+    unsigned char tmp = p[i];
+    p[i] = p[size - 1 - i];
+    p[size - 1 - i] = tmp;
+  }
+}
+
+static void test_foreign_byte_order(void **state) {
+  (void) state;
+
+  ins_vector_complex *v = ins_vector_complex_alloc(2);
+  v->data[0] = 1.0;
+  v->data[1] = -2.0;
+  v->data[2] = 3.5;
+  v->data[3] = 1e-300;
+
+  FILE *file = fopen("container_complex.ins", "wb");
+  assert_int_equal(ins_vector_complex_fwrite_ins(v, file), INS_SUCCESS);
+  fclose(file);
+
+  // Rewrite the container as a host of the opposite byte order would have
+  // written it.
+  unsigned char raw[INS_CONTAINER_ALIGNMENT + 4 * sizeof(double)];
+  file = fopen("container_complex.ins", "rb");
+  assert_int_equal(fread(raw, 1, sizeof(raw), file), sizeof(raw));
+  fclose(file);
+
+  size_t off;
+  for (off = 8; off < 24; off += 4) {
+    swap_bytes(raw + off, 4);
+  }
+  for (off = 24; off < 56; off += 8) {
+    swap_bytes(raw + off, 8);
+  }
+  swap_bytes(raw + 56, 4);
+  for (off = INS_CONTAINER_ALIGNMENT; off < sizeof(raw); off += 8) {
+    swap_bytes(raw + off, 8);
+  }
+
+  uint64_t checksum = ins_container_checksum(raw + INS_CONTAINER_ALIGNMENT,
+                                             4 * sizeof(double));
+  swap_bytes((unsigned char *) &checksum, 8);
+  memcpy(raw + 48, &checksum, 8);
+
+  file = fopen("container_complex.ins", "wb");
+  assert_int_equal(fwrite(raw, 1, sizeof(raw), file), sizeof(raw));
+  fclose(file);
+
+  ins_container_header header;
+  assert_int_equal(ins_container_query("container_complex.ins", &header),
+                   INS_SUCCESS);
+  assert_int_equal(header.type, INS_TYPE_COMPLEX);
+  assert_int_equal(header.count, 2);
+
+  ins_vector_complex *w = ins_vector_complex_calloc(2);
+  file = fopen("container_complex.ins", "rb");
+  assert_int_equal(ins_vector_complex_fread_ins(w, file, INS_CONTAINER_VERIFY),
+                   INS_SUCCESS);
+  fclose(file);
+  assert_memory_equal(w->data, v->data, 4 * sizeof(double));
+
+  ins_vector_complex_free(w);
+  ins_vector_complex_free(v);
+}
+
+static void test_checksum(void **state) {
+  (void) state;
+
+  unsigned char data[100];
+  size_t i;
+  for (i = 0; i < sizeof(data); ++i) {
+    data[i] = (unsigned char) (i * 7);
+  }
+
+  const uint64_t sum = ins_container_checksum(data, sizeof(data));
+  assert_true(sum == ins_container_checksum(data, sizeof(data)));
+
+  // Trailing zeros, single bit flips and swapped words all change it.
+  unsigned char longer[104] = {0};
+  memcpy(longer, data, sizeof(data));
+  assert_true(sum != ins_container_checksum(longer, sizeof(longer)));
+
+  data[99] ^= 1;
+  assert_true(sum != ins_container_checksum(data, sizeof(data)));
+  data[99] ^= 1;
+
+  unsigned char word[4];
+  memcpy(word, data, 4);
+  memcpy(data, data + 32, 4);
+  memcpy(data + 32, word, 4);
+  assert_true(sum != ins_container_checksum(data, sizeof(data)));
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_block_round_trip),
+    cmocka_unit_test(test_vector_strided_round_trip),
+    cmocka_unit_test(test_mismatches),
+    cmocka_unit_test(test_foreign_byte_order),
+    cmocka_unit_test(test_checksum)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
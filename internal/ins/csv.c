@@ -0,0 +1,463 @@
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_container.h"
+#include "ins/ins_text.h"
+#include "ins/ins_csv_io.h"
+#include "ins/ins_tuning_io.h"
+
+// Maximum number of threads parsing a file.
+#define INS_CSV_MAX_THREADS 64
+
+// The work shared by the threads: counting the rows of the ranges into
+// `counts`, or parsing them if `columns` is not null.
+typedef struct {
+  const ins_csv_file * file;
+  size_t next;
+
+  size_t * counts;
+
+  uint32_t type;
+  const size_t * columns;
+  const ins_csv_target * targets;
+  size_t n;
+
+  // Maps column `c <= max_column` to the first target receiving it, and
+  // `links` each target to the next one receiving the same column; -1 ends
+  // the lists.
+  size_t max_column;
+  const ptrdiff_t * heads;
+  const ptrdiff_t * links;
+
+  // The reason of the first failure, or null.
+  const char * error;
+} ins_csv_job;
+
+// Returns non-zero for the blanks around fields, which do not include the
+// delimiter.
+static int ins_csv_is_blank(const int c, const char delimiter) {
+  return (c == ' ' || c == '\t' || c == '\r') && c != delimiter;
+}
+
+// Returns the end of the line starting at `p`, before its '\n' if any.
+static const char * ins_csv_line_end(const char * p, const char * end) {
+  const char * q = (const char *) memchr(p, '\n', (size_t) (end - p));
+  return q != 0 ? q : end;
+}
+
+static int ins_csv_is_blank_line(const char * p, const char * end) {
+  for (; p < end; ++p) {
+    if (*p != ' ' && *p != '\t' && *p != '\r') {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+// Parses the field from `p` to `end`, without its blanks and quotes, into
+// element `row` of every target receiving it.
+static const char * ins_csv_store(const ins_csv_job * job,
+                                  const ptrdiff_t head, const size_t row,
+                                  const char * p, const char * end) {
+  const char * q = p;
+  double value_double = NAN;
+  float value_float = NAN;
+  int value_int = 0;
+  ptrdiff_t k;
+  int status = -1;
+
+  if (p == end) {
+    if (job->type == INS_TYPE_INT) {
+      return "empty field in delimited file";
+    }
+    status = 0;
+  } else if (job->type == INS_TYPE_DOUBLE) {
+    status = ins_text_parse_double(&q, end, &value_double);
+  } else if (job->type == INS_TYPE_FLOAT) {
+    status = ins_text_parse_float(&q, end, &value_float);
+  } else {
+    status = ins_text_parse_int(&q, end, &value_int);
+  }
+
+  if (status != 0 || q != end) {
+    return "invalid number in delimited file";
+  }
+
+  for (k = head; k >= 0; k = job->links[k]) {
+    const ins_csv_target * target = &job->targets[k];
+    const ptrdiff_t i = (ptrdiff_t) row * target->stride;
+
+    if (job->type == INS_TYPE_DOUBLE) {
+      ((double *) target->data)[i] = value_double;
+    } else if (job->type == INS_TYPE_FLOAT) {
+      ((float *) target->data)[i] = value_float;
+    } else {
+      ((int *) target->data)[i] = value_int;
+    }
+  }
+
+  return 0;
+}
+
+// Parses the selected fields of the line from `p` to `end` into element
+// `row` of the targets. Returns the reason of a failure, or null.
+static const char * ins_csv_parse_line(const ins_csv_job * job,
+                                       const size_t row, const char * p,
+                                       const char * end) {
+  const char delimiter = job->file->delimiter;
+  size_t column;
+
+  for (column = 0; column <= job->max_column; ++column) {
+    const char * field;
+    const char * field_end;
+
+    if (p > end) {
+      return "missing column in delimited file";
+    }
+
+    while (p < end && ins_csv_is_blank(*p, delimiter)) {
+      ++p;
+    }
+
+    if (p < end && *p == '"') {
+      // A quoted field ends at the first quote that is not doubled.
+      field = ++p;
+      while (p < end && (*p != '"' || (p + 1 < end && p[1] == '"'))) {
+        p += (*p == '"') ? 2 : 1;
+      }
+
+      if (p == end) {
+        return "unterminated quote in delimited file";
+      }
+
+      field_end = p++;
+      while (p < end && ins_csv_is_blank(*p, delimiter)) {
+        ++p;
+      }
+
+      if (p < end && *p != delimiter) {
+        return "invalid number in delimited file";
+      }
+    } else {
+      field = p;
+      p = (const char *) memchr(p, delimiter, (size_t) (end - p));
+      if (p == 0) {
+        p = end;
+      }
+
+      field_end = p;
+    }
+
+    // Numbers may be padded with blanks, also inside quotes.
+    while (field < field_end && ins_csv_is_blank(*field, 0)) {
+      ++field;
+    }
+
+    while (field_end > field && ins_csv_is_blank(field_end[-1], 0)) {
+      --field_end;
+    }
+
+    // `p` is at the delimiter or the end of the line; past the end of the
+    // line there are no more fields.
+    ++p;
+
+    if (job->heads[column] >= 0) {
+      const char * error = ins_csv_store(job, job->heads[column], row, field,
+                                         field_end);
+      if (error != 0) {
+        return error;
+      }
+    }
+  }
+
+  return 0;
+}
+
+// Counts the rows of range `r` into `counts[r + 1]`, or parses them.
+static const char * ins_csv_range(const ins_csv_job * job, const size_t r) {
+  const ins_csv_file * file = job->file;
+  const char * p = file->bounds[r];
+  const char * end = file->bounds[r + 1];
+  size_t row = job->columns != 0 ? file->first_rows[r] : 0;
+
+  while (p < end) {
+    const char * line_end = ins_csv_line_end(p, end);
+
+    if (!ins_csv_is_blank_line(p, line_end)) {
+      if (job->columns != 0) {
+        const char * error = ins_csv_parse_line(job, row, p, line_end);
+        if (error != 0) {
+          return error;
+        }
+      }
+      ++row;
+    }
+
+    p = line_end + 1;
+  }
+
+  if (job->columns == 0) {
+    job->counts[r + 1] = row;
+  }
+
+  return 0;
+}
+
+static void * ins_csv_worker(void * arg) {
+  ins_csv_job * job = (ins_csv_job *) arg;
+
+  for (;;) {
+    const size_t r = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+
+    if (r >= job->file->num_ranges ||
+        __atomic_load_n(&job->error, __ATOMIC_RELAXED) != 0) {
+      break;
+    }
+
+    const char * error = ins_csv_range(job, r);
+    if (error != 0) {
+      __atomic_store_n(&job->error, error, __ATOMIC_RELAXED);
+    }
+  }
+
+  return 0;
+}
+
+// Runs `job` on the ranges of the file, the calling thread being one of
+// the workers.
+static void ins_csv_run(ins_csv_job * job) {
+  pthread_t threads[INS_CSV_MAX_THREADS];
+  size_t started = 0;
+  size_t i;
+
+  job->next = 0;
+  job->error = 0;
+
+  for (i = 1; i < job->file->num_ranges; ++i) {
+    if (pthread_create(&threads[started], 0, ins_csv_worker, job) == 0) {
+      ++started;
+    }
+  }
+
+  ins_csv_worker(job);
+
+  for (i = 0; i < started; ++i) {
+    pthread_join(threads[i], 0);
+  }
+}
+
+int ins_csv_open(ins_csv_file * file, const char * path,
+                 const ins_csv_options * options) {
+  const char * begin = "";
+  const char * end = begin;
+  struct stat st;
+  size_t num_ranges;
+  size_t min_range;
+  size_t lines;
+  size_t i;
+  long threads;
+  int fd;
+
+  file->map = 0;
+  file->map_size = 0;
+  file->delimiter = (options != 0 && options->delimiter != 0)
+                        ? options->delimiter
+                        : ',';
+
+  fd = open(path, O_RDONLY);
+
+  if (fd < 0) {
+    INS_ERROR("failed to open file", INS_EFAILED);
+  }
+
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    INS_ERROR("fstat failed", INS_EFAILED);
+  }
+
+  // An empty file cannot be mapped, and has no rows.
+  if (st.st_size > 0) {
+    file->map_size = (size_t) st.st_size;
+    file->map = mmap(0, file->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (file->map == MAP_FAILED) {
+      close(fd);
+      INS_ERROR("mmap failed", INS_EFAILED);
+    }
+
+    // The file is parsed once from start to end. Advice is best effort.
+    madvise(file->map, file->map_size, MADV_SEQUENTIAL);
+
+    begin = (const char *) file->map;
+    end = begin + file->map_size;
+  }
+
+  close(fd);
+
+  if (end - begin >= 3 && memcmp(begin, "\xef\xbb\xbf", 3) == 0) {
+    begin += 3;
+  }
+
+  for (lines = options != 0 ? options->skip_lines : 0; lines > 0 && begin < end;
+       --lines) {
+    begin = ins_csv_line_end(begin, end) + 1;
+  }
+
+  if (begin > end) {
+    begin = end;
+  }
+
+  threads = (options != 0 && options->threads > 0) ? options->threads
+                                                   : ins_tuning_threads();
+
+  if (threads < 1) {
+    threads = 1;
+  }
+
+  // Small files are not split into ranges that cost more to start a thread
+  // for than to parse.
+  min_range = ins_tuning_get(&ins_tuning_current.parallel_min_bytes);
+  num_ranges = (size_t) (end - begin) / (min_range > 0 ? min_range : 1);
+
+  if (num_ranges > (size_t) threads) {
+    num_ranges = (size_t) threads;
+  }
+
+  if (num_ranges > INS_CSV_MAX_THREADS) {
+    num_ranges = INS_CSV_MAX_THREADS;
+  }
+
+  if (num_ranges == 0) {
+    num_ranges = 1;
+  }
+
+  file->num_ranges = num_ranges;
+  file->bounds = (const char **) malloc((num_ranges + 1) * sizeof(char *));
+  file->first_rows = (size_t *) malloc((num_ranges + 1) * sizeof(size_t));
+
+  if (file->bounds == 0 || file->first_rows == 0) {
+    ins_csv_close(file);
+    INS_ERROR("failed to allocate space for file ranges", INS_ENOMEM);
+  }
+
+  // The ranges are of about equal size, extended to the end of their last
+  // line.
+  file->bounds[0] = begin;
+  file->bounds[num_ranges] = end;
+
+  for (i = 1; i < num_ranges; ++i) {
+    const char * p = begin + (size_t) (end - begin) / num_ranges * i;
+
+    if (p < file->bounds[i - 1]) {
+      p = file->bounds[i - 1];
+    }
+
+    if (p > begin && p[-1] != '\n') {
+      p = ins_csv_line_end(p, end);
+      p += p < end ? 1 : 0;
+    }
+
+    file->bounds[i] = p;
+  }
+
+  // The rows of each range are counted in parallel, then summed up into the
+  // first row of each range.
+  ins_csv_job job;
+  memset(&job, 0, sizeof(job));
+  job.file = file;
+  job.counts = file->first_rows;
+
+  for (i = 0; i <= num_ranges; ++i) {
+    file->first_rows[i] = 0;
+  }
+
+  ins_csv_run(&job);
+
+  for (i = 1; i <= num_ranges; ++i) {
+    file->first_rows[i] += file->first_rows[i - 1];
+  }
+
+  return INS_SUCCESS;
+}
+
+size_t ins_csv_rows(const ins_csv_file * file) {
+  return file->first_rows[file->num_ranges];
+}
+
+int ins_csv_parse(const ins_csv_file * file, const uint32_t type,
+                  const size_t * columns, const ins_csv_target * targets,
+                  const size_t n) {
+  ins_csv_job job;
+  ptrdiff_t * heads;
+  ptrdiff_t * links;
+  size_t max_column = 0;
+  size_t i;
+
+  if (n == 0) {
+    return INS_SUCCESS;
+  }
+
+  for (i = 0; i < n; ++i) {
+    if (columns[i] > max_column) {
+      max_column = columns[i];
+    }
+  }
+
+  if (max_column >= SIZE_MAX / sizeof(ptrdiff_t) - n) {
+    INS_ERROR("column index is too large", INS_EINVAL);
+  }
+
+  heads = (ptrdiff_t *) malloc((max_column + 1 + n) * sizeof(ptrdiff_t));
+
+  if (heads == 0) {
+    INS_ERROR("failed to allocate space for column map", INS_ENOMEM);
+  }
+
+  links = heads + max_column + 1;
+
+  for (i = 0; i <= max_column; ++i) {
+    heads[i] = -1;
+  }
+
+  // Targets are prepended, so a column's list is in decreasing order.
+  for (i = n; i-- > 0;) {
+    links[i] = heads[columns[i]];
+    heads[columns[i]] = (ptrdiff_t) i;
+  }
+
+  job.file = file;
+  job.counts = 0;
+  job.type = type;
+  job.columns = columns;
+  job.targets = targets;
+  job.n = n;
+  job.max_column = max_column;
+  job.heads = heads;
+  job.links = links;
+
+  ins_csv_run(&job);
+
+  free(heads);
+
+  if (job.error != 0) {
+    INS_ERROR(job.error, INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+void ins_csv_close(ins_csv_file * file) {
+  if (file->map != 0) {
+    munmap(file->map, file->map_size);
+  }
+
+  free(file->bounds);
+  free(file->first_rows);
+}
@@ -0,0 +1,172 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+
+static void write_file(const char *text) {
+  FILE *file = fopen("csv.dat", "wb");
+  fputs(text, file);
+  fclose(file);
+}
+
+static void test_columns(void **state) {
+  (void) state;
+
+  // A byte order mark, a header, quotes, blanks, CRLF and an empty line.
+  write_file("\xef\xbb\xbfid,x,name,y\r\n"
+             "1, 2.5 ,\"a,b\",-3e2\r\n"
+             "\r\n"
+             "2,\" 0x10 \",c,\r\n"
+             "3,nan,d,7");
+
+  const size_t columns[] = {3, 1, 3};
+  ins_csv_options options = {0, 1, columns, 0};
+  ins_vector *vectors[3] = {NULL, NULL, NULL};
+
+  assert_int_equal(ins_vector_read_csv("csv.dat", &options, vectors, 3),
+                   INS_SUCCESS);
+
+  assert_int_equal(vectors[0]->size, 3);
+  assert_true(ins_vector_get(vectors[0], 0) == -300.0);
+  assert_true(isnan(ins_vector_get(vectors[0], 1)));
+  assert_true(ins_vector_get(vectors[0], 2) == 7.0);
+  assert_true(ins_vector_get(vectors[1], 0) == 2.5);
+  assert_true(ins_vector_get(vectors[1], 1) == 16.0);
+  assert_true(isnan(ins_vector_get(vectors[1], 2)));
+  assert_true(ins_vector_get(vectors[2], 2) == 7.0);
+
+  ins_vector_free(vectors[2]);
+  ins_vector_free(vectors[1]);
+  ins_vector_free(vectors[0]);
+}
+
+static void test_preallocated(void **state) {
+  (void) state;
+
+  write_file("1\t10\t100\n2\t20\t200\n3\t30\t300\n");
+
+  ins_csv_options options = {'\t', 0, NULL, 0};
+  ins_vector_int *data = ins_vector_int_calloc(6);
+  ins_vector_int *column = ins_vector_int_alloc_from_vector(data, 1, 3, 2);
+  ins_vector_float *floats[2] = {NULL, NULL};
+  ins_vector_int *ints[2] = {NULL, column};
+  size_t i;
+
+  assert_int_equal(ins_vector_int_read_csv("csv.dat", &options, ints, 2),
+                   INS_SUCCESS);
+  assert_int_equal(ins_vector_float_read_csv("csv.dat", &options, floats, 2),
+                   INS_SUCCESS);
+
+  for (i = 0; i < 3; ++i) {
+    assert_int_equal(ins_vector_int_get(ints[0], i), (int) i + 1);
+    assert_int_equal(ins_vector_int_get(data, 2 * i), 0);
+    assert_int_equal(ins_vector_int_get(data, 2 * i + 1), 10 * ((int) i + 1));
+    assert_true(ins_vector_float_get(floats[1], i) == 10.0F * (float) (i + 1));
+  }
+
+  ins_vector_float_free(floats[1]);
+  ins_vector_float_free(floats[0]);
+  ins_vector_int_free(ints[0]);
+  ins_vector_int_free(column);
+  ins_vector_int_free(data);
+}
+
+static void test_parallel(void **state) {
+  (void) state;
+
+  // Large enough to be split into several ranges.
+  const size_t n = 50000;
+  FILE *file = fopen("csv.dat", "wb");
+  size_t i;
+
+  fputs("a,b\n", file);
+  for (i = 0; i < n; ++i) {
+    fprintf(file, "%zu,%.17g\n", i, 1.0 / (double) (i + 1));
+    if (i % 1000 == 0) {
+      fputs("\n", file);
+    }
+  }
+  fclose(file);
+
+  ins_csv_options options = {0, 1, NULL, 4};
+  ins_vector *vectors[2] = {NULL, NULL};
+
+  assert_int_equal(ins_vector_read_csv("csv.dat", &options, vectors, 2),
+                   INS_SUCCESS);
+  assert_int_equal(vectors[0]->size, n);
+
+  for (i = 0; i < n; ++i) {
+    assert_true(ins_vector_get(vectors[0], i) == (double) i);
+    assert_true(ins_vector_get(vectors[1], i) == 1.0 / (double) (i + 1));
+  }
+
+  ins_vector_free(vectors[1]);
+  ins_vector_free(vectors[0]);
+}
+
+static void test_errors(void **state) {
+  (void) state;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+
+  ins_vector *v = ins_vector_alloc(2);
+  ins_vector *vectors[2] = {NULL, NULL};
+  ins_vector_int *ints[1] = {NULL};
+
+  write_file("1,2\n3\n");
+  assert_int_equal(ins_vector_read_csv("csv.dat", NULL, vectors, 2),
+                   INS_EFAILED);
+  assert_null(vectors[0]);
+  assert_null(vectors[1]);
+
+  write_file("1,2\n3,x\n");
+  assert_int_equal(ins_vector_read_csv("csv.dat", NULL, vectors, 2),
+                   INS_EFAILED);
+
+  write_file("1,\"2\n");
+  assert_int_equal(ins_vector_read_csv("csv.dat", NULL, vectors, 2),
+                   INS_EFAILED);
+
+  const size_t second[] = {1};
+  ins_csv_options options = {0, 0, second, 0};
+  write_file("1,2\n3, \n");
+  assert_int_equal(ins_vector_int_read_csv("csv.dat", &options, ints, 1),
+                   INS_EFAILED);
+  assert_null(ints[0]);
+
+  write_file("1\n2\n3\n");
+  vectors[0] = v;
+  assert_int_equal(ins_vector_read_csv("csv.dat", NULL, vectors, 1),
+                   INS_EBADLEN);
+  assert_ptr_equal(vectors[0], v);
+
+  assert_int_equal(ins_vector_read_csv("missing.dat", NULL, vectors, 1),
+                   INS_EFAILED);
+
+  ins_set_error_handler(handler);
+
+  // An empty file has no rows.
+  write_file("");
+  vectors[0] = NULL;
+  assert_int_equal(ins_vector_read_csv("csv.dat", NULL, vectors, 1),
+                   INS_SUCCESS);
+  assert_int_equal(vectors[0]->size, 0);
+  ins_vector_free(vectors[0]);
+
+  ins_vector_free(v);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_columns),
+    cmocka_unit_test(test_preallocated),
+    cmocka_unit_test(test_parallel),
+    cmocka_unit_test(test_errors)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,193 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // for O_DIRECT
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_direct_io.h"
+
+// Largest number of bytes moved by one `pread` or `pwrite` call.
+#define INS_DIRECT_MAX_CALL (1 << 30)
+
+// Moves `nbytes` bytes at byte `offset` of `fd` with `pread` or `pwrite`,
+// resuming short transfers. Returns -1 with `errno` set if a call fails,
+// or with `errno` 0 at the end of the file.
+static int ins_direct_io(const int fd, uint64_t offset, unsigned char * p,
+                         size_t nbytes, const int write) {
+  while (nbytes > 0) {
+    const size_t size = nbytes < INS_DIRECT_MAX_CALL ? nbytes
+                                                     : INS_DIRECT_MAX_CALL;
+    const ssize_t done = write ? pwrite(fd, p, size, (off_t) offset)
+                               : pread(fd, p, size, (off_t) offset);
+
+    if (done < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (done <= 0) {
+      if (done == 0) {
+        errno = 0;
+      }
+      return -1;
+    }
+
+    p += done;
+    offset += (uint64_t) done;
+    nbytes -= (size_t) done;
+  }
+
+  return 0;
+}
+
+// Moves the aligned middle part of a transfer with direct I/O, through the
+// bounce buffer if `p` is not aligned. If the file system rejects direct
+// I/O, the rest of the part is moved through the page cache.
+static int ins_direct_body(ins_direct_file * file, uint64_t offset,
+                           unsigned char * p, size_t nbytes,
+                           const int write) {
+  while (nbytes > 0 && file->direct_fd >= 0) {
+    unsigned char * buffer = p;
+    size_t size = nbytes;
+
+    if ((uintptr_t) p % INS_DIRECT_ALIGNMENT != 0) {
+      if (file->bounce == 0) {
+        file->bounce = ins_direct_alloc(INS_DIRECT_CHUNK);
+        if (file->bounce == 0) {
+          break;
+        }
+      }
+
+      buffer = (unsigned char *) file->bounce;
+      size = nbytes < INS_DIRECT_CHUNK ? nbytes : INS_DIRECT_CHUNK;
+
+      if (write) {
+        memcpy(buffer, p, size);
+      }
+    }
+
+    if (ins_direct_io(file->direct_fd, offset, buffer, size, write) != 0) {
+      if (errno != EINVAL) {
+        return -1;
+      }
+
+      close(file->direct_fd);
+      file->direct_fd = -1;
+      break;
+    }
+
+    if (!write && buffer != p) {
+      memcpy(p, buffer, size);
+    }
+
+    p += size;
+    offset += size;
+    nbytes -= size;
+  }
+
+  return ins_direct_io(file->fd, offset, p, nbytes, write);
+}
+
+int ins_direct_open(ins_direct_file * file, const char * path,
+                    const int write) {
+  const int flags = write ? O_WRONLY : O_RDONLY;
+
+  file->bounce = 0;
+  file->fd = open(path, write ? flags | O_CREAT : flags, 0666);
+
+  if (file->fd < 0) {
+    INS_ERROR("failed to open file", INS_EFAILED);
+  }
+
+  // A second descriptor bypasses the page cache. Opening it fails on file
+  // systems without direct I/O, which then get buffered transfers only.
+#if defined(O_DIRECT)
+  file->direct_fd = open(path, flags | O_DIRECT);
+#elif defined(F_NOCACHE)
+  file->direct_fd = open(path, flags);
+  if (file->direct_fd >= 0 && fcntl(file->direct_fd, F_NOCACHE, 1) != 0) {
+    close(file->direct_fd);
+    file->direct_fd = -1;
+  }
+#else
+  file->direct_fd = -1;
+#endif
+
+  return INS_SUCCESS;
+}
+
+int ins_direct_transfer(ins_direct_file * file, const uint64_t offset,
+                        void * buffer, const size_t nbytes, const int write) {
+  unsigned char * p = (unsigned char *) buffer;
+  size_t head = (size_t) ((INS_DIRECT_ALIGNMENT -
+                           offset % INS_DIRECT_ALIGNMENT) %
+                          INS_DIRECT_ALIGNMENT);
+  size_t body;
+  int failed;
+
+  if (head > nbytes) {
+    head = nbytes;
+  }
+
+  body = (nbytes - head) / INS_DIRECT_ALIGNMENT * INS_DIRECT_ALIGNMENT;
+
+  // The head and the tail share their pages with bytes outside the
+  // transfer, and go through the page cache.
+  failed = ins_direct_io(file->fd, offset, p, head, write) != 0 ||
+           ins_direct_body(file, offset + head, p + head, body, write) != 0 ||
+           ins_direct_io(file->fd, offset + head + body, p + head + body,
+                         nbytes - head - body, write) != 0;
+
+#ifdef POSIX_FADV_DONTNEED
+  // Without direct I/O the range is at least dropped from the page cache
+  // again, as far as it has been written back.
+  if (file->direct_fd < 0) {
+    posix_fadvise(file->fd, (off_t) offset, (off_t) nbytes,
+                  POSIX_FADV_DONTNEED);
+  }
+#endif
+
+  if (failed && write) {
+    INS_ERROR("write failed", INS_EFAILED);
+  }
+
+  if (failed) {
+    INS_ERROR("read failed", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+int ins_direct_close(ins_direct_file * file) {
+  int failed = 0;
+
+  if (file->direct_fd >= 0 && close(file->direct_fd) != 0) {
+    failed = 1;
+  }
+
+  if (close(file->fd) != 0) {
+    failed = 1;
+  }
+
+  free(file->bounce);
+
+  if (failed) {
+    INS_ERROR("close failed", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+void * ins_direct_alloc(const size_t nbytes) {
+  void * p;
+
+  if (posix_memalign(&p, INS_DIRECT_ALIGNMENT, nbytes > 0 ? nbytes : 1)
+      != 0) {
+    return 0;
+  }
+
+  return p;
+}
@@ -0,0 +1,153 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+
+static void fill(ins_block *block) {
+  size_t i;
+  for (i = 0; i < block->size; ++i) {
+    block->data[i] = 0.5 * (double) i - 7.0;
+  }
+}
+
+static void test_aligned_allocation(void **state) {
+  (void) state;
+
+  ins_block *a = ins_block_alloc(INS_DIRECT_MIN_SIZE / sizeof(double));
+  ins_block_float *b = ins_block_float_calloc(INS_DIRECT_MIN_SIZE);
+  size_t i;
+
+  assert_int_equal((uintptr_t) a->data % INS_DIRECT_ALIGNMENT, 0);
+  assert_int_equal((uintptr_t) b->data % INS_DIRECT_ALIGNMENT, 0);
+
+  for (i = 0; i < b->size; ++i) {
+    assert_true(b->data[i] == 0.0F);
+  }
+
+  ins_block_float_free(b);
+  ins_block_free(a);
+}
+
+static void test_block_round_trip(void **state) {
+  (void) state;
+
+  // Aligned and unaligned offsets, with an unaligned tail.
+  static const size_t offsets[] = {0, 4096, 100, 8191};
+  const size_t n = INS_DIRECT_MIN_SIZE / sizeof(double) + 333;
+  ins_block *a = ins_block_alloc(n);
+  ins_block *b = ins_block_alloc(n);
+  size_t k;
+
+  fill(a);
+  remove("direct.dat");
+
+  for (k = 0; k < sizeof(offsets) / sizeof(offsets[0]); ++k) {
+    memset(b->data, 0, n * sizeof(double));
+    assert_int_equal(ins_block_write_direct(a, "direct.dat", offsets[k]),
+                     INS_SUCCESS);
+    assert_int_equal(ins_block_read_direct(b, "direct.dat", offsets[k]),
+                     INS_SUCCESS);
+    assert_memory_equal(b->data, a->data, n * sizeof(double));
+  }
+
+  // The file is read back with stdio as the raw layout of `fwrite`.
+  FILE *file = fopen("direct.dat", "rb");
+  fseek(file, 8191, SEEK_SET);
+  memset(b->data, 0, n * sizeof(double));
+  assert_int_equal(ins_block_fread(b, file), INS_SUCCESS);
+  fclose(file);
+  assert_memory_equal(b->data, a->data, n * sizeof(double));
+
+  ins_block_free(b);
+  ins_block_free(a);
+}
+
+static void test_vector_views(void **state) {
+  (void) state;
+
+  const size_t n = 300001;
+  ins_vector *v = ins_vector_alloc(2 * n + 1);
+  ins_vector *w = ins_vector_calloc(2 * n + 1);
+  size_t i;
+
+  for (i = 0; i < v->size; ++i) {
+    ins_vector_set(v, i, (double) i);
+  }
+
+  // A view starting at an unaligned element goes through the bounce buffer,
+  // and a strided view through the staging buffer.
+  ins_vector *a = ins_vector_alloc_from_vector(v, 1, n, 1);
+  ins_vector *b = ins_vector_alloc_from_vector(w, 1, n, 1);
+  ins_vector *c = ins_vector_alloc_from_vector(v, 0, n, 2);
+  ins_vector *d = ins_vector_alloc_from_vector(w, 0, n, 2);
+
+  remove("direct.dat");
+  assert_int_equal(ins_vector_write_direct(a, "direct.dat", 0), INS_SUCCESS);
+  assert_int_equal(ins_vector_read_direct(b, "direct.dat", 0), INS_SUCCESS);
+  for (i = 0; i < n; ++i) {
+    assert_true(ins_vector_get(b, i) == (double) (i + 1));
+  }
+
+  assert_int_equal(ins_vector_write_direct(c, "direct.dat", 12), INS_SUCCESS);
+  ins_vector_set_zero(w);
+  assert_int_equal(ins_vector_read_direct(d, "direct.dat", 12), INS_SUCCESS);
+  for (i = 0; i < n; ++i) {
+    assert_true(ins_vector_get(w, 2 * i) == (double) (2 * i));
+    assert_true(ins_vector_get(w, 2 * i + 1) == 0.0);
+  }
+
+  // The first 12 bytes of the file were written by the first write, and
+  // are kept.
+  ins_vector *e = ins_vector_alloc(1);
+  assert_int_equal(ins_vector_read_direct(e, "direct.dat", 0), INS_SUCCESS);
+  assert_true(ins_vector_get(e, 0) == 1.0);
+
+  ins_vector_free(e);
+  ins_vector_free(d);
+  ins_vector_free(c);
+  ins_vector_free(b);
+  ins_vector_free(a);
+  ins_vector_free(w);
+  ins_vector_free(v);
+}
+
+static void test_errors(void **state) {
+  (void) state;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+
+  ins_block *a = ins_block_alloc(1000);
+  ins_vector_int *v = ins_vector_int_alloc(10);
+
+  fill(a);
+  remove("direct.dat");
+  assert_int_equal(ins_block_write_direct(a, "direct.dat", 0), INS_SUCCESS);
+
+  // Reads past the end of the file fail, with the end aligned or not.
+  assert_int_equal(ins_block_read_direct(a, "direct.dat", 8), INS_EFAILED);
+  assert_int_equal(ins_block_read_direct(a, "direct.dat", 4096),
+                   INS_EFAILED);
+  assert_int_equal(ins_vector_int_read_direct(v, "missing.dat", 0),
+                   INS_EFAILED);
+
+  ins_set_error_handler(handler);
+
+  ins_vector_int_free(v);
+  ins_block_free(a);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_aligned_allocation),
+    cmocka_unit_test(test_block_round_trip),
+    cmocka_unit_test(test_vector_views),
+    cmocka_unit_test(test_errors)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
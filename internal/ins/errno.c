@@ -1,10 +1,20 @@
 #include <stdlib.h>
-#include "ins/ins_errno.h"
+#include "ins/ins_errno_io.h"
 
-// Global variables
-FILE* ins_stream = NULL;
-ins_stream_handler_t* ins_stream_handler = NULL;
-ins_error_handler_t* ins_error_handler = NULL;
+// The process-wide defaults, used by the threads that have not set their own
+// handlers or stream. They are read and written atomically.
+static FILE* ins_default_stream = NULL;
+static ins_stream_handler_t* ins_default_stream_handler = NULL;
+static ins_error_handler_t* ins_default_error_handler = NULL;
+
+// The state of each thread. The `has_*` flags of its context tell whether the
+// thread has set its own handler or stream, which then replaces the default.
+typedef struct {
+  ins_error_context context;
+  ins_error_record last_error;
+} ins_thread_state;
+
+static _Thread_local ins_thread_state ins_thread;
 
 // The error handler that does nothing.
 static void
@@ -87,55 +97,101 @@ const char* ins_strerror(const int gsl_errno) {
   }
 }
 
+/* STREAM HANDLER */
+
+ins_stream_handler_t* ins_get_stream_handler(void) {
+  if (ins_thread.context.has_stream_handler) {
+    return ins_thread.context.stream_handler;
+  }
+
+  return __atomic_load_n(&ins_default_stream_handler, __ATOMIC_ACQUIRE);
+}
+
 ins_stream_handler_t*
 ins_set_stream_handler(ins_stream_handler_t* new_handler) {
-  ins_stream_handler_t* previous_handler = ins_stream_handler;
-  ins_stream_handler = new_handler;
+  ins_stream_handler_t* previous_handler = ins_get_stream_handler();
+  ins_thread.context.stream_handler = new_handler;
+  ins_thread.context.has_stream_handler = 1;
   return previous_handler;
 }
 
+ins_stream_handler_t*
+ins_set_default_stream_handler(ins_stream_handler_t* new_handler) {
+  return __atomic_exchange_n(&ins_default_stream_handler, new_handler,
+                             __ATOMIC_ACQ_REL);
+}
+
+FILE* ins_get_stream(void) {
+  FILE* stream = ins_thread.context.has_stream
+                   ? ins_thread.context.stream
+                   : __atomic_load_n(&ins_default_stream, __ATOMIC_ACQUIRE);
+
+  return stream != NULL ? stream : stderr;
+}
+
 FILE* ins_set_stream(FILE* new_stream) {
-  FILE* previous_stream;
-  if (ins_stream == NULL) {
-    ins_stream = stderr;
-  }
-  previous_stream = ins_stream;
-  ins_stream = new_stream;
+  FILE* previous_stream = ins_get_stream();
+  ins_thread.context.stream = new_stream;
+  ins_thread.context.has_stream = 1;
   return previous_stream;
 }
 
+FILE* ins_set_default_stream(FILE* new_stream) {
+  FILE* previous_stream = __atomic_exchange_n(&ins_default_stream, new_stream,
+                                              __ATOMIC_ACQ_REL);
+  return previous_stream != NULL ? previous_stream : stderr;
+}
+
 void ins_stream_printf(const char* label, const char* file, int line,
                        const char* reason) {
-  if (ins_stream == NULL) {
-    ins_stream = stderr;
-  }
+  ins_stream_handler_t* stream_handler = ins_get_stream_handler();
 
-  if (ins_stream_handler) {
+  if (stream_handler) {
     // It's a good practice to dereference function pointer here.
-    (*ins_stream_handler)(label, file, line, reason);
+    (*stream_handler)(label, file, line, reason);
     return;
   }
 
-  fprintf(ins_stream, "ins: %s:%d: %s: %s\n", file, line, label, reason);
+  fprintf(ins_get_stream(), "ins: %s:%d: %s: %s\n", file, line, label,
+          reason);
+}
+
+/* ERROR HANDLER */
+
+ins_error_handler_t* ins_get_error_handler(void) {
+  if (ins_thread.context.has_error_handler) {
+    return ins_thread.context.error_handler;
+  }
+
+  return __atomic_load_n(&ins_default_error_handler, __ATOMIC_ACQUIRE);
 }
 
 ins_error_handler_t*
 ins_set_error_handler(ins_error_handler_t* new_handler) {
-  ins_error_handler_t* previous_handler = ins_error_handler;
-  ins_error_handler = new_handler;
+  ins_error_handler_t* previous_handler = ins_get_error_handler();
+  ins_thread.context.error_handler = new_handler;
+  ins_thread.context.has_error_handler = 1;
   return previous_handler;
 }
 
 ins_error_handler_t* ins_set_error_handler_off(void) {
-  ins_error_handler_t* previous_handler = ins_error_handler;
-  ins_error_handler = no_error_handler;
-  return previous_handler;
+  return ins_set_error_handler(no_error_handler);
+}
+
+ins_error_handler_t*
+ins_set_default_error_handler(ins_error_handler_t* new_handler) {
+  return __atomic_exchange_n(&ins_default_error_handler, new_handler,
+                             __ATOMIC_ACQ_REL);
 }
 
 void
 ins_error(const char* reason, const char* file, int line, int error_code) {
-  if (ins_error_handler) {
-    (*ins_error_handler)(reason, file, line, error_code);
+  ins_error_handler_t* error_handler = ins_get_error_handler();
+
+  ins_record_error(reason, file, line, error_code);
+
+  if (error_handler) {
+    (*error_handler)(reason, file, line, error_code);
     return;
   }
 
@@ -148,6 +204,34 @@ ins_error(const char* reason, const char* file, int line, int error_code) {
   abort();
 }
 
+/* CONTEXT */
+
+void ins_get_error_context(ins_error_context* context) {
+  *context = ins_thread.context;
+}
+
+void ins_set_error_context(const ins_error_context* context) {
+  ins_thread.context = *context;
+}
+
+/* LAST ERROR */
+
+void ins_record_error(const char* reason, const char* file, int line,
+                      int error_code) {
+  ins_thread.last_error.error_code = error_code;
+  ins_thread.last_error.reason = reason;
+  ins_thread.last_error.file = file;
+  ins_thread.last_error.line = line;
+}
+
+const ins_error_record* ins_last_error(void) {
+  return &ins_thread.last_error;
+}
+
+void ins_clear_error(void) {
+  ins_record_error(NULL, NULL, 0, INS_SUCCESS);
+}
+
 static void
 no_error_handler(const char* reason, const char* file, int line, int error_code) {
   // Do nothing
@@ -2,6 +2,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <setjmp.h>
+#include <pthread.h>
 #include <cmocka.h>
 #include "ins/ins_errno.h"
 
@@ -286,29 +287,27 @@ static void new_stream_handler(const char*  label, const char*  file, int line,
 
 static void test_ins_set_stream_handler(void** state) {
   (void) state;
-  extern ins_stream_handler_t* ins_stream_handler;
 
   ins_set_stream_handler(&old_stream_handler);
-  assert_ptr_equal(ins_stream_handler, &old_stream_handler);
+  assert_ptr_equal(ins_get_stream_handler(), &old_stream_handler);
 
   ins_stream_handler_t* ret = ins_set_stream_handler(&new_stream_handler);
   assert_ptr_equal(ret, &old_stream_handler);
-  assert_ptr_equal(ins_stream_handler, &new_stream_handler);
+  assert_ptr_equal(ins_get_stream_handler(), &new_stream_handler);
 }
 
 static void test_ins_set_stream(void** state) {
   (void) state;
 
-  extern FILE* ins_stream;
   FILE* old_stream;
 
   old_stream = ins_set_stream(stdout);
   assert_ptr_equal(old_stream, stderr);
-  assert_ptr_equal(ins_stream, stdout);
+  assert_ptr_equal(ins_get_stream(), stdout);
 
   old_stream = ins_set_stream(stderr);
   assert_ptr_equal(old_stream, stdout);
-  assert_ptr_equal(ins_stream, stderr);
+  assert_ptr_equal(ins_get_stream(), stderr);
 }
 
 /* ERROR HANDLER */
@@ -333,14 +332,96 @@ static void new_error_handler(const char* reason, const char* file, int line,
 
 static void test_ins_set_error_handler(void** state) {
   (void) state;
-  extern ins_error_handler_t* ins_error_handler;
 
   ins_set_error_handler(&old_error_handler);
-  assert_ptr_equal(ins_error_handler, &old_error_handler);
+  assert_ptr_equal(ins_get_error_handler(), &old_error_handler);
 
   ins_error_handler_t* ret = ins_set_error_handler(&new_error_handler);
   assert_ptr_equal(ret, &old_error_handler);
-  assert_ptr_equal(ins_error_handler, &new_error_handler);
+  assert_ptr_equal(ins_get_error_handler(), &new_error_handler);
+}
+
+/* THREADS */
+
+// Records the handlers seen by a new thread, and raises an error in it.
+typedef struct {
+  ins_error_handler_t* error_handler;
+  ins_stream_handler_t* stream_handler;
+  int error_code;
+} thread_result;
+
+static void* thread_main(void* arg) {
+  thread_result* result = (thread_result*) arg;
+
+  result->error_handler = ins_get_error_handler();
+  result->stream_handler = ins_get_stream_handler();
+
+  ins_set_error_handler(&new_error_handler);
+  ins_error("thread error", "thread.c", 7, INS_EDOM);
+  result->error_code = ins_last_error()->error_code;
+
+  return NULL;
+}
+
+static void test_ins_thread_state(void** state) {
+  (void) state;
+
+  thread_result result;
+  pthread_t thread;
+
+  ins_set_error_handler(&old_error_handler);
+  ins_set_default_error_handler(&new_error_handler);
+  ins_set_default_stream_handler(&new_stream_handler);
+
+  // A new thread starts with the defaults, and its changes and errors stay
+  // its own.
+  ins_clear_error();
+  assert_int_equal(pthread_create(&thread, NULL, thread_main, &result), 0);
+  pthread_join(thread, NULL);
+
+  assert_ptr_equal(result.error_handler, &new_error_handler);
+  assert_ptr_equal(result.stream_handler, &new_stream_handler);
+  assert_int_equal(result.error_code, INS_EDOM);
+  assert_ptr_equal(ins_get_error_handler(), &old_error_handler);
+  assert_int_equal(ins_last_error()->error_code, INS_SUCCESS);
+
+  assert_ptr_equal(ins_set_default_error_handler(NULL), &new_error_handler);
+  assert_ptr_equal(ins_set_default_stream_handler(NULL), &new_stream_handler);
+  assert_ptr_equal(ins_set_default_stream(stdout), stderr);
+  assert_ptr_equal(ins_set_default_stream(NULL), stdout);
+}
+
+/* LAST ERROR */
+
+static int record_error(void) {
+  INS_ERROR_RECORD("recorded error", INS_EBADLEN);
+}
+
+static void test_ins_last_error(void** state) {
+  (void) state;
+
+  ins_error_handler_t* handler = ins_set_error_handler_off();
+
+  ins_clear_error();
+  assert_int_equal(ins_last_error()->error_code, INS_SUCCESS);
+  assert_null(ins_last_error()->reason);
+
+  // Errors raised through the handler are recorded too.
+  ins_error("raised error", "file.c", 42, INS_EINVAL);
+  assert_int_equal(ins_last_error()->error_code, INS_EINVAL);
+  assert_string_equal(ins_last_error()->reason, "raised error");
+  assert_string_equal(ins_last_error()->file, "file.c");
+  assert_int_equal(ins_last_error()->line, 42);
+
+  ins_set_error_handler(handler);
+
+  // Recording does not invoke the default handler, which would abort.
+  assert_int_equal(record_error(), INS_EBADLEN);
+  assert_int_equal(ins_last_error()->error_code, INS_EBADLEN);
+  assert_string_equal(ins_last_error()->reason, "recorded error");
+
+  ins_clear_error();
+  assert_int_equal(ins_last_error()->error_code, INS_SUCCESS);
 }
 
 int main(void) {
@@ -383,7 +464,9 @@ int main(void) {
     cmocka_unit_test(errno_unknown),
     cmocka_unit_test(test_ins_set_stream_handler),
     cmocka_unit_test(test_ins_set_stream),
-    cmocka_unit_test(test_ins_set_error_handler)
+    cmocka_unit_test(test_ins_set_error_handler),
+    cmocka_unit_test(test_ins_thread_state),
+    cmocka_unit_test(test_ins_last_error)
   };
 
   return cmocka_run_group_tests(tests, NULL, NULL);
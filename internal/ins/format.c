@@ -0,0 +1,757 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ins/ins_text.h"
+#include "ins/ins_pow5.h"
+
+// Formats with a larger precision are passed to `snprintf`.
+#define INS_TEXT_MAX_PRECISION 100
+
+// Room reserved in the buffer for one number formatted directly. The longest
+// such number is a `%f` with the maximum precision.
+#define INS_TEXT_MAX_FIELD 128
+
+// Values of `ins_text_format.conversion` besides the conversion characters
+// of the formats that are handled directly.
+enum {
+  INS_TEXT_SHORTEST = 0,
+  INS_TEXT_PRINTF = -1
+};
+
+static const uint64_t ins_text_pow10[20] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+  100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+  1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+  1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+  1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static const char ins_text_digit_pairs[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536"
+  "37383940414243444546474849505152535455565758596061626364656667686970717273"
+  "7475767778798081828384858687888990919293949596979899";
+
+/* Format specifiers
+ --------------------------------------------------------------------------*/
+
+static int ins_text_is_float_conversion(const int c) {
+  return c == 'e' || c == 'E' || c == 'f' || c == 'F' || c == 'g' ||
+         c == 'G';
+}
+
+void ins_text_format_init(ins_text_format * format, const char * spec) {
+  const char * p = spec;
+  int precision = -1;
+  int length = 0;
+
+  format->format = spec;
+  format->conversion = INS_TEXT_PRINTF;
+  format->precision = 6;
+
+  if (spec == 0) {
+    format->conversion = INS_TEXT_SHORTEST;
+    return;
+  }
+
+  // Only a single conversion with an optional precision is handled
+  // directly; flags, field widths and surrounding text are left to
+  // `snprintf`.
+  if (*p++ != '%') {
+    return;
+  }
+
+  if (*p == '.') {
+    ++p;
+    precision = 0;
+    while (*p >= '0' && *p <= '9') {
+      precision = 10 * precision + (*p++ - '0');
+      if (precision > INS_TEXT_MAX_PRECISION) {
+        return;
+      }
+    }
+  }
+
+  if (*p == 'l') {
+    ++p;
+    length = 1;
+  }
+
+  if (p[0] == '\0' || p[1] != '\0') {
+    return;
+  }
+
+  if (ins_text_is_float_conversion(p[0])) {
+    format->conversion = p[0];
+    format->precision = precision < 0 ? 6 : precision;
+  } else if ((p[0] == 'd' || p[0] == 'i') && precision < 0 && !length) {
+    format->conversion = p[0];
+  }
+}
+
+/* Writer
+ --------------------------------------------------------------------------*/
+
+void ins_text_writer_init(ins_text_writer * writer, FILE * stream) {
+  writer->stream = stream;
+  writer->length = 0;
+}
+
+int ins_text_writer_flush(ins_text_writer * writer) {
+  if (writer->length > 0 &&
+      fwrite(writer->buffer, 1, writer->length, writer->stream)
+      != writer->length) {
+    return -1;
+  }
+
+  writer->length = 0;
+  return 0;
+}
+
+// Makes sure that the next `n` bytes fit in the buffer.
+static int ins_text_reserve(ins_text_writer * writer, const size_t n) {
+  if (writer->length + n > INS_TEXT_BUFFER_SIZE) {
+    return ins_text_writer_flush(writer);
+  }
+
+  return 0;
+}
+
+int ins_text_write_char(ins_text_writer * writer, const char c) {
+  if (ins_text_reserve(writer, 1) != 0) {
+    return -1;
+  }
+
+  writer->buffer[writer->length++] = c;
+  return 0;
+}
+
+// Formats the arguments with `snprintf` into the buffer. Output longer than
+// the whole buffer goes straight to the stream.
+static int ins_text_write_printf(ins_text_writer * writer,
+                                 const char * format, ...) {
+  const size_t available = INS_TEXT_BUFFER_SIZE - writer->length;
+
+  va_list args;
+  int n;
+
+  va_start(args, format);
+  n = vsnprintf(writer->buffer + writer->length, available, format, args);
+  va_end(args);
+
+  if (n < 0) {
+    return -1;
+  }
+
+  if ((size_t) n < available) {
+    writer->length += (size_t) n;
+    return 0;
+  }
+
+  if (ins_text_writer_flush(writer) != 0) {
+    return -1;
+  }
+
+  va_start(args, format);
+  if ((size_t) n < INS_TEXT_BUFFER_SIZE) {
+    vsnprintf(writer->buffer, INS_TEXT_BUFFER_SIZE, format, args);
+    writer->length = (size_t) n;
+  } else {
+    n = vfprintf(writer->stream, format, args);
+  }
+  va_end(args);
+
+  return n < 0 ? -1 : 0;
+}
+
+/* Digits
+ --------------------------------------------------------------------------*/
+
+static int ins_text_num_digits(const uint64_t x) {
+  int n = 1;
+
+  while (n < 20 && x >= ins_text_pow10[n]) {
+    ++n;
+  }
+
+  return n;
+}
+
+// Writes the last `n` decimal digits of `x` to `p`, two at a time, padding
+// with leading zeros.
+static void ins_text_put_digits(char * p, uint64_t x, int n) {
+  while (n >= 2) {
+    const unsigned r = (unsigned) (x % 100);
+    x /= 100;
+    n -= 2;
+    memcpy(p + n, ins_text_digit_pairs + 2 * r, 2);
+  }
+
+  if (n == 1) {
+    p[0] = (char) ('0' + x % 10);
+  }
+}
+
+static char * ins_text_put_int(char * p, const int x) {
+  const uint64_t u = x < 0 ? 0U - (unsigned) x : (unsigned) x;
+  const int n = ins_text_num_digits(u);
+
+  if (x < 0) {
+    *p++ = '-';
+  }
+
+  ins_text_put_digits(p, u, n);
+  return p + n;
+}
+
+/* Shortest representation
+ --------------------------------------------------------------------------*/
+
+// The shortest representation is computed with the Schubfach algorithm
+// (R. Giulietti, "The Schubfach way to render doubles", 2020), which finds
+// the shortest decimal in the rounding interval of a number, and the one
+// closest to it if there are several.
+
+// A decimal number `digits * 10^exponent`.
+typedef struct {
+  uint64_t digits;
+  int exponent;
+} ins_text_decimal;
+
+#define INS_TEXT_MASK63 0x7fffffffffffffffULL
+
+// floor(e * log10(2)), floor(e * log10(3/4 * 2)) and floor(e * log2(10)),
+// exact for the exponents of doubles.
+static int ins_text_flog10_pow2(const int e) {
+  return (int) ((int64_t) e * 661971961083LL >> 41);
+}
+
+static int ins_text_flog10_three_quarters_pow2(const int e) {
+  return (int) (((int64_t) e * 661971961083LL - 274743187321LL) >> 41);
+}
+
+static int ins_text_flog2_pow10(const int e) {
+  return (int) ((int64_t) e * 913124641741LL >> 38);
+}
+
+// Returns the 126-bit approximation g = floor(10^-k * 2^m) + 1 of 10^-k
+// with 2^125 <= g < 2^126 as its high and low 63 bits. The normalized 10^-k
+// and 5^-k share their bits, so g is the table entry of 5^-k shifted right
+// by two, plus one. The entries for -27 <= q < 0 are the reciprocals rounded
+// up by one unit; all other entries are truncated at 128 bits.
+static void ins_text_pow10_126(const int k, uint64_t * g1, uint64_t * g0) {
+  const int q = -k;
+  const int index = 2 * (q - INS_POW5_MIN);
+
+  uint64_t high = ins_pow5_128[index];
+  uint64_t low = ins_pow5_128[index + 1];
+
+  if (q < 0 && q >= -27) {
+    high -= low == 0;
+    --low;
+  }
+
+  low = (low >> 2) | (high << 62);
+  high >>= 2;
+
+  ++low;
+  high += low == 0;
+
+  *g1 = (high << 1) | (low >> 63);
+  *g0 = low & INS_TEXT_MASK63;
+}
+
+// Computes g * cp / 2^127, rounded to odd.
+static uint64_t ins_text_rop(const uint64_t g1, const uint64_t g0,
+                             const uint64_t cp) {
+  uint64_t x1, y0, y1, unused;
+  uint64_t z;
+
+  ins_mul128(g0, cp, &x1, &unused);
+  ins_mul128(g1, cp, &y1, &y0);
+
+  z = (y0 >> 1) + x1;
+  return (y1 + (z >> 63)) | (((z & INS_TEXT_MASK63) + INS_TEXT_MASK63) >> 63);
+}
+
+// Computes the shortest representation of `c * 2^q`, a finite positive
+// number of a binary format whose smallest normal significand is `c_min`
+// and whose smallest exponent is `q_min`. The result is scaled by `10^dk`.
+static void ins_text_schubfach(const int q, const uint64_t c, const int dk,
+                               const uint64_t c_min, const int q_min,
+                               ins_text_decimal * d) {
+  const uint64_t out = c & 1;
+  const uint64_t cb = c << 2;
+  const uint64_t cbr = cb + 2;
+
+  uint64_t cbl, g1, g0, vb, vbl, vbr, s, t;
+  int k, h, uin, win;
+
+  if (c != c_min || q == q_min) {
+    cbl = cb - 2;
+    k = ins_text_flog10_pow2(q);
+  } else {
+    // The rounding interval of a power of two is asymmetric.
+    cbl = cb - 1;
+    k = ins_text_flog10_three_quarters_pow2(q);
+  }
+
+  h = q + ins_text_flog2_pow10(-k) + 2;
+  ins_text_pow10_126(k, &g1, &g0);
+
+  vb = ins_text_rop(g1, g0, cb << h);
+  vbl = ins_text_rop(g1, g0, cbl << h);
+  vbr = ins_text_rop(g1, g0, cbr << h);
+
+  s = vb >> 2;
+
+  // One digit shorter than `s`.
+  if (s >= 100) {
+    const uint64_t sp10 = s / 10 * 10;
+    const uint64_t tp10 = sp10 + 10;
+    const int upin = vbl + out <= sp10 << 2;
+    const int wpin = (tp10 << 2) + out <= vbr;
+
+    if (upin != wpin) {
+      d->digits = upin ? sp10 : tp10;
+      d->exponent = k;
+      return;
+    }
+  }
+
+  t = s + 1;
+  uin = vbl + out <= s << 2;
+  win = (t << 2) + out <= vbr;
+
+  if (uin != win) {
+    d->digits = uin ? s : t;
+  } else {
+    const uint64_t mid = (s + t) << 1;
+    d->digits = vb < mid || (vb == mid && (s & 1) == 0) ? s : t;
+  }
+
+  d->exponent = k + dk;
+}
+
+static void ins_text_strip_zeros(ins_text_decimal * d) {
+  while (d->digits % 10 == 0) {
+    d->digits /= 10;
+    ++d->exponent;
+  }
+}
+
+// Schubfach yields at least two significant digits, and subnormals, whose
+// rounding intervals are wide, can need fewer. Since a decimal that reads
+// back correctly with fewer digits implies one with one digit less than `d`
+// that does, the digits are dropped one at a time, checking the candidates
+// by reading them back. Candidates are written without a decimal point so
+// that `strtod` is independent of the locale.
+static void ins_text_shorten(ins_text_decimal * d, const double x,
+                             const int single) {
+  const double magnitude = x < 0 ? -x : x;
+
+  char buf[32];
+
+  while (d->digits >= 10) {
+    const uint64_t lo = d->digits / 10;
+    const uint64_t rem = d->digits % 10;
+    const int up = rem > 5 || (rem == 5 && (lo & 1) != 0);
+
+    int i;
+
+    for (i = 0; i < 2; ++i) {
+      const uint64_t candidate = lo + (uint64_t) (i == 0 ? up : !up);
+
+      sprintf(buf, "%llue%d", (unsigned long long) candidate,
+              d->exponent + 1);
+
+      if (single ? strtof(buf, 0) == (float) magnitude
+                 : strtod(buf, 0) == magnitude) {
+        break;
+      }
+    }
+
+    if (i == 2) {
+      return;
+    }
+
+    d->digits = lo + (uint64_t) (i == 0 ? up : !up);
+    ++d->exponent;
+    ins_text_strip_zeros(d);
+  }
+}
+
+// Computes the shortest representation of the finite non-zero double with
+// biased exponent `biased` and the explicit significand bits `fraction`.
+static void ins_text_shortest64(const int biased, const uint64_t fraction,
+                                ins_text_decimal * d) {
+  const uint64_t c_min = 1ULL << 52;
+  const int q_min = -1074;
+
+  if (biased != 0) {
+    const int mq = 1075 - biased;
+    const uint64_t c = c_min | fraction;
+
+    // Integers are their own shortest representation.
+    if (mq > 0 && mq < 53 && (c >> mq) << mq == c) {
+      d->digits = c >> mq;
+      d->exponent = 0;
+    } else {
+      ins_text_schubfach(-mq, c, 0, c_min, q_min, d);
+    }
+  } else if (fraction < 3) {
+    // The smallest subnormals are scaled up by ten to keep `s` long enough.
+    ins_text_schubfach(q_min, 10 * fraction, -1, c_min, q_min, d);
+  } else {
+    ins_text_schubfach(q_min, fraction, 0, c_min, q_min, d);
+  }
+
+  ins_text_strip_zeros(d);
+}
+
+// The same for floats. The double precision approximations of the powers
+// of ten are more than accurate enough.
+static void ins_text_shortest32(const int biased, const uint64_t fraction,
+                                ins_text_decimal * d) {
+  const uint64_t c_min = 1ULL << 23;
+  const int q_min = -149;
+
+  if (biased != 0) {
+    const int mq = 150 - biased;
+    const uint64_t c = c_min | fraction;
+
+    if (mq > 0 && mq < 24 && (c >> mq) << mq == c) {
+      d->digits = c >> mq;
+      d->exponent = 0;
+    } else {
+      ins_text_schubfach(-mq, c, 0, c_min, q_min, d);
+    }
+  } else if (fraction < 8) {
+    ins_text_schubfach(q_min, 10 * fraction, -1, c_min, q_min, d);
+  } else {
+    ins_text_schubfach(q_min, fraction, 0, c_min, q_min, d);
+  }
+
+  ins_text_strip_zeros(d);
+}
+
+/* Layout
+ --------------------------------------------------------------------------*/
+
+static char * ins_text_put_special(char * p, const int nan, const int upper) {
+  memcpy(p, nan ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf"), 3);
+  return p + 3;
+}
+
+// Writes `q * 10^r` in fixed notation with `-r` fraction digits.
+static char * ins_text_put_fixed(char * p, const uint64_t q, const int r) {
+  const int n = ins_text_num_digits(q);
+
+  if (r >= 0) {
+    ins_text_put_digits(p, q, n);
+    memset(p + n, '0', (size_t) r);
+    return p + n + r;
+  } else {
+    const int f = -r;
+    const int w = n > f ? n : f + 1;
+
+    ins_text_put_digits(p, q, w);
+    memmove(p + w - f + 1, p + w - f, (size_t) f);
+    p[w - f] = '.';
+    return p + w + 1;
+  }
+}
+
+// Writes the `n` digits of `q` in scientific notation, with the first digit
+// in front of the decimal point and the exponent `x`.
+static char * ins_text_put_scientific(char * p, const uint64_t q, const int n,
+                                      int x, const char e) {
+  ins_text_put_digits(p + 1, q, n);
+  p[0] = p[1];
+
+  if (n > 1) {
+    p[1] = '.';
+    p += n + 1;
+  } else {
+    p += 1;
+  }
+
+  *p++ = e;
+
+  if (x < 0) {
+    *p++ = '-';
+    x = -x;
+  } else {
+    *p++ = '+';
+  }
+
+  if (x >= 100) {
+    *p++ = (char) ('0' + x / 100);
+    x %= 100;
+  }
+
+  memcpy(p, ins_text_digit_pairs + 2 * x, 2);
+  return p + 2;
+}
+
+// Lays out a shortest representation like `%.17g` would.
+static char * ins_text_put_shortest(char * p, const ins_text_decimal * d) {
+  const int n = ins_text_num_digits(d->digits);
+  const int x = d->exponent + n - 1;
+
+  if (x >= -4 && x < 17) {
+    return ins_text_put_fixed(p, d->digits, d->exponent);
+  }
+
+  return ins_text_put_scientific(p, d->digits, n, x, 'e');
+}
+
+/* Fixed precision
+ --------------------------------------------------------------------------*/
+
+// Rounds the normal number whose shortest representation is `d`, with `n`
+// digits, to a multiple `*q` of `10^r`. The result is that of rounding the
+// exact binary value unless the function returns -1: the shortest
+// representation lies strictly closer to the number than any decimal with
+// fewer digits, so rounding it to fewer digits gives the same result unless
+// it is itself a tie. Padding it with zeros is exact up to 15 digits, where
+// a unit in the last place of a double is below half a decimal unit, and
+// for any number of digits if the rounding interval is symmetric, in which
+// case the shortest representation is also the closest.
+static int ins_text_round(const ins_text_decimal * d, const int n,
+                          const int symmetric, const int r, uint64_t * q) {
+  const int kept = d->exponent + n - r;
+
+  if (kept >= n) {
+    if (kept > 15 && !(kept == n && symmetric)) {
+      return -1;
+    }
+
+    *q = d->digits * ins_text_pow10[kept - n];
+    return 0;
+  }
+
+  if (kept < 0) {
+    *q = 0;
+    return 0;
+  }
+
+  {
+    const uint64_t p = ins_text_pow10[n - kept];
+    const uint64_t rem = d->digits % p;
+
+    *q = d->digits / p;
+
+    if (rem > p / 2) {
+      ++*q;
+    } else if (rem == p / 2) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// Formats the finite number `d` of the double with the given exponent and
+// significand bits with a `%e`, `%f` or `%g` conversion. Returns the end of
+// the output, or 0 if the result has to come from `snprintf`.
+static char * ins_text_put_precision(char * p, const ins_text_format * format,
+                                     const ins_text_decimal * d,
+                                     const int biased,
+                                     const uint64_t fraction) {
+  const int conversion = format->conversion;
+  const int precision = format->precision;
+  const int symmetric = fraction != 0;
+  const int zero = d->digits == 0;
+  const int n = ins_text_num_digits(d->digits);
+  const int x = d->exponent + n - 1;
+
+  uint64_t q = 0;
+  int r;
+
+  // Subnormals are rare enough to be left to `snprintf`.
+  if (biased == 0 && !zero) {
+    return 0;
+  }
+
+  if (conversion == 'f' || conversion == 'F') {
+    r = -precision;
+    if (!zero && ins_text_round(d, n, symmetric, r, &q) != 0) {
+      return 0;
+    }
+    return ins_text_put_fixed(p, q, r);
+  }
+
+  if (conversion == 'e' || conversion == 'E') {
+    r = zero ? -precision : x - precision;
+    if (!zero && ins_text_round(d, n, symmetric, r, &q) != 0) {
+      return 0;
+    }
+    if (!zero && q == ins_text_pow10[precision + 1]) {
+      q /= 10;
+      ++r;
+    }
+    return ins_text_put_scientific(p, q, precision + 1, r + precision,
+                                   (char) (conversion == 'e' ? 'e' : 'E'));
+  }
+
+  {
+    // `%g` picks fixed or scientific notation by the exponent of the number
+    // rounded to `precision` significant digits, and drops trailing zeros.
+    const int digits = precision == 0 ? 1 : precision;
+
+    int k = digits;
+    int y;
+
+    r = zero ? 1 - digits : x - digits + 1;
+    if (!zero && ins_text_round(d, n, symmetric, r, &q) != 0) {
+      return 0;
+    }
+    if (!zero && q == ins_text_pow10[digits]) {
+      q /= 10;
+      ++r;
+    }
+
+    y = r + digits - 1;
+
+    if (y >= -4 && y < digits) {
+      while (r < 0 && q % 10 == 0) {
+        q /= 10;
+        ++r;
+      }
+      return ins_text_put_fixed(p, q, r);
+    }
+
+    while (k > 1 && q % 10 == 0) {
+      q /= 10;
+      --k;
+    }
+    return ins_text_put_scientific(p, q, k, y,
+                                   (char) (conversion == 'g' ? 'e' : 'E'));
+  }
+}
+
+/* Public functions
+ --------------------------------------------------------------------------*/
+
+int ins_text_write_double(ins_text_writer * writer,
+                          const ins_text_format * format, const double x) {
+  const int conversion = format->conversion;
+
+  uint64_t bits, fraction;
+  int biased;
+  ins_text_decimal d;
+  char * p;
+  char * end;
+
+  if (conversion == INS_TEXT_PRINTF || conversion == 'd' ||
+      conversion == 'i') {
+    return ins_text_write_printf(writer, format->format, x);
+  }
+
+  if (ins_text_reserve(writer, INS_TEXT_MAX_FIELD) != 0) {
+    return -1;
+  }
+
+  memcpy(&bits, &x, sizeof(bits));
+  biased = (int) (bits >> 52) & 0x7ff;
+  fraction = bits & 0xfffffffffffffULL;
+
+  p = writer->buffer + writer->length;
+
+  if (bits >> 63) {
+    *p++ = '-';
+  }
+
+  if (biased == 0x7ff) {
+    end = ins_text_put_special(p, fraction != 0,
+                               conversion == 'E' || conversion == 'F' ||
+                               conversion == 'G');
+  } else {
+    if (biased == 0 && fraction == 0) {
+      d.digits = 0;
+      d.exponent = 0;
+    } else {
+      ins_text_shortest64(biased, fraction, &d);
+      if (biased == 0) {
+        ins_text_shorten(&d, x, 0);
+      }
+    }
+
+    if (conversion == INS_TEXT_SHORTEST) {
+      end = ins_text_put_shortest(p, &d);
+    } else {
+      end = ins_text_put_precision(p, format, &d, biased, fraction);
+      if (end == 0) {
+        return ins_text_write_printf(writer, format->format, x);
+      }
+    }
+  }
+
+  writer->length = (size_t) (end - writer->buffer);
+  return 0;
+}
+
+int ins_text_write_float(ins_text_writer * writer,
+                         const ins_text_format * format, const float x) {
+  uint32_t bits;
+  uint64_t fraction;
+  int biased;
+  ins_text_decimal d;
+  char * p;
+
+  if (format->conversion != INS_TEXT_SHORTEST) {
+    return ins_text_write_double(writer, format, x);
+  }
+
+  if (ins_text_reserve(writer, INS_TEXT_MAX_FIELD) != 0) {
+    return -1;
+  }
+
+  memcpy(&bits, &x, sizeof(bits));
+  biased = (int) (bits >> 23) & 0xff;
+  fraction = bits & 0x7fffffU;
+
+  p = writer->buffer + writer->length;
+
+  if (bits >> 31) {
+    *p++ = '-';
+  }
+
+  if (biased == 0xff) {
+    p = ins_text_put_special(p, fraction != 0, 0);
+  } else {
+    if (biased == 0 && fraction == 0) {
+      d.digits = 0;
+      d.exponent = 0;
+    } else {
+      ins_text_shortest32(biased, fraction, &d);
+      if (biased == 0) {
+        ins_text_shorten(&d, x, 1);
+      }
+    }
+    p = ins_text_put_shortest(p, &d);
+  }
+
+  writer->length = (size_t) (p - writer->buffer);
+  return 0;
+}
+
+int ins_text_write_int(ins_text_writer * writer,
+                       const ins_text_format * format, const int x) {
+  const int conversion = format->conversion;
+  char * p;
+
+  if (conversion != INS_TEXT_SHORTEST && conversion != 'd' &&
+      conversion != 'i') {
+    return ins_text_write_printf(writer, format->format, x);
+  }
+
+  if (ins_text_reserve(writer, INS_TEXT_MAX_FIELD) != 0) {
+    return -1;
+  }
+
+  p = ins_text_put_int(writer->buffer + writer->length, x);
+  writer->length = (size_t) (p - writer->buffer);
+  return 0;
+}
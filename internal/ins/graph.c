@@ -0,0 +1,540 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ins/ins_errno_io.h"
+#include "ins/ins_graph_io.h"
+#include "ins/ins_tuning_io.h"
+
+// Fused chains run on slices of their vectors at a time. The slices of
+// eight vectors of doubles fill the L2 cache of the tuning, or 256 KiB if
+// it is unknown, and have at least this many elements.
+#define INS_GRAPH_MIN_SLICE 256
+
+struct ins_graph {
+  ins_graph_node ** nodes;
+  size_t size;
+  size_t capacity;
+  int fusion;
+};
+
+// A thread of a run and its deque of ready chains, guarded by `mutex`. The
+// thread pushes and pops at `bottom`; other threads steal at `top`.
+typedef struct ins_graph_worker ins_graph_worker;
+
+// The state of a run.
+typedef struct {
+  ins_graph_worker * workers;
+  size_t num_workers;
+
+  // The number of elements of the slices that fused chains run on.
+  size_t slice;
+
+  // The numbers of chains that have not finished, and of chains in the
+  // deques, read and written atomically. Idle threads wait on `wake` until
+  // either changes.
+  size_t remaining;
+  size_t queued;
+  pthread_mutex_t mutex;
+  pthread_cond_t wake;
+
+  // The error code of the first node that failed, and the error recorded
+  // by the thread that ran it, guarded by `mutex`.
+  int status;
+  ins_error_record error;
+
+  // The handlers and stream of the calling thread, which the other threads
+  // of the run take on.
+  ins_error_context context;
+} ins_graph_state;
+
+struct ins_graph_worker {
+  ins_graph_state * state;
+  size_t index;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  ins_graph_node ** deque;
+  size_t top;
+  size_t bottom;
+};
+
+ins_graph * ins_graph_alloc(void) {
+  ins_graph * graph = (ins_graph *) calloc(1, sizeof(ins_graph));
+
+  if (graph == 0) {
+    INS_ERROR_VAL("failed to allocate space for graph", INS_ENOMEM, 0);
+  }
+
+  return graph;
+}
+
+void ins_graph_free(ins_graph * graph) {
+  size_t i;
+
+  if (graph == 0) { return; }
+
+  for (i = 0; i < graph->size; ++i) {
+    free(graph->nodes[i]->successors);
+    free(graph->nodes[i]);
+  }
+
+  free(graph->nodes);
+  free(graph);
+}
+
+void ins_graph_set_fusion(ins_graph * graph, const int enabled) {
+  graph->fusion = enabled != 0;
+}
+
+size_t ins_graph_size(const ins_graph * graph) {
+  return graph->size;
+}
+
+// Returns non-zero if the accesses `a` and `b` overlap and one writes.
+static int ins_graph_conflict(const ins_graph_access * a,
+                              const ins_graph_access * b) {
+  return (a->write || b->write) && a->begin < b->end && b->begin < a->end;
+}
+
+// Adds the edge from `before` to `node`, unless there is one. Returns 0, or
+// -1 if there is not enough memory.
+static int ins_graph_edge(ins_graph_node * before, ins_graph_node * node) {
+  size_t i;
+
+  for (i = 0; i < before->num_successors; ++i) {
+    if (before->successors[i] == node) {
+      return 0;
+    }
+  }
+
+  if (before->num_successors == before->max_successors) {
+    const size_t capacity = before->max_successors ? 2 * before->max_successors
+                                                   : 4;
+    ins_graph_node ** successors = (ins_graph_node **) realloc(
+        before->successors, capacity * sizeof(ins_graph_node *));
+
+    if (successors == 0) {
+      return -1;
+    }
+
+    before->successors = successors;
+    before->max_successors = capacity;
+  }
+
+  before->successors[before->num_successors++] = node;
+  ++node->num_predecessors;
+
+  return 0;
+}
+
+void ins_graph_access_vector(ins_graph_node * node, const void * data,
+                             const size_t n, const ptrdiff_t stride,
+                             const size_t size, const int write) {
+  ins_graph_access * access = &node->accesses[node->num_accesses++];
+  const char * first = (const char *) data;
+  const ptrdiff_t span = n > 0 ? (ptrdiff_t) (n - 1) * stride : 0;
+
+  // The elements of a reversed view lie before `data`.
+  access->begin = span < 0 ? first + span * (ptrdiff_t) size : first;
+  access->end = (span < 0 ? first : first + span * (ptrdiff_t) size) +
+                (n > 0 ? size : 0);
+  access->stride = stride;
+  access->write = write;
+}
+
+void ins_graph_access_scalar(ins_graph_node * node, const void * data,
+                             const size_t size, const int write) {
+  ins_graph_access * access = &node->accesses[node->num_accesses++];
+
+  access->begin = (const char *) data;
+  access->end = (const char *) data + size;
+  access->stride = 0;
+  access->write = write;
+}
+
+ins_graph_node * ins_graph_record(ins_graph * graph,
+                                  const ins_graph_node * node) {
+  ins_graph_node * copy;
+  size_t i, j, k;
+
+  if (graph->size == graph->capacity) {
+    const size_t capacity = graph->capacity ? 2 * graph->capacity : 16;
+    ins_graph_node ** nodes = (ins_graph_node **) realloc(
+        graph->nodes, capacity * sizeof(ins_graph_node *));
+
+    if (nodes == 0) {
+      INS_ERROR_VAL("failed to allocate space for graph nodes", INS_ENOMEM,
+                    0);
+    }
+
+    graph->nodes = nodes;
+    graph->capacity = capacity;
+  }
+
+  copy = (ins_graph_node *) malloc(sizeof(ins_graph_node));
+
+  if (copy == 0) {
+    INS_ERROR_VAL("failed to allocate space for graph node", INS_ENOMEM, 0);
+  }
+
+  *copy = *node;
+  copy->graph = graph;
+  copy->index = graph->size;
+  copy->successors = 0;
+  copy->num_successors = 0;
+  copy->max_successors = 0;
+  copy->num_predecessors = 0;
+
+  for (i = 0; i < graph->size; ++i) {
+    ins_graph_node * before = graph->nodes[i];
+    int conflict = 0;
+
+    for (j = 0; j < before->num_accesses && !conflict; ++j) {
+      for (k = 0; k < copy->num_accesses && !conflict; ++k) {
+        conflict = ins_graph_conflict(&before->accesses[j],
+                                      &copy->accesses[k]);
+      }
+    }
+
+    if (conflict && ins_graph_edge(before, copy) != 0) {
+      // Edges to the node are dropped with it.
+      for (j = 0; j < i; ++j) {
+        before = graph->nodes[j];
+        if (before->num_successors > 0 &&
+            before->successors[before->num_successors - 1] == copy) {
+          --before->num_successors;
+        }
+      }
+      free(copy);
+      INS_ERROR_VAL("failed to allocate space for graph edges", INS_ENOMEM,
+                    0);
+    }
+  }
+
+  graph->nodes[graph->size++] = copy;
+
+  return copy;
+}
+
+ins_graph_node * ins_graph_task(ins_graph * graph, ins_graph_task_t * task,
+                                void * context) {
+  ins_graph_node node;
+
+  memset(&node, 0, sizeof(node));
+  node.task = task;
+  node.context = context;
+
+  return ins_graph_record(graph, &node);
+}
+
+int ins_graph_depend(ins_graph_node * node, ins_graph_node * before) {
+  if (before->graph != node->graph || before->index >= node->index) {
+    INS_ERROR("dependency must be recorded earlier in the same graph",
+              INS_EINVAL);
+  }
+
+  if (ins_graph_edge(before, node) != 0) {
+    INS_ERROR("failed to allocate space for graph edges", INS_ENOMEM);
+  }
+
+  return INS_SUCCESS;
+}
+
+// Returns non-zero if `node` can run in slices together with the chain
+// starting at `head`: its accesses that conflict with those of the chain
+// must be to the same vectors.
+static int ins_graph_fusable(const ins_graph_node * head,
+                             const ins_graph_node * node) {
+  const ins_graph_node * other;
+  size_t j, k;
+
+  for (other = head; other != 0; other = other->next) {
+    for (j = 0; j < other->num_accesses; ++j) {
+      for (k = 0; k < node->num_accesses; ++k) {
+        const ins_graph_access * a = &other->accesses[j];
+        const ins_graph_access * b = &node->accesses[k];
+
+        if (ins_graph_conflict(a, b) &&
+            (a->stride == 0 || a->begin != b->begin || a->end != b->end ||
+             a->stride != b->stride)) {
+          return 0;
+        }
+      }
+    }
+  }
+
+  return 1;
+}
+
+// Links the nodes of `graph` into chains, fusing elementwise nodes if
+// fusion is on, and sets their dependencies left to run. Returns the number
+// of chains.
+static size_t ins_graph_chain(ins_graph * graph) {
+  size_t chains = 0;
+  size_t i;
+
+  for (i = 0; i < graph->size; ++i) {
+    ins_graph_node * node = graph->nodes[i];
+
+    node->head = node;
+    node->next = 0;
+    node->pending = node->num_predecessors;
+  }
+
+  for (i = 0; i < graph->size; ++i) {
+    ins_graph_node * node = graph->nodes[i];
+    ins_graph_node * tail = 0;
+    size_t j;
+
+    // The only node `node` depends on must have `node` as its only
+    // successor, and be the tail of its chain.
+    for (j = 0; graph->fusion && node->elementwise &&
+                node->num_predecessors == 1 && j < i; ++j) {
+      ins_graph_node * before = graph->nodes[j];
+
+      if (before->num_successors == 1 && before->successors[0] == node) {
+        tail = before;
+      }
+    }
+
+    if (tail != 0 && tail->elementwise && tail->next == 0 &&
+        tail->length == node->length &&
+        ins_graph_fusable(tail->head, node)) {
+      tail->next = node;
+      node->head = tail->head;
+    } else {
+      ++chains;
+    }
+  }
+
+  return chains;
+}
+
+// Returns the number of elements of the slices of fused chains.
+static size_t ins_graph_slice(void) {
+  const size_t l2_cache = ins_tuning_get(&ins_tuning_current.l2_cache);
+  const size_t slice =
+      (l2_cache > 0 ? l2_cache : (size_t) 1 << 18) / (8 * sizeof(double));
+
+  return slice < INS_GRAPH_MIN_SLICE ? INS_GRAPH_MIN_SLICE : slice;
+}
+
+// Runs the chain starting at `head`, in slices if it has more than one
+// node, and returns the chain's last node.
+static ins_graph_node * ins_graph_execute(ins_graph_state * state,
+                                          ins_graph_node * head) {
+  ins_graph_node * node = head;
+  int status = __atomic_load_n(&state->status, __ATOMIC_RELAXED);
+  int expected = INS_SUCCESS;
+
+  if (head->next == 0) {
+    if (status == INS_SUCCESS) {
+      status = head->task ? head->task(head->context)
+                          : head->op(head, 0, head->length);
+    }
+  } else {
+    size_t offset;
+
+    for (offset = 0; offset < head->length && status == INS_SUCCESS;
+         offset += state->slice) {
+      const size_t n = head->length - offset < state->slice
+                           ? head->length - offset
+                           : state->slice;
+
+      for (node = head; node != 0 && status == INS_SUCCESS;
+           node = node->next) {
+        status = node->op(node, offset, n);
+      }
+    }
+  }
+
+  if (status != INS_SUCCESS &&
+      __atomic_compare_exchange_n(&state->status, &expected, status, 0,
+                                  __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    pthread_mutex_lock(&state->mutex);
+    state->error = *ins_last_error();
+    pthread_mutex_unlock(&state->mutex);
+  }
+
+  for (node = head; node->next != 0; node = node->next) {
+  }
+
+  return node;
+}
+
+static void ins_graph_push(ins_graph_worker * worker, ins_graph_node * head) {
+  ins_graph_state * state = worker->state;
+
+  pthread_mutex_lock(&worker->mutex);
+  worker->deque[worker->bottom++] = head;
+  pthread_mutex_unlock(&worker->mutex);
+
+  __atomic_add_fetch(&state->queued, 1, __ATOMIC_SEQ_CST);
+
+  pthread_mutex_lock(&state->mutex);
+  pthread_cond_signal(&state->wake);
+  pthread_mutex_unlock(&state->mutex);
+}
+
+// Takes the newest chain of the deque of `worker` if `steal` is zero, and
+// the oldest one otherwise. Returns null if the deque is empty.
+static ins_graph_node * ins_graph_take(ins_graph_worker * worker,
+                                       const int steal) {
+  ins_graph_node * head = 0;
+
+  pthread_mutex_lock(&worker->mutex);
+
+  if (worker->top < worker->bottom) {
+    head = steal ? worker->deque[worker->top++]
+                 : worker->deque[--worker->bottom];
+  }
+
+  pthread_mutex_unlock(&worker->mutex);
+
+  if (head != 0) {
+    __atomic_sub_fetch(&worker->state->queued, 1, __ATOMIC_SEQ_CST);
+  }
+
+  return head;
+}
+
+static void * ins_graph_work(void * arg) {
+  ins_graph_worker * worker = (ins_graph_worker *) arg;
+  ins_graph_state * state = worker->state;
+
+  ins_set_error_context(&state->context);
+
+  for (;;) {
+    ins_graph_node * head = ins_graph_take(worker, 0);
+    size_t i;
+
+    for (i = 1; head == 0 && i < state->num_workers; ++i) {
+      head = ins_graph_take(
+          &state->workers[(worker->index + i) % state->num_workers], 1);
+    }
+
+    if (head != 0) {
+      ins_graph_node * tail = ins_graph_execute(state, head);
+
+      for (i = 0; i < tail->num_successors; ++i) {
+        ins_graph_node * next = tail->successors[i];
+
+        if (__atomic_sub_fetch(&next->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+          ins_graph_push(worker, next);
+        }
+      }
+
+      if (__atomic_sub_fetch(&state->remaining, 1, __ATOMIC_SEQ_CST) == 0) {
+        pthread_mutex_lock(&state->mutex);
+        pthread_cond_broadcast(&state->wake);
+        pthread_mutex_unlock(&state->mutex);
+      }
+
+      continue;
+    }
+
+    pthread_mutex_lock(&state->mutex);
+
+    while (__atomic_load_n(&state->queued, __ATOMIC_SEQ_CST) == 0 &&
+           __atomic_load_n(&state->remaining, __ATOMIC_SEQ_CST) != 0) {
+      pthread_cond_wait(&state->wake, &state->mutex);
+    }
+
+    pthread_mutex_unlock(&state->mutex);
+
+    if (__atomic_load_n(&state->remaining, __ATOMIC_SEQ_CST) == 0) {
+      return 0;
+    }
+  }
+}
+
+int ins_graph_run(ins_graph * graph, const int threads) {
+  ins_graph_state state;
+  ins_graph_node ** deques;
+  size_t chains, count, started, i, ready = 0;
+
+  if (graph->size == 0) {
+    return INS_SUCCESS;
+  }
+
+  chains = ins_graph_chain(graph);
+  count = threads > 0 ? (size_t) threads : (size_t) ins_tuning_threads();
+  if (count > chains) {
+    count = chains;
+  }
+
+  state.workers = (ins_graph_worker *) malloc(count * sizeof(ins_graph_worker));
+  deques = (ins_graph_node **) malloc(count * chains *
+                                      sizeof(ins_graph_node *));
+
+  if (state.workers == 0 || deques == 0) {
+    free(state.workers);
+    free(deques);
+    INS_ERROR("failed to allocate space for graph run", INS_ENOMEM);
+  }
+
+  state.num_workers = count;
+  state.slice = ins_graph_slice();
+  state.remaining = chains;
+  state.queued = 0;
+  state.status = INS_SUCCESS;
+  memset(&state.error, 0, sizeof(state.error));
+  ins_get_error_context(&state.context);
+  pthread_mutex_init(&state.mutex, 0);
+  pthread_cond_init(&state.wake, 0);
+
+  for (i = 0; i < count; ++i) {
+    state.workers[i].state = &state;
+    state.workers[i].index = i;
+    state.workers[i].deque = deques + i * chains;
+    state.workers[i].top = 0;
+    state.workers[i].bottom = 0;
+    pthread_mutex_init(&state.workers[i].mutex, 0);
+  }
+
+  // The chains that are ready at the start are dealt to the threads in
+  // turn.
+  for (i = 0; i < graph->size; ++i) {
+    ins_graph_node * node = graph->nodes[i];
+
+    if (node->head == node && node->pending == 0) {
+      ins_graph_worker * worker = &state.workers[ready++ % count];
+      worker->deque[worker->bottom++] = node;
+      ++state.queued;
+    }
+  }
+
+  for (started = 1; started < count; ++started) {
+    if (pthread_create(&state.workers[started].thread, 0, ins_graph_work,
+                       &state.workers[started]) != 0) {
+      break;
+    }
+  }
+
+  ins_graph_work(&state.workers[0]);
+
+  for (i = 1; i < started; ++i) {
+    pthread_join(state.workers[i].thread, 0);
+  }
+
+  for (i = 0; i < count; ++i) {
+    pthread_mutex_destroy(&state.workers[i].mutex);
+  }
+
+  pthread_cond_destroy(&state.wake);
+  pthread_mutex_destroy(&state.mutex);
+  free(deques);
+  free(state.workers);
+
+  // The handler has been called on the thread that failed, so the error is
+  // only recorded here. Tasks may fail without recording an error.
+  if (state.status != INS_SUCCESS) {
+    if (state.error.error_code == state.status) {
+      ins_record_error(state.error.reason, state.error.file, state.error.line,
+                       state.status);
+    } else {
+      ins_record_error("graph node failed", __FILE__, __LINE__, state.status);
+    }
+  }
+
+  return state.status;
+}
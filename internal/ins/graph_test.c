@@ -0,0 +1,248 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+#include <ins/ins_graph.h>
+#include <ins/ins_tuning.h>
+
+typedef struct {
+  const double * xy;
+  const double * xx;
+  double * alpha;
+} ratio_context;
+
+static int ratio(void * context) {
+  ratio_context * c = (ratio_context *) context;
+  *c->alpha = *c->xy / *c->xx;
+  return INS_SUCCESS;
+}
+
+static int fail(void * context) {
+  (void) context;
+  return INS_EFAILED;
+}
+
+static int count(void * context) {
+  ++*(int *) context;
+  return INS_SUCCESS;
+}
+
+typedef struct {
+  ins_vector * x;
+  const ins_vector * y;
+  pthread_t caller;
+} add_context;
+
+// Adds vectors of different lengths, which fails, on the threads of the
+// pool, and gives them time to start on the calling thread.
+static int add(void * context) {
+  add_context * c = (add_context *) context;
+  const struct timespec pause = {0, 1000000};
+
+  if (pthread_equal(pthread_self(), c->caller)) {
+    nanosleep(&pause, 0);
+    return INS_SUCCESS;
+  }
+
+  return ins_vector_add(c->x, c->y);
+}
+
+static void test_dependencies(void **state) {
+  (void) state;
+
+  const size_t n = 1000;
+  ins_vector * x = ins_vector_alloc(n);
+  ins_vector * y = ins_vector_alloc(n);
+  ins_vector * z = ins_vector_alloc(n);
+  double xy, xx, alpha, min, max, two = 2.0;
+  ratio_context context = {&xy, &xx, &alpha};
+  ins_graph * graph = ins_graph_alloc();
+  ins_graph_node * dot_xy;
+  ins_graph_node * dot_xx;
+  ins_graph_node * task;
+  ins_graph_node * axpy;
+  size_t i;
+  int run;
+
+  for (run = 1; run <= 4; ++run) {
+    for (i = 0; i < n; ++i) {
+      ins_vector_set(x, i, (double) (i % 7));
+      ins_vector_set(y, i, 1.0);
+      ins_vector_set(z, i, (double) i - 500.0);
+    }
+
+    // The first run also records the graph.
+    if (run == 1) {
+      ins_vector_graph_scale(graph, x, &two);
+      dot_xy = ins_vector_graph_dot(graph, x, y, &xy);
+      dot_xx = ins_vector_graph_dot(graph, x, x, &xx);
+      ins_vector_graph_minmax(graph, z, &min, &max);
+      task = ins_graph_task(graph, ratio, &context);
+      assert_int_equal(ins_graph_depend(task, dot_xy), INS_SUCCESS);
+      assert_int_equal(ins_graph_depend(task, dot_xx), INS_SUCCESS);
+      axpy = ins_vector_graph_axpy(graph, &alpha, x, y);
+      assert_int_equal(ins_graph_depend(axpy, task), INS_SUCCESS);
+      assert_int_equal(ins_graph_size(graph), 6);
+    }
+
+    assert_int_equal(ins_graph_run(graph, run), INS_SUCCESS);
+
+    // The scaling runs before both dots read `x`, and `axpy` after the task
+    // computes `alpha` and the first dot reads `y`.
+    for (i = 0, xx = 0.0, xy = 0.0; i < n; ++i) {
+      xy += 2.0 * (double) (i % 7);
+      xx += 4.0 * (double) (i % 7) * (double) (i % 7);
+    }
+    assert_true(alpha == xy / xx);
+    assert_true(min == -500.0);
+    assert_true(max == 499.0);
+    for (i = 0; i < n; ++i) {
+      const double error =
+          ins_vector_get(y, i) - (1.0 + alpha * 2.0 * (double) (i % 7));
+      assert_true(error < 1e-12 && error > -1e-12);
+    }
+  }
+
+  ins_graph_free(graph);
+  ins_vector_free(z);
+  ins_vector_free(y);
+  ins_vector_free(x);
+}
+
+static void test_fusion(void **state) {
+  (void) state;
+
+  const size_t n = 10000;
+  ins_vector_float * x = ins_vector_float_alloc(n);
+  ins_vector_float * y = ins_vector_float_alloc(n);
+  ins_vector_float * expected = ins_vector_float_alloc(n);
+  float half = 0.5F, three = 3.0F, sum;
+  ins_tuning saved, tuning;
+  int fusion;
+  size_t i;
+
+  ins_get_tuning(&saved);
+
+  // The last run fuses in the smallest slices, as for a small L2 cache.
+  for (fusion = 0; fusion <= 2; ++fusion) {
+    ins_graph * graph = ins_graph_alloc();
+    ins_graph_set_fusion(graph, fusion > 0);
+
+    if (fusion == 2) {
+      tuning = saved;
+      tuning.l2_cache = 1024;
+      ins_set_tuning(&tuning);
+    }
+
+    for (i = 0; i < n; ++i) {
+      ins_vector_float_set(x, i, (float) (i % 13));
+      ins_vector_float_set(y, i, (float) (i % 5));
+    }
+
+    // A chain of elementwise operations on `y`, then a reduction.
+    ins_vector_float_graph_add(graph, y, x);
+    ins_vector_float_graph_scale(graph, y, &half);
+    ins_vector_float_graph_axpy(graph, &three, x, y);
+    ins_vector_float_graph_add_constant(graph, y, &half);
+    ins_vector_float_graph_sum(graph, y, &sum);
+
+    assert_int_equal(ins_graph_run(graph, 2), INS_SUCCESS);
+
+    if (fusion == 0) {
+      ins_vector_float_copy(expected, y);
+    }
+
+    for (i = 0; i < n; ++i) {
+      assert_true(ins_vector_float_get(y, i) ==
+                  ins_vector_float_get(expected, i));
+    }
+    assert_true(sum == ins_vector_float_sum(expected));
+
+    ins_graph_free(graph);
+  }
+
+  ins_set_tuning(&saved);
+
+  ins_vector_float_free(expected);
+  ins_vector_float_free(y);
+  ins_vector_float_free(x);
+}
+
+static void test_errors(void **state) {
+  (void) state;
+
+  ins_vector_int * x = ins_vector_int_calloc(3);
+  ins_vector_int * y = ins_vector_int_calloc(4);
+  ins_graph * graph = ins_graph_alloc();
+  ins_graph * other = ins_graph_alloc();
+  ins_graph_node * first;
+  ins_graph_node * second;
+  int result, calls = 0;
+
+  ins_error_handler_t *h = ins_set_error_handler_off();
+
+  assert_null(ins_vector_int_graph_add(graph, x, y));
+  assert_null(ins_vector_int_graph_dot(graph, x, y, &result));
+  assert_int_equal(ins_graph_size(graph), 0);
+  assert_int_equal(ins_graph_run(graph, 0), INS_SUCCESS);
+
+  // Dependencies go from earlier nodes of the same graph only.
+  first = ins_graph_task(graph, fail, 0);
+  second = ins_graph_task(graph, count, &calls);
+  assert_int_equal(ins_graph_depend(first, second), INS_EINVAL);
+  assert_int_equal(ins_graph_depend(second, ins_graph_task(other, count, 0)),
+                   INS_EINVAL);
+  assert_int_equal(ins_graph_depend(second, first), INS_SUCCESS);
+
+  // A failure skips the nodes that have not started.
+  assert_int_equal(ins_graph_run(graph, 1), INS_EFAILED);
+  assert_int_equal(calls, 0);
+
+  ins_set_error_handler(h);
+
+  ins_graph_free(other);
+  ins_graph_free(graph);
+  ins_vector_int_free(y);
+  ins_vector_int_free(x);
+}
+
+static void test_error_handler(void **state) {
+  (void) state;
+
+  ins_vector * x = ins_vector_calloc(3);
+  ins_vector * y = ins_vector_calloc(4);
+  add_context context = {x, y, pthread_self()};
+  ins_graph * graph = ins_graph_alloc();
+  int i;
+
+  // Tasks that fail on the other threads of the run use the handler of the
+  // calling thread, which is off, rather than the default one, which aborts.
+  for (i = 0; i < 16; ++i) {
+    ins_graph_task(graph, add, &context);
+  }
+
+  ins_error_handler_t *h = ins_set_error_handler_off();
+  ins_clear_error();
+  assert_int_equal(ins_graph_run(graph, 4), INS_EBADLEN);
+  assert_int_equal(ins_last_error()->error_code, INS_EBADLEN);
+  ins_set_error_handler(h);
+
+  ins_graph_free(graph);
+  ins_vector_free(y);
+  ins_vector_free(x);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_dependencies),
+    cmocka_unit_test(test_fusion),
+    cmocka_unit_test(test_errors),
+    cmocka_unit_test(test_error_handler)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
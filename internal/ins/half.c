@@ -0,0 +1,69 @@
+#include "ins/ins_half.h"
+
+#if defined(__F16C__) || defined(__AVX512BF16__)
+#include <immintrin.h>
+#endif
+
+void ins_f16_to_float_array(const uint16_t * src, float * dst, size_t n) {
+  size_t i = 0;
+
+#if defined(__F16C__)
+
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h = _mm_loadu_si128((const __m128i *) (src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+
+#endif
+
+  for (; i < n; ++i) {
+    dst[i] = ins_f16_to_float(src[i]);
+  }
+}
+
+void ins_float_to_f16_array(const float * src, uint16_t * dst, size_t n) {
+  size_t i = 0;
+
+#if defined(__F16C__)
+
+  for (; i + 8 <= n; i += 8) {
+    const __m256 f = _mm256_loadu_ps(src + i);
+    const __m128i h =
+      _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storeu_si128((__m128i *) (dst + i), h);
+  }
+
+#endif
+
+  for (; i < n; ++i) {
+    dst[i] = ins_float_to_f16(src[i]);
+  }
+}
+
+void ins_bf16_to_float_array(const uint16_t * src, float * dst, size_t n) {
+  size_t i;
+
+  // A plain shift per element, which compilers vectorize on their own.
+  for (i = 0; i < n; ++i) {
+    dst[i] = ins_bf16_to_float(src[i]);
+  }
+}
+
+void ins_float_to_bf16_array(const float * src, uint16_t * dst, size_t n) {
+  size_t i = 0;
+
+#if defined(__AVX512BF16__)
+
+  // Note that the instruction flushes subnormal inputs and outputs to zero.
+  for (; i + 16 <= n; i += 16) {
+    const __m512 f = _mm512_loadu_ps(src + i);
+    const __m256bh h = _mm512_cvtneps_pbh(f);
+    memcpy(dst + i, &h, sizeof(h));
+  }
+
+#endif
+
+  for (; i < n; ++i) {
+    dst[i] = ins_float_to_bf16(src[i]);
+  }
+}
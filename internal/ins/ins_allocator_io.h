@@ -0,0 +1,20 @@
+#ifndef INS_INTERNAL_INS_ALLOCATOR_IO_H_
+#define INS_INTERNAL_INS_ALLOCATOR_IO_H_
+
+#include "ins/ins_allocator.h"
+
+#include <stddef.h>
+
+// The allocator of `malloc`, `posix_memalign` and `free`, which blocks
+// zeroed at allocation get from `calloc` or `ins_pages_alloc` instead.
+extern const ins_allocator ins_malloc_allocator;
+
+// Maps `size` bytes of anonymous memory, which is page-aligned and reads as
+// zero, so that its pages are only touched when they are used. Returns 0 on
+// failure.
+void * ins_pages_alloc(size_t size);
+
+// Unmaps the `size` bytes at `ptr` returned by `ins_pages_alloc`.
+void ins_pages_free(void * ptr, size_t size);
+
+#endif // INS_INTERNAL_INS_ALLOCATOR_IO_H_
@@ -0,0 +1,21 @@
+#ifndef INS_INTERNAL_INS_ASYNC_IO_H_
+#define INS_INTERNAL_INS_ASYNC_IO_H_
+
+#include <stddef.h>
+#include "ins/ins_async.h"
+
+// Called by `ins_async_wait`, on the waiting thread, once all I/O of a
+// successful operation has completed, with the buffer of the operation.
+typedef void ins_async_finish(void * ctx, void * buffer);
+
+// Starts reading (`write == 0`) or writing `nbytes` bytes between `buffer`
+// and the file `fd` at byte `offset`. If `owned` is non-zero, `buffer` was
+// allocated with `malloc` for this operation and is freed when it is waited
+// for. `finish`, if not null, is called with `ctx` before that. Calls the
+// error handler and returns null if the operation cannot be set up; an owned
+// buffer is freed in that case too.
+ins_async * ins_async_submit(int fd, size_t offset, void * buffer,
+                             size_t nbytes, int write, int owned,
+                             ins_async_finish * finish, void * ctx);
+
+#endif // INS_INTERNAL_INS_ASYNC_IO_H_
@@ -0,0 +1,96 @@
+#ifndef INS_INTERNAL_INS_COMPRESS_IO_H_
+#define INS_INTERNAL_INS_COMPRESS_IO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include "ins/ins_compress.h"
+
+// Writers and readers of compressed files shared by the vector templates.
+// Elements are `elem_size` bytes made of values of `value_size` bytes (two
+// per complex element), which is the unit the filters work on.
+
+// Default size in bytes of the chunks.
+#define INS_COMPRESS_CHUNK (1 << 18)
+
+typedef struct {
+  FILE * stream;
+  uint32_t elem_size;
+  uint32_t value_size;
+  uint32_t filter;
+  uint32_t codec;
+  int level;
+  uint64_t chunk_size;
+  uint64_t num_chunks;
+
+  // Compressed chunk sizes and checksums of the stored chunks, filled in as
+  // chunks are written. `checksums` follows `index` in the same allocation.
+  uint64_t * index;
+  uint64_t * checksums;
+  uint64_t next;
+  off_t index_position;
+
+  // Two buffers of one chunk each.
+  unsigned char * scratch;
+  unsigned char * out;
+} ins_compress_writer;
+
+// Writes the header of a compressed file of `count` elements and reserves
+// its index. The stream must be seekable, since the index is only known
+// once all chunks are written. Returns `INS_EINVAL` for invalid parameters,
+// `INS_EUNSUP` if the codec is not available, `INS_ENOMEM` and
+// `INS_EFAILED`.
+int ins_compress_writer_init(ins_compress_writer * writer, FILE * stream,
+                             uint32_t type, uint32_t elem_size,
+                             uint32_t value_size, uint64_t count,
+                             const ins_compress_params * params);
+
+// Compresses and writes the next chunk, `n` contiguous elements at `data`.
+// Every chunk but the last holds `writer->chunk_size` elements.
+int ins_compress_writer_put(ins_compress_writer * writer, const void * data,
+                            size_t n);
+
+// Writes the index and leaves the stream after the last chunk. Releases the
+// writer, also when `status` is not `INS_SUCCESS`, in which case nothing is
+// written and `status` is returned.
+int ins_compress_writer_finish(ins_compress_writer * writer, int status);
+
+typedef struct {
+  FILE * stream;
+  uint32_t elem_size;
+  uint32_t value_size;
+  uint32_t filter;
+  uint32_t codec;
+  uint64_t count;
+  uint64_t chunk_size;
+  uint64_t num_chunks;
+  int swap;
+
+  // Offsets of the chunks from the first chunk, with the end of the last
+  // chunk as the final entry, the flags from the index, and the checksums
+  // of the chunks, or null for files without them.
+  uint64_t * offsets;
+  unsigned char * stored;
+  uint64_t * checksums;
+} ins_compress_reader;
+
+// Reads the header and the index of the compressed file at the current
+// position of `stream`. Returns `INS_EINVAL` if the file holds another
+// element type, `INS_EUNSUP` for a newer format or an unavailable codec,
+// `INS_ENOMEM` and `INS_EFAILED`.
+int ins_compress_reader_open(ins_compress_reader * reader, FILE * stream,
+                             uint32_t type, uint32_t elem_size,
+                             uint32_t value_size);
+
+// Decompresses the `n` elements starting at element `first` into the
+// contiguous buffer `data`, and leaves the stream after the file. Only the
+// chunks overlapping the range are decompressed, in parallel. Releases the
+// reader.
+int ins_compress_reader_read(ins_compress_reader * reader, uint64_t first,
+                             size_t n, void * data);
+
+// Releases a reader without reading.
+void ins_compress_reader_close(ins_compress_reader * reader);
+
+#endif // INS_INTERNAL_INS_COMPRESS_IO_H_
@@ -0,0 +1,62 @@
+#ifndef INS_INTERNAL_INS_CONTAINER_IO_H_
+#define INS_INTERNAL_INS_CONTAINER_IO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "ins/ins_container.h"
+#include "ins/ins_staging.h"
+
+// Helpers shared by the block and vector container templates.
+
+// Size in bytes of the staging buffer used to gather strided vectors into
+// contiguous payload chunks. It is a multiple of every element size and of
+// `INS_CHECKSUM_BLOCK`.
+#define INS_CONTAINER_CHUNK INS_STAGING_CHUNK
+
+// Number of independent checksum lanes, and the number of bytes consumed
+// per step (one little-endian 32-bit word per lane).
+#define INS_CHECKSUM_LANES 8
+#define INS_CHECKSUM_BLOCK (4 * INS_CHECKSUM_LANES)
+
+// Running state of a payload checksum.
+typedef struct {
+  uint64_t a[INS_CHECKSUM_LANES];
+  uint64_t b[INS_CHECKSUM_LANES];
+  uint64_t nbytes;
+} ins_checksum_state;
+
+void ins_checksum_init(ins_checksum_state * state);
+
+// Adds `nbytes` bytes at `data` to the checksum. Every call but the last
+// must pass a multiple of `INS_CHECKSUM_BLOCK` bytes.
+void ins_checksum_update(ins_checksum_state * state, const void * data,
+                         size_t nbytes);
+
+uint64_t ins_checksum_final(const ins_checksum_state * state);
+
+// Returns non-zero if the host stores multi-byte values big-endian.
+int ins_host_big_endian(void);
+
+// Reverses the byte order of each of the `count` values of `size` bytes at
+// `data`. `size` must be 2, 4 or 8.
+void ins_byteswap(void * data, size_t count, size_t size);
+
+// Writes a container header describing `count` elements of the given type
+// and size with the given payload checksum, followed by the padding up to
+// the payload. Returns `INS_EFAILED` if writing fails.
+int ins_container_write_header(FILE * stream, uint32_t type,
+                               uint32_t elem_size, uint64_t count,
+                               uint64_t checksum);
+
+// Checks that the container described by `header` holds elements of the
+// given type and size. Returns `INS_EINVAL` on mismatch.
+int ins_container_check_type(const ins_container_header * header,
+                             uint32_t type, uint32_t elem_size);
+
+// Consumes the padding between the fixed header, which has just been read
+// from `stream`, and the payload. Returns `INS_EFAILED` if reading fails.
+int ins_container_skip_padding(FILE * stream,
+                               const ins_container_header * header);
+
+#endif // INS_INTERNAL_INS_CONTAINER_IO_H_
@@ -0,0 +1,52 @@
+#ifndef INS_INTERNAL_INS_CSV_IO_H_
+#define INS_INTERNAL_INS_CSV_IO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ins/ins_csv.h"
+
+// The parser of delimited text files shared by the vector templates.
+
+// A vector receiving a column: element `i` is stored at
+// `data + i * stride` elements of the vector type.
+typedef struct {
+  void * data;
+  ptrdiff_t stride;
+} ins_csv_target;
+
+typedef struct {
+  // The mapping of the file, if it is not empty.
+  void * map;
+  size_t map_size;
+
+  char delimiter;
+
+  // The data lines are split into `num_ranges` ranges of whole lines;
+  // range `i` runs from `bounds[i]` to `bounds[i + 1]` and its first row
+  // is `first_rows[i]`. `first_rows[num_ranges]` is the number of rows.
+  size_t num_ranges;
+  const char ** bounds;
+  size_t * first_rows;
+} ins_csv_file;
+
+// Maps the file at `path`, skips the lines requested by `options`, splits
+// the rest into ranges and counts their rows. Returns `INS_ENOMEM` and
+// `INS_EFAILED` if the file cannot be read.
+int ins_csv_open(ins_csv_file * file, const char * path,
+                 const ins_csv_options * options);
+
+// Returns the number of rows of the file.
+size_t ins_csv_rows(const ins_csv_file * file);
+
+// Parses the columns `columns[0, n)` of every row into `targets[0, n)`,
+// whose elements are of the given type (`INS_TYPE_DOUBLE`, `INS_TYPE_FLOAT`
+// or `INS_TYPE_INT`). Returns `INS_EFAILED` if a row lacks a column or a
+// field is not a number.
+int ins_csv_parse(const ins_csv_file * file, uint32_t type,
+                  const size_t * columns, const ins_csv_target * targets,
+                  size_t n);
+
+// Unmaps the file.
+void ins_csv_close(ins_csv_file * file);
+
+#endif // INS_INTERNAL_INS_CSV_IO_H_
@@ -0,0 +1,44 @@
+#ifndef INS_INTERNAL_INS_DIRECT_IO_H_
+#define INS_INTERNAL_INS_DIRECT_IO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ins/ins_direct.h"
+
+// Direct I/O shared by the block and vector templates (see
+// `ins/ins_direct.h`).
+
+// Size in bytes of the bounce buffer of unaligned transfers and of the
+// staging buffer of strided vectors. It is a multiple of
+// `INS_DIRECT_ALIGNMENT` and of every element size.
+#define INS_DIRECT_CHUNK (1 << 23)
+
+typedef struct {
+  // The descriptor of buffered transfers, and of direct transfers, or -1
+  // if the file system does not support them.
+  int fd;
+  int direct_fd;
+
+  // The bounce buffer of `INS_DIRECT_CHUNK` bytes, allocated on first use.
+  void * bounce;
+} ins_direct_file;
+
+// Opens the file at `path` for reading, or for writing if `write` is
+// non-zero, creating it if needed. Returns `INS_EFAILED` if it cannot be
+// opened.
+int ins_direct_open(ins_direct_file * file, const char * path, int write);
+
+// Reads `nbytes` bytes at byte `offset` of the file into `buffer`, or
+// writes them from `buffer` if `write` is non-zero. Returns `INS_EFAILED`
+// if a transfer fails or a read reaches the end of the file.
+int ins_direct_transfer(ins_direct_file * file, uint64_t offset,
+                        void * buffer, size_t nbytes, int write);
+
+// Closes the file. Returns `INS_EFAILED` if closing a written file fails.
+int ins_direct_close(ins_direct_file * file);
+
+// Allocates `nbytes` bytes at a multiple of `INS_DIRECT_ALIGNMENT`, to be
+// released with `free`. Returns a null pointer if allocation fails.
+void * ins_direct_alloc(size_t nbytes);
+
+#endif // INS_INTERNAL_INS_DIRECT_IO_H_
@@ -0,0 +1,25 @@
+#ifndef INS_INTERNAL_INS_ERRNO_IO_H_
+#define INS_INTERNAL_INS_ERRNO_IO_H_
+
+#include <stdio.h>
+#include "ins/ins_errno.h"
+
+// The stream handler, stream and error handler of a thread. The threads the
+// library starts to run the work of a call take on the context of the
+// calling thread, so that errors there are handled as the caller asked.
+typedef struct {
+  int has_stream;
+  int has_stream_handler;
+  int has_error_handler;
+  FILE* stream;
+  ins_stream_handler_t* stream_handler;
+  ins_error_handler_t* error_handler;
+} ins_error_context;
+
+// Stores the context of the calling thread in `context`.
+void ins_get_error_context(ins_error_context* context);
+
+// Replaces the context of the calling thread with `context`.
+void ins_set_error_context(const ins_error_context* context);
+
+#endif // INS_INTERNAL_INS_ERRNO_IO_H_
@@ -0,0 +1,81 @@
+#ifndef INS_INTERNAL_INS_GRAPH_IO_H_
+#define INS_INTERNAL_INS_GRAPH_IO_H_
+
+#include <stddef.h>
+#include "ins/ins_graph.h"
+
+// The most regions of memory a node reads or writes.
+#define INS_GRAPH_MAX_ACCESSES 4
+
+// A region `[begin, end)` of memory that a node reads or writes. `stride`
+// is the stride of a vector, so that the accesses of two nodes to the same
+// vector can be told from accesses to overlapping ones, or 0 for a scalar.
+typedef struct {
+  const char * begin;
+  const char * end;
+  ptrdiff_t stride;
+  int write;
+} ins_graph_access;
+
+// Runs an operation node on the elements `[offset, offset + n)` of its
+// vectors. Elementwise operations run on any slice, others only on all
+// elements. Returns `INS_SUCCESS` or an error code.
+typedef int ins_graph_op(const ins_graph_node * node, size_t offset,
+                         size_t n);
+
+struct ins_graph_node {
+  ins_graph * graph;
+
+  // The position of the node in the order of recording.
+  size_t index;
+
+  // The operation and its operands, or the task of the caller.
+  ins_graph_op * op;
+  void * x;
+  void * y;
+  const void * alpha;
+  void * result;
+  void * result2;
+  ins_graph_task_t * task;
+  void * context;
+
+  // The length of the vectors, and whether the operation is elementwise
+  // and so may be fused.
+  size_t length;
+  int elementwise;
+
+  ins_graph_access accesses[INS_GRAPH_MAX_ACCESSES];
+  size_t num_accesses;
+
+  // The nodes that depend on this one, and the number of nodes this one
+  // depends on.
+  ins_graph_node ** successors;
+  size_t num_successors;
+  size_t max_successors;
+  size_t num_predecessors;
+
+  // The state of a run: the number of dependencies left, and the chain of
+  // fused nodes this one starts or belongs to.
+  size_t pending;
+  ins_graph_node * head;
+  ins_graph_node * next;
+};
+
+// Records a node of the graph `graph` that is a copy of `node`, whose
+// operation, operands and accesses are set, and makes it depend on the
+// nodes before it that it conflicts with. Calls the error handler and
+// returns null if there is not enough memory.
+ins_graph_node * ins_graph_record(ins_graph * graph,
+                                  const ins_graph_node * node);
+
+// Adds the access to the `n` elements at `data` at `stride` of a vector,
+// each `size` bytes, to `node`.
+void ins_graph_access_vector(ins_graph_node * node, const void * data,
+                             size_t n, ptrdiff_t stride, size_t size,
+                             int write);
+
+// Adds the access to the scalar of `size` bytes at `data` to `node`.
+void ins_graph_access_scalar(ins_graph_node * node, const void * data,
+                             size_t size, int write);
+
+#endif // INS_INTERNAL_INS_GRAPH_IO_H_
@@ -0,0 +1,127 @@
+#ifndef INS_INTERNAL_INS_HALF_H_
+#define INS_INTERNAL_INS_HALF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Conversions between single precision and the two 16-bit floating point
+// storage formats, IEEE 754 half precision (f16) and brain floating point
+// (bf16). Conversions to 16 bits round to nearest, ties to even, and keep
+// NaNs quiet.
+
+static inline float ins_f16_to_float(const uint16_t h) {
+  const uint32_t sign = (uint32_t) (h & 0x8000) << 16;
+  uint32_t exponent = (h >> 10) & 0x1f;
+  uint32_t mantissa = h & 0x3ff;
+  uint32_t bits;
+  float f;
+
+  if (exponent == 0x1f) {
+    // Infinity or NaN. NaNs are made quiet, as F16C does.
+    bits = sign | 0x7f800000 | (mantissa << 13);
+    if (mantissa != 0) {
+      bits |= 0x400000;
+    }
+  } else if (exponent != 0) {
+    // Normal number: rebias the exponent from 15 to 127.
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    // Signed zero.
+    bits = sign;
+  } else {
+    // Subnormal half is a normal float: shift the mantissa until its
+    // leading one becomes the implicit bit.
+    exponent = 113;
+    while ((mantissa & 0x400) == 0) {
+      mantissa <<= 1;
+      --exponent;
+    }
+    bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+  }
+
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+static inline uint16_t ins_float_to_f16(const float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+
+  const uint16_t sign = (uint16_t) ((bits >> 16) & 0x8000);
+  const uint32_t abs = bits & 0x7fffffff;
+  uint32_t h;
+  uint32_t rest;
+  uint32_t halfway;
+
+  // Infinity or NaN.
+  if (abs >= 0x7f800000) {
+    if (abs == 0x7f800000) {
+      return sign | 0x7c00;
+    }
+    return sign | 0x7e00 | ((abs >> 13) & 0x3ff);
+  }
+
+  // Values that round to a magnitude of at least 65520 overflow.
+  if (abs >= 0x477ff000) {
+    return sign | 0x7c00;
+  }
+
+  // Values below 2^-14 become subnormal halves, or zero below 2^-25.
+  if (abs < 0x38800000) {
+    if (abs < 0x33000000) {
+      return sign;
+    }
+
+    const uint32_t shift = 126 - (abs >> 23);
+    const uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+
+    h = mantissa >> shift;
+    rest = mantissa & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+  } else {
+    // Normal number: rebias the exponent from 127 to 15.
+    h = (abs >> 13) - (112u << 10);
+    rest = abs & 0x1fff;
+    halfway = 0x1000;
+  }
+
+  // A carry out of the mantissa correctly bumps the exponent.
+  if (rest > halfway || (rest == halfway && (h & 1))) {
+    ++h;
+  }
+
+  return sign | (uint16_t) h;
+}
+
+static inline float ins_bf16_to_float(const uint16_t h) {
+  const uint32_t bits = (uint32_t) h << 16;
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+static inline uint16_t ins_float_to_bf16(const float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+
+  // Keep NaNs NaN (rounding could otherwise turn them into infinity).
+  if ((bits & 0x7fffffff) > 0x7f800000) {
+    return (uint16_t) ((bits >> 16) | 0x0040);
+  }
+
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return (uint16_t) (bits >> 16);
+}
+
+// Converts `n` contiguous elements between 16-bit storage and single
+// precision. These use F16C and AVX-512 BF16 instructions when the library
+// is configured with `INSIGHT_ENABLE_F16C` and `INSIGHT_ENABLE_AVX512_BF16`
+// or compiled for a target that has them (e.g. with `-march=native`), and
+// the scalar conversions above otherwise.
+void ins_f16_to_float_array(const uint16_t * src, float * dst, size_t n);
+void ins_float_to_f16_array(const float * src, uint16_t * dst, size_t n);
+void ins_bf16_to_float_array(const uint16_t * src, float * dst, size_t n);
+void ins_float_to_bf16_array(const float * src, uint16_t * dst, size_t n);
+
+#endif // INS_INTERNAL_INS_HALF_H_
@@ -0,0 +1,20 @@
+#ifndef INS_INTERNAL_INS_MEMORY_IO_H_
+#define INS_INTERNAL_INS_MEMORY_IO_H_
+
+#include <stddef.h>
+#include "ins/ins_memory.h"
+
+// Reserves `bytes` bytes of the budgets of the process and of the tag of
+// the calling thread, which is stored into `tag`, before they are
+// allocated. Returns 0, or -1 if a budget is exceeded and the budget handler
+// does not allow it, without calling the error handler.
+int ins_memory_reserve(size_t bytes, int * tag);
+
+// Counts the allocation of `bytes` bytes reserved under `tag`, or returns
+// them to the budgets if `allocated` is 0 because allocation failed.
+void ins_memory_commit(size_t bytes, int tag, int allocated);
+
+// Counts freeing `bytes` bytes allocated under `tag`.
+void ins_memory_release(size_t bytes, int tag);
+
+#endif // INS_INTERNAL_INS_MEMORY_IO_H_
@@ -0,0 +1,10 @@
+#ifndef INS_INTERNAL_INS_STAGING_H_
+#define INS_INTERNAL_INS_STAGING_H_
+
+// Size in bytes of the contiguous buffer through which strided vectors are
+// read and written, one chunk at a time, so that stdio is called once per
+// chunk rather than once per element. It is a multiple of every element
+// size.
+#define INS_STAGING_CHUNK 65536
+
+#endif // INS_INTERNAL_INS_STAGING_H_
@@ -0,0 +1,131 @@
+#ifndef INS_INTERNAL_INS_STATS_IO_H_
+#define INS_INTERNAL_INS_STATS_IO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ins/ins_stats.h"
+#include "ins/ins_trace.h"
+#include "ins/internal/config.h"
+
+// The probes of the operation counters and of tracing (see `ins/ins_stats.h`
+// and `ins/ins_trace.h`).
+//
+// `INS_STATS(func, elements, stride, bytes)` at the start of the body of the
+// function `func` counts a call processing `elements` elements at `stride`
+// and moving `bytes` bytes whenever counting is on, and the time until the
+// function returns, and reports the call to the trace handler while one is
+// set. Without `INSIGHT_ENABLE_STATS` and `INSIGHT_ENABLE_TRACE` it does
+// nothing.
+
+#if defined(INSIGHT_ENABLE_STATS) || defined(INSIGHT_ENABLE_TRACE)
+#define INS_STATS_PROBES
+#endif
+
+#ifdef INS_STATS_PROBES
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+// A counted function, registered with an index into the counter tables on
+// its first counted call. `id` is 0 until then, and -1 if the tables are
+// full.
+typedef struct {
+  const char * name;
+  int id;
+} ins_stats_site;
+
+// The counters of a function in a table.
+enum {
+  INS_STATS_CALLS,
+  INS_STATS_ELEMENTS,
+  INS_STATS_BYTES,
+  INS_STATS_CYCLES,
+  INS_STATS_FIELDS
+};
+
+// The bits of `ins_stats_flags` and of the flags of a probe.
+enum {
+  INS_STATS_COUNTING = 1,
+  INS_STATS_TRACING = 2
+};
+
+// A call in progress. `flags` tells what is recorded of it and is 0 if
+// nothing is. A counted call has the counters of its function in the table
+// of the calling thread and the ticks at its start, and a traced call has
+// its event and the handler its start was reported to.
+typedef struct {
+  int flags;
+  uint64_t * counters;
+  uint64_t start;
+  ins_trace_event event;
+  const ins_trace_handler * handler;
+} ins_stats_probe;
+
+// Whether counting and tracing are on.
+extern int ins_stats_flags;
+
+static inline uint64_t ins_stats_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+#endif
+}
+
+// Starts `probe` for a call of the function of `site` processing `elements`
+// elements at `stride` and moving `bytes` bytes: counts the call in the
+// table of the calling thread if counting is on, and reports its start to
+// the trace handler if tracing is on.
+void ins_stats_enter(ins_stats_probe * probe, ins_stats_site * site,
+                     uint64_t elements, ptrdiff_t stride, uint64_t bytes);
+
+// Ends `probe` when its call returns: adds the time of the call to its
+// counters and reports the end to the trace handler.
+void ins_stats_exit(ins_stats_probe * probe);
+
+// Report the start of the call of `probe`, whose event is filled in except
+// for the timestamps, and its end to the trace handler (see `trace.c`).
+void ins_trace_enter(ins_stats_probe * probe);
+void ins_trace_exit(ins_stats_probe * probe);
+
+static inline void ins_stats_leave(ins_stats_probe * probe) {
+  if (probe->flags != 0) {
+    ins_stats_exit(probe);
+  }
+}
+
+#define INS_STATS_STRING(func) INS_STATS_STRING_(func)
+#define INS_STATS_STRING_(func) #func
+
+// The probe is a variable whose cleanup ends the call on every return. When
+// counting and tracing are off, the call only clears the flags of the probe
+// and tests a flag on entry and on return.
+#define INS_STATS(func, elements, stride, bytes)                            \
+  static ins_stats_site ins_stats_site_ = {INS_STATS_STRING(func), 0};     \
+  ins_stats_probe ins_stats_probe_                                          \
+      __attribute__((cleanup(ins_stats_leave)));                            \
+  ins_stats_probe_.flags = 0;                                               \
+  if (__builtin_expect(__atomic_load_n(&ins_stats_flags, __ATOMIC_RELAXED), \
+                       0)) {                                                \
+    ins_stats_enter(&ins_stats_probe_, &ins_stats_site_,                    \
+                    (uint64_t) (elements), (ptrdiff_t) (stride),            \
+                    (uint64_t) (bytes));                                    \
+  }                                                                         \
+  (void) 0
+
+#else // INS_STATS_PROBES
+
+#define INS_STATS(func, elements, stride, bytes) ((void) 0)
+
+#endif // INS_STATS_PROBES
+
+#endif // INS_INTERNAL_INS_STATS_IO_H_
@@ -0,0 +1,50 @@
+#ifndef INS_INTERNAL_INS_STREAM_IO_H_
+#define INS_INTERNAL_INS_STREAM_IO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ins/ins_async.h"
+
+// Sequential reads of a range of a file in fixed-size chunks, for the
+// out-of-core reductions. Two chunk buffers are used in turn: while the
+// caller works on one chunk the next one is read asynchronously into the
+// other buffer.
+
+// Size in bytes of the chunks.
+#define INS_STREAM_CHUNK (1 << 22)
+
+typedef struct {
+  int fd;
+
+  // The file offset and the number of bytes of the range that have not yet
+  // been requested.
+  uint64_t offset;
+  uint64_t remaining;
+
+  // The chunk size, a multiple of the element size.
+  size_t chunk;
+
+  unsigned char * buffers[2];
+
+  // The read in flight into `buffers[next]`, of `pending_size` bytes.
+  ins_async * pending;
+  size_t pending_size;
+  int next;
+} ins_stream;
+
+// Opens the file at `path` to read `nbytes` bytes starting at byte `offset`
+// in chunks of whole elements of `elem_size` bytes, and starts reading the
+// first chunk. Returns `INS_EINVAL` if the file is too short, `INS_ENOMEM`,
+// and `INS_EFAILED` if the file cannot be opened or read.
+int ins_stream_open(ins_stream * stream, const char * path, uint64_t offset,
+                    uint64_t nbytes, size_t elem_size);
+
+// Waits for the next chunk and stores its address and size in `data` and
+// `nbytes`, which is zero once the range has been read. The chunk stays
+// valid until the next call. Returns `INS_EFAILED` if reading fails.
+int ins_stream_next(ins_stream * stream, const void ** data, size_t * nbytes);
+
+// Waits for any read in flight and releases the stream.
+void ins_stream_close(ins_stream * stream);
+
+#endif // INS_INTERNAL_INS_STREAM_IO_H_
@@ -0,0 +1,98 @@
+#ifndef INS_INTERNAL_INS_TEXT_H_
+#define INS_INTERNAL_INS_TEXT_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Locale-independent number parsing for the `fscanf` family of functions.
+//
+// Each function skips leading white space, parses one number from `stream`
+// and stores it in `out`, consuming exactly the characters that make up the
+// number (plus at most one character of look-ahead, which is pushed back
+// with `ungetc`), so the stream can be read further afterwards just as with
+// `fscanf`. Characters are read with `getc_unlocked`, i.e. straight out of
+// the stdio buffer; callers must hold the stream lock (`flockfile`) for the
+// duration of a bulk read.
+//
+// Floating point numbers are accepted in the syntax of `strtod` in the "C"
+// locale: decimal numbers with an optional exponent, "inf", "infinity" and
+// "nan" in any case, and hexadecimal numbers. Decimal numbers are converted
+// with correct rounding using the Eisel-Lemire algorithm; the rare inputs it
+// cannot decide (more than 19 significant digits whose truncation matters)
+// and hexadecimal numbers fall back to `strtod`.
+//
+// The functions return 0 for success and -1 if no number could be parsed.
+
+int ins_text_read_double(FILE * stream, double * out);
+
+int ins_text_read_float(FILE * stream, float * out);
+
+// Parses a decimal integer with an optional sign. Values that do not fit in
+// an `int` are rejected.
+int ins_text_read_int(FILE * stream, int * out);
+
+// The same parsers reading from memory: they parse one number from the
+// characters between `*text` and `end` and advance `*text` past it.
+int ins_text_parse_double(const char ** text, const char * end, double * out);
+
+int ins_text_parse_float(const char ** text, const char * end, float * out);
+
+int ins_text_parse_int(const char ** text, const char * end, int * out);
+
+// Buffered number formatting for the `fprintf` family of functions.
+//
+// Numbers are formatted into the buffer of an `ins_text_writer`, which is
+// handed to the stream with `fwrite` whenever it fills up, so that a whole
+// block costs a handful of stdio calls instead of two per element. Numbers
+// are formatted according to an `ins_text_format`:
+//
+// - a null format selects the shortest decimal representation that reads
+//   back to the same value (the digits of the shortest round trip, laid out
+//   like `%.17g`), and `%d` for integers;
+// - the formats `%e`, `%f` and `%g` (or `%E`, `%F` and `%G`, with an
+//   optional precision and an optional `l` length modifier) and `%d` or
+//   `%i` for integers are formatted directly, giving the same output as
+//   `printf` in the "C" locale;
+// - any other format is passed to `snprintf`.
+//
+// The write functions return 0 for success and -1 if writing to the stream
+// failed.
+
+// Size of the buffer of an `ins_text_writer` in bytes.
+#define INS_TEXT_BUFFER_SIZE 16384
+
+// A parsed format specifier; see `ins_text_format_init`.
+typedef struct {
+  const char * format;
+  int conversion;
+  int precision;
+} ins_text_format;
+
+typedef struct {
+  FILE * stream;
+  size_t length;
+  char buffer[INS_TEXT_BUFFER_SIZE];
+} ins_text_writer;
+
+// Parses the format specifier `format`, which may be null.
+void ins_text_format_init(ins_text_format * format, const char * spec);
+
+void ins_text_writer_init(ins_text_writer * writer, FILE * stream);
+
+int ins_text_write_double(ins_text_writer * writer,
+                          const ins_text_format * format, double x);
+
+// Formats `x` like `ins_text_write_double`, except that the shortest
+// representation is that of a float.
+int ins_text_write_float(ins_text_writer * writer,
+                         const ins_text_format * format, float x);
+
+int ins_text_write_int(ins_text_writer * writer,
+                       const ins_text_format * format, int x);
+
+int ins_text_write_char(ins_text_writer * writer, char c);
+
+// Hands the buffered output to the stream.
+int ins_text_writer_flush(ins_text_writer * writer);
+
+#endif // INS_INTERNAL_INS_TEXT_H_
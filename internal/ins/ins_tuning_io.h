@@ -0,0 +1,22 @@
+#ifndef INS_INTERNAL_INS_TUNING_IO_H_
+#define INS_INTERNAL_INS_TUNING_IO_H_
+
+#include <stddef.h>
+#include "ins/ins_tuning.h"
+
+// The current tuning (see `ins/ins_tuning.h`). Its fields are read and
+// written with relaxed atomic loads and stores, so that operations read it
+// without locks.
+extern ins_tuning ins_tuning_current;
+
+// Returns the number of threads of parallel operations that are not given
+// one: the tuned number, or the number of online processors, and at least
+// one.
+long ins_tuning_threads(void);
+
+// Returns the value of the field `field` of the current tuning.
+static inline size_t ins_tuning_get(const size_t * field) {
+  return __atomic_load_n(field, __ATOMIC_RELAXED);
+}
+
+#endif // INS_INTERNAL_INS_TUNING_IO_H_
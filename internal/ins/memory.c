@@ -0,0 +1,223 @@
+#include <stdint.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_memory_io.h"
+
+// The counters of the process or of a tag. They are read and written
+// atomically, so that allocations in any thread count into them without
+// locks.
+typedef struct {
+  size_t live_bytes;
+  size_t peak_bytes;
+  size_t budget;
+  uint64_t allocations;
+  uint64_t frees;
+} ins_memory_counters;
+
+// The counters of a thread, which only it writes.
+typedef struct {
+  int tag;
+  uint64_t allocated_bytes;
+  uint64_t freed_bytes;
+  uint64_t peak_bytes;
+  uint64_t allocations;
+  uint64_t frees;
+} ins_memory_thread_counters;
+
+static ins_memory_counters ins_memory_process;
+static ins_memory_counters ins_memory_tags[INS_MEMORY_TAGS];
+static ins_memory_budget_handler_t * ins_memory_handler = 0;
+
+static _Thread_local ins_memory_thread_counters ins_memory_thread;
+
+// Returns the live bytes of the calling thread.
+static uint64_t ins_memory_thread_live(void) {
+  const ins_memory_thread_counters * thread = &ins_memory_thread;
+
+  return thread->allocated_bytes > thread->freed_bytes
+             ? thread->allocated_bytes - thread->freed_bytes
+             : 0;
+}
+
+// Adds `bytes` to the live bytes of `counters` unless that exceeds their
+// budget. Returns 0, or the budget.
+static size_t ins_memory_take(ins_memory_counters * counters,
+                              const size_t bytes) {
+  const size_t budget = __atomic_load_n(&counters->budget, __ATOMIC_RELAXED);
+  const size_t live = __atomic_add_fetch(&counters->live_bytes, bytes,
+                                         __ATOMIC_RELAXED);
+
+  if (budget == 0 || live <= budget || bytes == 0) {
+    return 0;
+  }
+
+  __atomic_sub_fetch(&counters->live_bytes, bytes, __ATOMIC_RELAXED);
+
+  return budget;
+}
+
+// Raises the peak of `counters` to their live bytes.
+static void ins_memory_raise_peak(ins_memory_counters * counters) {
+  const size_t live = __atomic_load_n(&counters->live_bytes,
+                                      __ATOMIC_RELAXED);
+  size_t peak = __atomic_load_n(&counters->peak_bytes, __ATOMIC_RELAXED);
+
+  while (live > peak &&
+         !__atomic_compare_exchange_n(&counters->peak_bytes, &peak, live, 1,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+static void ins_memory_load(const ins_memory_counters * counters,
+                            ins_memory_usage * usage) {
+  usage->live_bytes = __atomic_load_n(&counters->live_bytes,
+                                      __ATOMIC_RELAXED);
+  usage->peak_bytes = __atomic_load_n(&counters->peak_bytes,
+                                      __ATOMIC_RELAXED);
+  usage->allocations = __atomic_load_n(&counters->allocations,
+                                       __ATOMIC_RELAXED);
+  usage->frees = __atomic_load_n(&counters->frees, __ATOMIC_RELAXED);
+}
+
+int ins_memory_reserve(const size_t bytes, int * tag) {
+  const int current = ins_memory_thread.tag;
+  ins_memory_budget_handler_t * handler;
+  size_t budget = ins_memory_take(&ins_memory_process, bytes);
+
+  if (budget == 0) {
+    budget = ins_memory_take(&ins_memory_tags[current], bytes);
+
+    if (budget != 0) {
+      __atomic_sub_fetch(&ins_memory_process.live_bytes, bytes,
+                         __ATOMIC_RELAXED);
+    }
+  }
+
+  if (budget != 0) {
+    handler = __atomic_load_n(&ins_memory_handler, __ATOMIC_ACQUIRE);
+
+    if (handler == 0 || !handler(bytes, current, budget)) {
+      return -1;
+    }
+
+    __atomic_add_fetch(&ins_memory_process.live_bytes, bytes,
+                       __ATOMIC_RELAXED);
+    __atomic_add_fetch(&ins_memory_tags[current].live_bytes, bytes,
+                       __ATOMIC_RELAXED);
+  }
+
+  *tag = current;
+
+  return 0;
+}
+
+void ins_memory_commit(const size_t bytes, const int tag,
+                       const int allocated) {
+  ins_memory_thread_counters * thread = &ins_memory_thread;
+
+  if (!allocated) {
+    __atomic_sub_fetch(&ins_memory_process.live_bytes, bytes,
+                       __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&ins_memory_tags[tag].live_bytes, bytes,
+                       __ATOMIC_RELAXED);
+    return;
+  }
+
+  __atomic_add_fetch(&ins_memory_process.allocations, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&ins_memory_tags[tag].allocations, 1, __ATOMIC_RELAXED);
+  ins_memory_raise_peak(&ins_memory_process);
+  ins_memory_raise_peak(&ins_memory_tags[tag]);
+
+  thread->allocated_bytes += bytes;
+  ++thread->allocations;
+  if (ins_memory_thread_live() > thread->peak_bytes) {
+    thread->peak_bytes = ins_memory_thread_live();
+  }
+}
+
+void ins_memory_release(const size_t bytes, const int tag) {
+  __atomic_sub_fetch(&ins_memory_process.live_bytes, bytes,
+                     __ATOMIC_RELAXED);
+  __atomic_sub_fetch(&ins_memory_tags[tag].live_bytes, bytes,
+                     __ATOMIC_RELAXED);
+  __atomic_add_fetch(&ins_memory_process.frees, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&ins_memory_tags[tag].frees, 1, __ATOMIC_RELAXED);
+
+  ins_memory_thread.freed_bytes += bytes;
+  ++ins_memory_thread.frees;
+}
+
+void ins_get_memory_usage(ins_memory_usage * usage) {
+  ins_memory_load(&ins_memory_process, usage);
+}
+
+void ins_get_thread_memory_usage(ins_memory_usage * usage) {
+  usage->live_bytes = (size_t) ins_memory_thread_live();
+  usage->peak_bytes = (size_t) ins_memory_thread.peak_bytes;
+  usage->allocations = ins_memory_thread.allocations;
+  usage->frees = ins_memory_thread.frees;
+}
+
+int ins_get_tag_memory_usage(const int tag, ins_memory_usage * usage) {
+  if (tag < 0 || tag >= INS_MEMORY_TAGS) {
+    INS_ERROR("memory tag out of range", INS_EINVAL);
+  }
+
+  ins_memory_load(&ins_memory_tags[tag], usage);
+
+  return INS_SUCCESS;
+}
+
+void ins_reset_memory_peak(void) {
+  int i;
+
+  __atomic_store_n(&ins_memory_process.peak_bytes,
+                   __atomic_load_n(&ins_memory_process.live_bytes,
+                                   __ATOMIC_RELAXED),
+                   __ATOMIC_RELAXED);
+
+  for (i = 0; i < INS_MEMORY_TAGS; ++i) {
+    __atomic_store_n(&ins_memory_tags[i].peak_bytes,
+                     __atomic_load_n(&ins_memory_tags[i].live_bytes,
+                                     __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+  }
+
+  ins_memory_thread.peak_bytes = ins_memory_thread_live();
+}
+
+int ins_get_memory_tag(void) {
+  return ins_memory_thread.tag;
+}
+
+int ins_set_memory_tag(const int tag) {
+  if (tag < 0 || tag >= INS_MEMORY_TAGS) {
+    INS_ERROR("memory tag out of range", INS_EINVAL);
+  }
+
+  ins_memory_thread.tag = tag;
+
+  return INS_SUCCESS;
+}
+
+void ins_set_memory_budget(const size_t bytes) {
+  __atomic_store_n(&ins_memory_process.budget, bytes, __ATOMIC_RELAXED);
+}
+
+int ins_set_tag_memory_budget(const int tag, const size_t bytes) {
+  if (tag < 0 || tag >= INS_MEMORY_TAGS) {
+    INS_ERROR("memory tag out of range", INS_EINVAL);
+  }
+
+  __atomic_store_n(&ins_memory_tags[tag].budget, bytes, __ATOMIC_RELAXED);
+
+  return INS_SUCCESS;
+}
+
+ins_memory_budget_handler_t * ins_get_memory_budget_handler(void) {
+  return __atomic_load_n(&ins_memory_handler, __ATOMIC_ACQUIRE);
+}
+
+ins_memory_budget_handler_t *
+ins_set_memory_budget_handler(ins_memory_budget_handler_t * handler) {
+  return __atomic_exchange_n(&ins_memory_handler, handler, __ATOMIC_ACQ_REL);
+}
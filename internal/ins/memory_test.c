@@ -0,0 +1,159 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+#include <ins/ins_memory.h>
+
+static size_t handler_calls = 0;
+static int handler_tag = -1;
+
+static int allow_handler(size_t bytes, int tag, size_t budget) {
+  (void) bytes;
+  (void) budget;
+  ++handler_calls;
+  handler_tag = tag;
+  return 1;
+}
+
+static void test_usage(void **state) {
+  (void) state;
+
+  ins_memory_usage before, after, thread_before, thread_after;
+  ins_get_memory_usage(&before);
+  ins_get_thread_memory_usage(&thread_before);
+
+  ins_block * block = ins_block_alloc(100);
+  ins_vector_float * v = ins_vector_float_calloc(50);
+  assert_non_null(block);
+  assert_non_null(v);
+
+  ins_get_memory_usage(&after);
+  assert_int_equal(after.live_bytes,
+                   before.live_bytes + 100 * sizeof(double) +
+                   50 * sizeof(float));
+  assert_true(after.peak_bytes >= after.live_bytes);
+  assert_int_equal(after.allocations, before.allocations + 2);
+
+  ins_get_thread_memory_usage(&thread_after);
+  assert_int_equal(thread_after.allocations, thread_before.allocations + 2);
+
+  ins_vector_float_free(v);
+  ins_block_free(block);
+
+  ins_get_memory_usage(&after);
+  assert_int_equal(after.live_bytes, before.live_bytes);
+  assert_int_equal(after.frees, before.frees + 2);
+
+  // The peak stays until it is reset.
+  assert_true(after.peak_bytes >= before.live_bytes + 100 * sizeof(double));
+  ins_reset_memory_peak();
+  ins_get_memory_usage(&after);
+  assert_int_equal(after.peak_bytes, after.live_bytes);
+}
+
+static void test_tags(void **state) {
+  (void) state;
+
+  ins_memory_usage usage;
+  ins_block_int * block;
+
+  assert_int_equal(ins_get_memory_tag(), 0);
+  assert_int_equal(ins_set_memory_tag(3), INS_SUCCESS);
+  block = ins_block_int_alloc(10);
+  assert_int_equal(ins_set_memory_tag(0), INS_SUCCESS);
+
+  assert_int_equal(ins_get_tag_memory_usage(3, &usage), INS_SUCCESS);
+  assert_int_equal(usage.live_bytes, 10 * sizeof(int));
+  assert_int_equal(usage.allocations, 1);
+
+  // The block is counted under its tag wherever it is freed.
+  ins_block_int_free(block);
+  assert_int_equal(ins_get_tag_memory_usage(3, &usage), INS_SUCCESS);
+  assert_int_equal(usage.live_bytes, 0);
+  assert_int_equal(usage.frees, 1);
+
+  ins_error_handler_t *h = ins_set_error_handler_off();
+  assert_int_equal(ins_set_memory_tag(INS_MEMORY_TAGS), INS_EINVAL);
+  assert_int_equal(ins_set_memory_tag(-1), INS_EINVAL);
+  assert_int_equal(ins_get_tag_memory_usage(INS_MEMORY_TAGS, &usage),
+                   INS_EINVAL);
+  assert_int_equal(ins_set_tag_memory_budget(-1, 1), INS_EINVAL);
+  ins_set_error_handler(h);
+
+  assert_int_equal(ins_get_memory_tag(), 0);
+}
+
+static void test_budgets(void **state) {
+  (void) state;
+
+  ins_memory_usage before, after;
+  ins_block * block;
+  ins_vector * v;
+
+  ins_error_handler_t *h = ins_set_error_handler_off();
+
+  // A tag budget fails allocations past it with `INS_ENOMEM`.
+  ins_set_memory_tag(5);
+  assert_int_equal(ins_set_tag_memory_budget(5, 1000), INS_SUCCESS);
+
+  ins_get_memory_usage(&before);
+  block = ins_block_alloc(100);
+  assert_non_null(block);
+  assert_null(ins_block_alloc(100));
+  assert_int_equal(ins_last_error()->error_code, INS_ENOMEM);
+  assert_null(ins_vector_calloc(100));
+
+  ins_get_memory_usage(&after);
+  assert_int_equal(after.live_bytes, before.live_bytes + 800);
+  assert_int_equal(after.allocations, before.allocations + 1);
+
+  // The handler may allow an allocation past the budget.
+  assert_null(ins_set_memory_budget_handler(allow_handler));
+  v = ins_vector_alloc(100);
+  assert_non_null(v);
+  assert_int_equal(handler_calls, 1);
+  assert_int_equal(handler_tag, 5);
+  assert_ptr_equal(ins_set_memory_budget_handler(0), allow_handler);
+
+  ins_vector_free(v);
+  ins_block_free(block);
+  assert_int_equal(ins_set_tag_memory_budget(5, 0), INS_SUCCESS);
+  ins_set_memory_tag(0);
+
+  // So does the process budget, under any tag.
+  ins_get_memory_usage(&before);
+  ins_set_memory_budget(before.live_bytes + 1000);
+  block = ins_block_alloc(100);
+  assert_non_null(block);
+  assert_null(ins_block_float_alloc(100));
+  ins_block_free(block);
+  ins_set_memory_budget(0);
+
+  block = ins_block_alloc(1000);
+  assert_non_null(block);
+  ins_block_free(block);
+
+  // Sizes whose byte count does not fit in a `size_t` fail before they are
+  // counted, also when the number of atoms alone would wrap.
+  ins_get_memory_usage(&before);
+  assert_null(ins_block_complex_alloc(SIZE_MAX / 2 + 1));
+  assert_int_equal(ins_last_error()->error_code, INS_ENOMEM);
+  assert_null(ins_block_alloc(SIZE_MAX / 4));
+  ins_get_memory_usage(&after);
+  assert_int_equal(after.allocations, before.allocations);
+
+  ins_set_error_handler(h);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_usage),
+    cmocka_unit_test(test_tags),
+    cmocka_unit_test(test_budgets)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,195 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+#include <ins/ins_shm.h>
+
+// Segment names are per process, so that concurrent runs do not collide.
+static void segment_name(char * name, size_t size, const char * suffix) {
+  snprintf(name, size, "/insight_shm_test_%ld_%s", (long) getpid(), suffix);
+}
+
+static void test_publish(void **state) {
+  (void) state;
+
+  const size_t n = 1000;
+  char name[64];
+  ins_vector * writer;
+  ins_vector * reader;
+  uint64_t epoch;
+  size_t i;
+
+  segment_name(name, sizeof(name), "publish");
+
+  writer = ins_vector_shm_create(name, n);
+  assert_non_null(writer);
+  assert_int_equal(writer->size, n);
+  assert_int_equal(ins_vector_shm_epoch(writer, &epoch), INS_SUCCESS);
+  assert_int_equal(epoch, 0);
+  for (i = 0; i < n; ++i) {
+    assert_true(ins_vector_get(writer, i) == 0.0);
+  }
+
+  assert_int_equal(ins_vector_shm_begin_publish(writer), INS_SUCCESS);
+  ins_vector_shm_epoch(writer, &epoch);
+  assert_int_equal(epoch, 1);
+  for (i = 0; i < n; ++i) {
+    ins_vector_set(writer, i, (double) i * 0.5);
+  }
+  assert_int_equal(ins_vector_shm_end_publish(writer), INS_SUCCESS);
+
+  // The reader sees the same pages, so later updates show through.
+  reader = ins_vector_shm_open(name);
+  assert_non_null(reader);
+  assert_int_equal(reader->size, n);
+  assert_int_equal(ins_vector_shm_epoch(reader, &epoch), INS_SUCCESS);
+  assert_int_equal(epoch, 2);
+  assert_true(ins_vector_get(reader, n - 1) == (double) (n - 1) * 0.5);
+
+  ins_vector_shm_begin_publish(writer);
+  ins_vector_set(writer, 0, -1.0);
+  ins_vector_shm_end_publish(writer);
+  ins_vector_shm_epoch(reader, &epoch);
+  assert_int_equal(epoch, 4);
+  assert_true(ins_vector_get(reader, 0) == -1.0);
+
+  // Removing the name leaves the mappings in place.
+  assert_int_equal(ins_shm_unlink(name), INS_SUCCESS);
+  assert_true(ins_vector_get(reader, 1) == 0.5);
+
+  ins_vector_free(reader);
+  ins_vector_free(writer);
+}
+
+static void test_processes(void **state) {
+  (void) state;
+
+  const size_t n = 4096;
+  const uint64_t versions = 200;
+  char name[64];
+  ins_vector * writer;
+  uint64_t version;
+  pid_t child;
+  pid_t waited;
+  int status;
+  size_t i;
+
+  segment_name(name, sizeof(name), "processes");
+
+  writer = ins_vector_shm_create(name, n);
+  assert_non_null(writer);
+
+  child = fork();
+  assert_true(child >= 0);
+
+  // The child checks that every read it keeps saw a single version, in
+  // which all elements are equal.
+  if (child == 0) {
+    ins_vector * reader = ins_vector_shm_open(name);
+    uint64_t before = 0, after = 0;
+
+    if (reader == 0) {
+      _exit(1);
+    }
+
+    while (after != 2 * versions) {
+      double first;
+      int torn;
+
+      do {
+        torn = 0;
+        ins_vector_shm_epoch(reader, &before);
+        first = ins_vector_get(reader, 0);
+        for (i = 1; i < n; ++i) {
+          torn |= ins_vector_get(reader, i) != first;
+        }
+        ins_vector_shm_epoch(reader, &after);
+      } while (before % 2 != 0 || before != after);
+
+      if (torn || first != (double) (after / 2)) {
+        _exit(2);
+      }
+    }
+
+    ins_vector_free(reader);
+    _exit(0);
+  }
+
+  for (version = 1; version <= versions; ++version) {
+    ins_vector_shm_begin_publish(writer);
+    ins_vector_set_all(writer, (double) version);
+    ins_vector_shm_end_publish(writer);
+  }
+
+  // The segment is removed before the checks, so that a failure does not
+  // leave it behind.
+  waited = waitpid(child, &status, 0);
+  ins_shm_unlink(name);
+
+  assert_int_equal(waited, child);
+  assert_true(WIFEXITED(status));
+  assert_int_equal(WEXITSTATUS(status), 0);
+
+  ins_vector_free(writer);
+}
+
+static void test_errors(void **state) {
+  (void) state;
+
+  char name[64];
+  ins_vector * writer;
+  ins_vector * reader;
+  ins_vector * plain = ins_vector_calloc(3);
+  uint64_t epoch;
+
+  segment_name(name, sizeof(name), "errors");
+
+  ins_error_handler_t *h = ins_set_error_handler_off();
+
+  assert_null(ins_vector_shm_open(name));
+  assert_int_equal(ins_last_error()->error_code, INS_EFAILED);
+  assert_int_equal(ins_shm_unlink(name), INS_EFAILED);
+
+  writer = ins_vector_shm_create(name, 3);
+  assert_non_null(writer);
+  assert_null(ins_vector_shm_create(name, 3));
+  assert_int_equal(ins_last_error()->error_code, INS_EFAILED);
+
+  // Segments hold one element type.
+  assert_null(ins_vector_int_shm_open(name));
+  assert_int_equal(ins_last_error()->error_code, INS_EINVAL);
+
+  // Readers cannot publish, and publications do not nest.
+  reader = ins_vector_shm_open(name);
+  assert_non_null(reader);
+  assert_int_equal(ins_vector_shm_begin_publish(reader), INS_EINVAL);
+  assert_int_equal(ins_vector_shm_end_publish(writer), INS_EINVAL);
+  assert_int_equal(ins_vector_shm_begin_publish(writer), INS_SUCCESS);
+  assert_int_equal(ins_vector_shm_begin_publish(writer), INS_EINVAL);
+  assert_int_equal(ins_vector_shm_end_publish(writer), INS_SUCCESS);
+
+  assert_int_equal(ins_vector_shm_epoch(plain, &epoch), INS_EINVAL);
+
+  ins_set_error_handler(h);
+
+  ins_shm_unlink(name);
+  ins_vector_free(reader);
+  ins_vector_free(writer);
+  ins_vector_free(plain);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_publish),
+    cmocka_unit_test(test_processes),
+    cmocka_unit_test(test_errors)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,287 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_stats_io.h"
+
+#ifdef INS_STATS_PROBES
+int ins_stats_flags = 0;
+#endif
+
+#ifdef INSIGHT_ENABLE_STATS
+
+#include <pthread.h>
+
+// Maximum number of counted functions.
+#define INS_STATS_MAX_SITES 1024
+
+// The counters of one thread, in the list of all tables. Only the owning
+// thread writes them, with relaxed atomic stores so that concurrent
+// snapshots read whole values.
+typedef struct ins_stats_table {
+  uint64_t counters[INS_STATS_MAX_SITES][INS_STATS_FIELDS];
+  struct ins_stats_table * next;
+} ins_stats_table;
+
+// The registered functions and the tables are guarded by the mutex. The
+// counts of exited threads are added to `ins_stats_retired`.
+static pthread_mutex_t ins_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static const char * ins_stats_names[INS_STATS_MAX_SITES];
+static int ins_stats_num_sites = 0;
+static ins_stats_table * ins_stats_tables = 0;
+static ins_stats_table ins_stats_retired;
+
+static pthread_once_t ins_stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ins_stats_key;
+static _Thread_local ins_stats_table * ins_stats_local = 0;
+
+// Counting can be turned on before `main` through the environment.
+__attribute__((constructor)) static void ins_stats_init(void) {
+  const char * value = getenv("INSIGHT_STATS");
+
+  if (value != 0 && strcmp(value, "1") == 0) {
+    __atomic_fetch_or(&ins_stats_flags, INS_STATS_COUNTING, __ATOMIC_RELAXED);
+  }
+}
+
+// Moves the counts of an exiting thread to the retired counts.
+static void ins_stats_detach(void * arg) {
+  ins_stats_table * table = (ins_stats_table *) arg;
+  ins_stats_table ** link;
+  int i, j;
+
+  pthread_mutex_lock(&ins_stats_mutex);
+
+  for (link = &ins_stats_tables; *link != table; link = &(*link)->next) {
+  }
+  *link = table->next;
+
+  for (i = 0; i < ins_stats_num_sites; ++i) {
+    for (j = 0; j < INS_STATS_FIELDS; ++j) {
+      ins_stats_retired.counters[i][j] += table->counters[i][j];
+    }
+  }
+
+  pthread_mutex_unlock(&ins_stats_mutex);
+
+  free(table);
+}
+
+static void ins_stats_create_key(void) {
+  pthread_key_create(&ins_stats_key, ins_stats_detach);
+}
+
+// Returns the table of the calling thread, creating it on first use.
+static ins_stats_table * ins_stats_attach(void) {
+  ins_stats_table * table;
+
+  pthread_once(&ins_stats_once, ins_stats_create_key);
+
+  table = (ins_stats_table *) calloc(1, sizeof(ins_stats_table));
+  if (table == 0) {
+    return 0;
+  }
+
+  pthread_mutex_lock(&ins_stats_mutex);
+  table->next = ins_stats_tables;
+  ins_stats_tables = table;
+  pthread_mutex_unlock(&ins_stats_mutex);
+
+  pthread_setspecific(ins_stats_key, table);
+  ins_stats_local = table;
+
+  return table;
+}
+
+// Assigns the next index to the function of `site`.
+static int ins_stats_register(ins_stats_site * site) {
+  int id;
+
+  pthread_mutex_lock(&ins_stats_mutex);
+
+  id = site->id;
+  if (id == 0) {
+    id = -1;
+    if (ins_stats_num_sites < INS_STATS_MAX_SITES) {
+      ins_stats_names[ins_stats_num_sites] = site->name;
+      id = ++ins_stats_num_sites;
+    }
+    __atomic_store_n(&site->id, id, __ATOMIC_RELEASE);
+  }
+
+  pthread_mutex_unlock(&ins_stats_mutex);
+
+  return id;
+}
+
+static void ins_stats_add(uint64_t * counter, const uint64_t value) {
+  __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value,
+                   __ATOMIC_RELAXED);
+}
+
+// Counts a call of the function of `site` and starts timing it.
+static void ins_stats_count(ins_stats_probe * probe, ins_stats_site * site,
+                            const uint64_t elements, const uint64_t bytes) {
+  ins_stats_table * table = ins_stats_local;
+  int id = __atomic_load_n(&site->id, __ATOMIC_ACQUIRE);
+  uint64_t * counters;
+
+  if (id == 0) {
+    id = ins_stats_register(site);
+  }
+
+  if (id < 0 || (table == 0 && (table = ins_stats_attach()) == 0)) {
+    return;
+  }
+
+  counters = table->counters[id - 1];
+  ins_stats_add(&counters[INS_STATS_CALLS], 1);
+  ins_stats_add(&counters[INS_STATS_ELEMENTS], elements);
+  ins_stats_add(&counters[INS_STATS_BYTES], bytes);
+
+  probe->flags |= INS_STATS_COUNTING;
+  probe->counters = counters;
+  probe->start = ins_stats_ticks();
+}
+
+int ins_stats_enable(const int enabled) {
+  if (enabled) {
+    __atomic_fetch_or(&ins_stats_flags, INS_STATS_COUNTING, __ATOMIC_RELAXED);
+  } else {
+    __atomic_fetch_and(&ins_stats_flags, ~INS_STATS_COUNTING,
+                       __ATOMIC_RELAXED);
+  }
+  return INS_SUCCESS;
+}
+
+int ins_stats_enabled(void) {
+  return (__atomic_load_n(&ins_stats_flags, __ATOMIC_RELAXED) &
+          INS_STATS_COUNTING) != 0;
+}
+
+size_t ins_stats_snapshot(ins_stats_entry * entries, const size_t capacity) {
+  const ins_stats_table * table;
+  size_t count = 0;
+  int i;
+
+  pthread_mutex_lock(&ins_stats_mutex);
+
+  for (i = 0; i < ins_stats_num_sites; ++i) {
+    uint64_t sums[INS_STATS_FIELDS];
+    int j;
+
+    for (j = 0; j < INS_STATS_FIELDS; ++j) {
+      sums[j] = ins_stats_retired.counters[i][j];
+      for (table = ins_stats_tables; table != 0; table = table->next) {
+        sums[j] += __atomic_load_n(&table->counters[i][j], __ATOMIC_RELAXED);
+      }
+    }
+
+    if (sums[INS_STATS_CALLS] == 0) {
+      continue;
+    }
+
+    if (count < capacity) {
+      entries[count].name = ins_stats_names[i];
+      entries[count].calls = sums[INS_STATS_CALLS];
+      entries[count].elements = sums[INS_STATS_ELEMENTS];
+      entries[count].bytes = sums[INS_STATS_BYTES];
+      entries[count].cycles = sums[INS_STATS_CYCLES];
+    }
+    ++count;
+  }
+
+  pthread_mutex_unlock(&ins_stats_mutex);
+
+  return count;
+}
+
+void ins_stats_reset(void) {
+  ins_stats_table * table;
+  int i, j;
+
+  pthread_mutex_lock(&ins_stats_mutex);
+
+  memset(&ins_stats_retired, 0, sizeof(ins_stats_retired));
+
+  for (table = ins_stats_tables; table != 0; table = table->next) {
+    for (i = 0; i < ins_stats_num_sites; ++i) {
+      for (j = 0; j < INS_STATS_FIELDS; ++j) {
+        __atomic_store_n(&table->counters[i][j], 0, __ATOMIC_RELAXED);
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&ins_stats_mutex);
+}
+
+#else // INSIGHT_ENABLE_STATS
+
+int ins_stats_enable(const int enabled) {
+  (void) enabled;
+  INS_ERROR("Insight was configured without INSIGHT_ENABLE_STATS",
+            INS_EUNSUP);
+}
+
+int ins_stats_enabled(void) {
+  return 0;
+}
+
+size_t ins_stats_snapshot(ins_stats_entry * entries, const size_t capacity) {
+  (void) entries;
+  (void) capacity;
+  return 0;
+}
+
+void ins_stats_reset(void) {
+}
+
+#endif // INSIGHT_ENABLE_STATS
+
+#ifdef INS_STATS_PROBES
+
+// The call is reported to the trace handler before it is counted and after
+// its time is taken, so that the handler does not add to the cycles.
+void ins_stats_enter(ins_stats_probe * probe, ins_stats_site * site,
+                     const uint64_t elements, const ptrdiff_t stride,
+                     const uint64_t bytes) {
+  const int flags = __atomic_load_n(&ins_stats_flags, __ATOMIC_RELAXED);
+
+#ifdef INSIGHT_ENABLE_TRACE
+  if (flags & INS_STATS_TRACING) {
+    probe->event.name = site->name;
+    probe->event.size = (size_t) elements;
+    probe->event.stride = stride;
+    probe->event.bytes = (size_t) bytes;
+    ins_trace_enter(probe);
+  }
+#else
+  (void) stride;
+#endif
+
+#ifdef INSIGHT_ENABLE_STATS
+  if (flags & INS_STATS_COUNTING) {
+    ins_stats_count(probe, site, elements, bytes);
+  }
+#else
+  (void) site;
+  (void) elements;
+  (void) bytes;
+#endif
+}
+
+void ins_stats_exit(ins_stats_probe * probe) {
+#ifdef INSIGHT_ENABLE_STATS
+  if (probe->flags & INS_STATS_COUNTING) {
+    ins_stats_add(&probe->counters[INS_STATS_CYCLES],
+                  ins_stats_ticks() - probe->start);
+  }
+#endif
+
+#ifdef INSIGHT_ENABLE_TRACE
+  if (probe->flags & INS_STATS_TRACING) {
+    ins_trace_exit(probe);
+  }
+#endif
+}
+
+#endif // INS_STATS_PROBES
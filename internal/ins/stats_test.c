@@ -0,0 +1,102 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include <string.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+#include <ins/ins_stats.h>
+
+// Returns the entry named `name` of a snapshot, or null.
+static const ins_stats_entry *find(const ins_stats_entry *entries,
+                                   const size_t count, const char *name) {
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    if (strcmp(entries[i].name, name) == 0) {
+      return &entries[i];
+    }
+  }
+  return NULL;
+}
+
+static void *thread_main(void *arg) {
+  ins_vector_float *v = (ins_vector_float *) arg;
+  ins_vector_float_scale(v, 2.0F);
+  ins_vector_float_scale(v, 0.5F);
+  return NULL;
+}
+
+static void test_counters(void **state) {
+  (void) state;
+
+  ins_stats_entry entries[64];
+  size_t count;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+  const int status = ins_stats_enable(1);
+  ins_set_error_handler(handler);
+
+  if (status == INS_EUNSUP) {
+    // Without instrumentation nothing is ever counted.
+    assert_false(ins_stats_enabled());
+    assert_int_equal(ins_stats_snapshot(entries, 64), 0);
+    return;
+  }
+
+  assert_int_equal(status, INS_SUCCESS);
+  assert_true(ins_stats_enabled());
+  ins_stats_reset();
+
+  ins_vector *x = ins_vector_alloc(1000);
+  ins_vector *y = ins_vector_calloc(1000);
+  ins_vector_float *v = ins_vector_float_calloc(10);
+  pthread_t thread;
+
+  ins_vector_set_all(x, 1.0);
+  ins_vector_add(y, x);
+  ins_vector_add(y, x);
+  assert_true(ins_vector_dot(x, y) == 2000.0);
+
+  // The counts of other threads are merged, also after they exit.
+  pthread_create(&thread, NULL, thread_main, v);
+  pthread_join(thread, NULL);
+
+  count = ins_stats_snapshot(entries, 64);
+  assert_true(count <= 64);
+
+  const ins_stats_entry *add = find(entries, count, "ins_vector_add");
+  assert_non_null(add);
+  assert_int_equal(add->calls, 2);
+  assert_int_equal(add->elements, 2000);
+  assert_int_equal(add->bytes, 2 * 3 * 1000 * sizeof(double));
+
+  const ins_stats_entry *dot = find(entries, count, "ins_vector_dot");
+  assert_non_null(dot);
+  assert_int_equal(dot->calls, 1);
+
+  const ins_stats_entry *scale = find(entries, count, "ins_vector_float_scale");
+  assert_non_null(scale);
+  assert_int_equal(scale->calls, 2);
+  assert_int_equal(scale->elements, 20);
+
+  // Nothing is counted while counting is off, and a reset clears all.
+  ins_stats_enable(0);
+  ins_vector_add(y, x);
+  count = ins_stats_snapshot(entries, 64);
+  assert_int_equal(find(entries, count, "ins_vector_add")->calls, 2);
+
+  ins_stats_reset();
+  assert_int_equal(ins_stats_snapshot(entries, 64), 0);
+
+  ins_vector_float_free(v);
+  ins_vector_free(y);
+  ins_vector_free(x);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_counters)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,128 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_async_io.h"
+#include "ins/ins_stream_io.h"
+
+// Starts reading the next chunk of the range into `buffers[next]`.
+static int ins_stream_request(ins_stream * stream) {
+  const size_t size = stream->remaining < stream->chunk
+                          ? (size_t) stream->remaining
+                          : stream->chunk;
+
+  stream->pending_size = size;
+
+  if (size == 0) {
+    stream->pending = 0;
+    return INS_SUCCESS;
+  }
+
+  stream->pending = ins_async_submit(stream->fd, (size_t) stream->offset,
+                                     stream->buffers[stream->next], size, 0,
+                                     0, 0, 0);
+
+  if (stream->pending == 0) {
+    return INS_EFAILED;
+  }
+
+  stream->offset += size;
+  stream->remaining -= size;
+
+  return INS_SUCCESS;
+}
+
+int ins_stream_open(ins_stream * stream, const char * path,
+                    const uint64_t offset, const uint64_t nbytes,
+                    const size_t elem_size) {
+  struct stat st;
+  size_t chunk = INS_STREAM_CHUNK / elem_size * elem_size;
+
+  if (nbytes < chunk) {
+    chunk = (size_t) nbytes;
+  }
+
+  stream->fd = open(path, O_RDONLY);
+
+  if (stream->fd < 0) {
+    INS_ERROR("failed to open file", INS_EFAILED);
+  }
+
+  if (fstat(stream->fd, &st) != 0) {
+    close(stream->fd);
+    INS_ERROR("fstat failed", INS_EFAILED);
+  }
+
+  if ((uint64_t) st.st_size < offset ||
+      (uint64_t) st.st_size - offset < nbytes) {
+    close(stream->fd);
+    INS_ERROR("file is too short for the requested vector", INS_EINVAL);
+  }
+
+  // The range is read once from start to end. Access pattern advice is
+  // best effort, so failures are ignored.
+#ifdef POSIX_FADV_SEQUENTIAL
+  posix_fadvise(stream->fd, (off_t) offset, (off_t) nbytes,
+                POSIX_FADV_SEQUENTIAL);
+#endif
+
+  stream->offset = offset;
+  stream->remaining = nbytes;
+  stream->chunk = chunk;
+  stream->pending = 0;
+  stream->next = 0;
+  stream->buffers[0] = (unsigned char *) malloc(chunk > 0 ? chunk : 1);
+  stream->buffers[1] = (unsigned char *) malloc(chunk > 0 ? chunk : 1);
+
+  if (stream->buffers[0] == 0 || stream->buffers[1] == 0) {
+    free(stream->buffers[0]);
+    free(stream->buffers[1]);
+    close(stream->fd);
+    INS_ERROR("failed to allocate space for stream buffers", INS_ENOMEM);
+  }
+
+  if (ins_stream_request(stream) != INS_SUCCESS) {
+    free(stream->buffers[0]);
+    free(stream->buffers[1]);
+    close(stream->fd);
+    return INS_EFAILED;
+  }
+
+  return INS_SUCCESS;
+}
+
+int ins_stream_next(ins_stream * stream, const void ** data,
+                    size_t * nbytes) {
+  const int current = stream->next;
+  int status;
+
+  *data = stream->buffers[current];
+  *nbytes = stream->pending_size;
+
+  if (stream->pending == 0) {
+    return INS_SUCCESS;
+  }
+
+  status = ins_async_wait(stream->pending);
+  stream->pending = 0;
+
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  // The following chunk is read into the other buffer while the caller
+  // works on this one.
+  stream->next = 1 - current;
+  return ins_stream_request(stream);
+}
+
+void ins_stream_close(ins_stream * stream) {
+  if (stream->pending != 0) {
+    ins_async_wait(stream->pending);
+  }
+
+  free(stream->buffers[0]);
+  free(stream->buffers[1]);
+  close(stream->fd);
+}
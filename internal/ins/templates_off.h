@@ -72,8 +72,12 @@
 #undef INS_SHORT
 #endif
 
-#ifdef INS_INPUT_FORMAT
-#undef INS_INPUT_FORMAT
+#ifdef INS_TEXT_READ
+#undef INS_TEXT_READ
+#endif
+
+#ifdef INS_TEXT_WRITE
+#undef INS_TEXT_WRITE
 #endif
 
 #ifdef INS_OUTPUT_FORMAT
@@ -91,3 +95,43 @@
 #ifdef INS_FLOATING_POINT
 #undef INS_FLOATING_POINT
 #endif
+
+#ifdef INS_HALF_PRECISION
+#undef INS_HALF_PRECISION
+#endif
+
+#ifdef INS_SCALAR
+#undef INS_SCALAR
+#endif
+
+#ifdef INS_TO_SCALAR
+#undef INS_TO_SCALAR
+#endif
+
+#ifdef INS_FROM_SCALAR
+#undef INS_FROM_SCALAR
+#endif
+
+#ifdef INS_TO_FLOAT_ARRAY
+#undef INS_TO_FLOAT_ARRAY
+#endif
+
+#ifdef INS_FROM_FLOAT_ARRAY
+#undef INS_FROM_FLOAT_ARRAY
+#endif
+
+#ifdef INS_COMPLEX
+#undef INS_COMPLEX
+#endif
+
+#ifdef INS_ATOMIC
+#undef INS_ATOMIC
+#endif
+
+#ifdef INS_MULTIPLICITY
+#undef INS_MULTIPLICITY
+#endif
+
+#ifdef INS_TYPE_ID
+#undef INS_TYPE_ID
+#endif
@@ -2,7 +2,8 @@
 #define INS_BASE double
 #define INS_SHORT double
 #define INS_FLOATING_POINT 1
-#define INS_INPUT_FORMAT "%lg"
+#define INS_TEXT_READ ins_text_read_double
+#define INS_TEXT_WRITE ins_text_write_double
 #define INS_OUTPUT_FORMAT "%g"
 #define INS_ZERO 0.0
 #define INS_ONE 1.0
@@ -10,21 +11,112 @@
 #define INS_BASE float
 #define INS_SHORT float
 #define INS_FLOATING_POINT 1
-#define INS_INPUT_FORMAT "%g"
+#define INS_TEXT_READ ins_text_read_float
+#define INS_TEXT_WRITE ins_text_write_float
 #define INS_OUTPUT_FORMAT "%g"
 #define INS_ZERO 0.0F
 #define INS_ONE 1.0F
 #elif defined(INS_BASE_INT)
 #define INS_BASE int
 #define INS_SHORT int
-#define INS_INPUT_FORMAT "%d"
+#define INS_TEXT_READ ins_text_read_int
+#define INS_TEXT_WRITE ins_text_write_int
 #define INS_OUTPUT_FORMAT "%d"
 #define INS_ZERO 0
 #define INS_ONE 1
+#elif defined(INS_BASE_F16)
+// Half precision (IEEE 754 binary16) is stored as raw bits and computed in
+// single precision. `INS_ZERO` and `INS_ONE` are the stored bit patterns.
+#define INS_BASE uint16_t
+#define INS_SHORT f16
+#define INS_HALF_PRECISION 1
+#define INS_SCALAR float
+#define INS_TO_SCALAR(x) ins_f16_to_float(x)
+#define INS_FROM_SCALAR(x) ins_float_to_f16(x)
+#define INS_TO_FLOAT_ARRAY ins_f16_to_float_array
+#define INS_FROM_FLOAT_ARRAY ins_float_to_f16_array
+#define INS_TEXT_READ ins_text_read_float
+#define INS_TEXT_WRITE ins_text_write_float
+#define INS_OUTPUT_FORMAT "%g"
+#define INS_ZERO 0x0000
+#define INS_ONE 0x3C00
+#elif defined(INS_BASE_BF16)
+// Brain floating point (the upper half of an IEEE 754 binary32) is stored as
+// raw bits and computed in single precision. `INS_ZERO` and `INS_ONE` are the
+// stored bit patterns.
+#define INS_BASE uint16_t
+#define INS_SHORT bf16
+#define INS_HALF_PRECISION 1
+#define INS_SCALAR float
+#define INS_TO_SCALAR(x) ins_bf16_to_float(x)
+#define INS_FROM_SCALAR(x) ins_float_to_bf16(x)
+#define INS_TO_FLOAT_ARRAY ins_bf16_to_float_array
+#define INS_FROM_FLOAT_ARRAY ins_float_to_bf16_array
+#define INS_TEXT_READ ins_text_read_float
+#define INS_TEXT_WRITE ins_text_write_float
+#define INS_OUTPUT_FORMAT "%g"
+#define INS_ZERO 0x0000
+#define INS_ONE 0x3F80
+#elif defined(INS_BASE_COMPLEX)
+// Complex numbers are stored as interleaved (real, imaginary) pairs of
+// `INS_ATOMIC`s, i.e. `INS_MULTIPLICITY` atomics per element.
+#define INS_BASE ins_complex
+#define INS_SHORT complex
+#define INS_COMPLEX 1
+#define INS_ATOMIC double
+#define INS_MULTIPLICITY 2
+#define INS_TEXT_READ ins_text_read_double
+#define INS_TEXT_WRITE ins_text_write_double
+#define INS_OUTPUT_FORMAT "%g"
+#define INS_ZERO ((ins_complex) {{0.0, 0.0}})
+#define INS_ONE ((ins_complex) {{1.0, 0.0}})
+#elif defined(INS_BASE_COMPLEX_FLOAT)
+#define INS_BASE ins_complex_float
+#define INS_SHORT complex_float
+#define INS_COMPLEX 1
+#define INS_ATOMIC float
+#define INS_MULTIPLICITY 2
+#define INS_TEXT_READ ins_text_read_float
+#define INS_TEXT_WRITE ins_text_write_float
+#define INS_OUTPUT_FORMAT "%g"
+#define INS_ZERO ((ins_complex_float) {{0.0F, 0.0F}})
+#define INS_ONE ((ins_complex_float) {{1.0F, 0.0F}})
 #else
 #error Unkown INS_BASE_ DIRECTIVE
 #endif
 
+// The type in which elements are passed to and returned from the library
+// functions, and the conversions between it and the stored element type.
+#ifndef INS_SCALAR
+#define INS_SCALAR INS_BASE
+#define INS_TO_SCALAR(x) (x)
+#define INS_FROM_SCALAR(x) (x)
+#endif
+
+// The `ins_type` code of the element type, as stored in `.ins` containers.
+#if defined(INS_BASE_DOUBLE)
+#define INS_TYPE_ID INS_TYPE_DOUBLE
+#elif defined(INS_BASE_FLOAT)
+#define INS_TYPE_ID INS_TYPE_FLOAT
+#elif defined(INS_BASE_INT)
+#define INS_TYPE_ID INS_TYPE_INT
+#elif defined(INS_BASE_F16)
+#define INS_TYPE_ID INS_TYPE_F16
+#elif defined(INS_BASE_BF16)
+#define INS_TYPE_ID INS_TYPE_BF16
+#elif defined(INS_BASE_COMPLEX)
+#define INS_TYPE_ID INS_TYPE_COMPLEX
+#elif defined(INS_BASE_COMPLEX_FLOAT)
+#define INS_TYPE_ID INS_TYPE_COMPLEX_FLOAT
+#endif
+
+// The type of the values that make up the storage of one element, and how
+// many of them there are per element.
+#ifndef INS_ATOMIC
+#define INS_ATOMIC INS_BASE
+#define INS_MULTIPLICITY 1
+#endif
+
 #define CONCAT2x(a,b) a ## _ ## b
 #define CONCAT2(a,b) CONCAT2x(a,b)
 #define CONCAT3x(a,b,c) a ## _ ## b ## _ ## c
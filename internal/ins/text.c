@@ -0,0 +1,697 @@
+#include <float.h>
+#include <limits.h>
+#include <locale.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ins/ins_text.h"
+#include "ins/ins_pow5.h"
+
+// Number of leading significant digits accumulated into the 64-bit decimal
+// mantissa. 10^19 - 1 is the largest such number that fits in 64 bits.
+#define INS_TEXT_MANTISSA_DIGITS 19
+
+// Number of significant digits kept for the `strtod` fallback. A double is
+// determined by its first 768 significant digits and whether any of the
+// remaining ones is non-zero, so longer inputs are cut and the remaining
+// digits are folded into the last kept one.
+#define INS_TEXT_MAX_DIGITS 800
+
+// Exponents are clamped to this magnitude while they are accumulated; any
+// larger exponent over- or underflows regardless of the digits.
+#define INS_TEXT_MAX_EXPONENT 100000
+
+// A parsed decimal number `digits * 10^exponent`, with the first
+// `INS_TEXT_MANTISSA_DIGITS` significant digits in `w` so that
+// `w * 10^q` is the value truncated to those digits.
+typedef struct {
+  int negative;
+  uint64_t w;
+  int64_t q;
+  size_t num_digits;
+  char digits[INS_TEXT_MAX_DIGITS + 1];
+  int64_t exponent;
+} ins_decimal;
+
+// The kinds of floating point numbers `ins_text_scan` recognizes.
+enum {
+  INS_TEXT_DECIMAL,
+  INS_TEXT_INFINITY,
+  INS_TEXT_NAN,
+  INS_TEXT_HEX
+};
+
+// Size of the buffer holding hexadecimal numbers for `strtod`.
+#define INS_TEXT_HEX_SIZE 128
+
+// A source of characters: the stream `stream`, or if it is null the
+// characters from `p` to `end`.
+typedef struct {
+  FILE * stream;
+  const char * p;
+  const char * end;
+} ins_text_input;
+
+static inline int ins_text_get(ins_text_input * in) {
+  if (in->stream != 0) {
+    return getc_unlocked(in->stream);
+  }
+
+  return in->p < in->end ? (unsigned char) *in->p++ : EOF;
+}
+
+// Pushes back the last character returned by `ins_text_get`.
+static inline void ins_text_unget(ins_text_input * in, const int c) {
+  if (c == EOF) {
+    return;
+  }
+
+  if (in->stream != 0) {
+    ungetc(c, in->stream);
+  } else {
+    --in->p;
+  }
+}
+
+static int ins_text_is_space(const int c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+static int ins_text_is_digit(const int c) {
+  return c >= '0' && c <= '9';
+}
+
+static int ins_text_is_hex_digit(const int c) {
+  return ins_text_is_digit(c) || (c >= 'a' && c <= 'f') ||
+         (c >= 'A' && c <= 'F');
+}
+
+static int ins_text_lower(const int c) {
+  return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+// Consumes the characters of `rest` from `in`, ignoring case, starting
+// with the already read character `*c`. On return `*c` holds the first
+// character that was not consumed. Returns non-zero if all of `rest` matched.
+static int ins_text_match(ins_text_input * in, int * c, const char * rest) {
+  for (; *rest != '\0'; ++rest) {
+    if (ins_text_lower(*c) != *rest) {
+      return 0;
+    }
+    *c = ins_text_get(in);
+  }
+
+  return 1;
+}
+
+// Adds the significant digit `c` to the decimal number `d`. `fraction` is
+// non-zero for digits after the decimal point.
+static void ins_text_add_digit(ins_decimal * d, const int c,
+                               const int fraction) {
+  const unsigned digit = (unsigned) (c - '0');
+
+  if (d->num_digits < INS_TEXT_MANTISSA_DIGITS) {
+    d->w = 10 * d->w + digit;
+    if (fraction) {
+      d->q -= 1;
+    }
+  } else if (!fraction) {
+    d->q += 1;
+  }
+
+  if (d->num_digits < INS_TEXT_MAX_DIGITS) {
+    d->digits[d->num_digits] = (char) c;
+    if (fraction) {
+      d->exponent -= 1;
+    }
+  } else {
+    // Digits past the kept ones only matter through being non-zero.
+    if (digit != 0) {
+      d->digits[INS_TEXT_MAX_DIGITS - 1] |= 1;
+    }
+    if (!fraction) {
+      d->exponent += 1;
+    }
+  }
+
+  ++d->num_digits;
+}
+
+// Reads a floating point number from `in`. Decimal numbers are stored in
+// `d`; hexadecimal numbers are copied to `hex`. Returns the kind of number
+// read, or -1 if there is no number.
+static int ins_text_scan(ins_text_input * in, ins_decimal * d, char * hex) {
+  int c;
+  int seen_digit = 0;
+  int64_t exponent = 0;
+  int exponent_negative = 0;
+
+  d->negative = 0;
+  d->w = 0;
+  d->q = 0;
+  d->num_digits = 0;
+  d->exponent = 0;
+
+  do {
+    c = ins_text_get(in);
+  } while (ins_text_is_space(c));
+
+  if (c == '+' || c == '-') {
+    d->negative = c == '-';
+    c = ins_text_get(in);
+  }
+
+  if (c == 'i' || c == 'I') {
+    if (!ins_text_match(in, &c, "inf")) {
+      return -1;
+    }
+    if (c == 'i' || c == 'I') {
+      ins_text_match(in, &c, "inity");
+    }
+    ins_text_unget(in, c);
+    return INS_TEXT_INFINITY;
+  }
+
+  if (c == 'n' || c == 'N') {
+    if (!ins_text_match(in, &c, "nan")) {
+      return -1;
+    }
+    if (c == '(') {
+      do {
+        c = ins_text_get(in);
+      } while (ins_text_is_digit(c) || c == '_' ||
+               (ins_text_lower(c) >= 'a' && ins_text_lower(c) <= 'z'));
+      if (c == ')') {
+        c = ins_text_get(in);
+      }
+    }
+    ins_text_unget(in, c);
+    return INS_TEXT_NAN;
+  }
+
+  if (c == '0') {
+    seen_digit = 1;
+    c = ins_text_get(in);
+
+    if (c == 'x' || c == 'X') {
+      size_t n = 0;
+      int in_exponent = 0;
+
+      hex[n++] = d->negative ? '-' : '+';
+      hex[n++] = '0';
+      hex[n++] = 'x';
+      c = ins_text_get(in);
+
+      // The characters are validated by `strtod`; this only collects them.
+      while (n < INS_TEXT_HEX_SIZE - 1) {
+        if (c == 'p' || c == 'P') {
+          if (in_exponent) {
+            break;
+          }
+          in_exponent = 1;
+        } else if (c == '+' || c == '-') {
+          if (hex[n - 1] != 'p') {
+            break;
+          }
+        } else if (in_exponent ? !ins_text_is_digit(c)
+                               : !(ins_text_is_hex_digit(c) || c == '.')) {
+          break;
+        }
+        hex[n++] = (char) ((c == 'P') ? 'p' : c);
+        c = ins_text_get(in);
+      }
+
+      hex[n] = '\0';
+      ins_text_unget(in, c);
+      return INS_TEXT_HEX;
+    }
+  }
+
+  // Leading zeros are not significant.
+  while (c == '0') {
+    c = ins_text_get(in);
+  }
+
+  while (ins_text_is_digit(c)) {
+    seen_digit = 1;
+    ins_text_add_digit(d, c, 0);
+    c = ins_text_get(in);
+  }
+
+  if (c == '.') {
+    c = ins_text_get(in);
+
+    // Zeros right after the decimal point only shift the exponent.
+    if (d->num_digits == 0) {
+      while (c == '0') {
+        seen_digit = 1;
+        d->q -= 1;
+        d->exponent -= 1;
+        c = ins_text_get(in);
+      }
+    }
+
+    while (ins_text_is_digit(c)) {
+      seen_digit = 1;
+      ins_text_add_digit(d, c, 1);
+      c = ins_text_get(in);
+    }
+  }
+
+  if (!seen_digit) {
+    ins_text_unget(in, c);
+    return -1;
+  }
+
+  if (c == 'e' || c == 'E') {
+    c = ins_text_get(in);
+
+    if (c == '+' || c == '-') {
+      exponent_negative = c == '-';
+      c = ins_text_get(in);
+    }
+
+    if (!ins_text_is_digit(c)) {
+      ins_text_unget(in, c);
+      return -1;
+    }
+
+    while (ins_text_is_digit(c)) {
+      if (exponent < INS_TEXT_MAX_EXPONENT) {
+        exponent = 10 * exponent + (c - '0');
+      }
+      c = ins_text_get(in);
+    }
+
+    if (exponent_negative) {
+      exponent = -exponent;
+    }
+
+    d->q += exponent;
+    d->exponent += exponent;
+  }
+
+  ins_text_unget(in, c);
+
+  return INS_TEXT_DECIMAL;
+}
+
+/* Eisel-Lemire
+ --------------------------------------------------------------------------*/
+
+// Parameters of a binary floating point format.
+typedef struct {
+  int mantissa_bits;     // explicitly stored mantissa bits
+  int minimum_exponent;  // negated exponent bias
+  int infinite_power;    // biased exponent of infinity
+  int smallest_power;    // powers of ten below this round to zero
+  int largest_power;     // powers of ten above this round to infinity
+  int min_round_to_even; // range of powers of ten for which a product can
+  int max_round_to_even; // be exactly half-way between two floats
+} ins_binary_format;
+
+static const ins_binary_format ins_binary64 = {
+  52, -1023, 0x7ff, -342, 308, -4, 23
+};
+
+static const ins_binary_format ins_binary32 = {
+  23, -127, 0xff, -65, 38, -17, 10
+};
+
+static int ins_text_leading_zeros(uint64_t x) {
+#if defined(__GNUC__)
+  return __builtin_clzll(x);
+#else
+  int n = 0;
+  while (!(x & 0x8000000000000000ULL)) {
+    x <<= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+// Computes the binary floating point number nearest to `w * 10^q` in the
+// format `f`, for a non-zero `w`, returning its biased exponent and its
+// mantissa without the implicit bit. With a 128-bit approximation of the
+// power of five the result is always correctly rounded (N. Mushtak and
+// D. Lemire, "Fast Number Parsing Without Fallback", 2023).
+static void ins_eisel_lemire(const ins_binary_format * f, uint64_t w,
+                             const int64_t q, uint64_t * mantissa,
+                             int * power2) {
+  const int lz = ins_text_leading_zeros(w);
+  const int index = 2 * (int) (q - INS_POW5_MIN);
+  const uint64_t precision_mask =
+    0xffffffffffffffffULL >> (f->mantissa_bits + 3);
+
+  uint64_t high;
+  uint64_t low;
+  int upperbit;
+  int shift;
+  int64_t p2;
+
+  if (q < f->smallest_power) {
+    *mantissa = 0;
+    *power2 = 0;
+    return;
+  }
+
+  if (q > f->largest_power) {
+    *mantissa = 0;
+    *power2 = f->infinite_power;
+    return;
+  }
+
+  w <<= lz;
+  ins_mul128(w, ins_pow5_128[index], &high, &low);
+
+  // Refine with the low half of the power of five only when the bits below
+  // the ones that are kept are all ones, i.e. when a carry could matter.
+  if ((high & precision_mask) == precision_mask) {
+    uint64_t high2;
+    uint64_t low2;
+    ins_mul128(w, ins_pow5_128[index + 1], &high2, &low2);
+    low += high2;
+    if (high2 > low) {
+      ++high;
+    }
+  }
+
+  upperbit = (int) (high >> 63);
+  shift = upperbit + 64 - f->mantissa_bits - 3;
+  *mantissa = high >> shift;
+
+  // floor(q * log2(10)) + 63, see the Eisel-Lemire paper.
+  p2 = ((((int64_t) 152170 + 65536) * q) >> 16) + 63 + upperbit - lz -
+       f->minimum_exponent;
+
+  if (p2 <= 0) {
+    // Subnormal result.
+    if (-p2 + 1 >= 64) {
+      *mantissa = 0;
+      *power2 = 0;
+      return;
+    }
+    *mantissa >>= -p2 + 1;
+    *mantissa += *mantissa & 1;
+    *mantissa >>= 1;
+    *power2 = *mantissa < ((uint64_t) 1 << f->mantissa_bits) ? 0 : 1;
+    *mantissa &= ~((uint64_t) 1 << f->mantissa_bits);
+    return;
+  }
+
+  // Ties round to even: an exact half-way product rounds down when the
+  // mantissa is already even.
+  if (low <= 1 && q >= f->min_round_to_even && q <= f->max_round_to_even &&
+      (*mantissa & 3) == 1 && (*mantissa << shift) == high) {
+    *mantissa &= ~(uint64_t) 1;
+  }
+
+  *mantissa += *mantissa & 1;
+  *mantissa >>= 1;
+
+  if (*mantissa >= ((uint64_t) 2 << f->mantissa_bits)) {
+    *mantissa = (uint64_t) 1 << f->mantissa_bits;
+    ++p2;
+  }
+
+  *mantissa &= ~((uint64_t) 1 << f->mantissa_bits);
+
+  if (p2 >= f->infinite_power) {
+    *mantissa = 0;
+    p2 = f->infinite_power;
+  }
+
+  *power2 = (int) p2;
+}
+
+/* Fallback
+ --------------------------------------------------------------------------*/
+
+// Copies the hexadecimal number `hex` to `buf`, replacing the decimal point
+// by the one of the current locale so that `strtod` and `strtof` read it.
+static void ins_text_localize_hex(const char * hex, char * buf,
+                                  const size_t size) {
+  const char * point = localeconv()->decimal_point;
+  const size_t point_len = strlen(point);
+  size_t n = 0;
+
+  for (; *hex != '\0' && n + point_len < size - 1; ++hex) {
+    if (*hex == '.') {
+      memcpy(buf + n, point, point_len);
+      n += point_len;
+    } else {
+      buf[n++] = *hex;
+    }
+  }
+
+  buf[n] = '\0';
+}
+
+// Writes the decimal number `d` as "[-]digitsE[-]exponent", which `strtod`
+// reads the same way in every locale since it has no decimal point.
+static void ins_text_format_decimal(const ins_decimal * d, char * buf) {
+  const size_t n = d->num_digits < INS_TEXT_MAX_DIGITS
+                   ? d->num_digits : INS_TEXT_MAX_DIGITS;
+  char * p = buf;
+
+  if (d->negative) {
+    *p++ = '-';
+  }
+
+  memcpy(p, d->digits, n);
+  p += n;
+  sprintf(p, "e%lld", (long long) d->exponent);
+}
+
+/* Conversions
+ --------------------------------------------------------------------------*/
+
+static int ins_text_convert_double(ins_text_input * in, double * out) {
+  ins_decimal d;
+  char hex[INS_TEXT_HEX_SIZE];
+  uint64_t mantissa;
+  uint64_t bits;
+  int power2;
+  double value;
+
+  switch (ins_text_scan(in, &d, hex)) {
+  case INS_TEXT_DECIMAL:
+    break;
+  case INS_TEXT_INFINITY:
+    *out = d.negative ? -HUGE_VAL : HUGE_VAL;
+    return 0;
+  case INS_TEXT_NAN:
+    *out = d.negative ? -NAN : NAN;
+    return 0;
+  case INS_TEXT_HEX: {
+    char buf[INS_TEXT_HEX_SIZE * 4];
+    ins_text_localize_hex(hex, buf, sizeof(buf));
+    *out = strtod(buf, 0);
+    return 0;
+  }
+  default:
+    return -1;
+  }
+
+  if (d.w == 0) {
+    *out = d.negative ? -0.0 : 0.0;
+    return 0;
+  }
+
+#if FLT_EVAL_METHOD == 0
+  // Clinger's fast path: both the mantissa and the power of ten are exact
+  // doubles, so a single correctly rounded operation gives the result.
+  if (d.num_digits <= INS_TEXT_MANTISSA_DIGITS && d.w <= (1ULL << 53) &&
+      d.q >= -22 && d.q <= 22) {
+    static const double powers[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    value = (double) d.w;
+    value = d.q < 0 ? value / powers[-d.q] : value * powers[d.q];
+    *out = d.negative ? -value : value;
+    return 0;
+  }
+#endif
+
+  ins_eisel_lemire(&ins_binary64, d.w, d.q, &mantissa, &power2);
+
+  // When digits were cut off the value lies between `w * 10^q` and
+  // `(w + 1) * 10^q`; if both round to the same double, so does the value.
+  if (d.num_digits > INS_TEXT_MANTISSA_DIGITS) {
+    uint64_t mantissa_up;
+    int power2_up;
+
+    ins_eisel_lemire(&ins_binary64, d.w + 1, d.q, &mantissa_up, &power2_up);
+
+    if (mantissa_up != mantissa || power2_up != power2) {
+      char buf[INS_TEXT_MAX_DIGITS + 32];
+      ins_text_format_decimal(&d, buf);
+      *out = strtod(buf, 0);
+      return 0;
+    }
+  }
+
+  bits = mantissa | ((uint64_t) power2 << 52);
+  if (d.negative) {
+    bits |= (uint64_t) 1 << 63;
+  }
+
+  memcpy(&value, &bits, sizeof(double));
+  *out = value;
+  return 0;
+}
+
+static int ins_text_convert_float(ins_text_input * in, float * out) {
+  ins_decimal d;
+  char hex[INS_TEXT_HEX_SIZE];
+  uint64_t mantissa;
+  uint32_t bits;
+  int power2;
+  float value;
+
+  switch (ins_text_scan(in, &d, hex)) {
+  case INS_TEXT_DECIMAL:
+    break;
+  case INS_TEXT_INFINITY:
+    *out = d.negative ? -HUGE_VALF : HUGE_VALF;
+    return 0;
+  case INS_TEXT_NAN:
+    *out = d.negative ? -NAN : NAN;
+    return 0;
+  case INS_TEXT_HEX: {
+    char buf[INS_TEXT_HEX_SIZE * 4];
+    ins_text_localize_hex(hex, buf, sizeof(buf));
+    *out = strtof(buf, 0);
+    return 0;
+  }
+  default:
+    return -1;
+  }
+
+  if (d.w == 0) {
+    *out = d.negative ? -0.0F : 0.0F;
+    return 0;
+  }
+
+#if FLT_EVAL_METHOD == 0
+  if (d.num_digits <= INS_TEXT_MANTISSA_DIGITS && d.w <= (1ULL << 24) &&
+      d.q >= -10 && d.q <= 10) {
+    static const float powers[] = {
+      1e0F, 1e1F, 1e2F, 1e3F, 1e4F, 1e5F, 1e6F, 1e7F, 1e8F, 1e9F, 1e10F
+    };
+    value = (float) d.w;
+    value = d.q < 0 ? value / powers[-d.q] : value * powers[d.q];
+    *out = d.negative ? -value : value;
+    return 0;
+  }
+#endif
+
+  ins_eisel_lemire(&ins_binary32, d.w, d.q, &mantissa, &power2);
+
+  if (d.num_digits > INS_TEXT_MANTISSA_DIGITS) {
+    uint64_t mantissa_up;
+    int power2_up;
+
+    ins_eisel_lemire(&ins_binary32, d.w + 1, d.q, &mantissa_up, &power2_up);
+
+    if (mantissa_up != mantissa || power2_up != power2) {
+      char buf[INS_TEXT_MAX_DIGITS + 32];
+      ins_text_format_decimal(&d, buf);
+      *out = strtof(buf, 0);
+      return 0;
+    }
+  }
+
+  bits = (uint32_t) mantissa | ((uint32_t) power2 << 23);
+  if (d.negative) {
+    bits |= (uint32_t) 1 << 31;
+  }
+
+  memcpy(&value, &bits, sizeof(float));
+  *out = value;
+  return 0;
+}
+
+static int ins_text_convert_int(ins_text_input * in, int * out) {
+  int c;
+  int negative = 0;
+  int overflow = 0;
+  long long value = 0;
+  const long long limit = (long long) INT_MAX + 1;
+
+  do {
+    c = ins_text_get(in);
+  } while (ins_text_is_space(c));
+
+  if (c == '+' || c == '-') {
+    negative = c == '-';
+    c = ins_text_get(in);
+  }
+
+  if (!ins_text_is_digit(c)) {
+    ins_text_unget(in, c);
+    return -1;
+  }
+
+  while (ins_text_is_digit(c)) {
+    value = 10 * value + (c - '0');
+    if (value > limit) {
+      overflow = 1;
+      value = limit;
+    }
+    c = ins_text_get(in);
+  }
+
+  ins_text_unget(in, c);
+
+  if (overflow || (!negative && value > INT_MAX)) {
+    return -1;
+  }
+
+  *out = (int) (negative ? -value : value);
+  return 0;
+}
+
+/* Public functions
+ --------------------------------------------------------------------------*/
+
+int ins_text_read_double(FILE * stream, double * out) {
+  ins_text_input in = {stream, 0, 0};
+  return ins_text_convert_double(&in, out);
+}
+
+int ins_text_read_float(FILE * stream, float * out) {
+  ins_text_input in = {stream, 0, 0};
+  return ins_text_convert_float(&in, out);
+}
+
+int ins_text_read_int(FILE * stream, int * out) {
+  ins_text_input in = {stream, 0, 0};
+  return ins_text_convert_int(&in, out);
+}
+
+int ins_text_parse_double(const char ** text, const char * end,
+                          double * out) {
+  ins_text_input in = {0, *text, end};
+  const int status = ins_text_convert_double(&in, out);
+  *text = in.p;
+  return status;
+}
+
+int ins_text_parse_float(const char ** text, const char * end, float * out) {
+  ins_text_input in = {0, *text, end};
+  const int status = ins_text_convert_float(&in, out);
+  *text = in.p;
+  return status;
+}
+
+int ins_text_parse_int(const char ** text, const char * end, int * out) {
+  ins_text_input in = {0, *text, end};
+  const int status = ins_text_convert_int(&in, out);
+  *text = in.p;
+  return status;
+}
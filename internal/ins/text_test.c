@@ -0,0 +1,273 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include <ins/ins_block.h>
+#include <ins/ins_vector.h>
+
+static FILE * text_file(const char *text) {
+  FILE *file = fopen("text.dat", "w+");
+  fputs(text, file);
+  rewind(file);
+  return file;
+}
+
+static void test_vector_fscanf(void **state) {
+  (void) state;
+
+  static const char *text[] = {
+    "0", "-0", "1", "+2.5", "-1e-3", ".5", "5.", "1E+10", "0x1.8p1",
+    "1.7976931348623157e308", "4.9e-324", "2.2250738585072011e-308",
+    "123456789012345678901234567890", "0.1000000000000000055511151231257827",
+    "9007199254740993", "1e400", "1e-400"
+  };
+  const size_t n = sizeof(text) / sizeof(text[0]);
+
+  FILE *file = fopen("text.dat", "w+");
+  size_t i;
+  for (i = 0; i < n; ++i) {
+    fprintf(file, i % 3 == 0 ? "%s\n" : "%s\t ", text[i]);
+  }
+  rewind(file);
+
+  ins_vector *v = ins_vector_alloc(n);
+  assert_int_equal(ins_vector_fscanf(v, file), INS_SUCCESS);
+  fclose(file);
+
+  // Conversions are correctly rounded, i.e. they match `strtod`.
+  for (i = 0; i < n; ++i) {
+    const double expected = strtod(text[i], 0);
+    const double actual = ins_vector_get(v, i);
+    assert_memory_equal(&actual, &expected, sizeof(double));
+  }
+
+  ins_vector_free(v);
+}
+
+static void test_special_values(void **state) {
+  (void) state;
+
+  FILE *file = text_file("inf -Infinity NaN nan(123) 1e39 -1.5e-46");
+
+  ins_vector_float *v = ins_vector_float_alloc(6);
+  assert_int_equal(ins_vector_float_fscanf(v, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_true(isinf(ins_vector_float_get(v, 0)));
+  assert_true(ins_vector_float_get(v, 0) > 0.0F);
+  assert_true(isinf(ins_vector_float_get(v, 1)));
+  assert_true(ins_vector_float_get(v, 1) < 0.0F);
+  assert_true(isnan(ins_vector_float_get(v, 2)));
+  assert_true(isnan(ins_vector_float_get(v, 3)));
+  assert_true(isinf(ins_vector_float_get(v, 4)));
+  assert_true(ins_vector_float_get(v, 5) == 0.0F);
+
+  ins_vector_float_free(v);
+}
+
+static void test_sequential_reads(void **state) {
+  (void) state;
+
+  // Several objects can be read from one stream, and the stream is left
+  // right after the last number.
+  FILE *file = text_file("1 2 3\n-4 5\n1.5 -2 0.25 8 rest");
+
+  ins_vector_int *a = ins_vector_int_alloc(3);
+  ins_block_int *b = ins_block_int_alloc(2);
+  ins_block_complex *c = ins_block_complex_alloc(2);
+
+  assert_int_equal(ins_vector_int_fscanf(a, file), INS_SUCCESS);
+  assert_int_equal(ins_block_int_fscanf(b, file), INS_SUCCESS);
+  assert_int_equal(ins_block_complex_fscanf(c, file), INS_SUCCESS);
+
+  char rest[8];
+  assert_non_null(fgets(rest, sizeof(rest), file));
+  assert_string_equal(rest, " rest");
+  fclose(file);
+
+  assert_int_equal(ins_vector_int_get(a, 0), 1);
+  assert_int_equal(ins_vector_int_get(a, 2), 3);
+  assert_int_equal(b->data[0], -4);
+  assert_int_equal(b->data[1], 5);
+  assert_double_equal(c->data[0], 1.5, 0.0);
+  assert_double_equal(c->data[1], -2.0, 0.0);
+  assert_double_equal(c->data[2], 0.25, 0.0);
+  assert_double_equal(c->data[3], 8.0, 0.0);
+
+  ins_block_complex_free(c);
+  ins_block_int_free(b);
+  ins_vector_int_free(a);
+}
+
+static void test_invalid_input(void **state) {
+  (void) state;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+
+  ins_vector *v = ins_vector_alloc(3);
+  FILE *file = text_file("1 2 x");
+  assert_int_equal(ins_vector_fscanf(v, file), INS_EFAILED);
+  fclose(file);
+
+  file = text_file("1 2");
+  assert_int_equal(ins_vector_fscanf(v, file), INS_EFAILED);
+  fclose(file);
+
+  ins_vector_int *w = ins_vector_int_alloc(2);
+  file = text_file("1 99999999999");
+  assert_int_equal(ins_vector_int_fscanf(w, file), INS_EFAILED);
+  fclose(file);
+
+  file = text_file("1 2.5");
+  assert_int_equal(ins_vector_int_fscanf(w, file), INS_SUCCESS);
+  fclose(file);
+  assert_int_equal(ins_vector_int_get(w, 1), 2);
+
+  ins_set_error_handler(handler);
+
+  ins_vector_int_free(w);
+  ins_vector_free(v);
+}
+
+static char * read_all(FILE *file, char *buf, size_t size) {
+  rewind(file);
+  buf[fread(buf, 1, size - 1, file)] = '\0';
+  return buf;
+}
+
+static void test_shortest_round_trip(void **state) {
+  (void) state;
+
+  const size_t n = 1000;
+  ins_vector *v = ins_vector_alloc(n);
+  ins_vector *w = ins_vector_alloc(n);
+  uint64_t bits = 88172645463325252ULL;
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    double x;
+    bits ^= bits << 13;
+    bits ^= bits >> 7;
+    bits ^= bits << 17;
+    memcpy(&x, &bits, sizeof(x));
+    ins_vector_set(v, i, isfinite(x) ? x : (double) i);
+  }
+  ins_vector_set(v, 0, 0.1);
+  ins_vector_set(v, 1, 4.9406564584124654e-324);
+  ins_vector_set(v, 2, -1e23);
+
+  FILE *file = fopen("text.dat", "w+");
+  assert_int_equal(ins_vector_fprintf(v, file, NULL), INS_SUCCESS);
+  rewind(file);
+  assert_int_equal(ins_vector_fscanf(w, file), INS_SUCCESS);
+  assert_memory_equal(w->data, v->data, n * sizeof(double));
+
+  char buf[64];
+  rewind(file);
+  assert_non_null(fgets(buf, sizeof(buf), file));
+  assert_string_equal(buf, "0.1\n");
+  assert_non_null(fgets(buf, sizeof(buf), file));
+  assert_string_equal(buf, "5e-324\n");
+  assert_non_null(fgets(buf, sizeof(buf), file));
+  assert_string_equal(buf, "-1e+23\n");
+  fclose(file);
+
+  ins_vector_free(w);
+  ins_vector_free(v);
+}
+
+static void test_fprintf_formats(void **state) {
+  (void) state;
+
+  static const double values[] = {
+    0.0, -0.0, 1.0, 0.5, 2.5, 0.1, 1.0 / 3.0, -123456.789, 9.5e-5, 1e100,
+    1e15, 1e16, 9.9999999e22, 5e-324
+  };
+  static const char *formats[] = {
+    "%g", "%e", "%f", "%.0f", "%.3e", "%.17g", "%.10f", "%G", "%lg",
+    "%12.4f", "x=%g"
+  };
+  const size_t n = sizeof(values) / sizeof(values[0]);
+
+  ins_block *b = ins_block_alloc(n);
+  memcpy(b->data, values, sizeof(values));
+
+  size_t f, i;
+  for (f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f) {
+    char expected[4096] = "";
+    char actual[4096];
+    for (i = 0; i < n; ++i) {
+      const size_t len = strlen(expected);
+      snprintf(expected + len, sizeof(expected) - len, formats[f], values[i]);
+      strcat(expected, "\n");
+    }
+
+    FILE *file = fopen("text.dat", "w+");
+    assert_int_equal(ins_block_fprintf(b, file, formats[f]), INS_SUCCESS);
+    assert_string_equal(read_all(file, actual, sizeof(actual)), expected);
+    fclose(file);
+  }
+
+  ins_block_free(b);
+}
+
+static void test_fprintf_types(void **state) {
+  (void) state;
+
+  char buf[256];
+
+  ins_vector_int *v = ins_vector_int_alloc(3);
+  ins_vector_int_set(v, 0, 0);
+  ins_vector_int_set(v, 1, -2147483647 - 1);
+  ins_vector_int_set(v, 2, 2147483647);
+  FILE *file = fopen("text.dat", "w+");
+  assert_int_equal(ins_vector_int_fprintf(v, file, "%d"), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_fprintf(v, file, "%5d"), INS_SUCCESS);
+  assert_string_equal(read_all(file, buf, sizeof(buf)),
+                      "0\n-2147483648\n2147483647\n"
+                      "    0\n-2147483648\n2147483647\n");
+  fclose(file);
+
+  ins_vector_float *f = ins_vector_float_alloc(3);
+  ins_vector_float_set(f, 0, 0.1F);
+  ins_vector_float_set(f, 1, -3.4028235e38F);
+  ins_vector_float_set(f, 2, 1.0F / 0.0F);
+  file = fopen("text.dat", "w+");
+  assert_int_equal(ins_vector_float_fprintf(f, file, NULL), INS_SUCCESS);
+  assert_int_equal(ins_vector_float_fprintf(f, file, "%g"), INS_SUCCESS);
+  assert_string_equal(read_all(file, buf, sizeof(buf)),
+                      "0.1\n-3.4028235e+38\ninf\n"
+                      "0.1\n-3.40282e+38\ninf\n");
+  fclose(file);
+
+  ins_block_complex_float *c = ins_block_complex_float_alloc(1);
+  c->data[0] = 1.5F;
+  c->data[1] = -0.2F;
+  file = fopen("text.dat", "w+");
+  assert_int_equal(ins_block_complex_float_fprintf(c, file, NULL),
+                   INS_SUCCESS);
+  assert_string_equal(read_all(file, buf, sizeof(buf)), "1.5 -0.2\n");
+  fclose(file);
+
+  ins_block_complex_float_free(c);
+  ins_vector_float_free(f);
+  ins_vector_int_free(v);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_vector_fscanf),
+    cmocka_unit_test(test_special_values),
+    cmocka_unit_test(test_sequential_reads),
+    cmocka_unit_test(test_invalid_input),
+    cmocka_unit_test(test_shortest_round_trip),
+    cmocka_unit_test(test_fprintf_formats),
+    cmocka_unit_test(test_fprintf_types)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
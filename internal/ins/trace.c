@@ -0,0 +1,289 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // for syscall
+#endif
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_stats_io.h"
+
+#ifdef INSIGHT_ENABLE_TRACE
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+// The trace handler. It is read without locks by traced calls; setting it
+// and the tracing flag together is serialized by the mutex.
+static const ins_trace_handler * ins_trace_current = 0;
+static pthread_mutex_t ins_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t ins_trace_now(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+const ins_trace_handler * ins_get_trace_handler(void) {
+  return __atomic_load_n(&ins_trace_current, __ATOMIC_ACQUIRE);
+}
+
+const ins_trace_handler *
+ins_set_trace_handler(const ins_trace_handler * new_handler) {
+  const ins_trace_handler * previous;
+
+  pthread_mutex_lock(&ins_trace_mutex);
+
+  previous = __atomic_exchange_n(&ins_trace_current, new_handler,
+                                 __ATOMIC_ACQ_REL);
+
+  if (new_handler != 0) {
+    __atomic_fetch_or(&ins_stats_flags, INS_STATS_TRACING, __ATOMIC_RELAXED);
+  } else {
+    __atomic_fetch_and(&ins_stats_flags, ~INS_STATS_TRACING,
+                       __ATOMIC_RELAXED);
+  }
+
+  pthread_mutex_unlock(&ins_trace_mutex);
+
+  return previous;
+}
+
+void ins_trace_enter(ins_stats_probe * probe) {
+  const ins_trace_handler * handler =
+      __atomic_load_n(&ins_trace_current, __ATOMIC_ACQUIRE);
+
+  if (handler == 0) {
+    return;
+  }
+
+  probe->flags |= INS_STATS_TRACING;
+  probe->handler = handler;
+  probe->event.begin = ins_trace_now();
+  probe->event.end = 0;
+
+  if (handler->begin != 0) {
+    handler->begin(&probe->event, handler->context);
+  }
+}
+
+void ins_trace_exit(ins_stats_probe * probe) {
+  probe->event.end = ins_trace_now();
+
+  if (probe->handler->end != 0) {
+    probe->handler->end(&probe->event, probe->handler->context);
+  }
+}
+
+/* CHROME TRACE */
+
+// The events of one thread. `count` is the number of events recorded so
+// far, of which the last `capacity` are kept.
+typedef struct {
+  ins_trace_event * events;
+  uint64_t count;
+  long thread_id;
+} ins_trace_ring;
+
+// The rings of the built-in handler, claimed by threads in the order of
+// their first recorded call. `generation` changes on every start, so that
+// threads claim a ring again.
+static ins_trace_ring * ins_trace_rings = 0;
+static ins_trace_event * ins_trace_events = 0;
+static size_t ins_trace_num_rings = 0;
+static size_t ins_trace_capacity = 0;
+static size_t ins_trace_claimed = 0;
+static unsigned ins_trace_generation = 0;
+
+static _Thread_local unsigned ins_trace_local_generation = 0;
+static _Thread_local ins_trace_ring * ins_trace_local_ring = 0;
+
+static long ins_trace_thread_id(const size_t index) {
+#if defined(__linux__) && defined(SYS_gettid)
+  (void) index;
+  return (long) syscall(SYS_gettid);
+#elif defined(__APPLE__)
+  uint64_t id;
+  (void) index;
+  pthread_threadid_np(0, &id);
+  return (long) id;
+#else
+  return (long) index + 1;
+#endif
+}
+
+// Returns the ring of the calling thread, claiming one on its first call
+// since the last start, or null if all rings are taken.
+static ins_trace_ring * ins_trace_ring_of_thread(void) {
+  const unsigned generation =
+      __atomic_load_n(&ins_trace_generation, __ATOMIC_ACQUIRE);
+
+  if (ins_trace_local_generation != generation) {
+    const size_t index =
+        __atomic_fetch_add(&ins_trace_claimed, 1, __ATOMIC_RELAXED);
+
+    ins_trace_local_ring = 0;
+    if (index < ins_trace_num_rings) {
+      ins_trace_local_ring = &ins_trace_rings[index];
+      ins_trace_local_ring->thread_id = ins_trace_thread_id(index);
+    }
+    ins_trace_local_generation = generation;
+  }
+
+  return ins_trace_local_ring;
+}
+
+static void ins_trace_chrome_record(const ins_trace_event * event,
+                                    void * context) {
+  ins_trace_ring * ring = ins_trace_ring_of_thread();
+  uint64_t count;
+
+  (void) context;
+
+  if (ring == 0) {
+    return;
+  }
+
+  count = __atomic_load_n(&ring->count, __ATOMIC_RELAXED);
+  ring->events[count % ins_trace_capacity] = *event;
+  __atomic_store_n(&ring->count, count + 1, __ATOMIC_RELEASE);
+}
+
+static const ins_trace_handler ins_trace_chrome_handler = {
+  0, ins_trace_chrome_record, 0
+};
+
+int ins_trace_chrome_start(const size_t threads, const size_t events) {
+  ins_trace_ring * rings;
+  ins_trace_event * buffer;
+  size_t i;
+
+  if (threads == 0 || events == 0) {
+    INS_ERROR("number of threads and events must be positive", INS_EINVAL);
+  }
+
+  if (events > SIZE_MAX / sizeof(ins_trace_event) / threads) {
+    INS_ERROR("failed to allocate space for trace events", INS_ENOMEM);
+  }
+
+  rings = (ins_trace_ring *) calloc(threads, sizeof(ins_trace_ring));
+  buffer = (ins_trace_event *) malloc(threads * events *
+                                      sizeof(ins_trace_event));
+
+  if (rings == 0 || buffer == 0) {
+    free(rings);
+    free(buffer);
+    INS_ERROR("failed to allocate space for trace events", INS_ENOMEM);
+  }
+
+  for (i = 0; i < threads; ++i) {
+    rings[i].events = buffer + i * events;
+  }
+
+  ins_trace_chrome_stop();
+
+  free(ins_trace_rings);
+  free(ins_trace_events);
+
+  ins_trace_rings = rings;
+  ins_trace_events = buffer;
+  ins_trace_num_rings = threads;
+  ins_trace_capacity = events;
+  ins_trace_claimed = 0;
+  __atomic_add_fetch(&ins_trace_generation, 1, __ATOMIC_RELEASE);
+
+  ins_set_trace_handler(&ins_trace_chrome_handler);
+
+  return INS_SUCCESS;
+}
+
+void ins_trace_chrome_stop(void) {
+  pthread_mutex_lock(&ins_trace_mutex);
+
+  if (ins_trace_current == &ins_trace_chrome_handler) {
+    __atomic_store_n(&ins_trace_current, 0, __ATOMIC_RELEASE);
+    __atomic_fetch_and(&ins_stats_flags, ~INS_STATS_TRACING,
+                       __ATOMIC_RELAXED);
+  }
+
+  pthread_mutex_unlock(&ins_trace_mutex);
+}
+
+int ins_trace_chrome_write(FILE * stream) {
+  const size_t claimed = __atomic_load_n(&ins_trace_claimed, __ATOMIC_RELAXED);
+  const size_t num_rings = claimed < ins_trace_num_rings ? claimed
+                                                         : ins_trace_num_rings;
+  const long pid = (long) getpid();
+  const char * separator = "\n";
+  size_t i;
+
+  fprintf(stream, "{\"traceEvents\":[");
+
+  for (i = 0; i < num_rings; ++i) {
+    const ins_trace_ring * ring = &ins_trace_rings[i];
+    const uint64_t count = __atomic_load_n(&ring->count, __ATOMIC_ACQUIRE);
+    uint64_t k = count > ins_trace_capacity ? count - ins_trace_capacity : 0;
+
+    for (; k < count; ++k) {
+      const ins_trace_event * event = &ring->events[k % ins_trace_capacity];
+      const uint64_t duration = event->end - event->begin;
+
+      fprintf(stream,
+              "%s{\"name\":\"%s\",\"cat\":\"insight\",\"ph\":\"X\","
+              "\"ts\":%" PRIu64 ".%03u,\"dur\":%" PRIu64 ".%03u,"
+              "\"pid\":%ld,\"tid\":%ld,\"args\":{\"size\":%zu,"
+              "\"stride\":%td,\"bytes\":%zu}}",
+              separator, event->name, event->begin / 1000,
+              (unsigned) (event->begin % 1000), duration / 1000,
+              (unsigned) (duration % 1000), pid, ring->thread_id,
+              event->size, event->stride, event->bytes);
+      separator = ",\n";
+    }
+  }
+
+  fprintf(stream, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+  if (fflush(stream) != 0 || ferror(stream)) {
+    INS_ERROR("failed to write trace", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+#else // INSIGHT_ENABLE_TRACE
+
+const ins_trace_handler * ins_get_trace_handler(void) {
+  return 0;
+}
+
+const ins_trace_handler *
+ins_set_trace_handler(const ins_trace_handler * new_handler) {
+  (void) new_handler;
+  INS_ERROR_VAL("Insight was configured without INSIGHT_ENABLE_TRACE",
+                INS_EUNSUP, 0);
+}
+
+int ins_trace_chrome_start(const size_t threads, const size_t events) {
+  (void) threads;
+  (void) events;
+  INS_ERROR("Insight was configured without INSIGHT_ENABLE_TRACE",
+            INS_EUNSUP);
+}
+
+void ins_trace_chrome_stop(void) {
+}
+
+int ins_trace_chrome_write(FILE * stream) {
+  fprintf(stream, "{\"traceEvents\":[\n],\"displayTimeUnit\":\"ns\"}\n");
+
+  if (fflush(stream) != 0 || ferror(stream)) {
+    INS_ERROR("failed to write trace", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+#endif // INSIGHT_ENABLE_TRACE
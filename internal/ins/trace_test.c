@@ -0,0 +1,164 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+#include <ins/ins_trace.h>
+
+typedef struct {
+  int begins;
+  int ends;
+  ins_trace_event last;
+} recorder;
+
+static void record_begin(const ins_trace_event *event, void *context) {
+  recorder *r = (recorder *) context;
+  assert_int_equal(event->end, 0);
+  ++r->begins;
+}
+
+static void record_end(const ins_trace_event *event, void *context) {
+  recorder *r = (recorder *) context;
+  assert_true(event->end >= event->begin);
+  ++r->ends;
+  r->last = *event;
+}
+
+static void test_handler(void **state) {
+  (void) state;
+
+  recorder r = {0, 0, {0}};
+  const ins_trace_handler handler = {record_begin, record_end, &r};
+
+  ins_error_handler_t *error_handler = ins_set_error_handler_off();
+  const ins_trace_handler *previous = ins_set_trace_handler(&handler);
+  ins_set_error_handler(error_handler);
+
+  if (ins_get_trace_handler() == NULL) {
+    // Without tracing compiled in nothing is ever reported.
+    assert_int_equal(ins_last_error()->error_code, INS_EUNSUP);
+    return;
+  }
+
+  assert_null(previous);
+
+  ins_vector *x = ins_vector_calloc(10);
+  ins_vector *y = ins_vector_alloc_from_vector(x, 0, 5, 2);
+  ins_vector *z = ins_vector_calloc(5);
+
+  r.begins = r.ends = 0;
+  ins_vector_add(z, y);
+
+  assert_int_equal(r.begins, 1);
+  assert_int_equal(r.ends, 1);
+  assert_string_equal(r.last.name, "ins_vector_add");
+  assert_int_equal(r.last.size, 5);
+  assert_int_equal(r.last.stride, 1);
+  assert_int_equal(r.last.bytes, 3 * 5 * sizeof(double));
+
+  ins_vector_set_all(y, 1.0);
+  assert_string_equal(r.last.name, "ins_vector_set_all");
+  assert_int_equal(r.last.stride, 2);
+
+  // Nothing is reported once tracing is off.
+  assert_ptr_equal(ins_set_trace_handler(NULL), &handler);
+  ins_vector_add(z, y);
+  assert_int_equal(r.ends, 2);
+
+  ins_vector_free(z);
+  ins_vector_free(y);
+  ins_vector_free(x);
+}
+
+static void *thread_main(void *arg) {
+  ins_vector_float *v = (ins_vector_float *) arg;
+  ins_vector_float_scale(v, 2.0F);
+  return NULL;
+}
+
+// Returns the number of occurrences of `pattern` in `text`.
+static int count(const char *text, const char *pattern) {
+  int n = 0;
+  for (text = strstr(text, pattern); text != NULL;
+       text = strstr(text + 1, pattern)) {
+    ++n;
+  }
+  return n;
+}
+
+static void test_chrome(void **state) {
+  (void) state;
+
+  char buffer[16384];
+  size_t length;
+  int i;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+  const int status = ins_trace_chrome_start(2, 4);
+  ins_set_error_handler(handler);
+
+  if (status == INS_EUNSUP) {
+    return;
+  }
+
+  assert_int_equal(status, INS_SUCCESS);
+  assert_non_null(ins_get_trace_handler());
+
+  ins_vector *x = ins_vector_calloc(8);
+  ins_vector_float *v = ins_vector_float_calloc(3);
+  pthread_t thread;
+
+  // The ring of this thread keeps the last four of six calls.
+  for (i = 0; i < 6; ++i) {
+    ins_vector_add(x, x);
+  }
+
+  pthread_create(&thread, NULL, thread_main, v);
+  pthread_join(thread, NULL);
+
+  ins_trace_chrome_stop();
+  assert_null(ins_get_trace_handler());
+  ins_vector_add(x, x);
+
+  FILE *stream = tmpfile();
+  assert_non_null(stream);
+  assert_int_equal(ins_trace_chrome_write(stream), INS_SUCCESS);
+  rewind(stream);
+  length = fread(buffer, 1, sizeof(buffer) - 1, stream);
+  buffer[length] = '\0';
+  fclose(stream);
+
+  assert_int_equal(strncmp(buffer, "{\"traceEvents\":[", 16), 0);
+  assert_int_equal(count(buffer, "\"ph\":\"X\""), 5);
+  assert_int_equal(count(buffer, "\"name\":\"ins_vector_add\""), 4);
+  assert_int_equal(count(buffer, "\"name\":\"ins_vector_float_scale\""), 1);
+  assert_int_equal(count(buffer, "\"args\":{\"size\":8,\"stride\":1,"), 4);
+  const char *end = "\n],\"displayTimeUnit\":\"ns\"}\n";
+  assert_string_equal(buffer + length - strlen(end), end);
+
+  ins_vector_float_free(v);
+  ins_vector_free(x);
+}
+
+static void test_chrome_invalid(void **state) {
+  (void) state;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+  const int status = ins_trace_chrome_start(0, 4);
+  ins_set_error_handler(handler);
+
+  assert_true(status == INS_EINVAL || status == INS_EUNSUP);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_handler),
+    cmocka_unit_test(test_chrome),
+    cmocka_unit_test(test_chrome_invalid)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,304 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ins/ins_errno.h"
+#include "ins/ins_tuning_io.h"
+
+// The longest line of a profile.
+#define INS_TUNING_MAX_LINE 256
+
+// The types of the values of a profile.
+enum {
+  INS_TUNING_SIZE,
+  INS_TUNING_INT,
+  INS_TUNING_DOUBLE
+};
+
+// A key of a profile and the field of `ins_tuning` it sets.
+typedef struct {
+  const char * key;
+  int type;
+  size_t offset;
+} ins_tuning_key;
+
+static const ins_tuning_key ins_tuning_keys[] = {
+  {"l1_cache", INS_TUNING_SIZE, offsetof(ins_tuning, l1_cache)},
+  {"l2_cache", INS_TUNING_SIZE, offsetof(ins_tuning, l2_cache)},
+  {"l3_cache", INS_TUNING_SIZE, offsetof(ins_tuning, l3_cache)},
+  {"memory_bandwidth", INS_TUNING_DOUBLE,
+   offsetof(ins_tuning, memory_bandwidth)},
+  {"threads", INS_TUNING_INT, offsetof(ins_tuning, threads)},
+  {"parallel_min_bytes", INS_TUNING_SIZE,
+   offsetof(ins_tuning, parallel_min_bytes)}
+};
+
+#define INS_TUNING_NUM_KEYS \
+  (sizeof(ins_tuning_keys) / sizeof(ins_tuning_keys[0]))
+
+// The names of the operations in the keys of the crossovers.
+static const char * const ins_tuning_ops[INS_TUNING_BLAS_OPS] = {
+  "scale", "axpy", "swap", "copy", "dot"
+};
+
+ins_tuning ins_tuning_current = {
+  0, 0, 0, 0.0, 0, 1 << 16, {0, 0, 0, 0, 0}, {0, 0, 0, 0, 0}
+};
+
+void ins_default_tuning(ins_tuning * tuning) {
+  int i;
+
+  tuning->l1_cache = 0;
+  tuning->l2_cache = 0;
+  tuning->l3_cache = 0;
+  tuning->memory_bandwidth = 0.0;
+  tuning->threads = 0;
+  tuning->parallel_min_bytes = 1 << 16;
+
+  // BLAS is called at every length, as before there were profiles.
+  for (i = 0; i < INS_TUNING_BLAS_OPS; ++i) {
+    tuning->blas_min_double[i] = 0;
+    tuning->blas_min_float[i] = 0;
+  }
+}
+
+void ins_get_tuning(ins_tuning * tuning) {
+  const ins_tuning * current = &ins_tuning_current;
+  int i;
+
+  tuning->l1_cache = ins_tuning_get(&current->l1_cache);
+  tuning->l2_cache = ins_tuning_get(&current->l2_cache);
+  tuning->l3_cache = ins_tuning_get(&current->l3_cache);
+  __atomic_load(&current->memory_bandwidth, &tuning->memory_bandwidth,
+                __ATOMIC_RELAXED);
+  tuning->threads = __atomic_load_n(&current->threads, __ATOMIC_RELAXED);
+  tuning->parallel_min_bytes = ins_tuning_get(&current->parallel_min_bytes);
+
+  for (i = 0; i < INS_TUNING_BLAS_OPS; ++i) {
+    tuning->blas_min_double[i] = ins_tuning_get(&current->blas_min_double[i]);
+    tuning->blas_min_float[i] = ins_tuning_get(&current->blas_min_float[i]);
+  }
+}
+
+void ins_set_tuning(const ins_tuning * tuning) {
+  ins_tuning * current = &ins_tuning_current;
+  int i;
+
+  __atomic_store_n(&current->l1_cache, tuning->l1_cache, __ATOMIC_RELAXED);
+  __atomic_store_n(&current->l2_cache, tuning->l2_cache, __ATOMIC_RELAXED);
+  __atomic_store_n(&current->l3_cache, tuning->l3_cache, __ATOMIC_RELAXED);
+  __atomic_store(&current->memory_bandwidth, &tuning->memory_bandwidth,
+                 __ATOMIC_RELAXED);
+  __atomic_store_n(&current->threads, tuning->threads, __ATOMIC_RELAXED);
+  __atomic_store_n(&current->parallel_min_bytes, tuning->parallel_min_bytes,
+                   __ATOMIC_RELAXED);
+
+  for (i = 0; i < INS_TUNING_BLAS_OPS; ++i) {
+    __atomic_store_n(&current->blas_min_double[i],
+                     tuning->blas_min_double[i], __ATOMIC_RELAXED);
+    __atomic_store_n(&current->blas_min_float[i], tuning->blas_min_float[i],
+                     __ATOMIC_RELAXED);
+  }
+}
+
+long ins_tuning_threads(void) {
+  long threads = __atomic_load_n(&ins_tuning_current.threads,
+                                 __ATOMIC_RELAXED);
+
+  if (threads <= 0) {
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+  }
+
+  return threads > 0 ? threads : 1;
+}
+
+// Returns the crossover of `tuning` named `key`, such as
+// "blas_min.double.axpy", or null if there is none.
+static size_t * ins_tuning_crossover(ins_tuning * tuning, const char * key) {
+  size_t * crossovers;
+  int i;
+
+  if (strncmp(key, "blas_min.double.", 16) == 0) {
+    crossovers = tuning->blas_min_double;
+    key += 16;
+  } else if (strncmp(key, "blas_min.float.", 15) == 0) {
+    crossovers = tuning->blas_min_float;
+    key += 15;
+  } else {
+    return 0;
+  }
+
+  for (i = 0; i < INS_TUNING_BLAS_OPS; ++i) {
+    if (strcmp(key, ins_tuning_ops[i]) == 0) {
+      return &crossovers[i];
+    }
+  }
+
+  return 0;
+}
+
+// Sets the field of `tuning` named `key` to `value`. Returns 0, or -1 if
+// the value is malformed. Unknown keys are skipped.
+static int ins_tuning_assign(ins_tuning * tuning, const char * key,
+                             const char * value) {
+  char * end;
+  size_t * crossover = ins_tuning_crossover(tuning, key);
+  int type = INS_TUNING_SIZE;
+  void * field = crossover;
+  size_t i;
+
+  for (i = 0; field == 0 && i < INS_TUNING_NUM_KEYS; ++i) {
+    if (strcmp(key, ins_tuning_keys[i].key) == 0) {
+      type = ins_tuning_keys[i].type;
+      field = (char *) tuning + ins_tuning_keys[i].offset;
+    }
+  }
+
+  if (field == 0) {
+    return 0;
+  }
+
+  if (type == INS_TUNING_DOUBLE) {
+    *(double *) field = strtod(value, &end);
+  } else if (type == INS_TUNING_INT) {
+    *(int *) field = (int) strtol(value, &end, 10);
+  } else if (*value == '-') {
+    return -1;
+  } else {
+    *(size_t *) field = (size_t) strtoull(value, &end, 10);
+  }
+
+  return end == value || *end != '\0' ? -1 : 0;
+}
+
+// Removes the blanks at both ends of `text` and returns its start.
+static char * ins_tuning_trim(char * text) {
+  char * end = text + strlen(text);
+
+  while (end > text && isspace((unsigned char) end[-1])) {
+    --end;
+  }
+  *end = '\0';
+
+  while (isspace((unsigned char) *text)) {
+    ++text;
+  }
+
+  return text;
+}
+
+// Reads the profile at `path` into `tuning`. Returns `INS_SUCCESS`,
+// `INS_EFAILED` or `INS_EINVAL`, without calling the error handler.
+static int ins_tuning_read(const char * path, ins_tuning * tuning) {
+  char line[INS_TUNING_MAX_LINE];
+  FILE * stream = fopen(path, "r");
+  int status = INS_SUCCESS;
+
+  if (stream == 0) {
+    return INS_EFAILED;
+  }
+
+  while (status == INS_SUCCESS && fgets(line, sizeof(line), stream) != 0) {
+    const size_t length = strlen(line);
+    const int truncated = length + 1 == sizeof(line) &&
+                          line[length - 1] != '\n';
+    char * text = ins_tuning_trim(line);
+    char * equals = strchr(text, '=');
+
+    if (*text == '\0' || *text == '#') {
+      continue;
+    }
+
+    if (equals == 0 || truncated) {
+      status = INS_EINVAL;
+      break;
+    }
+
+    *equals = '\0';
+    if (ins_tuning_assign(tuning, ins_tuning_trim(text),
+                          ins_tuning_trim(equals + 1)) != 0) {
+      status = INS_EINVAL;
+    }
+  }
+
+  if (status == INS_SUCCESS && ferror(stream)) {
+    status = INS_EFAILED;
+  }
+
+  fclose(stream);
+
+  return status;
+}
+
+int ins_load_tuning(const char * path) {
+  ins_tuning tuning;
+  int status;
+
+  ins_get_tuning(&tuning);
+  status = ins_tuning_read(path, &tuning);
+
+  if (status == INS_EFAILED) {
+    INS_ERROR("failed to read tuning profile", INS_EFAILED);
+  }
+
+  if (status != INS_SUCCESS) {
+    INS_ERROR("malformed tuning profile", INS_EINVAL);
+  }
+
+  ins_set_tuning(&tuning);
+
+  return INS_SUCCESS;
+}
+
+int ins_save_tuning(const ins_tuning * tuning, const char * path) {
+  FILE * stream = fopen(path, "w");
+  int failed;
+  int i;
+
+  if (stream == 0) {
+    INS_ERROR("failed to open tuning profile", INS_EFAILED);
+  }
+
+  fprintf(stream, "# Insight tuning profile\n");
+  fprintf(stream, "l1_cache = %zu\n", tuning->l1_cache);
+  fprintf(stream, "l2_cache = %zu\n", tuning->l2_cache);
+  fprintf(stream, "l3_cache = %zu\n", tuning->l3_cache);
+  fprintf(stream, "memory_bandwidth = %.6g\n", tuning->memory_bandwidth);
+  fprintf(stream, "threads = %d\n", tuning->threads);
+  fprintf(stream, "parallel_min_bytes = %zu\n", tuning->parallel_min_bytes);
+
+  for (i = 0; i < INS_TUNING_BLAS_OPS; ++i) {
+    fprintf(stream, "blas_min.double.%s = %zu\n", ins_tuning_ops[i],
+            tuning->blas_min_double[i]);
+  }
+
+  for (i = 0; i < INS_TUNING_BLAS_OPS; ++i) {
+    fprintf(stream, "blas_min.float.%s = %zu\n", ins_tuning_ops[i],
+            tuning->blas_min_float[i]);
+  }
+
+  failed = ferror(stream);
+  if (fclose(stream) != 0 || failed) {
+    INS_ERROR("failed to write tuning profile", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+// The profile named by the environment is loaded before `main`. A profile
+// that cannot be read leaves the defaults, since no error handler can be
+// set yet.
+__attribute__((constructor)) static void ins_tuning_init(void) {
+  const char * path = getenv("INSIGHT_TUNING");
+  ins_tuning tuning;
+
+  if (path == 0 || *path == '\0') {
+    return;
+  }
+
+  ins_get_tuning(&tuning);
+  if (ins_tuning_read(path, &tuning) == INS_SUCCESS) {
+    ins_set_tuning(&tuning);
+  }
+}
@@ -0,0 +1,174 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+#include <ins/ins_tuning.h>
+
+// The profile is written to a directory of its own, so that parallel runs
+// and read-only source trees do not get in the way.
+static char profile_dir[4096];
+static char profile_path[sizeof(profile_dir) + sizeof("/tuning.profile")];
+
+static int make_profile_dir(void) {
+  const char *tmp = getenv("TMPDIR");
+
+  snprintf(profile_dir, sizeof(profile_dir), "%s/insight_tuning_XXXXXX",
+           tmp != NULL && *tmp != '\0' ? tmp : "/tmp");
+  if (mkdtemp(profile_dir) == NULL) {
+    return -1;
+  }
+
+  snprintf(profile_path, sizeof(profile_path), "%s/tuning.profile",
+           profile_dir);
+  return 0;
+}
+
+static int remove_profile_dir(void) {
+  remove(profile_path);
+  return rmdir(profile_dir);
+}
+
+static void test_save_load(void **state) {
+  (void) state;
+
+  ins_tuning saved, tuning, loaded;
+  ins_get_tuning(&saved);
+
+  ins_default_tuning(&tuning);
+  tuning.l2_cache = 1 << 20;
+  tuning.memory_bandwidth = 2.5e10;
+  tuning.threads = 3;
+  tuning.parallel_min_bytes = 4096;
+  tuning.blas_min_double[INS_TUNING_AXPY] = 64;
+  tuning.blas_min_float[INS_TUNING_DOT] = 128;
+
+  assert_int_equal(ins_save_tuning(&tuning, profile_path), INS_SUCCESS);
+  assert_int_equal(ins_load_tuning(profile_path), INS_SUCCESS);
+
+  ins_get_tuning(&loaded);
+  assert_int_equal(loaded.l2_cache, 1 << 20);
+  assert_true(loaded.memory_bandwidth == 2.5e10);
+  assert_int_equal(loaded.threads, 3);
+  assert_int_equal(loaded.parallel_min_bytes, 4096);
+  assert_int_equal(loaded.blas_min_double[INS_TUNING_AXPY], 64);
+  assert_int_equal(loaded.blas_min_double[INS_TUNING_DOT], 0);
+  assert_int_equal(loaded.blas_min_float[INS_TUNING_DOT], 128);
+
+  ins_set_tuning(&saved);
+  remove(profile_path);
+}
+
+static void test_partial_and_malformed(void **state) {
+  (void) state;
+
+  ins_tuning saved, tuning;
+  FILE *stream;
+
+  ins_get_tuning(&saved);
+
+  // Missing keys are kept and unknown keys are skipped.
+  stream = fopen(profile_path, "w");
+  assert_non_null(stream);
+  fprintf(stream, "# comment\n\n  threads = 2  \nfuture_key = 1\n");
+  fclose(stream);
+
+  assert_int_equal(ins_load_tuning(profile_path), INS_SUCCESS);
+  ins_get_tuning(&tuning);
+  assert_int_equal(tuning.threads, 2);
+  assert_int_equal(tuning.parallel_min_bytes, saved.parallel_min_bytes);
+
+  // A malformed line leaves the tuning unchanged.
+  stream = fopen(profile_path, "w");
+  assert_non_null(stream);
+  fprintf(stream, "threads = 5\nblas_min.double.dot = -1\n");
+  fclose(stream);
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+  assert_int_equal(ins_load_tuning(profile_path), INS_EINVAL);
+  remove(profile_path);
+  assert_int_equal(ins_load_tuning(profile_path), INS_EFAILED);
+  ins_set_error_handler(handler);
+
+  ins_get_tuning(&tuning);
+  assert_int_equal(tuning.threads, 2);
+
+  ins_set_tuning(&saved);
+}
+
+// Runs the operations that may call BLAS on vectors of 5 elements.
+static void check_operations(void) {
+  ins_vector *x = ins_vector_alloc(5);
+  ins_vector *y = ins_vector_calloc(5);
+  ins_vector_float *v = ins_vector_float_alloc(5);
+  ins_vector_float *w = ins_vector_float_alloc(5);
+  size_t i;
+
+  for (i = 0; i < 5; ++i) {
+    ins_vector_set(x, i, (double) i);
+    ins_vector_float_set(v, i, (float) i);
+  }
+
+  ins_vector_scale(x, 2.0);
+  ins_vector_axpy(0.5, x, y);
+  ins_vector_copy(y, x);
+  assert_true(ins_vector_dot(x, y) == 120.0);
+  ins_vector_swap(x, y);
+
+  ins_vector_float_copy(w, v);
+  ins_vector_float_scale(w, 2.0F);
+  ins_vector_float_axpy(-1.0F, v, w);
+  ins_vector_float_swap(v, w);
+  assert_true(ins_vector_float_dot(v, w) == 30.0F);
+
+  ins_vector_float_free(w);
+  ins_vector_float_free(v);
+  ins_vector_free(y);
+  ins_vector_free(x);
+}
+
+static void test_dispatch(void **state) {
+  (void) state;
+
+  ins_tuning saved, tuning;
+  int i;
+
+  ins_get_tuning(&saved);
+
+  // The plain loops and the BLAS calls give the same results.
+  ins_default_tuning(&tuning);
+  for (i = 0; i < INS_TUNING_BLAS_OPS; ++i) {
+    tuning.blas_min_double[i] = (size_t) -1;
+    tuning.blas_min_float[i] = (size_t) -1;
+  }
+  ins_set_tuning(&tuning);
+  check_operations();
+
+  ins_default_tuning(&tuning);
+  ins_set_tuning(&tuning);
+  check_operations();
+
+  ins_set_tuning(&saved);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_save_load),
+    cmocka_unit_test(test_partial_and_malformed),
+    cmocka_unit_test(test_dispatch)
+  };
+
+  int failed;
+
+  if (make_profile_dir() != 0) {
+    return 1;
+  }
+
+  failed = cmocka_run_group_tests(tests, NULL, NULL);
+  remove_profile_dir();
+
+  return failed;
+}
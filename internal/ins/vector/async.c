@@ -0,0 +1,54 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ins/ins_vector.h"
+#include "ins/ins_async_io.h"
+#include "ins/ins_stats_io.h"
+
+#define INS_BASE_DOUBLE
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/async_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/async_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/async_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
+
+#define INS_BASE_F16
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/async_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_F16
+
+#define INS_BASE_BF16
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/async_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_BF16
+
+#define INS_BASE_COMPLEX
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/async_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX
+
+#define INS_BASE_COMPLEX_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/async_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX_FLOAT
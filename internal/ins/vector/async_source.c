@@ -0,0 +1,62 @@
+// Template for asynchronous reads and writes of ins_vector_[atomic] types.
+// Contiguous vectors are transferred in place; strided vectors go through a
+// staging buffer holding all of their elements, which is gathered before a
+// write starts and scattered once a read has been waited for.
+
+// `ins_async_finish` callback storing the staged elements of a strided read
+// into the vector.
+static void INS_VECTOR_FUNC(scatter_async)(void * ctx, void * buffer) {
+  INS_VECTOR_TYPE * v = (INS_VECTOR_TYPE *) ctx;
+
+  INS_VECTOR_FUNC(scatter)(v, 0, v->size, (const INS_BASE *) buffer);
+}
+
+ins_async * INS_VECTOR_FUNC(read_async)(INS_VECTOR_TYPE * v, const int fd,
+                                        const size_t offset) {
+  INS_STATS(INS_VECTOR_FUNC(read_async), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const size_t nbytes = v->size * sizeof(INS_BASE);
+
+  INS_BASE * buf;
+
+  if (v->stride == 1 || v->size == 0) {
+    return ins_async_submit(fd, offset, v->data, nbytes, 0, 0, 0, 0);
+  }
+
+  buf = (INS_BASE *) malloc(nbytes);
+
+  if (buf == 0) {
+    INS_ERROR_VAL("failed to allocate space for staging buffer",
+                  INS_ENOMEM, 0);
+  }
+
+  return ins_async_submit(fd, offset, buf, nbytes, 0, 1,
+                          INS_VECTOR_FUNC(scatter_async), v);
+}
+
+ins_async * INS_VECTOR_FUNC(write_async)(const INS_VECTOR_TYPE * v,
+                                         const int fd, const size_t offset) {
+  INS_STATS(INS_VECTOR_FUNC(write_async), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const size_t nbytes = v->size * sizeof(INS_BASE);
+
+  INS_BASE * buf;
+
+  if (v->stride == 1 || v->size == 0) {
+    return ins_async_submit(fd, offset, (void *) v->data, nbytes, 1, 0, 0,
+                            0);
+  }
+
+  buf = (INS_BASE *) malloc(nbytes);
+
+  if (buf == 0) {
+    INS_ERROR_VAL("failed to allocate space for staging buffer",
+                  INS_ENOMEM, 0);
+  }
+
+  INS_VECTOR_FUNC(gather)(v, 0, v->size, buf);
+
+  return ins_async_submit(fd, offset, buf, nbytes, 1, 1, 0, 0);
+}
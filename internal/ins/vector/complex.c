@@ -0,0 +1,21 @@
+#include "ins/ins_vector.h"
+#include "ins/ins_blas.h"
+#include "ins/ins_stats_io.h"
+
+// Some CBLAS headers include <complex.h>, whose `complex` macro would break
+// the `INS_SHORT complex` token pasting of the templates below.
+#ifdef complex
+#undef complex
+#endif
+
+#define INS_BASE_COMPLEX
+#include "ins/templates_on.h"
+#include "ins/vector/complex_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX
+
+#define INS_BASE_COMPLEX_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/complex_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_COMPLEX_FLOAT
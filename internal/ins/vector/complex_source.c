@@ -0,0 +1,250 @@
+// Template for the complex vector types. Elements are interleaved (real,
+// imaginary) pairs of `INS_ATOMIC`s and strides count whole complex
+// numbers, so the element `i` starts at `data[2 * i * stride]`.
+
+// Returns the address that BLAS routines expect for the elements of the
+// vector `v`. For a negative increment BLAS starts from the element with the
+// lowest address, which is the last element of a vector with a negative
+// stride, and walks the memory backwards from there.
+static INS_ATOMIC *
+INS_VECTOR_FUNC(blas_data)(const INS_VECTOR_TYPE * v) {
+  if (v->stride < 0 && v->size > 0) {
+    return v->data + 2 * (ptrdiff_t) (v->size - 1) * v->stride;
+  }
+
+  return v->data;
+}
+
+INS_BASE
+INS_VECTOR_FUNC(get)(const INS_VECTOR_TYPE * v, const size_t i) {
+  return *(const INS_BASE *) (v->data + 2 * (ptrdiff_t) i * v->stride);
+}
+
+void INS_VECTOR_FUNC(set)(INS_VECTOR_TYPE * v, const size_t i, INS_BASE z) {
+  *(INS_BASE *) (v->data + 2 * (ptrdiff_t) i * v->stride) = z;
+}
+
+int INS_VECTOR_FUNC(add)(INS_VECTOR_TYPE * x, const INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(add), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
+  const size_t size = x->size;
+
+  if (y->size != size) {
+    INS_ERROR("vectors must have same length", INS_EBADLEN);
+  }
+
+  const ptrdiff_t x_stride = 2 * x->stride;
+  const ptrdiff_t y_stride = 2 * y->stride;
+
+  size_t i;
+
+  for (i = 0; i < size; ++i) {
+    INS_ATOMIC * const xi = x->data + (ptrdiff_t) i * x_stride;
+    const INS_ATOMIC * yi = y->data + (ptrdiff_t) i * y_stride;
+    xi[0] += yi[0];
+    xi[1] += yi[1];
+  }
+
+  return INS_SUCCESS;
+}
+
+int INS_VECTOR_FUNC(sub)(INS_VECTOR_TYPE * x, const INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(sub), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
+  const size_t size = x->size;
+
+  if (y->size != size) {
+    INS_ERROR("vectors must have same length", INS_EBADLEN);
+  }
+
+  const ptrdiff_t x_stride = 2 * x->stride;
+  const ptrdiff_t y_stride = 2 * y->stride;
+
+  size_t i;
+
+  for (i = 0; i < size; ++i) {
+    INS_ATOMIC * const xi = x->data + (ptrdiff_t) i * x_stride;
+    const INS_ATOMIC * yi = y->data + (ptrdiff_t) i * y_stride;
+    xi[0] -= yi[0];
+    xi[1] -= yi[1];
+  }
+
+  return INS_SUCCESS;
+}
+
+int INS_VECTOR_FUNC(mul)(INS_VECTOR_TYPE * x, const INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(mul), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
+  const size_t size = x->size;
+
+  if (y->size != size) {
+    INS_ERROR("vectors must have same length", INS_EBADLEN);
+  }
+
+  const ptrdiff_t x_stride = 2 * x->stride;
+  const ptrdiff_t y_stride = 2 * y->stride;
+
+  size_t i;
+
+  // `(a + bi) * (c + di) = (ac - bd) + (ad + bc)i`, computed in a single
+  // pass over both vectors.
+  for (i = 0; i < size; ++i) {
+    INS_ATOMIC * const xi = x->data + (ptrdiff_t) i * x_stride;
+    const INS_ATOMIC * yi = y->data + (ptrdiff_t) i * y_stride;
+    const INS_ATOMIC a = xi[0];
+    const INS_ATOMIC b = xi[1];
+    xi[0] = a * yi[0] - b * yi[1];
+    xi[1] = a * yi[1] + b * yi[0];
+  }
+
+  return INS_SUCCESS;
+}
+
+int INS_VECTOR_FUNC(scale)(INS_VECTOR_TYPE * x, INS_BASE alpha) {
+  INS_STATS(INS_VECTOR_FUNC(scale), x->size, x->stride,
+            2 * x->size * sizeof(INS_BASE));
+
+  const ptrdiff_t stride = x->stride;
+
+  // The order of the elements does not matter for scaling, so a reversed
+  // vector is handed to BLAS as a forward one.
+#if defined(INS_BASE_COMPLEX)
+  cblas_zscal(x->size, alpha.dat, INS_VECTOR_FUNC(blas_data)(x),
+              stride < 0 ? -stride : stride);
+#else
+  cblas_cscal(x->size, alpha.dat, INS_VECTOR_FUNC(blas_data)(x),
+              stride < 0 ? -stride : stride);
+#endif
+
+  return INS_SUCCESS;
+}
+
+int
+INS_VECTOR_FUNC(axpy)(INS_BASE alpha,
+                      const INS_VECTOR_TYPE * x,
+                      INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(axpy), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
+  const size_t size = x->size;
+
+  if (y->size != size) {
+    INS_ERROR("vectors must have same length", INS_EBADLEN);
+  }
+
+#if defined(INS_BASE_COMPLEX)
+  cblas_zaxpy(size, alpha.dat, INS_VECTOR_FUNC(blas_data)(x), x->stride,
+              INS_VECTOR_FUNC(blas_data)(y), y->stride);
+#else
+  cblas_caxpy(size, alpha.dat, INS_VECTOR_FUNC(blas_data)(x), x->stride,
+              INS_VECTOR_FUNC(blas_data)(y), y->stride);
+#endif
+
+  return INS_SUCCESS;
+}
+
+int INS_VECTOR_FUNC(swap)(INS_VECTOR_TYPE * v, INS_VECTOR_TYPE * w) {
+  INS_STATS(INS_VECTOR_FUNC(swap), v->size, v->stride,
+            4 * v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+
+  if (w->size != size) {
+    INS_ERROR("vectors must have same length", INS_EINVAL);
+  }
+
+#if defined(INS_BASE_COMPLEX)
+  cblas_zswap(size, INS_VECTOR_FUNC(blas_data)(v), v->stride,
+              INS_VECTOR_FUNC(blas_data)(w), w->stride);
+#else
+  cblas_cswap(size, INS_VECTOR_FUNC(blas_data)(v), v->stride,
+              INS_VECTOR_FUNC(blas_data)(w), w->stride);
+#endif
+
+  return INS_SUCCESS;
+}
+
+int
+INS_VECTOR_FUNC(copy)(INS_VECTOR_TYPE * dst, const INS_VECTOR_TYPE * src) {
+  INS_STATS(INS_VECTOR_FUNC(copy), src->size, src->stride,
+            2 * src->size * sizeof(INS_BASE));
+
+  const size_t size = src->size;
+
+  if (dst->size != size) {
+    INS_ERROR("vectors must have same length", INS_EINVAL);
+  }
+
+#if defined(INS_BASE_COMPLEX)
+  cblas_zcopy(size, INS_VECTOR_FUNC(blas_data)(src), src->stride,
+              INS_VECTOR_FUNC(blas_data)(dst), dst->stride);
+#else
+  cblas_ccopy(size, INS_VECTOR_FUNC(blas_data)(src), src->stride,
+              INS_VECTOR_FUNC(blas_data)(dst), dst->stride);
+#endif
+
+  return INS_SUCCESS;
+}
+
+INS_BASE
+INS_VECTOR_FUNC(dotu)(const INS_VECTOR_TYPE * v, const INS_VECTOR_TYPE * w) {
+  INS_STATS(INS_VECTOR_FUNC(dotu), v->size, v->stride,
+            2 * v->size * sizeof(INS_BASE));
+
+  INS_BASE ret = INS_ZERO;
+
+  if (w->size != v->size) {
+    INS_ERROR_VAL("vectors must have same length", INS_EINVAL, ret);
+  }
+
+#if defined(INS_BASE_COMPLEX)
+  cblas_zdotu_sub(v->size, INS_VECTOR_FUNC(blas_data)(v), v->stride,
+                  INS_VECTOR_FUNC(blas_data)(w), w->stride, ret.dat);
+#else
+  cblas_cdotu_sub(v->size, INS_VECTOR_FUNC(blas_data)(v), v->stride,
+                  INS_VECTOR_FUNC(blas_data)(w), w->stride, ret.dat);
+#endif
+
+  return ret;
+}
+
+INS_BASE
+INS_VECTOR_FUNC(dotc)(const INS_VECTOR_TYPE * v, const INS_VECTOR_TYPE * w) {
+  INS_STATS(INS_VECTOR_FUNC(dotc), v->size, v->stride,
+            2 * v->size * sizeof(INS_BASE));
+
+  INS_BASE ret = INS_ZERO;
+
+  if (w->size != v->size) {
+    INS_ERROR_VAL("vectors must have same length", INS_EINVAL, ret);
+  }
+
+#if defined(INS_BASE_COMPLEX)
+  cblas_zdotc_sub(v->size, INS_VECTOR_FUNC(blas_data)(v), v->stride,
+                  INS_VECTOR_FUNC(blas_data)(w), w->stride, ret.dat);
+#else
+  cblas_cdotc_sub(v->size, INS_VECTOR_FUNC(blas_data)(v), v->stride,
+                  INS_VECTOR_FUNC(blas_data)(w), w->stride, ret.dat);
+#endif
+
+  return ret;
+}
+
+INS_ATOMIC
+INS_VECTOR_FUNC(nrm2)(const INS_VECTOR_TYPE * v) {
+  INS_STATS(INS_VECTOR_FUNC(nrm2), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const ptrdiff_t stride = v->stride;
+
+#if defined(INS_BASE_COMPLEX)
+  return cblas_dznrm2(v->size, INS_VECTOR_FUNC(blas_data)(v),
+                      stride < 0 ? -stride : stride);
+#else
+  return cblas_scnrm2(v->size, INS_VECTOR_FUNC(blas_data)(v),
+                      stride < 0 ? -stride : stride);
+#endif
+}
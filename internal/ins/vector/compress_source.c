@@ -0,0 +1,128 @@
+// Template for reading and writing ins_vector_[atomic] types as compressed
+// files. Strided vectors are gathered chunk by chunk when written, and read
+// through a contiguous staging buffer.
+
+int INS_VECTOR_FUNC(fwrite_compressed)(const INS_VECTOR_TYPE * v,
+                                       FILE * stream,
+                                       const ins_compress_params * params) {
+  INS_STATS(INS_VECTOR_FUNC(fwrite_compressed), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+
+  ins_compress_writer writer;
+  INS_BASE * buf = 0;
+  size_t chunk;
+  size_t i;
+  int status;
+
+  status = ins_compress_writer_init(&writer, stream, INS_TYPE_ID,
+                                    (uint32_t) sizeof(INS_BASE),
+                                    (uint32_t) sizeof(INS_ATOMIC), size,
+                                    params);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  chunk = (size_t) writer.chunk_size;
+
+  if (v->stride != 1) {
+    buf = (INS_BASE *) malloc(chunk * sizeof(INS_BASE));
+
+    if (buf == 0) {
+      ins_compress_writer_finish(&writer, INS_ENOMEM);
+      INS_ERROR("failed to allocate space for staging buffer", INS_ENOMEM);
+    }
+  }
+
+  for (i = 0; status == INS_SUCCESS && i < size; i += chunk) {
+    const size_t count = size - i < chunk ? size - i : chunk;
+
+    if (buf == 0) {
+      status = ins_compress_writer_put(&writer, (const INS_BASE *) v->data + i,
+                                       count);
+    } else {
+      INS_VECTOR_FUNC(gather)(v, i, count, buf);
+      status = ins_compress_writer_put(&writer, buf, count);
+    }
+  }
+
+  free(buf);
+  return ins_compress_writer_finish(&writer, status);
+}
+
+// Reads the elements `[offset, offset + v->size)` of the compressed file
+// whose header has been opened with `reader` into `v`.
+static int INS_VECTOR_FUNC(read_compressed)(INS_VECTOR_TYPE * v,
+                                            ins_compress_reader * reader,
+                                            const size_t offset) {
+  INS_BASE * buf;
+  int status;
+
+  if (v->stride == 1 || v->size == 0) {
+    return ins_compress_reader_read(reader, offset, v->size, v->data);
+  }
+
+  buf = (INS_BASE *) malloc(v->size * sizeof(INS_BASE));
+
+  if (buf == 0) {
+    ins_compress_reader_close(reader);
+    INS_ERROR("failed to allocate space for staging buffer", INS_ENOMEM);
+  }
+
+  status = ins_compress_reader_read(reader, offset, v->size, buf);
+
+  if (status == INS_SUCCESS) {
+    INS_VECTOR_FUNC(scatter)(v, 0, v->size, buf);
+  }
+
+  free(buf);
+  return status;
+}
+
+int INS_VECTOR_FUNC(fread_compressed)(INS_VECTOR_TYPE * v, FILE * stream) {
+  INS_STATS(INS_VECTOR_FUNC(fread_compressed), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  ins_compress_reader reader;
+  int status;
+
+  status = ins_compress_reader_open(&reader, stream, INS_TYPE_ID,
+                                    (uint32_t) sizeof(INS_BASE),
+                                    (uint32_t) sizeof(INS_ATOMIC));
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  if (reader.count != v->size) {
+    ins_compress_reader_close(&reader);
+    INS_ERROR("vector length does not match the compressed file",
+              INS_EBADLEN);
+  }
+
+  return INS_VECTOR_FUNC(read_compressed)(v, &reader, 0);
+}
+
+int INS_VECTOR_FUNC(fread_compressed_range)(INS_VECTOR_TYPE * v,
+                                            FILE * stream,
+                                            const size_t offset) {
+  INS_STATS(INS_VECTOR_FUNC(fread_compressed_range), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  ins_compress_reader reader;
+  int status;
+
+  status = ins_compress_reader_open(&reader, stream, INS_TYPE_ID,
+                                    (uint32_t) sizeof(INS_BASE),
+                                    (uint32_t) sizeof(INS_ATOMIC));
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  if (offset > reader.count || reader.count - offset < v->size) {
+    ins_compress_reader_close(&reader);
+    INS_ERROR("range exceeds the compressed file", INS_EBADLEN);
+  }
+
+  return INS_VECTOR_FUNC(read_compressed)(v, &reader, offset);
+}
@@ -0,0 +1,156 @@
+// Template for reading and writing ins_vector_[atomic] types as `.ins`
+// containers. Strided vectors are staged through a contiguous buffer of
+// `INS_CONTAINER_CHUNK` bytes, so the payload is always contiguous.
+
+int INS_VECTOR_FUNC(fwrite_ins)(const INS_VECTOR_TYPE * v, FILE * stream) {
+  INS_STATS(INS_VECTOR_FUNC(fwrite_ins), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+  const size_t elem_size = sizeof(INS_BASE);
+  const size_t chunk = INS_CONTAINER_CHUNK / sizeof(INS_BASE);
+
+  ins_checksum_state state;
+  INS_BASE * buf;
+  size_t i;
+  int status;
+
+  if (v->stride == 1) {
+    status = ins_container_write_header(
+      stream, INS_TYPE_ID, (uint32_t) elem_size, size,
+      ins_container_checksum(v->data, size * elem_size));
+    if (status != INS_SUCCESS) {
+      return status;
+    }
+
+    if (fwrite(v->data, elem_size, size, stream) != size) {
+      INS_ERROR("fwrite failed", INS_EFAILED);
+    }
+
+    return INS_SUCCESS;
+  }
+
+  buf = (INS_BASE *) malloc(INS_CONTAINER_CHUNK);
+
+  if (buf == 0) {
+    INS_ERROR("failed to allocate space for staging buffer", INS_ENOMEM);
+  }
+
+  // The header carries the checksum, so the elements are gathered twice:
+  // once to checksum them and once to write them.
+  ins_checksum_init(&state);
+
+  for (i = 0; i < size; i += chunk) {
+    const size_t count = size - i < chunk ? size - i : chunk;
+    INS_VECTOR_FUNC(gather)(v, i, count, buf);
+    ins_checksum_update(&state, buf, count * elem_size);
+  }
+
+  status = ins_container_write_header(stream, INS_TYPE_ID,
+                                      (uint32_t) elem_size, size,
+                                      ins_checksum_final(&state));
+
+  for (i = 0; status == INS_SUCCESS && i < size; i += chunk) {
+    const size_t count = size - i < chunk ? size - i : chunk;
+    INS_VECTOR_FUNC(gather)(v, i, count, buf);
+    if (fwrite(buf, elem_size, count, stream) != count) {
+      free(buf);
+      INS_ERROR("fwrite failed", INS_EFAILED);
+    }
+  }
+
+  free(buf);
+  return status;
+}
+
+int INS_VECTOR_FUNC(fread_ins)(INS_VECTOR_TYPE * v, FILE * stream,
+                               const int flags) {
+  INS_STATS(INS_VECTOR_FUNC(fread_ins), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+  const size_t elem_size = sizeof(INS_BASE);
+  const size_t chunk = INS_CONTAINER_CHUNK / sizeof(INS_BASE);
+
+  ins_container_header header;
+  ins_checksum_state state;
+  INS_BASE * buf;
+  int swap;
+  size_t i;
+  int status;
+
+  status = ins_container_read_header(stream, &header);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  status = ins_container_check_type(&header, INS_TYPE_ID,
+                                    (uint32_t) elem_size);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  if (header.count != size) {
+    INS_ERROR("container length does not match vector size", INS_EBADLEN);
+  }
+
+  status = ins_container_skip_padding(stream, &header);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  swap = header.big_endian != ins_host_big_endian();
+
+  if (v->stride == 1) {
+    if (fread(v->data, elem_size, size, stream) != size) {
+      INS_ERROR("fread failed", INS_EFAILED);
+    }
+
+    // The checksum covers the payload as stored, i.e. before any byte swap.
+    if ((flags & INS_CONTAINER_VERIFY) &&
+        ins_container_checksum(v->data, size * elem_size)
+        != header.checksum) {
+      INS_ERROR("container checksum mismatch", INS_EFAILED);
+    }
+
+    if (swap) {
+      ins_byteswap(v->data, INS_MULTIPLICITY * size, sizeof(INS_ATOMIC));
+    }
+
+    return INS_SUCCESS;
+  }
+
+  buf = (INS_BASE *) malloc(INS_CONTAINER_CHUNK);
+
+  if (buf == 0) {
+    INS_ERROR("failed to allocate space for staging buffer", INS_ENOMEM);
+  }
+
+  ins_checksum_init(&state);
+
+  for (i = 0; i < size; i += chunk) {
+    const size_t count = size - i < chunk ? size - i : chunk;
+
+    if (fread(buf, elem_size, count, stream) != count) {
+      free(buf);
+      INS_ERROR("fread failed", INS_EFAILED);
+    }
+
+    ins_checksum_update(&state, buf, count * elem_size);
+
+    if (swap) {
+      ins_byteswap(buf, INS_MULTIPLICITY * count, sizeof(INS_ATOMIC));
+    }
+
+    INS_VECTOR_FUNC(scatter)(v, i, count, buf);
+  }
+
+  free(buf);
+
+  if ((flags & INS_CONTAINER_VERIFY) &&
+      ins_checksum_final(&state) != header.checksum) {
+    INS_ERROR("container checksum mismatch", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
@@ -0,0 +1,89 @@
+// Template for loading columns of delimited text files into
+// ins_vector_[atomic]. The file is parsed by `ins/ins_csv_io.h`.
+
+int INS_VECTOR_FUNC(read_csv)(const char * path,
+                              const ins_csv_options * options,
+                              INS_VECTOR_TYPE ** vectors, const size_t n) {
+  INS_STATS(INS_VECTOR_FUNC(read_csv), n, 1, 0);
+
+  ins_csv_file file;
+  ins_csv_target * targets;
+  size_t * columns;
+  unsigned char * allocated;
+  size_t rows;
+  size_t i;
+  int status;
+
+  status = ins_csv_open(&file, path, options);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  rows = ins_csv_rows(&file);
+
+  for (i = 0; i < n; ++i) {
+    if (vectors[i] != 0 && vectors[i]->size != rows) {
+      ins_csv_close(&file);
+      INS_ERROR("vector length does not match the number of rows",
+                INS_EBADLEN);
+    }
+  }
+
+  // One allocation holds the targets, the default columns and the flags of
+  // the vectors allocated here.
+  targets = (ins_csv_target *) malloc(
+      n * (sizeof(ins_csv_target) + sizeof(size_t) + 1) + 1);
+
+  if (targets == 0) {
+    ins_csv_close(&file);
+    INS_ERROR("failed to allocate space for column targets", INS_ENOMEM);
+  }
+
+  columns = (size_t *) (targets + n);
+  allocated = (unsigned char *) (columns + n);
+
+  for (i = 0; i < n; ++i) {
+    columns[i] = i;
+    allocated[i] = 0;
+  }
+
+  if (options != 0 && options->columns != 0) {
+    memcpy(columns, options->columns, n * sizeof(size_t));
+  }
+
+  // Missing vectors are allocated with one element per row.
+  for (i = 0; i < n; ++i) {
+    if (vectors[i] == 0) {
+      vectors[i] = INS_VECTOR_FUNC(alloc)(rows);
+      allocated[i] = 1;
+
+      if (vectors[i] == 0) {
+        status = INS_ENOMEM;
+        break;
+      }
+    }
+
+    targets[i].data = vectors[i]->data;
+    targets[i].stride = (ptrdiff_t) vectors[i]->stride;
+  }
+
+  if (status == INS_SUCCESS) {
+    status = ins_csv_parse(&file, INS_TYPE_ID, columns, targets, n);
+  }
+
+  // On failure the vectors allocated here are freed again, and the caller's
+  // vectors are left partially filled.
+  if (status != INS_SUCCESS) {
+    for (i = 0; i < n; ++i) {
+      if (allocated[i]) {
+        INS_VECTOR_FUNC(free)(vectors[i]);
+        vectors[i] = 0;
+      }
+    }
+  }
+
+  free(targets);
+  ins_csv_close(&file);
+
+  return status;
+}
@@ -0,0 +1,91 @@
+// Template for direct reads and writes of ins_vector_[atomic] types.
+// Contiguous vectors are transferred in place; strided vectors go through an
+// aligned staging buffer one chunk at a time.
+
+// Reads the vector `v` from `file`, or writes it if `write` is non-zero.
+static int INS_VECTOR_FUNC(transfer_direct)(INS_VECTOR_TYPE * v,
+                                            ins_direct_file * file,
+                                            const uint64_t offset,
+                                            const int write) {
+  const size_t chunk = INS_DIRECT_CHUNK / sizeof(INS_BASE);
+
+  INS_BASE * buf;
+  size_t done;
+  int status = INS_SUCCESS;
+
+  if (v->stride == 1 || v->size == 0) {
+    return ins_direct_transfer(file, offset, v->data,
+                               v->size * sizeof(INS_BASE), write);
+  }
+
+  buf = (INS_BASE *) ins_direct_alloc(
+      (v->size < chunk ? v->size : chunk) * sizeof(INS_BASE));
+
+  if (buf == 0) {
+    INS_ERROR("failed to allocate space for staging buffer", INS_ENOMEM);
+  }
+
+  for (done = 0; done < v->size && status == INS_SUCCESS; done += chunk) {
+    const size_t count = v->size - done < chunk ? v->size - done : chunk;
+    const uint64_t position = offset + (uint64_t) done * sizeof(INS_BASE);
+
+    if (write) {
+      INS_VECTOR_FUNC(gather)(v, done, count, buf);
+    }
+
+    status = ins_direct_transfer(file, position, buf,
+                                 count * sizeof(INS_BASE), write);
+
+    if (!write && status == INS_SUCCESS) {
+      INS_VECTOR_FUNC(scatter)(v, done, count, buf);
+    }
+  }
+
+  free(buf);
+  return status;
+}
+
+int INS_VECTOR_FUNC(read_direct)(INS_VECTOR_TYPE * v, const char * path,
+                                 const size_t offset) {
+  INS_STATS(INS_VECTOR_FUNC(read_direct), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  ins_direct_file file;
+  int status;
+
+  status = ins_direct_open(&file, path, 0);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  status = INS_VECTOR_FUNC(transfer_direct)(v, &file, offset, 0);
+
+  if (ins_direct_close(&file) != INS_SUCCESS) {
+    status = INS_EFAILED;
+  }
+
+  return status;
+}
+
+int INS_VECTOR_FUNC(write_direct)(const INS_VECTOR_TYPE * v,
+                                  const char * path, const size_t offset) {
+  INS_STATS(INS_VECTOR_FUNC(write_direct), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  ins_direct_file file;
+  int status;
+
+  status = ins_direct_open(&file, path, 1);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  status = INS_VECTOR_FUNC(transfer_direct)((INS_VECTOR_TYPE *) v, &file,
+                                            offset, 1);
+
+  if (ins_direct_close(&file) != INS_SUCCESS) {
+    status = INS_EFAILED;
+  }
+
+  return status;
+}
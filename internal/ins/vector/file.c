@@ -1,7 +1,27 @@
+#include <stdlib.h>
+#include <string.h>
 #include "ins/ins_vector.h"
+#include "ins/ins_staging.h"
+#include "ins/ins_text.h"
+#include "ins/ins_stats_io.h"
 
 #define INS_BASE_DOUBLE
 #include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
 #include "ins/vector/file_source.c"
 #include "ins/templates_off.h"
 #undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/file_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/vector/stage_source.c"
+#include "ins/vector/file_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
@@ -1,6 +1,9 @@
 int INS_VECTOR_FUNC(fread)(INS_VECTOR_TYPE *v, FILE *stream) {
+  INS_STATS(INS_VECTOR_FUNC(fread), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
 
   const size_t elem_size = sizeof(INS_BASE);
   size_t num_elems;
@@ -11,24 +14,47 @@ int INS_VECTOR_FUNC(fread)(INS_VECTOR_TYPE *v, FILE *stream) {
       INS_ERROR("fread failed", INS_EFAILED);
     }
   } else {
+    // Strided vectors are read a chunk at a time into a contiguous staging
+    // buffer and scattered from there.
+    const size_t chunk = INS_STAGING_CHUNK / elem_size;
+
+    INS_BASE *buf;
     size_t i;
 
-    // TODO(linh): Call `fread` inside a loop? What if the size of the
-    // vector is big, say, order of million elements?
-    for (i = 0; i < size; ++i) {
-      num_elems = fread(v->data + i * stride, elem_size, 1, stream);
-      if (num_elems != 1) {
+    if (size == 0) {
+      return INS_SUCCESS;
+    }
+
+    buf = (INS_BASE *) malloc(INS_STAGING_CHUNK);
+
+    if (buf == 0) {
+      INS_ERROR("failed to allocate space for staging buffer", INS_ENOMEM);
+    }
+
+    for (i = 0; i < size; i += chunk) {
+      const size_t count = size - i < chunk ? size - i : chunk;
+
+      num_elems = fread(buf, elem_size, count, stream);
+      if (num_elems != count) {
+        free(buf);
         INS_ERROR("fread failed", INS_EFAILED);
       }
+
+      INS_VECTOR_FUNC(scatter)(v, i, count, buf);
     }
+
+    free(buf);
   }
 
   return INS_SUCCESS;
 }
 
 int INS_VECTOR_FUNC(fwrite)(const INS_VECTOR_TYPE *v, FILE *stream) {
+  INS_STATS(INS_VECTOR_FUNC(fwrite), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
 
   const size_t elem_size = sizeof(INS_BASE);
   size_t num_elems;
@@ -39,16 +65,36 @@ int INS_VECTOR_FUNC(fwrite)(const INS_VECTOR_TYPE *v, FILE *stream) {
       INS_ERROR("fwrite failed", INS_EFAILED);
     }
   } else {
+    // Strided vectors are gathered a chunk at a time into a contiguous
+    // staging buffer and written from there.
+    const size_t chunk = INS_STAGING_CHUNK / elem_size;
+
+    INS_BASE *buf;
     size_t i;
 
-    // TODO(linh): Call `fwrite` inside a loop? What if the size of the
-    // vector is big, say, order of million elements?
-    for (i = 0; i < size; ++i) {
-      num_elems = fwrite(v->data + i * stride, elem_size, 1, stream);
-      if (num_elems != 1) {
+    if (size == 0) {
+      return INS_SUCCESS;
+    }
+
+    buf = (INS_BASE *) malloc(INS_STAGING_CHUNK);
+
+    if (buf == 0) {
+      INS_ERROR("failed to allocate space for staging buffer", INS_ENOMEM);
+    }
+
+    for (i = 0; i < size; i += chunk) {
+      const size_t count = size - i < chunk ? size - i : chunk;
+
+      INS_VECTOR_FUNC(gather)(v, i, count, buf);
+
+      num_elems = fwrite(buf, elem_size, count, stream);
+      if (num_elems != count) {
+        free(buf);
         INS_ERROR("fwrite failed", INS_EFAILED);
       }
     }
+
+    free(buf);
   }
 
   return INS_SUCCESS;
@@ -57,38 +103,61 @@ int INS_VECTOR_FUNC(fwrite)(const INS_VECTOR_TYPE *v, FILE *stream) {
 int INS_VECTOR_FUNC(fprintf)(const INS_VECTOR_TYPE *v,
                              FILE *stream,
                              const char *format) {
+  INS_STATS(INS_VECTOR_FUNC(fprintf), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
   const INS_BASE *data = v->data;
 
+  ins_text_writer writer;
+  ins_text_format spec;
   size_t i;
+  int status = 0;
 
-  for (i = 0; i < size; ++i) {
-    if (fprintf(stream, format, data[i * stride]) < 0) {
-      INS_ERROR("fprintf failed", INS_EFAILED);
-    }
+  ins_text_format_init(&spec, format);
+  ins_text_writer_init(&writer, stream);
+
+  for (i = 0; i < size && status == 0; ++i) {
+    status = INS_TEXT_WRITE(&writer, &spec, data[(ptrdiff_t) i * stride]);
 
-    if (putc('\n', stream) == EOF) {
-      INS_ERROR("putc failed", INS_EFAILED);
+    if (status == 0) {
+      status = ins_text_write_char(&writer, '\n');
     }
   }
 
+  if (status == 0) {
+    status = ins_text_writer_flush(&writer);
+  }
+
+  if (status != 0) {
+    INS_ERROR("fprintf failed", INS_EFAILED);
+  }
+
   return INS_SUCCESS;
 }
 
 int INS_VECTOR_FUNC(fscanf)(INS_VECTOR_TYPE *v, FILE *stream) {
+  INS_STATS(INS_VECTOR_FUNC(fscanf), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
   INS_BASE * const data = v->data;
 
   size_t i;
-  INS_BASE tmp;
+  int status = 0;
 
-  for (i = 0; i < size; ++i) {
-    if (fscanf(stream, INS_INPUT_FORMAT, &tmp) != 1) {
-      INS_ERROR("fscanf failed", INS_EFAILED);
-    }
-    data[i * stride] = tmp;
+  flockfile(stream);
+
+  for (i = 0; i < size && status == 0; ++i) {
+    status = INS_TEXT_READ(stream, &data[(ptrdiff_t) i * stride]);
+  }
+
+  funlockfile(stream);
+
+  if (status != 0) {
+    INS_ERROR("fscanf failed", INS_EFAILED);
   }
 
   return INS_SUCCESS;
@@ -0,0 +1,21 @@
+#include <string.h>
+#include "ins/ins_vector.h"
+#include "ins/ins_graph_io.h"
+
+#define INS_BASE_DOUBLE
+#include "ins/templates_on.h"
+#include "ins/vector/graph_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/graph_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/vector/graph_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
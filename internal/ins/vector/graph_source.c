@@ -0,0 +1,273 @@
+// Template for the task graph nodes of ins_vector_[type] types.
+
+// Returns the view of the elements `[offset, offset + n)` of `v`.
+static INS_VECTOR_TYPE INS_VECTOR_FUNC(graph_slice)(const void * v,
+                                                    const size_t offset,
+                                                    const size_t n) {
+  INS_VECTOR_TYPE slice = *(const INS_VECTOR_TYPE *) v;
+
+  slice.data += (ptrdiff_t) offset * slice.stride;
+  slice.size = n;
+  slice.owner = 0;
+
+  return slice;
+}
+
+static int INS_VECTOR_FUNC(graph_run_add)(const ins_graph_node * node,
+                                          const size_t offset,
+                                          const size_t n) {
+  INS_VECTOR_TYPE x = INS_VECTOR_FUNC(graph_slice)(node->x, offset, n);
+  INS_VECTOR_TYPE y = INS_VECTOR_FUNC(graph_slice)(node->y, offset, n);
+  return INS_VECTOR_FUNC(add)(&x, &y);
+}
+
+static int INS_VECTOR_FUNC(graph_run_sub)(const ins_graph_node * node,
+                                          const size_t offset,
+                                          const size_t n) {
+  INS_VECTOR_TYPE x = INS_VECTOR_FUNC(graph_slice)(node->x, offset, n);
+  INS_VECTOR_TYPE y = INS_VECTOR_FUNC(graph_slice)(node->y, offset, n);
+  return INS_VECTOR_FUNC(sub)(&x, &y);
+}
+
+static int INS_VECTOR_FUNC(graph_run_mul)(const ins_graph_node * node,
+                                          const size_t offset,
+                                          const size_t n) {
+  INS_VECTOR_TYPE x = INS_VECTOR_FUNC(graph_slice)(node->x, offset, n);
+  INS_VECTOR_TYPE y = INS_VECTOR_FUNC(graph_slice)(node->y, offset, n);
+  return INS_VECTOR_FUNC(mul)(&x, &y);
+}
+
+static int INS_VECTOR_FUNC(graph_run_div)(const ins_graph_node * node,
+                                          const size_t offset,
+                                          const size_t n) {
+  INS_VECTOR_TYPE x = INS_VECTOR_FUNC(graph_slice)(node->x, offset, n);
+  INS_VECTOR_TYPE y = INS_VECTOR_FUNC(graph_slice)(node->y, offset, n);
+  return INS_VECTOR_FUNC(div)(&x, &y);
+}
+
+static int INS_VECTOR_FUNC(graph_run_scale)(const ins_graph_node * node,
+                                            const size_t offset,
+                                            const size_t n) {
+  INS_VECTOR_TYPE x = INS_VECTOR_FUNC(graph_slice)(node->x, offset, n);
+  return INS_VECTOR_FUNC(scale)(&x, *(const INS_BASE *) node->alpha);
+}
+
+static int INS_VECTOR_FUNC(graph_run_add_constant)(
+    const ins_graph_node * node, const size_t offset, const size_t n) {
+  INS_VECTOR_TYPE x = INS_VECTOR_FUNC(graph_slice)(node->x, offset, n);
+  return INS_VECTOR_FUNC(add_constant)(&x, *(const INS_BASE *) node->alpha);
+}
+
+static int INS_VECTOR_FUNC(graph_run_axpy)(const ins_graph_node * node,
+                                           const size_t offset,
+                                           const size_t n) {
+  INS_VECTOR_TYPE x = INS_VECTOR_FUNC(graph_slice)(node->x, offset, n);
+  INS_VECTOR_TYPE y = INS_VECTOR_FUNC(graph_slice)(node->y, offset, n);
+  return INS_VECTOR_FUNC(axpy)(*(const INS_BASE *) node->alpha, &x, &y);
+}
+
+static int INS_VECTOR_FUNC(graph_run_copy)(const ins_graph_node * node,
+                                           const size_t offset,
+                                           const size_t n) {
+  INS_VECTOR_TYPE x = INS_VECTOR_FUNC(graph_slice)(node->x, offset, n);
+  INS_VECTOR_TYPE y = INS_VECTOR_FUNC(graph_slice)(node->y, offset, n);
+  return INS_VECTOR_FUNC(copy)(&x, &y);
+}
+
+static int INS_VECTOR_FUNC(graph_run_dot)(const ins_graph_node * node,
+                                          const size_t offset,
+                                          const size_t n) {
+  (void) offset;
+  (void) n;
+  *(INS_BASE *) node->result =
+      INS_VECTOR_FUNC(dot)((const INS_VECTOR_TYPE *) node->x,
+                           (const INS_VECTOR_TYPE *) node->y);
+  return INS_SUCCESS;
+}
+
+static int INS_VECTOR_FUNC(graph_run_sum)(const ins_graph_node * node,
+                                          const size_t offset,
+                                          const size_t n) {
+  (void) offset;
+  (void) n;
+  *(INS_BASE *) node->result =
+      INS_VECTOR_FUNC(sum)((const INS_VECTOR_TYPE *) node->x);
+  return INS_SUCCESS;
+}
+
+static int INS_VECTOR_FUNC(graph_run_minmax)(const ins_graph_node * node,
+                                             const size_t offset,
+                                             const size_t n) {
+  (void) offset;
+  (void) n;
+  INS_VECTOR_FUNC(minmax)((const INS_VECTOR_TYPE *) node->x,
+                          (INS_BASE *) node->result,
+                          (INS_BASE *) node->result2);
+  return INS_SUCCESS;
+}
+
+// Adds the access to the elements of `v` to `node`.
+static void INS_VECTOR_FUNC(graph_access)(ins_graph_node * node,
+                                          const INS_VECTOR_TYPE * v,
+                                          const int write) {
+  ins_graph_access_vector(node, v->data, v->size, v->stride,
+                          sizeof(INS_BASE), write);
+}
+
+// Records the node of `op` that writes `x` and reads `y` and `alpha`, which
+// may be null. If `y` is not null, it must be as long as `x`.
+static ins_graph_node *
+INS_VECTOR_FUNC(graph_elementwise)(ins_graph * graph, ins_graph_op * op,
+                                   const INS_BASE * alpha,
+                                   INS_VECTOR_TYPE * x,
+                                   const INS_VECTOR_TYPE * y) {
+  ins_graph_node node;
+
+  if (y != 0 && x->size != y->size) {
+    INS_ERROR_VAL("vectors must have same length", INS_EBADLEN, 0);
+  }
+
+  memset(&node, 0, sizeof(node));
+  node.op = op;
+  node.x = x;
+  node.y = (void *) y;
+  node.alpha = alpha;
+  node.length = x->size;
+  node.elementwise = 1;
+
+  INS_VECTOR_FUNC(graph_access)(&node, x, 1);
+  if (y != 0) {
+    INS_VECTOR_FUNC(graph_access)(&node, y, 0);
+  }
+  if (alpha != 0) {
+    ins_graph_access_scalar(&node, alpha, sizeof(INS_BASE), 0);
+  }
+
+  return ins_graph_record(graph, &node);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_add)(ins_graph * graph,
+                                            INS_VECTOR_TYPE * x,
+                                            const INS_VECTOR_TYPE * y) {
+  return INS_VECTOR_FUNC(graph_elementwise)(
+      graph, INS_VECTOR_FUNC(graph_run_add), 0, x, y);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_sub)(ins_graph * graph,
+                                            INS_VECTOR_TYPE * x,
+                                            const INS_VECTOR_TYPE * y) {
+  return INS_VECTOR_FUNC(graph_elementwise)(
+      graph, INS_VECTOR_FUNC(graph_run_sub), 0, x, y);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_mul)(ins_graph * graph,
+                                            INS_VECTOR_TYPE * x,
+                                            const INS_VECTOR_TYPE * y) {
+  return INS_VECTOR_FUNC(graph_elementwise)(
+      graph, INS_VECTOR_FUNC(graph_run_mul), 0, x, y);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_div)(ins_graph * graph,
+                                            INS_VECTOR_TYPE * x,
+                                            const INS_VECTOR_TYPE * y) {
+  return INS_VECTOR_FUNC(graph_elementwise)(
+      graph, INS_VECTOR_FUNC(graph_run_div), 0, x, y);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_scale)(ins_graph * graph,
+                                              INS_VECTOR_TYPE * x,
+                                              const INS_BASE * alpha) {
+  return INS_VECTOR_FUNC(graph_elementwise)(
+      graph, INS_VECTOR_FUNC(graph_run_scale), alpha, x, 0);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_add_constant)(ins_graph * graph,
+                                                     INS_VECTOR_TYPE * x,
+                                                     const INS_BASE * alpha) {
+  return INS_VECTOR_FUNC(graph_elementwise)(
+      graph, INS_VECTOR_FUNC(graph_run_add_constant), alpha, x, 0);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_axpy)(ins_graph * graph,
+                                             const INS_BASE * alpha,
+                                             const INS_VECTOR_TYPE * x,
+                                             INS_VECTOR_TYPE * y) {
+  ins_graph_node * node = INS_VECTOR_FUNC(graph_elementwise)(
+      graph, INS_VECTOR_FUNC(graph_run_axpy), alpha, y, x);
+
+  // The operands are stored in the order of `ins_vector_axpy`.
+  if (node != 0) {
+    node->x = (void *) x;
+    node->y = y;
+  }
+
+  return node;
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_copy)(ins_graph * graph,
+                                             INS_VECTOR_TYPE * dst,
+                                             const INS_VECTOR_TYPE * src) {
+  return INS_VECTOR_FUNC(graph_elementwise)(
+      graph, INS_VECTOR_FUNC(graph_run_copy), 0, dst, src);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_dot)(ins_graph * graph,
+                                            const INS_VECTOR_TYPE * x,
+                                            const INS_VECTOR_TYPE * y,
+                                            INS_BASE * result) {
+  ins_graph_node node;
+
+  if (x->size != y->size) {
+    INS_ERROR_VAL("vectors must have same length", INS_EBADLEN, 0);
+  }
+
+  memset(&node, 0, sizeof(node));
+  node.op = INS_VECTOR_FUNC(graph_run_dot);
+  node.x = (void *) x;
+  node.y = (void *) y;
+  node.result = result;
+  node.length = x->size;
+
+  INS_VECTOR_FUNC(graph_access)(&node, x, 0);
+  INS_VECTOR_FUNC(graph_access)(&node, y, 0);
+  ins_graph_access_scalar(&node, result, sizeof(INS_BASE), 1);
+
+  return ins_graph_record(graph, &node);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_sum)(ins_graph * graph,
+                                            const INS_VECTOR_TYPE * x,
+                                            INS_BASE * result) {
+  ins_graph_node node;
+
+  memset(&node, 0, sizeof(node));
+  node.op = INS_VECTOR_FUNC(graph_run_sum);
+  node.x = (void *) x;
+  node.result = result;
+  node.length = x->size;
+
+  INS_VECTOR_FUNC(graph_access)(&node, x, 0);
+  ins_graph_access_scalar(&node, result, sizeof(INS_BASE), 1);
+
+  return ins_graph_record(graph, &node);
+}
+
+ins_graph_node * INS_VECTOR_FUNC(graph_minmax)(ins_graph * graph,
+                                               const INS_VECTOR_TYPE * x,
+                                               INS_BASE * min_out,
+                                               INS_BASE * max_out) {
+  ins_graph_node node;
+
+  memset(&node, 0, sizeof(node));
+  node.op = INS_VECTOR_FUNC(graph_run_minmax);
+  node.x = (void *) x;
+  node.result = min_out;
+  node.result2 = max_out;
+  node.length = x->size;
+
+  INS_VECTOR_FUNC(graph_access)(&node, x, 0);
+  ins_graph_access_scalar(&node, min_out, sizeof(INS_BASE), 1);
+  ins_graph_access_scalar(&node, max_out, sizeof(INS_BASE), 1);
+
+  return ins_graph_record(graph, &node);
+}
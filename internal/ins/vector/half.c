@@ -0,0 +1,23 @@
+#include <math.h>
+#include "ins/ins_vector.h"
+#include "ins/ins_blas.h"
+#include "ins/ins_half.h"
+#include "ins/ins_stats_io.h"
+
+// Number of elements converted to single precision at a time by the 16-bit
+// vector operations. The float buffers live on the stack and stay in L1.
+#define INS_HALF_CHUNK 512
+
+#define INS_BASE_F16
+#include "ins/templates_on.h"
+#include "ins/vector/half_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_F16
+
+#define INS_BASE_BF16
+#include "ins/templates_on.h"
+#include "ins/vector/half_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_BF16
+
+#undef INS_HALF_CHUNK
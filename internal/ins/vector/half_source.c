@@ -0,0 +1,228 @@
+// Template for the 16-bit storage vectors. Elements are converted to single
+// precision in chunks of `INS_HALF_CHUNK`, the arithmetic runs on the float
+// chunks, and results are rounded back to 16 bits where they are stored.
+
+// Converts `count` elements of the vector `v` starting at index `offset`
+// to single precision and stores them contiguously in `buf`.
+static void
+INS_VECTOR_FUNC(load_chunk)(const INS_VECTOR_TYPE * v, const size_t offset,
+                            const size_t count, float * buf) {
+  const ptrdiff_t stride = v->stride;
+  const INS_BASE * data = v->data + (ptrdiff_t) offset * stride;
+
+  size_t i;
+
+  if (stride == 1) {
+    INS_TO_FLOAT_ARRAY(data, buf, count);
+    return;
+  }
+
+  for (i = 0; i < count; ++i) {
+    buf[i] = INS_TO_SCALAR(data[(ptrdiff_t) i * stride]);
+  }
+}
+
+// Rounds the `count` floats in `buf` to 16 bits and stores them in the
+// vector `v` starting at index `offset`.
+static void
+INS_VECTOR_FUNC(store_chunk)(INS_VECTOR_TYPE * v, const size_t offset,
+                             const size_t count, const float * buf) {
+  const ptrdiff_t stride = v->stride;
+  INS_BASE * data = v->data + (ptrdiff_t) offset * stride;
+
+  size_t i;
+
+  if (stride == 1) {
+    INS_FROM_FLOAT_ARRAY(buf, data, count);
+    return;
+  }
+
+  for (i = 0; i < count; ++i) {
+    data[(ptrdiff_t) i * stride] = INS_FROM_SCALAR(buf[i]);
+  }
+}
+
+INS_SCALAR
+INS_VECTOR_FUNC(get)(const INS_VECTOR_TYPE * v, const size_t i) {
+  return INS_TO_SCALAR(v->data[(ptrdiff_t) i * v->stride]);
+}
+
+void INS_VECTOR_FUNC(set)(INS_VECTOR_TYPE * v, const size_t i, INS_SCALAR x) {
+  v->data[(ptrdiff_t) i * v->stride] = INS_FROM_SCALAR(x);
+}
+
+int
+INS_VECTOR_FUNC(from_float)(INS_VECTOR_TYPE * dst,
+                            const ins_vector_float * src) {
+  INS_STATS(INS_VECTOR_FUNC(from_float), dst->size, dst->stride,
+            dst->size * (sizeof(INS_BASE) + sizeof(float)));
+
+  const size_t size = dst->size;
+
+  if (src->size != size) {
+    INS_ERROR("vectors must have same length", INS_EBADLEN);
+  }
+
+  const ptrdiff_t src_stride = src->stride;
+
+  size_t i;
+
+  if (src_stride == 1) {
+    for (i = 0; i < size; i += INS_HALF_CHUNK) {
+      const size_t count = size - i < INS_HALF_CHUNK ? size - i
+                                                     : INS_HALF_CHUNK;
+      INS_VECTOR_FUNC(store_chunk)(dst, i, count, src->data + i);
+    }
+  } else {
+    for (i = 0; i < size; ++i) {
+      dst->data[(ptrdiff_t) i * dst->stride] =
+        INS_FROM_SCALAR(src->data[(ptrdiff_t) i * src_stride]);
+    }
+  }
+
+  return INS_SUCCESS;
+}
+
+int
+INS_VECTOR_FUNC(to_float)(ins_vector_float * dst,
+                          const INS_VECTOR_TYPE * src) {
+  INS_STATS(INS_VECTOR_FUNC(to_float), src->size, src->stride,
+            src->size * (sizeof(INS_BASE) + sizeof(float)));
+
+  const size_t size = src->size;
+
+  if (dst->size != size) {
+    INS_ERROR("vectors must have same length", INS_EBADLEN);
+  }
+
+  const ptrdiff_t dst_stride = dst->stride;
+
+  size_t i;
+
+  if (dst_stride == 1) {
+    for (i = 0; i < size; i += INS_HALF_CHUNK) {
+      const size_t count = size - i < INS_HALF_CHUNK ? size - i
+                                                     : INS_HALF_CHUNK;
+      INS_VECTOR_FUNC(load_chunk)(src, i, count, dst->data + i);
+    }
+  } else {
+    for (i = 0; i < size; ++i) {
+      dst->data[(ptrdiff_t) i * dst_stride] =
+        INS_TO_SCALAR(src->data[(ptrdiff_t) i * src->stride]);
+    }
+  }
+
+  return INS_SUCCESS;
+}
+
+INS_SCALAR
+INS_VECTOR_FUNC(sum)(const INS_VECTOR_TYPE * x) {
+  INS_STATS(INS_VECTOR_FUNC(sum), x->size, x->stride,
+            x->size * sizeof(INS_BASE));
+
+  const size_t size = x->size;
+
+  float buf[INS_HALF_CHUNK];
+  float sum = 0.0F;
+
+  size_t i;
+  size_t j;
+
+  for (i = 0; i < size; i += INS_HALF_CHUNK) {
+    const size_t count = size - i < INS_HALF_CHUNK ? size - i
+                                                   : INS_HALF_CHUNK;
+    INS_VECTOR_FUNC(load_chunk)(x, i, count, buf);
+
+    for (j = 0; j < count; ++j) {
+      sum += buf[j];
+    }
+  }
+
+  return sum;
+}
+
+int
+INS_VECTOR_FUNC(axpy)(INS_SCALAR alpha,
+                      const INS_VECTOR_TYPE * x,
+                      INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(axpy), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
+  const size_t size = x->size;
+
+  if (y->size != size) {
+    INS_ERROR("vectors must have same length", INS_EBADLEN);
+  }
+
+  float x_buf[INS_HALF_CHUNK];
+  float y_buf[INS_HALF_CHUNK];
+
+  size_t i;
+
+  for (i = 0; i < size; i += INS_HALF_CHUNK) {
+    const size_t count = size - i < INS_HALF_CHUNK ? size - i
+                                                   : INS_HALF_CHUNK;
+    INS_VECTOR_FUNC(load_chunk)(x, i, count, x_buf);
+    INS_VECTOR_FUNC(load_chunk)(y, i, count, y_buf);
+
+    cblas_saxpy(count, alpha, x_buf, 1, y_buf, 1);
+
+    INS_VECTOR_FUNC(store_chunk)(y, i, count, y_buf);
+  }
+
+  return INS_SUCCESS;
+}
+
+INS_SCALAR
+INS_VECTOR_FUNC(dot)(const INS_VECTOR_TYPE * v, const INS_VECTOR_TYPE * w) {
+  INS_STATS(INS_VECTOR_FUNC(dot), v->size, v->stride,
+            2 * v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+
+  if (w->size != size) {
+    INS_ERROR("vectors must have same length", INS_EINVAL);
+  }
+
+  float v_buf[INS_HALF_CHUNK];
+  float w_buf[INS_HALF_CHUNK];
+  float ret = 0.0F;
+
+  size_t i;
+
+  for (i = 0; i < size; i += INS_HALF_CHUNK) {
+    const size_t count = size - i < INS_HALF_CHUNK ? size - i
+                                                   : INS_HALF_CHUNK;
+    INS_VECTOR_FUNC(load_chunk)(v, i, count, v_buf);
+    INS_VECTOR_FUNC(load_chunk)(w, i, count, w_buf);
+
+    ret += cblas_sdot(count, v_buf, 1, w_buf, 1);
+  }
+
+  return ret;
+}
+
+INS_SCALAR
+INS_VECTOR_FUNC(nrm2)(const INS_VECTOR_TYPE * v) {
+  INS_STATS(INS_VECTOR_FUNC(nrm2), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+
+  float buf[INS_HALF_CHUNK];
+  float ret = 0.0F;
+
+  size_t i;
+
+  for (i = 0; i < size; i += INS_HALF_CHUNK) {
+    const size_t count = size - i < INS_HALF_CHUNK ? size - i
+                                                   : INS_HALF_CHUNK;
+    INS_VECTOR_FUNC(load_chunk)(v, i, count, buf);
+
+    // Combining the norms of the chunks with `hypotf` avoids the overflow
+    // of summing squares, which matters for the range of bfloat16.
+    ret = hypotf(ret, cblas_snrm2(count, buf, 1));
+  }
+
+  return ret;
+}
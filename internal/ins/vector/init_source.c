@@ -2,6 +2,8 @@
 
 INS_VECTOR_TYPE *
 INS_VECTOR_FUNC(alloc)(const size_t n) {
+  INS_STATS(INS_VECTOR_FUNC(alloc), n, 1, 0);
+
   INS_BLOCK_TYPE *block;
   INS_VECTOR_TYPE *vector;
 
@@ -34,6 +36,8 @@ INS_VECTOR_FUNC(alloc)(const size_t n) {
 
 INS_VECTOR_TYPE *
 INS_VECTOR_FUNC(calloc)(const size_t n) {
+  INS_STATS(INS_VECTOR_FUNC(calloc), n, 1, n * sizeof(INS_BASE));
+
   INS_BLOCK_TYPE *block;
   INS_VECTOR_TYPE *vector;
 
@@ -65,24 +69,39 @@ INS_VECTOR_FUNC(calloc)(const size_t n) {
 }
 
 INS_VECTOR_TYPE *
-INS_VECTOR_FUNC(alloc_from_block)(ins_block * block,
+INS_VECTOR_FUNC(alloc_from_block)(INS_BLOCK_TYPE * block,
                                  const size_t offset,
                                  const size_t n,
-                                 const size_t stride) {
+                                 const ptrdiff_t stride) {
+  INS_STATS(INS_VECTOR_FUNC(alloc_from_block), n, stride, 0);
+
   INS_VECTOR_TYPE *vector;
 
-  // Check to make sure that the given `stride` is a positive integer.
+  // Check to make sure that the given `stride` is a non-zero integer.
   if (stride == 0) {
-    INS_ERROR_VAL("stride must be positive integer", INS_EINVAL, 0);
+    INS_ERROR_VAL("stride must be non-zero integer", INS_EINVAL, 0);
   }
 
   // Check to make sure that `block` has enough elements for the vector.
   // We have `v[i] = block[offset + i * stride]` for `i = 0, 1, ...n-1`,
   // therefore the index of the last vector element `offset + (n-1) * stride`
-  // must less than `block->size`.
-  if (block->size <= offset + (n > 0 ? n - 1 : 0) * stride) {
-    INS_ERROR_VAL("vector would extend past the end of the input block",
-                  INS_EINVAL, 0);
+  // must less than `block->size` if `stride` is positive and must not be
+  // negative if `stride` is negative.
+  if (stride > 0) {
+    if (block->size <= offset + (n > 0 ? n - 1 : 0) * (size_t) stride) {
+      INS_ERROR_VAL("vector would extend past the end of the input block",
+                    INS_EINVAL, 0);
+    }
+  } else {
+    if (block->size <= offset) {
+      INS_ERROR_VAL("vector would extend past the end of the input block",
+                    INS_EINVAL, 0);
+    }
+
+    if (offset < (n > 0 ? n - 1 : 0) * (size_t) -stride) {
+      INS_ERROR_VAL("vector would extend past the start of the input block",
+                    INS_EINVAL, 0);
+    }
   }
 
   vector = (INS_VECTOR_TYPE *) malloc(sizeof(INS_VECTOR_TYPE));
@@ -93,7 +112,7 @@ INS_VECTOR_FUNC(alloc_from_block)(ins_block * block,
 
   vector->size = n;
   vector->stride = stride;
-  vector->data = block->data + offset;
+  vector->data = block->data + INS_MULTIPLICITY * offset;
   vector->block = block;
   vector->owner = 0;
 
@@ -104,21 +123,35 @@ INS_VECTOR_TYPE *
 INS_VECTOR_FUNC(alloc_from_vector)(INS_VECTOR_TYPE * other,
                                    const size_t offset,
                                    const size_t n,
-                                   const size_t stride) {
+                                   const ptrdiff_t stride) {
+  INS_STATS(INS_VECTOR_FUNC(alloc_from_vector), n, stride, 0);
+
   INS_VECTOR_TYPE *vector;
 
-  // Check to make sure the the given `stride` is a positive integer
+  // Check to make sure the the given `stride` is a non-zero integer
   if (stride == 0) {
-    INS_ERROR_VAL("stride must be a positive integer", INS_EINVAL, 0);
+    INS_ERROR_VAL("stride must be a non-zero integer", INS_EINVAL, 0);
   }
 
   // Check to make sure that the `other` has enough enough elements for the
   // vector. We have `v[i] = other[offset + i * stride]`, for `i = 0, 1, n-1`,
   // therefore the index of the last vector element `offset + (n-1) * stride`
-  // must less than `other->size`.
-  if (other->size <= offset + (n > 0 ? n - 1 : 0) * stride) {
-    INS_ERROR_VAL("vector would extend pass the end of the input vector",
-                  INS_EINVAL, 0);
+  // must less than `other->size` and must not be negative.
+  if (stride > 0) {
+    if (other->size <= offset + (n > 0 ? n - 1 : 0) * (size_t) stride) {
+      INS_ERROR_VAL("vector would extend pass the end of the input vector",
+                    INS_EINVAL, 0);
+    }
+  } else {
+    if (other->size <= offset) {
+      INS_ERROR_VAL("vector would extend pass the end of the input vector",
+                    INS_EINVAL, 0);
+    }
+
+    if (offset < (n > 0 ? n - 1 : 0) * (size_t) -stride) {
+      INS_ERROR_VAL("vector would extend pass the start of the input vector",
+                    INS_EINVAL, 0);
+    }
   }
 
   vector = (INS_VECTOR_TYPE *) malloc(sizeof(INS_VECTOR_TYPE));
@@ -129,14 +162,84 @@ INS_VECTOR_FUNC(alloc_from_vector)(INS_VECTOR_TYPE * other,
 
   vector->size = n;
   vector->stride = stride * other->stride;
-  vector->data = other->data + offset * other->stride;
+  vector->data =
+    other->data + INS_MULTIPLICITY * (ptrdiff_t) offset * other->stride;
+  vector->block = other->block;
+  vector->owner = 0;
+
+  return vector;
+}
+
+INS_VECTOR_TYPE *
+INS_VECTOR_FUNC(alloc_reverse)(INS_VECTOR_TYPE * other) {
+  INS_STATS(INS_VECTOR_FUNC(alloc_reverse), other->size, -other->stride, 0);
+
+  const size_t n = other->size;
+  INS_VECTOR_TYPE *vector;
+
+  vector = (INS_VECTOR_TYPE *) malloc(sizeof(INS_VECTOR_TYPE));
+
+  if (vector == 0) {
+    INS_ERROR_VAL("failed to allocate space for vector", INS_ENOMEM, 0);
+  }
+
+  // The first element of the reversed view is the last element of `other`.
+  vector->size = n;
+  vector->stride = -other->stride;
+  vector->data = other->data
+    + INS_MULTIPLICITY * (ptrdiff_t) (n > 0 ? n - 1 : 0) * other->stride;
   vector->block = other->block;
   vector->owner = 0;
 
   return vector;
 }
 
+INS_VECTOR_TYPE *
+INS_VECTOR_FUNC(wrap)(INS_ATOMIC * data, const size_t n,
+                      const ptrdiff_t stride) {
+  INS_STATS(INS_VECTOR_FUNC(wrap), n, stride, 0);
+
+  const size_t step = (size_t) (stride > 0 ? stride : -stride);
+  const size_t span = n > 0 ? (n - 1) * step + 1 : 0;
+  INS_BLOCK_TYPE *block;
+  INS_VECTOR_TYPE *vector;
+
+  if (stride == 0) {
+    INS_ERROR_VAL("stride must be non-zero integer", INS_EINVAL, 0);
+  }
+
+  vector = (INS_VECTOR_TYPE *) malloc(sizeof(INS_VECTOR_TYPE));
+
+  if (vector == 0) {
+    INS_ERROR_VAL("failed to allocate space for vector", INS_ENOMEM, 0);
+  }
+
+  // The block starts at the lowest address of the elements, which is the
+  // last element if `stride` is negative.
+  block = INS_BLOCK_FUNC(wrap)(
+      stride > 0 || n == 0
+          ? data
+          : data + INS_MULTIPLICITY * (ptrdiff_t) (n - 1) * stride,
+      span, 0, 0);
+
+  if (block == 0) {
+    free(vector);
+    return 0;
+  }
+
+  vector->size = n;
+  vector->stride = stride;
+  vector->data = data;
+  vector->block = block;
+  vector->owner = 1;
+
+  return vector;
+}
+
 void INS_VECTOR_FUNC(free)(INS_VECTOR_TYPE * vector) {
+  INS_STATS(INS_VECTOR_FUNC(free), vector != 0 ? vector->size : 0,
+            vector != 0 ? vector->stride : 1, 0);
+
   if (vector == 0) {
     return;
   }
@@ -149,39 +252,54 @@ void INS_VECTOR_FUNC(free)(INS_VECTOR_TYPE * vector) {
 }
 
 void INS_VECTOR_FUNC(set_zero)(INS_VECTOR_TYPE * v) {
-  INS_BASE * const data = v->data;
+  INS_STATS(INS_VECTOR_FUNC(set_zero), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  INS_ATOMIC * const data = v->data;
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
+  const INS_BASE zero = INS_ZERO;
 
   size_t i;
 
+  // Elements are written through `INS_BASE *` so that multi-atom types
+  // (complex numbers) are assigned as a whole.
   for (i = 0; i < size; ++i) {
-    data[i * stride] = INS_ZERO;
+    *(INS_BASE *) (data + INS_MULTIPLICITY * (ptrdiff_t) i * stride) = zero;
   }
 }
 
-void INS_VECTOR_FUNC(set_all)(INS_VECTOR_TYPE * v, INS_BASE x) {
-  INS_BASE * const data = v->data;
+void INS_VECTOR_FUNC(set_all)(INS_VECTOR_TYPE * v, INS_SCALAR x) {
+  INS_STATS(INS_VECTOR_FUNC(set_all), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  INS_ATOMIC * const data = v->data;
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
+  const INS_BASE value = INS_FROM_SCALAR(x);
 
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    data[i * stride] = x;
+    *(INS_BASE *) (data + INS_MULTIPLICITY * (ptrdiff_t) i * stride) = value;
   }
 }
 
 void INS_VECTOR_FUNC(set_basis)(INS_VECTOR_TYPE * v, size_t i) {
-  INS_BASE * const data = v->data;
+  INS_STATS(INS_VECTOR_FUNC(set_basis), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  INS_ATOMIC * const data = v->data;
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
+  const INS_BASE zero = INS_ZERO;
+  const INS_BASE one = INS_ONE;
 
   size_t j;
 
   for (j = 0; j < size; ++j) {
-    data[j * stride] = INS_ZERO;
+    *(INS_BASE *) (data + INS_MULTIPLICITY * (ptrdiff_t) j * stride) = zero;
   }
 
-  data[i * stride] = INS_ONE;
+  *(INS_BASE *) (data + INS_MULTIPLICITY * (ptrdiff_t) i * stride) = one;
 }
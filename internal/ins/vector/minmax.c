@@ -1,8 +1,21 @@
 #include <math.h>
 #include "ins/ins_vector.h"
+#include "ins/ins_stats_io.h"
 
 #define INS_BASE_DOUBLE
 #include "ins/templates_on.h"
 #include "ins/vector/minmax_source.c"
 #include "ins/templates_off.h"
 #undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/minmax_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/vector/minmax_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
@@ -1,7 +1,10 @@
 INS_BASE
 INS_VECTOR_FUNC(min)(const INS_VECTOR_TYPE *v) {
+  INS_STATS(INS_VECTOR_FUNC(min), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
 
   INS_BASE min = v->data[0 * stride];
   INS_BASE cur;
@@ -9,7 +12,7 @@ INS_VECTOR_FUNC(min)(const INS_VECTOR_TYPE *v) {
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    cur = v->data[i * stride];
+    cur = v->data[(ptrdiff_t) i * stride];
 
     if (cur < min) {
       min = cur;
@@ -30,8 +33,11 @@ INS_VECTOR_FUNC(min)(const INS_VECTOR_TYPE *v) {
 
 INS_BASE
 INS_VECTOR_FUNC(max)(const INS_VECTOR_TYPE *v) {
+  INS_STATS(INS_VECTOR_FUNC(max), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
 
   INS_BASE max = v->data[0 * stride];
   INS_BASE cur;
@@ -39,7 +45,7 @@ INS_VECTOR_FUNC(max)(const INS_VECTOR_TYPE *v) {
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    cur = v->data[i * stride];
+    cur = v->data[(ptrdiff_t) i * stride];
 
     if (cur > max) {
       max = cur;
@@ -62,8 +68,11 @@ void
 INS_VECTOR_FUNC(minmax)(const INS_VECTOR_TYPE * v,
                         INS_BASE * min_out,
                         INS_BASE * max_out) {
+  INS_STATS(INS_VECTOR_FUNC(minmax), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
 
   INS_BASE min = v->data[0 * stride];
   INS_BASE max = min;
@@ -72,7 +81,7 @@ INS_VECTOR_FUNC(minmax)(const INS_VECTOR_TYPE * v,
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    cur = v->data[i * stride];
+    cur = v->data[(ptrdiff_t) i * stride];
 
     if (cur < min) {
       min = cur;
@@ -100,8 +109,11 @@ INS_VECTOR_FUNC(minmax)(const INS_VECTOR_TYPE * v,
 
 size_t
 INS_VECTOR_FUNC(min_index)(const INS_VECTOR_TYPE * v) {
+  INS_STATS(INS_VECTOR_FUNC(min_index), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
 
   INS_BASE min = v->data[0 * stride];
   INS_BASE cur;
@@ -110,7 +122,7 @@ INS_VECTOR_FUNC(min_index)(const INS_VECTOR_TYPE * v) {
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    cur = v->data[i * stride];
+    cur = v->data[(ptrdiff_t) i * stride];
 
     if (cur < min) {
       min = cur;
@@ -132,8 +144,11 @@ INS_VECTOR_FUNC(min_index)(const INS_VECTOR_TYPE * v) {
 
 size_t
 INS_VECTOR_FUNC(max_index)(const INS_VECTOR_TYPE * v) {
+  INS_STATS(INS_VECTOR_FUNC(max_index), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
 
   INS_BASE max = v->data[0 * stride];
   INS_BASE cur;
@@ -142,7 +157,7 @@ INS_VECTOR_FUNC(max_index)(const INS_VECTOR_TYPE * v) {
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    cur = v->data[i * stride];
+    cur = v->data[(ptrdiff_t) i * stride];
 
     if (cur > max) {
       max = cur;
@@ -166,8 +181,11 @@ void
 INS_VECTOR_FUNC(minmax_index)(const INS_VECTOR_TYPE * v,
                               size_t * imin_out,
                               size_t * imax_out) {
+  INS_STATS(INS_VECTOR_FUNC(minmax_index), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
+  const ptrdiff_t stride = v->stride;
 
   INS_BASE min = v->data[0 * stride];
   INS_BASE max = min;
@@ -178,7 +196,7 @@ INS_VECTOR_FUNC(minmax_index)(const INS_VECTOR_TYPE * v,
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    cur = v->data[i * stride];
+    cur = v->data[(ptrdiff_t) i * stride];
 
     if (cur < min) {
       min = cur;
@@ -0,0 +1,122 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ins/ins_vector.h"
+#include "ins/ins_container_io.h"
+#include "ins/ins_stats_io.h"
+
+// A file mapping owned by a block: the page-aligned address returned by
+// `mmap` and the length of the mapping, which may start before the first
+// element of the block when the file offset is not page-aligned.
+typedef struct {
+  void * addr;
+  size_t length;
+} ins_mapping;
+
+// Block `release` function for memory-mapped blocks.
+static void ins_mapping_release(void * data, void * release_ctx) {
+  ins_mapping * mapping = (ins_mapping *) release_ctx;
+
+  (void) data;
+
+  munmap(mapping->addr, mapping->length);
+  free(mapping);
+}
+
+// Maps `length` bytes of the file at `path` starting `offset` bytes into the
+// file, records the mapping in `mapping` and returns the address of the byte
+// at `offset`. Calls the error handler and returns 0 on failure.
+static void * ins_mmap_file(const char * path, const size_t offset,
+                            const size_t length, const int flags,
+                            ins_mapping * mapping) {
+  const int writable = flags & INS_MMAP_WRITE;
+  const size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+  const size_t delta = offset % page_size;
+
+  struct stat st;
+  int fd;
+  int prot = PROT_READ;
+  int map_flags = MAP_SHARED;
+  void * addr;
+
+  fd = open(path, writable ? O_RDWR : O_RDONLY);
+
+  if (fd < 0) {
+    INS_ERROR_VAL("failed to open file", INS_EFAILED, 0);
+  }
+
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    INS_ERROR_VAL("fstat failed", INS_EFAILED, 0);
+  }
+
+  if ((size_t) st.st_size < offset || (size_t) st.st_size - offset < length) {
+    close(fd);
+    INS_ERROR_VAL("file is too short for the requested vector",
+                  INS_EINVAL, 0);
+  }
+
+  if (writable) {
+    prot |= PROT_WRITE;
+  }
+
+#ifdef MAP_POPULATE
+  if (flags & INS_MMAP_POPULATE) {
+    map_flags |= MAP_POPULATE;
+  }
+#endif
+
+  addr = mmap(0, length + delta, prot, map_flags, fd,
+              (off_t) (offset - delta));
+
+  // The mapping keeps its own reference to the file.
+  close(fd);
+
+  if (addr == MAP_FAILED) {
+    INS_ERROR_VAL("mmap failed", INS_EFAILED, 0);
+  }
+
+  // Access pattern advice is best effort, so failures are ignored.
+  if (flags & INS_MMAP_SEQUENTIAL) {
+    madvise(addr, length + delta, MADV_SEQUENTIAL);
+  }
+
+  if (flags & INS_MMAP_RANDOM) {
+    madvise(addr, length + delta, MADV_RANDOM);
+  }
+
+  if (flags & INS_MMAP_WILLNEED) {
+    madvise(addr, length + delta, MADV_WILLNEED);
+  }
+
+#ifdef MADV_HUGEPAGE
+  if (flags & INS_MMAP_HUGEPAGE) {
+    madvise(addr, length + delta, MADV_HUGEPAGE);
+  }
+#endif
+
+  mapping->addr = addr;
+  mapping->length = length + delta;
+
+  return (char *) addr + delta;
+}
+
+#define INS_BASE_DOUBLE
+#include "ins/templates_on.h"
+#include "ins/vector/mmap_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/mmap_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/vector/mmap_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
@@ -0,0 +1,116 @@
+// Template for memory-mapped ins_vector_[atomic] types.
+
+INS_VECTOR_TYPE *
+INS_VECTOR_FUNC(mmap)(const char * path,
+                      const size_t offset,
+                      const size_t n,
+                      const int flags) {
+  INS_STATS(INS_VECTOR_FUNC(mmap), n, 1, 0);
+
+  const size_t elem_size = INS_MULTIPLICITY * sizeof(INS_ATOMIC);
+
+  INS_BLOCK_TYPE * block;
+  INS_VECTOR_TYPE * vector;
+  ins_mapping * mapping;
+  void * data;
+
+  // The first element must be suitably aligned for the element type, and
+  // the mapping itself always starts on a page boundary.
+  if (offset % elem_size != 0) {
+    INS_ERROR_VAL("offset must be a multiple of the element size",
+                  INS_EINVAL, 0);
+  }
+
+  if (n > SIZE_MAX / elem_size) {
+    INS_ERROR_VAL("vector is too large to be mapped", INS_EINVAL, 0);
+  }
+
+  // An empty mapping is not valid, so zero-size requests get an ordinary
+  // empty vector.
+  if (n == 0) {
+    return INS_VECTOR_FUNC(alloc)(0);
+  }
+
+  mapping = (ins_mapping *) malloc(sizeof(ins_mapping));
+
+  if (mapping == 0) {
+    INS_ERROR_VAL("failed to allocate space for mapping", INS_ENOMEM, 0);
+  }
+
+  data = ins_mmap_file(path, offset, n * elem_size, flags, mapping);
+
+  if (data == 0) {
+    free(mapping);
+    return 0;
+  }
+
+  block = (INS_BLOCK_TYPE *) malloc(sizeof(INS_BLOCK_TYPE));
+
+  if (block == 0) {
+    ins_mapping_release(data, mapping);
+    INS_ERROR_VAL("failed to allocate space for block struct", INS_ENOMEM, 0);
+  }
+
+  block->size = n;
+  block->data = (INS_ATOMIC *) data;
+  block->release = ins_mapping_release;
+  block->release_ctx = mapping;
+  block->tag = 0;
+  block->allocator = 0;
+
+  vector = (INS_VECTOR_TYPE *) malloc(sizeof(INS_VECTOR_TYPE));
+
+  if (vector == 0) {
+    INS_BLOCK_FUNC(free)(block);
+    INS_ERROR_VAL("failed to allocate space for vector", INS_ENOMEM, 0);
+  }
+
+  vector->size = n;
+  vector->stride = 1;
+  vector->data = block->data;
+  vector->block = block;
+  vector->owner = 1;
+
+  return vector;
+}
+
+INS_VECTOR_TYPE *
+INS_VECTOR_FUNC(mmap_ins)(const char * path, const int flags) {
+  INS_STATS(INS_VECTOR_FUNC(mmap_ins), 0, 1, 0);
+
+  const size_t elem_size = INS_MULTIPLICITY * sizeof(INS_ATOMIC);
+
+  ins_container_header header;
+  INS_VECTOR_TYPE * vector;
+
+  if (ins_container_query(path, &header) != INS_SUCCESS) {
+    return 0;
+  }
+
+  if (ins_container_check_type(&header, INS_TYPE_ID, (uint32_t) elem_size)
+      != INS_SUCCESS) {
+    return 0;
+  }
+
+  // A mapping is a view of the bytes as stored, so they cannot be converted.
+  if (header.big_endian != ins_host_big_endian()) {
+    INS_ERROR_VAL("container byte order differs from the host",
+                  INS_EUNSUP, 0);
+  }
+
+  vector = INS_VECTOR_FUNC(mmap)(path, header.payload_offset, header.count,
+                                 flags);
+
+  if (vector == 0) {
+    return 0;
+  }
+
+  if ((flags & INS_CONTAINER_VERIFY) &&
+      ins_container_checksum(vector->data, header.payload_size)
+      != header.checksum) {
+    INS_VECTOR_FUNC(free)(vector);
+    INS_ERROR_VAL("container checksum mismatch", INS_EFAILED, 0);
+  }
+
+  return vector;
+}
@@ -1,113 +1,167 @@
+#if defined(INS_BASE_DOUBLE) || defined(INS_BASE_FLOAT)
+
+// Returns the address that BLAS routines expect for the elements of the
+// vector `v`. For a negative increment BLAS starts from the element with the
+// lowest address, which is the last element of a vector with a negative
+// stride, and walks the memory backwards from there.
+static INS_BASE *
+INS_VECTOR_FUNC(blas_data)(const INS_VECTOR_TYPE * v) {
+  if (v->stride < 0 && v->size > 0) {
+    return v->data + (ptrdiff_t) (v->size - 1) * v->stride;
+  }
+
+  return v->data;
+}
+
+// Returns non-zero if the operation `op` of `ins/ins_tuning.h` on `n`
+// elements calls BLAS, which pays off from the tuned length on.
+static int INS_VECTOR_FUNC(use_blas)(const int op, const size_t n) {
+#if defined(INS_BASE_DOUBLE)
+  return n >= ins_tuning_get(&ins_tuning_current.blas_min_double[op]);
+#else
+  return n >= ins_tuning_get(&ins_tuning_current.blas_min_float[op]);
+#endif
+}
+
+#endif
+
 int INS_VECTOR_FUNC(add)(INS_VECTOR_TYPE * x, const INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(add), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
   const size_t size = x->size;
 
   if (y->size != size) {
     INS_ERROR("vectors must have same length", INS_EBADLEN);
   }
 
-  const size_t x_stride = x->stride;
-  const size_t y_stride = y->stride;
+  const ptrdiff_t x_stride = x->stride;
+  const ptrdiff_t y_stride = y->stride;
 
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    x->data[i * x_stride] += y->data[i * y_stride];
+    x->data[(ptrdiff_t) i * x_stride] += y->data[(ptrdiff_t) i * y_stride];
   }
 
   return INS_SUCCESS;
 }
 
 int INS_VECTOR_FUNC(sub)(INS_VECTOR_TYPE * x, const INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(sub), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
   const size_t size = x->size;
 
   if (y->size != size) {
     INS_ERROR("vectors must have same length", INS_EBADLEN);
   }
 
-  const size_t x_stride = x->stride;
-  const size_t y_stride = y->stride;
+  const ptrdiff_t x_stride = x->stride;
+  const ptrdiff_t y_stride = y->stride;
 
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    x->data[i * x_stride] -= y->data[i * y_stride];
+    x->data[(ptrdiff_t) i * x_stride] -= y->data[(ptrdiff_t) i * y_stride];
   }
 
   return INS_SUCCESS;
 }
 
 int INS_VECTOR_FUNC(mul)(INS_VECTOR_TYPE * x, const INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(mul), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
   const size_t size = x->size;
 
   if (y->size != size) {
     INS_ERROR("vectors must have same length", INS_EBADLEN);
   }
 
-  const size_t x_stride = x->stride;
-  const size_t y_stride = y->stride;
+  const ptrdiff_t x_stride = x->stride;
+  const ptrdiff_t y_stride = y->stride;
 
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    x->data[i * x_stride] *= y->data[i * y_stride];
+    x->data[(ptrdiff_t) i * x_stride] *= y->data[(ptrdiff_t) i * y_stride];
   }
 
   return INS_SUCCESS;
 }
 
 int INS_VECTOR_FUNC(div)(INS_VECTOR_TYPE * x, const INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(div), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
   const size_t size = x->size;
 
   if (y->size != size) {
     INS_ERROR("vectors must have same length", INS_EBADLEN);
   }
 
-  const size_t x_stride = x->stride;
-  const size_t y_stride = y->stride;
+  const ptrdiff_t x_stride = x->stride;
+  const ptrdiff_t y_stride = y->stride;
 
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    x->data[i * x_stride] /= y->data[i * y_stride];
+    x->data[(ptrdiff_t) i * x_stride] /= y->data[(ptrdiff_t) i * y_stride];
   }
 
   return INS_SUCCESS;
 }
 
 int INS_VECTOR_FUNC(scale)(INS_VECTOR_TYPE * x, INS_BASE alpha) {
+  INS_STATS(INS_VECTOR_FUNC(scale), x->size, x->stride,
+            2 * x->size * sizeof(INS_BASE));
+
   const size_t n = x->size;
-  const size_t stride = x->stride;
+  const ptrdiff_t stride = x->stride;
 
+  // The order of the elements does not matter for scaling, so a reversed
+  // vector is handed to BLAS as a forward one (BLAS ignores non-positive
+  // increments here).
 #if defined(INS_BASE_DOUBLE)
 
-  cblas_dscal(n, alpha, x->data, stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_SCALE, n)) {
+    cblas_dscal(n, alpha, INS_VECTOR_FUNC(blas_data)(x),
+                stride < 0 ? -stride : stride);
+    return INS_SUCCESS;
+  }
 
 #elif defined(INS_BASE_FLOAT)
 
-  cblas_sscal(n, alpha, x->data, stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_SCALE, n)) {
+    cblas_sscal(n, alpha, INS_VECTOR_FUNC(blas_data)(x),
+                stride < 0 ? -stride : stride);
+    return INS_SUCCESS;
+  }
 
-#else
+#endif
 
   size_t i;
 
-  for (i = 0; i < size; ++i) {
-    x->data[i * stride] *= alpha;
+  for (i = 0; i < n; ++i) {
+    x->data[(ptrdiff_t) i * stride] *= alpha;
   }
 
-#endif
-
   return INS_SUCCESS;
 }
 
 int
 INS_VECTOR_FUNC(add_constant)(INS_VECTOR_TYPE * x, INS_BASE alpha) {
+  INS_STATS(INS_VECTOR_FUNC(add_constant), x->size, x->stride,
+            2 * x->size * sizeof(INS_BASE));
+
   const size_t size = x->size;
-  const size_t stride = x->stride;
+  const ptrdiff_t stride = x->stride;
 
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    x->data[i * stride] += alpha;
+    x->data[(ptrdiff_t) i * stride] += alpha;
   }
 
   return INS_SUCCESS;
@@ -115,14 +169,17 @@ INS_VECTOR_FUNC(add_constant)(INS_VECTOR_TYPE * x, INS_BASE alpha) {
 
 INS_BASE
 INS_VECTOR_FUNC(sum)(const INS_VECTOR_TYPE * x) {
+  INS_STATS(INS_VECTOR_FUNC(sum), x->size, x->stride,
+            x->size * sizeof(INS_BASE));
+
   const size_t size = x->size;
-  const size_t stride = x->stride;
+  const ptrdiff_t stride = x->stride;
 
   size_t i;
   INS_BASE sum = INS_ZERO;
 
   for (i = 0; i < size; ++i) {
-    sum += x->data[i * stride];
+    sum += x->data[(ptrdiff_t) i * stride];
   }
 
   return sum;
@@ -132,159 +189,315 @@ int
 INS_VECTOR_FUNC(axpy)(INS_BASE alpha,
                       const INS_VECTOR_TYPE * x,
                       INS_VECTOR_TYPE * y) {
+  INS_STATS(INS_VECTOR_FUNC(axpy), x->size, x->stride,
+            3 * x->size * sizeof(INS_BASE));
+
   const size_t size = x->size;
 
   if (y->size != size) {
     INS_ERROR("vectors must have same length", INS_EBADLEN);
   }
 
-  const size_t x_stride = x->stride;
-  const size_t y_stride = y->stride;
+  const ptrdiff_t x_stride = x->stride;
+  const ptrdiff_t y_stride = y->stride;
 
 #if defined(INS_BASE_DOUBLE)
 
-  cblas_daxpy(size, alpha, x->data, x_stride, y->data, y_stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_AXPY, size)) {
+    cblas_daxpy(size, alpha, INS_VECTOR_FUNC(blas_data)(x), x_stride,
+                INS_VECTOR_FUNC(blas_data)(y), y_stride);
+    return INS_SUCCESS;
+  }
 
 #elif defined(INS_BASE_FLOAT)
 
-  cblas_saxpy(size, alpha, x->data, x_stride, y->data, y_stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_AXPY, size)) {
+    cblas_saxpy(size, alpha, INS_VECTOR_FUNC(blas_data)(x), x_stride,
+                INS_VECTOR_FUNC(blas_data)(y), y_stride);
+    return INS_SUCCESS;
+  }
 
-#else
+#endif
 
   size_t i ;
 
   for (i = 0; i < size; ++i) {
-    y->data[i * y_stride] += alpha * x->data[i * x_stride];
+    y->data[(ptrdiff_t) i * y_stride] +=
+      alpha * x->data[(ptrdiff_t) i * x_stride];
   }
 
-#endif
-
   return INS_SUCCESS;
 }
 
 int INS_VECTOR_FUNC(swap)(INS_VECTOR_TYPE * v, INS_VECTOR_TYPE * w) {
+  INS_STATS(INS_VECTOR_FUNC(swap), v->size, v->stride,
+            4 * v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
 
   if (w->size != size) {
     INS_ERROR("vectors must have same length", INS_EINVAL);
   }
 
-  const size_t v_stride = v->stride;
-  const size_t w_stride = w->stride;
-
-  INS_BASE * const v_data = v->data;
-  INS_BASE * const w_data = w->data;
+  const ptrdiff_t v_stride = v->stride;
+  const ptrdiff_t w_stride = w->stride;
 
 #if defined(INS_BASE_DOUBLE)
 
-  cblas_dswap(size, v_data, v_stride, w_data, w_stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_SWAP, size)) {
+    cblas_dswap(size, INS_VECTOR_FUNC(blas_data)(v), v_stride,
+                INS_VECTOR_FUNC(blas_data)(w), w_stride);
+    return INS_SUCCESS;
+  }
 
 #elif defined(INS_BASE_FLOAT)
 
-  cblas_sswap(size, v_data, v_stride, w_data, w_stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_SWAP, size)) {
+    cblas_sswap(size, INS_VECTOR_FUNC(blas_data)(v), v_stride,
+                INS_VECTOR_FUNC(blas_data)(w), w_stride);
+    return INS_SUCCESS;
+  }
 
-#else
+#endif
+
+  INS_BASE * const v_data = v->data;
+  INS_BASE * const w_data = w->data;
 
   size_t i;
   INS_BASE tmp;
 
   for (i = 0; i < size; ++i) {
-    tmp = v_data[i * v_stride];
-    v_data[i * v_stride] = w_data[i * w_stride];
-    w_data[i * w_stride] = tmp;
+    tmp = v_data[(ptrdiff_t) i * v_stride];
+    v_data[(ptrdiff_t) i * v_stride] = w_data[(ptrdiff_t) i * w_stride];
+    w_data[(ptrdiff_t) i * w_stride] = tmp;
   }
 
-#endif
-
   return INS_SUCCESS;
 }
 
 int
 INS_VECTOR_FUNC(copy)(INS_VECTOR_TYPE *dst, const INS_VECTOR_TYPE *src) {
+  INS_STATS(INS_VECTOR_FUNC(copy), src->size, src->stride,
+            2 * src->size * sizeof(INS_BASE));
+
   const size_t size = src->size;
 
   if (dst->size != size) {
     INS_ERROR("vectors must have same length", INS_EINVAL);
   }
 
-  const size_t src_stride = src->stride;
-  const size_t dst_stride = dst->stride;
-
-  const INS_BASE * src_data = src->data;
-  INS_BASE * const dst_data = dst->data;
+  const ptrdiff_t src_stride = src->stride;
+  const ptrdiff_t dst_stride = dst->stride;
 
 #if defined(INS_BASE_DOUBLE)
 
-  cblas_dcopy(size, src_data, src_stride, dst_data, dst_stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_COPY, size)) {
+    cblas_dcopy(size, INS_VECTOR_FUNC(blas_data)(src), src_stride,
+                INS_VECTOR_FUNC(blas_data)(dst), dst_stride);
+    return INS_SUCCESS;
+  }
 
 #elif defined(INS_BASE_FLOAT)
 
-  cblas_scopy(size, src_data, src_stride, dst_data, dst_stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_COPY, size)) {
+    cblas_scopy(size, INS_VECTOR_FUNC(blas_data)(src), src_stride,
+                INS_VECTOR_FUNC(blas_data)(dst), dst_stride);
+    return INS_SUCCESS;
+  }
 
-#else
+#endif
+
+  const INS_BASE * src_data = src->data;
+  INS_BASE * const dst_data = dst->data;
 
   size_t i;
 
   for (i = 0; i < size; ++i) {
-    dst_data[i * dst_stride] = src_data[i * src_stride];
+    dst_data[(ptrdiff_t) i * dst_stride] =
+      src_data[(ptrdiff_t) i * src_stride];
   }
 
-#endif
-
   return INS_SUCCESS;
 }
 
 INS_BASE
 INS_VECTOR_FUNC(dot)(const INS_VECTOR_TYPE *v, const INS_VECTOR_TYPE *w) {
+  INS_STATS(INS_VECTOR_FUNC(dot), v->size, v->stride,
+            2 * v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
 
   if (w->size != size) {
     INS_ERROR("vectors must have same length", INS_EINVAL);
   }
 
-  const size_t v_stride = v->stride;
-  const size_t w_stride = w->stride;
-
-  const INS_BASE * v_data = v->data;
-  const INS_BASE * w_data = w->data;
+  const ptrdiff_t v_stride = v->stride;
+  const ptrdiff_t w_stride = w->stride;
 
 #if defined(INS_BASE_DOUBLE)
 
-  return cblas_ddot(size, v_data, v_stride, w_data, w_stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_DOT, size)) {
+    return cblas_ddot(size, INS_VECTOR_FUNC(blas_data)(v), v_stride,
+                      INS_VECTOR_FUNC(blas_data)(w), w_stride);
+  }
 
 #elif defined(INS_BASE_FLOAT)
 
-  return cblas_sdot(size, v_data, v_stride, w_data, w_stride);
+  if (INS_VECTOR_FUNC(use_blas)(INS_TUNING_DOT, size)) {
+    return cblas_sdot(size, INS_VECTOR_FUNC(blas_data)(v), v_stride,
+                      INS_VECTOR_FUNC(blas_data)(w), w_stride);
+  }
 
-#else
+#endif
+
+  const INS_BASE * v_data = v->data;
+  const INS_BASE * w_data = w->data;
 
   size_t i;
   INS_BASE ret = INS_ZERO;
 
   for (i = 0; i < size; ++i) {
-    ret += v_data[i * v_stride] * w_data[i * w_stride];
+    ret += v_data[(ptrdiff_t) i * v_stride] * w_data[(ptrdiff_t) i * w_stride];
   }
 
   return ret;
+}
 
-#endif
+#if defined(INS_BASE_INT)
+
+double
+INS_VECTOR_FUNC(nrm2)(const INS_VECTOR_TYPE *v) {
+  INS_STATS(INS_VECTOR_FUNC(nrm2), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+  const ptrdiff_t stride = v->stride;
+  const INS_BASE * data = v->data;
+
+  size_t i;
+  double ret = 0.0;
+
+  // The squares are accumulated in double precision, since they would
+  // quickly overflow an `int`.
+  for (i = 0; i < size; ++i) {
+    const double cur = data[(ptrdiff_t) i * stride];
+    ret += cur * cur;
+  }
+
+  return sqrt(ret);
 }
 
+#else
+
 INS_BASE
 INS_VECTOR_FUNC(nrm2)(const INS_VECTOR_TYPE *v) {
+  INS_STATS(INS_VECTOR_FUNC(nrm2), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
   const size_t size = v->size;
-  const size_t stride = v->stride;
-  const INS_BASE * data = v->data;
+  const ptrdiff_t stride = v->stride;
 
 #if defined(INS_BASE_DOUBLE)
 
-  return cblas_dnrm2(size, data, stride);
+  return cblas_dnrm2(size, INS_VECTOR_FUNC(blas_data)(v),
+                     stride < 0 ? -stride : stride);
 
 #elif defined(INS_BASE_FLOAT)
 
-  return cblas_snrm2(size, data, stride);
+  return cblas_snrm2(size, INS_VECTOR_FUNC(blas_data)(v),
+                     stride < 0 ? -stride : stride);
 
 #else
 #error Unsupport operation
 #endif
 }
+
+#endif
+
+#if defined(INS_BASE_FLOAT)
+
+double
+INS_VECTOR_FUNC(dsum)(const INS_VECTOR_TYPE * x) {
+  INS_STATS(INS_VECTOR_FUNC(dsum), x->size, x->stride,
+            x->size * sizeof(INS_BASE));
+
+  const size_t size = x->size;
+  const ptrdiff_t stride = x->stride;
+  const INS_BASE * data = x->data;
+
+  double sum0 = 0.0;
+  double sum1 = 0.0;
+  double sum2 = 0.0;
+  double sum3 = 0.0;
+
+  size_t i = 0;
+
+  // Four independent accumulators let the compiler widen and add four
+  // contiguous elements per vector instruction.
+  if (stride == 1) {
+    for (; i + 4 <= size; i += 4) {
+      sum0 += (double) data[i];
+      sum1 += (double) data[i + 1];
+      sum2 += (double) data[i + 2];
+      sum3 += (double) data[i + 3];
+    }
+  }
+
+  for (; i < size; ++i) {
+    sum0 += (double) data[(ptrdiff_t) i * stride];
+  }
+
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+double
+INS_VECTOR_FUNC(dsdot)(const INS_VECTOR_TYPE *v, const INS_VECTOR_TYPE *w) {
+  INS_STATS(INS_VECTOR_FUNC(dsdot), v->size, v->stride,
+            2 * v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+
+  if (w->size != size) {
+    INS_ERROR("vectors must have same length", INS_EINVAL);
+  }
+
+  return cblas_dsdot(size, INS_VECTOR_FUNC(blas_data)(v), v->stride,
+                     INS_VECTOR_FUNC(blas_data)(w), w->stride);
+}
+
+double
+INS_VECTOR_FUNC(dnrm2)(const INS_VECTOR_TYPE *v) {
+  INS_STATS(INS_VECTOR_FUNC(dnrm2), v->size, v->stride,
+            v->size * sizeof(INS_BASE));
+
+  const size_t size = v->size;
+  const ptrdiff_t stride = v->stride;
+  const INS_BASE * data = v->data;
+
+  double sum0 = 0.0;
+  double sum1 = 0.0;
+  double sum2 = 0.0;
+  double sum3 = 0.0;
+
+  size_t i = 0;
+
+  // The square of a float cannot overflow a double, so the squares are
+  // summed directly without the scaling that `cblas_snrm2` needs.
+  if (stride == 1) {
+    for (; i + 4 <= size; i += 4) {
+      sum0 += (double) data[i] * data[i];
+      sum1 += (double) data[i + 1] * data[i + 1];
+      sum2 += (double) data[i + 2] * data[i + 2];
+      sum3 += (double) data[i + 3] * data[i + 3];
+    }
+  }
+
+  for (; i < size; ++i) {
+    const double cur = data[(ptrdiff_t) i * stride];
+    sum0 += cur * cur;
+  }
+
+  return sqrt((sum0 + sum1) + (sum2 + sum3));
+}
+
+#endif
@@ -0,0 +1,277 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ins/ins_vector.h"
+#include "ins/ins_shm.h"
+#include "ins/ins_stats_io.h"
+
+// The header at the start of a segment, laid out as in `ins/ins_shm.h`.
+typedef struct {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t type;
+  uint32_t elem_size;
+  uint32_t reserved;
+  uint64_t count;
+  uint64_t epoch;
+  unsigned char padding[24];
+} ins_shm_header;
+
+static const unsigned char ins_shm_magic[8] = {
+  0x89, 'I', 'N', 'S', 'S', 'H', 'M', '\n'
+};
+
+// A segment mapping owned by a block: the header at the start of the
+// mapping, the length of the mapping, and whether it is writable.
+typedef struct {
+  ins_shm_header * header;
+  size_t length;
+  int writable;
+} ins_shm_mapping;
+
+// Block `release` function for shared-memory blocks.
+static void ins_shm_release(void * data, void * release_ctx) {
+  ins_shm_mapping * mapping = (ins_shm_mapping *) release_ctx;
+
+  (void) data;
+
+  munmap(mapping->header, mapping->length);
+  free(mapping);
+}
+
+// Creates the segment `name` for `count` elements of type `type`, each
+// `elem_size` bytes and all zero, maps it read-write and returns the
+// mapping. Calls the error handler and returns 0 on failure.
+static ins_shm_mapping * ins_shm_create(const char * name,
+                                        const uint32_t type,
+                                        const size_t elem_size,
+                                        const size_t count) {
+  ins_shm_mapping * mapping;
+  ins_shm_header * header;
+  uint64_t magic;
+  size_t length;
+  void * addr;
+  int fd;
+
+  if (count > (SIZE_MAX - INS_SHM_HEADER_SIZE) / elem_size) {
+    INS_ERROR_VAL("vector is too large to be shared", INS_EINVAL, 0);
+  }
+
+  length = INS_SHM_HEADER_SIZE + count * elem_size;
+
+  mapping = (ins_shm_mapping *) malloc(sizeof(ins_shm_mapping));
+
+  if (mapping == 0) {
+    INS_ERROR_VAL("failed to allocate space for mapping", INS_ENOMEM, 0);
+  }
+
+  // An existing segment is never taken over, since its readers would see
+  // its elements change type or length under them.
+  fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+
+  if (fd < 0) {
+    free(mapping);
+    INS_ERROR_VAL("failed to create shared-memory segment", INS_EFAILED, 0);
+  }
+
+  // The new segment reads as zeros, so the elements start zeroed.
+  if (ftruncate(fd, (off_t) length) != 0) {
+    close(fd);
+    shm_unlink(name);
+    free(mapping);
+    INS_ERROR_VAL("ftruncate failed", INS_EFAILED, 0);
+  }
+
+  addr = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  // The mapping keeps its own reference to the segment.
+  close(fd);
+
+  if (addr == MAP_FAILED) {
+    shm_unlink(name);
+    free(mapping);
+    INS_ERROR_VAL("mmap failed", INS_EFAILED, 0);
+  }
+
+  header = (ins_shm_header *) addr;
+  header->version = INS_SHM_VERSION;
+  header->type = type;
+  header->elem_size = (uint32_t) elem_size;
+  header->count = count;
+
+  // The magic is stored last, so that a process opening the segment while
+  // it is being created sees either no header or the whole of it.
+  memcpy(&magic, ins_shm_magic, sizeof(magic));
+  __atomic_store_n(&header->magic, magic, __ATOMIC_RELEASE);
+
+  mapping->header = header;
+  mapping->length = length;
+  mapping->writable = 1;
+
+  return mapping;
+}
+
+// Maps the segment `name` read-only, checks that it holds elements of type
+// `type`, each `elem_size` bytes, and returns the mapping. Calls the error
+// handler and returns 0 on failure.
+static ins_shm_mapping * ins_shm_open(const char * name,
+                                      const uint32_t type,
+                                      const size_t elem_size) {
+  ins_shm_mapping * mapping;
+  ins_shm_header * header;
+  struct stat st;
+  uint64_t magic;
+  void * addr;
+  int fd;
+
+  fd = shm_open(name, O_RDONLY, 0);
+
+  if (fd < 0) {
+    INS_ERROR_VAL("failed to open shared-memory segment", INS_EFAILED, 0);
+  }
+
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    INS_ERROR_VAL("fstat failed", INS_EFAILED, 0);
+  }
+
+  if ((size_t) st.st_size < INS_SHM_HEADER_SIZE) {
+    close(fd);
+    INS_ERROR_VAL("not a shared-memory vector", INS_EINVAL, 0);
+  }
+
+  addr = mmap(0, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+  close(fd);
+
+  if (addr == MAP_FAILED) {
+    INS_ERROR_VAL("mmap failed", INS_EFAILED, 0);
+  }
+
+  header = (ins_shm_header *) addr;
+  magic = __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE);
+
+  if (memcmp(&magic, ins_shm_magic, sizeof(magic)) != 0) {
+    munmap(addr, (size_t) st.st_size);
+    INS_ERROR_VAL("not a shared-memory vector", INS_EINVAL, 0);
+  }
+
+  if (header->version > INS_SHM_VERSION) {
+    munmap(addr, (size_t) st.st_size);
+    INS_ERROR_VAL("unsupported shared-memory version", INS_EUNSUP, 0);
+  }
+
+  if (header->type != type || header->elem_size != elem_size) {
+    munmap(addr, (size_t) st.st_size);
+    INS_ERROR_VAL("shared-memory element type does not match",
+                  INS_EINVAL, 0);
+  }
+
+  if (header->count > ((size_t) st.st_size - INS_SHM_HEADER_SIZE)
+                      / elem_size) {
+    munmap(addr, (size_t) st.st_size);
+    INS_ERROR_VAL("shared-memory segment is too short", INS_EINVAL, 0);
+  }
+
+  mapping = (ins_shm_mapping *) malloc(sizeof(ins_shm_mapping));
+
+  if (mapping == 0) {
+    munmap(addr, (size_t) st.st_size);
+    INS_ERROR_VAL("failed to allocate space for mapping", INS_ENOMEM, 0);
+  }
+
+  mapping->header = header;
+  mapping->length = (size_t) st.st_size;
+  mapping->writable = 0;
+
+  return mapping;
+}
+
+// Returns the mapping of the shared-memory block with the release function
+// `release` and its context `release_ctx`. Calls the error handler and
+// returns 0 if the block is not in shared memory.
+static ins_shm_mapping * ins_shm_mapping_of(void (*release)(void *, void *),
+                                            void * release_ctx) {
+  if (release != ins_shm_release) {
+    INS_ERROR_VAL("vector is not in shared memory", INS_EINVAL, 0);
+  }
+
+  return (ins_shm_mapping *) release_ctx;
+}
+
+// The publisher stores the epoch in relaxed order and then fences, so that
+// a reader that sees a store to an element also sees the odd epoch, and
+// ends an update with a release store, so that a reader that sees the even
+// epoch also sees the elements.
+static int ins_shm_begin_publish(ins_shm_mapping * mapping) {
+  uint64_t epoch;
+
+  if (!mapping->writable) {
+    INS_ERROR("shared-memory vector is read-only", INS_EINVAL);
+  }
+
+  epoch = __atomic_load_n(&mapping->header->epoch, __ATOMIC_RELAXED);
+
+  if (epoch % 2 != 0) {
+    INS_ERROR("an update is already being published", INS_EINVAL);
+  }
+
+  __atomic_store_n(&mapping->header->epoch, epoch + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  return INS_SUCCESS;
+}
+
+static int ins_shm_end_publish(ins_shm_mapping * mapping) {
+  uint64_t epoch;
+
+  if (!mapping->writable) {
+    INS_ERROR("shared-memory vector is read-only", INS_EINVAL);
+  }
+
+  epoch = __atomic_load_n(&mapping->header->epoch, __ATOMIC_RELAXED);
+
+  if (epoch % 2 == 0) {
+    INS_ERROR("no update is being published", INS_EINVAL);
+  }
+
+  __atomic_store_n(&mapping->header->epoch, epoch + 1, __ATOMIC_RELEASE);
+
+  return INS_SUCCESS;
+}
+
+// The fence orders the reads of the elements before the load, for the
+// check that follows them.
+static uint64_t ins_shm_epoch(const ins_shm_mapping * mapping) {
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&mapping->header->epoch, __ATOMIC_ACQUIRE);
+}
+
+int ins_shm_unlink(const char * name) {
+  if (shm_unlink(name) != 0) {
+    INS_ERROR("failed to remove shared-memory segment", INS_EFAILED);
+  }
+
+  return INS_SUCCESS;
+}
+
+#define INS_BASE_DOUBLE
+#include "ins/templates_on.h"
+#include "ins/vector/shm_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/shm_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/vector/shm_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
@@ -0,0 +1,118 @@
+// Template for shared-memory ins_vector_[atomic] types.
+
+// Returns a vector over the elements of `mapping`, which it then owns.
+// Calls the error handler, unmaps the segment and returns 0 on failure.
+static INS_VECTOR_TYPE *
+INS_VECTOR_FUNC(shm_vector)(ins_shm_mapping * mapping) {
+  const size_t n = (size_t) mapping->header->count;
+
+  INS_BLOCK_TYPE * block;
+  INS_VECTOR_TYPE * vector;
+
+  block = (INS_BLOCK_TYPE *) malloc(sizeof(INS_BLOCK_TYPE));
+
+  if (block == 0) {
+    ins_shm_release(0, mapping);
+    INS_ERROR_VAL("failed to allocate space for block struct", INS_ENOMEM, 0);
+  }
+
+  block->size = n;
+  block->data = (INS_ATOMIC *) ((char *) mapping->header
+                                + INS_SHM_HEADER_SIZE);
+  block->release = ins_shm_release;
+  block->release_ctx = mapping;
+  block->tag = 0;
+  block->allocator = 0;
+
+  vector = (INS_VECTOR_TYPE *) malloc(sizeof(INS_VECTOR_TYPE));
+
+  if (vector == 0) {
+    INS_BLOCK_FUNC(free)(block);
+    INS_ERROR_VAL("failed to allocate space for vector", INS_ENOMEM, 0);
+  }
+
+  vector->size = n;
+  vector->stride = 1;
+  vector->data = block->data;
+  vector->block = block;
+  vector->owner = 1;
+
+  return vector;
+}
+
+// Returns the mapping of the segment that `v` is a view of. Calls the error
+// handler and returns 0 if `v` is not in shared memory.
+static ins_shm_mapping *
+INS_VECTOR_FUNC(shm_mapping)(const INS_VECTOR_TYPE * v) {
+  if (v->block == 0) {
+    INS_ERROR_VAL("vector is not in shared memory", INS_EINVAL, 0);
+  }
+
+  return ins_shm_mapping_of(v->block->release, v->block->release_ctx);
+}
+
+INS_VECTOR_TYPE * INS_VECTOR_FUNC(shm_create)(const char * name,
+                                              const size_t n) {
+  INS_STATS(INS_VECTOR_FUNC(shm_create), n, 1, 0);
+
+  ins_shm_mapping * mapping =
+      ins_shm_create(name, INS_TYPE_ID,
+                     INS_MULTIPLICITY * sizeof(INS_ATOMIC), n);
+
+  if (mapping == 0) {
+    return 0;
+  }
+
+  return INS_VECTOR_FUNC(shm_vector)(mapping);
+}
+
+INS_VECTOR_TYPE * INS_VECTOR_FUNC(shm_open)(const char * name) {
+  INS_STATS(INS_VECTOR_FUNC(shm_open), 0, 1, 0);
+
+  ins_shm_mapping * mapping =
+      ins_shm_open(name, INS_TYPE_ID, INS_MULTIPLICITY * sizeof(INS_ATOMIC));
+
+  if (mapping == 0) {
+    return 0;
+  }
+
+  return INS_VECTOR_FUNC(shm_vector)(mapping);
+}
+
+int INS_VECTOR_FUNC(shm_epoch)(const INS_VECTOR_TYPE * v, uint64_t * epoch) {
+  INS_STATS(INS_VECTOR_FUNC(shm_epoch), v->size, v->stride, 0);
+
+  const ins_shm_mapping * mapping = INS_VECTOR_FUNC(shm_mapping)(v);
+
+  if (mapping == 0) {
+    return INS_EINVAL;
+  }
+
+  *epoch = ins_shm_epoch(mapping);
+
+  return INS_SUCCESS;
+}
+
+int INS_VECTOR_FUNC(shm_begin_publish)(INS_VECTOR_TYPE * v) {
+  INS_STATS(INS_VECTOR_FUNC(shm_begin_publish), v->size, v->stride, 0);
+
+  ins_shm_mapping * mapping = INS_VECTOR_FUNC(shm_mapping)(v);
+
+  if (mapping == 0) {
+    return INS_EINVAL;
+  }
+
+  return ins_shm_begin_publish(mapping);
+}
+
+int INS_VECTOR_FUNC(shm_end_publish)(INS_VECTOR_TYPE * v) {
+  INS_STATS(INS_VECTOR_FUNC(shm_end_publish), v->size, v->stride, 0);
+
+  ins_shm_mapping * mapping = INS_VECTOR_FUNC(shm_mapping)(v);
+
+  if (mapping == 0) {
+    return INS_EINVAL;
+  }
+
+  return ins_shm_end_publish(mapping);
+}
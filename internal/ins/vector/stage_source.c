@@ -0,0 +1,77 @@
+// Template for moving strided ins_vector_[atomic] elements to and from a
+// contiguous staging buffer. The loops are unrolled by four so that the
+// independent loads and stores of consecutive elements overlap; unit and
+// reversed unit strides (after the complex multiplicity) are plain copies
+// the compiler vectorizes.
+
+// Copies `count` elements of the vector `v` starting at index `offset` into
+// the contiguous buffer `buf`.
+static void
+INS_VECTOR_FUNC(gather)(const INS_VECTOR_TYPE * v, const size_t offset,
+                        const size_t count, INS_BASE * buf) {
+  const ptrdiff_t stride = v->stride;
+  const ptrdiff_t step = INS_MULTIPLICITY * stride;
+  const INS_ATOMIC * data = v->data + (ptrdiff_t) offset * step;
+
+  size_t i = 0;
+
+  if (stride == 1) {
+    memcpy(buf, data, count * sizeof(INS_BASE));
+    return;
+  }
+
+  if (stride == -1) {
+    for (i = 0; i < count; ++i) {
+      buf[i] = *(const INS_BASE *) (data - (ptrdiff_t) i * INS_MULTIPLICITY);
+    }
+    return;
+  }
+
+  for (; i + 4 <= count; i += 4) {
+    const INS_ATOMIC * p = data + (ptrdiff_t) i * step;
+    buf[i] = *(const INS_BASE *) p;
+    buf[i + 1] = *(const INS_BASE *) (p + step);
+    buf[i + 2] = *(const INS_BASE *) (p + 2 * step);
+    buf[i + 3] = *(const INS_BASE *) (p + 3 * step);
+  }
+
+  for (; i < count; ++i) {
+    buf[i] = *(const INS_BASE *) (data + (ptrdiff_t) i * step);
+  }
+}
+
+// Copies `count` elements from the contiguous buffer `buf` into the vector
+// `v` starting at index `offset`.
+static void
+INS_VECTOR_FUNC(scatter)(INS_VECTOR_TYPE * v, const size_t offset,
+                         const size_t count, const INS_BASE * buf) {
+  const ptrdiff_t stride = v->stride;
+  const ptrdiff_t step = INS_MULTIPLICITY * stride;
+  INS_ATOMIC * data = v->data + (ptrdiff_t) offset * step;
+
+  size_t i = 0;
+
+  if (stride == 1) {
+    memcpy(data, buf, count * sizeof(INS_BASE));
+    return;
+  }
+
+  if (stride == -1) {
+    for (i = 0; i < count; ++i) {
+      *(INS_BASE *) (data - (ptrdiff_t) i * INS_MULTIPLICITY) = buf[i];
+    }
+    return;
+  }
+
+  for (; i + 4 <= count; i += 4) {
+    INS_ATOMIC * p = data + (ptrdiff_t) i * step;
+    *(INS_BASE *) p = buf[i];
+    *(INS_BASE *) (p + step) = buf[i + 1];
+    *(INS_BASE *) (p + 2 * step) = buf[i + 2];
+    *(INS_BASE *) (p + 3 * step) = buf[i + 3];
+  }
+
+  for (; i < count; ++i) {
+    *(INS_BASE *) (data + (ptrdiff_t) i * step) = buf[i];
+  }
+}
@@ -0,0 +1,23 @@
+#include <math.h>
+#include <stdint.h>
+#include "ins/ins_vector.h"
+#include "ins/ins_stream_io.h"
+#include "ins/ins_stats_io.h"
+
+#define INS_BASE_DOUBLE
+#include "ins/templates_on.h"
+#include "ins/vector/stream_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_DOUBLE
+
+#define INS_BASE_FLOAT
+#include "ins/templates_on.h"
+#include "ins/vector/stream_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_FLOAT
+
+#define INS_BASE_INT
+#include "ins/templates_on.h"
+#include "ins/vector/stream_source.c"
+#include "ins/templates_off.h"
+#undef INS_BASE_INT
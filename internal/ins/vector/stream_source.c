@@ -0,0 +1,312 @@
+// Template for reductions over ins_vector_[atomic] elements stored in a
+// file. The file is streamed in chunks (see `ins/ins_stream_io.h`), each
+// chunk is reduced with the in-memory kernel of the type through a vector
+// view, and the partial results are combined.
+
+#if defined(INS_BASE_INT)
+#define INS_NRM2_TYPE double
+#else
+#define INS_NRM2_TYPE INS_BASE
+#endif
+
+// Returns a vector view of the `nbytes` bytes of a chunk.
+static INS_VECTOR_TYPE INS_VECTOR_FUNC(stream_view)(const void * data,
+                                                    const size_t nbytes) {
+  INS_VECTOR_TYPE view;
+
+  view.size = nbytes / sizeof(INS_BASE);
+  view.stride = 1;
+  view.data = (INS_ATOMIC *) data;
+  view.block = 0;
+  view.owner = 0;
+
+  return view;
+}
+
+// Opens the `n` elements at byte `offset` of the file at `path`.
+static int INS_VECTOR_FUNC(stream_open)(ins_stream * stream,
+                                        const char * path,
+                                        const size_t offset,
+                                        const size_t n) {
+  if (n > SIZE_MAX / sizeof(INS_BASE)) {
+    INS_ERROR("vector is too large", INS_EINVAL);
+  }
+
+  return ins_stream_open(stream, path, offset, n * sizeof(INS_BASE),
+                         sizeof(INS_BASE));
+}
+
+int INS_VECTOR_FUNC(file_sum)(const char * path, const size_t offset,
+                              const size_t n, INS_BASE * result) {
+  INS_STATS(INS_VECTOR_FUNC(file_sum), n, 1, n * sizeof(INS_BASE));
+
+  INS_BASE sum = INS_ZERO;
+
+  ins_stream stream;
+  const void * data;
+  size_t nbytes;
+  int status;
+
+  status = INS_VECTOR_FUNC(stream_open)(&stream, path, offset, n);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  while ((status = ins_stream_next(&stream, &data, &nbytes)) == INS_SUCCESS &&
+         nbytes > 0) {
+    const INS_VECTOR_TYPE view = INS_VECTOR_FUNC(stream_view)(data, nbytes);
+    sum += INS_VECTOR_FUNC(sum)(&view);
+  }
+
+  ins_stream_close(&stream);
+
+  if (status == INS_SUCCESS) {
+    *result = sum;
+  }
+
+  return status;
+}
+
+int INS_VECTOR_FUNC(file_dot)(const char * x_path, const size_t x_offset,
+                              const char * y_path, const size_t y_offset,
+                              const size_t n, INS_BASE * result) {
+  INS_STATS(INS_VECTOR_FUNC(file_dot), n, 1, 2 * n * sizeof(INS_BASE));
+
+  INS_BASE dot = INS_ZERO;
+
+  ins_stream x_stream;
+  ins_stream y_stream;
+  const void * x_data;
+  const void * y_data;
+  size_t x_nbytes;
+  size_t y_nbytes;
+  int status;
+
+  status = INS_VECTOR_FUNC(stream_open)(&x_stream, x_path, x_offset, n);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  status = INS_VECTOR_FUNC(stream_open)(&y_stream, y_path, y_offset, n);
+  if (status != INS_SUCCESS) {
+    ins_stream_close(&x_stream);
+    return status;
+  }
+
+  // Both streams have the same chunk size, so their chunks line up.
+  for (;;) {
+    status = ins_stream_next(&x_stream, &x_data, &x_nbytes);
+    if (status == INS_SUCCESS) {
+      status = ins_stream_next(&y_stream, &y_data, &y_nbytes);
+    }
+
+    if (status != INS_SUCCESS || x_nbytes == 0) {
+      break;
+    }
+
+    const INS_VECTOR_TYPE x = INS_VECTOR_FUNC(stream_view)(x_data, x_nbytes);
+    const INS_VECTOR_TYPE y = INS_VECTOR_FUNC(stream_view)(y_data, y_nbytes);
+    dot += INS_VECTOR_FUNC(dot)(&x, &y);
+  }
+
+  ins_stream_close(&y_stream);
+  ins_stream_close(&x_stream);
+
+  if (status == INS_SUCCESS) {
+    *result = dot;
+  }
+
+  return status;
+}
+
+int INS_VECTOR_FUNC(file_nrm2)(const char * path, const size_t offset,
+                               const size_t n, INS_NRM2_TYPE * result) {
+  INS_STATS(INS_VECTOR_FUNC(file_nrm2), n, 1, n * sizeof(INS_BASE));
+
+  // The partial norms are combined as `scale * sqrt(ssq)`, rescaled by the
+  // largest partial norm so far, so that squaring them cannot overflow.
+  double scale = 0.0;
+  double ssq = 1.0;
+
+  ins_stream stream;
+  const void * data;
+  size_t nbytes;
+  int status;
+
+  status = INS_VECTOR_FUNC(stream_open)(&stream, path, offset, n);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  while ((status = ins_stream_next(&stream, &data, &nbytes)) == INS_SUCCESS &&
+         nbytes > 0) {
+    const INS_VECTOR_TYPE view = INS_VECTOR_FUNC(stream_view)(data, nbytes);
+    const double norm = (double) INS_VECTOR_FUNC(nrm2)(&view);
+
+    // An infinite partial norm cannot be rescaled, so once the norm is
+    // infinite it stays so, unless a NaN follows.
+    if (isnan(norm)) {
+      scale = norm;
+    } else if (!isfinite(scale)) {
+      continue;
+    } else if (isinf(norm)) {
+      scale = norm;
+      ssq = 1.0;
+    } else if (norm > scale) {
+      ssq = 1.0 + ssq * (scale / norm) * (scale / norm);
+      scale = norm;
+    } else if (norm > 0.0) {
+      ssq += (norm / scale) * (norm / scale);
+    }
+  }
+
+  ins_stream_close(&stream);
+
+  if (status == INS_SUCCESS) {
+    *result = (INS_NRM2_TYPE) (scale * sqrt(ssq));
+  }
+
+  return status;
+}
+
+int INS_VECTOR_FUNC(file_minmax)(const char * path, const size_t offset,
+                                 const size_t n, INS_BASE * min_out,
+                                 INS_BASE * max_out) {
+  INS_STATS(INS_VECTOR_FUNC(file_minmax), n, 1, n * sizeof(INS_BASE));
+
+  INS_BASE min = INS_ZERO;
+  INS_BASE max = INS_ZERO;
+
+  ins_stream stream;
+  const void * data;
+  size_t nbytes;
+  size_t seen = 0;
+  int status;
+
+  if (n == 0) {
+    INS_ERROR("vector must not be empty", INS_EINVAL);
+  }
+
+  status = INS_VECTOR_FUNC(stream_open)(&stream, path, offset, n);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  while ((status = ins_stream_next(&stream, &data, &nbytes)) == INS_SUCCESS &&
+         nbytes > 0) {
+    const INS_VECTOR_TYPE view = INS_VECTOR_FUNC(stream_view)(data, nbytes);
+    INS_BASE chunk_min;
+    INS_BASE chunk_max;
+
+    INS_VECTOR_FUNC(minmax)(&view, &chunk_min, &chunk_max);
+
+    if (seen == 0 || chunk_min < min) {
+      min = chunk_min;
+    }
+
+    if (seen == 0 || chunk_max > max) {
+      max = chunk_max;
+    }
+
+    seen += view.size;
+
+#ifdef INS_FLOATING_POINT
+
+    // A NaN is the result as soon as one is found, as in memory.
+    if (isnan(chunk_min)) {
+      min = chunk_min;
+      max = chunk_max;
+      break;
+    }
+
+#endif
+
+  }
+
+  ins_stream_close(&stream);
+
+  if (status == INS_SUCCESS) {
+    *min_out = min;
+    *max_out = max;
+  }
+
+  return status;
+}
+
+int INS_VECTOR_FUNC(file_minmax_index)(const char * path,
+                                       const size_t offset, const size_t n,
+                                       size_t * imin_out, size_t * imax_out) {
+  INS_STATS(INS_VECTOR_FUNC(file_minmax_index), n, 1, n * sizeof(INS_BASE));
+
+  INS_BASE min = INS_ZERO;
+  INS_BASE max = INS_ZERO;
+  size_t imin = 0;
+  size_t imax = 0;
+
+  ins_stream stream;
+  const void * data;
+  size_t nbytes;
+  size_t seen = 0;
+  int status;
+
+  if (n == 0) {
+    INS_ERROR("vector must not be empty", INS_EINVAL);
+  }
+
+  status = INS_VECTOR_FUNC(stream_open)(&stream, path, offset, n);
+  if (status != INS_SUCCESS) {
+    return status;
+  }
+
+  while ((status = ins_stream_next(&stream, &data, &nbytes)) == INS_SUCCESS &&
+         nbytes > 0) {
+    const INS_VECTOR_TYPE view = INS_VECTOR_FUNC(stream_view)(data, nbytes);
+    const INS_BASE * values = (const INS_BASE *) data;
+    size_t chunk_imin;
+    size_t chunk_imax;
+
+    INS_VECTOR_FUNC(minmax_index)(&view, &chunk_imin, &chunk_imax);
+
+    // Chunk indices are offset by the elements of the previous chunks.
+    // Strict comparisons keep the lowest index of equal elements.
+    if (seen == 0 || values[chunk_imin] < min) {
+      min = values[chunk_imin];
+      imin = seen + chunk_imin;
+    }
+
+    if (seen == 0 || values[chunk_imax] > max) {
+      max = values[chunk_imax];
+      imax = seen + chunk_imax;
+    }
+
+#ifdef INS_FLOATING_POINT
+
+    if (isnan(values[chunk_imin])) {
+      imin = seen + chunk_imin;
+      imax = imin;
+      break;
+    }
+
+#endif
+
+    seen += view.size;
+  }
+
+  ins_stream_close(&stream);
+
+  if (status == INS_SUCCESS) {
+    *imin_out = imin;
+    *imax_out = imax;
+  }
+
+  return status;
+}
+
+int INS_VECTOR_FUNC(file_max_index)(const char * path, const size_t offset,
+                                    const size_t n, size_t * imax_out) {
+  size_t imin;
+
+  return INS_VECTOR_FUNC(file_minmax_index)(path, offset, n, &imin, imax_out);
+}
+
+#undef INS_NRM2_TYPE
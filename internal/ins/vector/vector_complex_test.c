@@ -0,0 +1,199 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <math.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+
+static ins_complex make_complex(double re, double im) {
+  ins_complex z;
+  INS_SET_COMPLEX(&z, re, im);
+  return z;
+}
+
+static void test_alloc_success(void **state) {
+  (void) state;
+
+  ins_vector_complex *v = ins_vector_complex_calloc(3);
+  assert_non_null(v);
+  assert_int_equal(v->size, 3);
+  assert_int_equal(v->stride, 1);
+  assert_int_equal(v->block->size, 3);
+  assert_ptr_equal(v->data, v->block->data);
+  assert_int_equal(v->owner, 1);
+
+  const double expected_mem[] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  assert_memory_equal(v->data, expected_mem, 6 * sizeof(double));
+
+  ins_vector_complex_free(v);
+}
+
+static void test_views_and_set(void **state) {
+  (void) state;
+
+  ins_block_complex *b = ins_block_complex_calloc(5);
+  ins_vector_complex *v = ins_vector_complex_alloc_from_block(b, 1, 2, 2);
+  assert_non_null(v);
+  assert_ptr_equal(v->data, b->data + 2);
+
+  ins_vector_complex_set_all(v, make_complex(1.0, -1.0));
+  const double expected_mem[] = {0.0, 0.0, 1.0, -1.0, 0.0, 0.0,
+                                 1.0, -1.0, 0.0, 0.0};
+  assert_memory_equal(b->data, expected_mem, 10 * sizeof(double));
+
+  ins_vector_complex *r = ins_vector_complex_alloc_reverse(v);
+  ins_vector_complex_set(r, 0, make_complex(2.0, 3.0));
+  ins_complex z = ins_vector_complex_get(v, 1);
+  assert_true(INS_REAL(z) == 2.0 && INS_IMAG(z) == 3.0);
+
+  ins_vector_complex_set_basis(v, 0);
+  z = ins_vector_complex_get(r, 1);
+  assert_true(INS_REAL(z) == 1.0 && INS_IMAG(z) == 0.0);
+  z = ins_vector_complex_get(r, 0);
+  assert_true(INS_REAL(z) == 0.0 && INS_IMAG(z) == 0.0);
+
+  ins_vector_complex_free(r);
+  ins_vector_complex_free(v);
+  ins_block_complex_free(b);
+}
+
+static void test_elementwise_ops(void **state) {
+  (void) state;
+
+  ins_vector_complex *x = ins_vector_complex_alloc(2);
+  ins_vector_complex *y = ins_vector_complex_alloc(2);
+  ins_vector_complex_set(x, 0, make_complex(1.0, 2.0));
+  ins_vector_complex_set(x, 1, make_complex(3.0, -1.0));
+  ins_vector_complex_set(y, 0, make_complex(0.5, 1.0));
+  ins_vector_complex_set(y, 1, make_complex(-2.0, 4.0));
+
+  assert_int_equal(ins_vector_complex_add(x, y), INS_SUCCESS);
+  const double added[] = {1.5, 3.0, 1.0, 3.0};
+  assert_memory_equal(x->data, added, 4 * sizeof(double));
+
+  assert_int_equal(ins_vector_complex_sub(x, y), INS_SUCCESS);
+  const double subtracted[] = {1.0, 2.0, 3.0, -1.0};
+  assert_memory_equal(x->data, subtracted, 4 * sizeof(double));
+
+  // (1 + 2i)(0.5 + i) = -1.5 + 2i, (3 - i)(-2 + 4i) = -2 + 14i
+  assert_int_equal(ins_vector_complex_mul(x, y), INS_SUCCESS);
+  const double multiplied[] = {-1.5, 2.0, -2.0, 14.0};
+  assert_memory_equal(x->data, multiplied, 4 * sizeof(double));
+
+  ins_vector_complex *z = ins_vector_complex_alloc(3);
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+  assert_int_equal(ins_vector_complex_add(x, z), INS_EBADLEN);
+  ins_set_error_handler(handler);
+
+  ins_vector_complex_free(z);
+  ins_vector_complex_free(y);
+  ins_vector_complex_free(x);
+}
+
+static void test_blas_ops(void **state) {
+  (void) state;
+
+  ins_vector_complex *x = ins_vector_complex_alloc(2);
+  ins_vector_complex *y = ins_vector_complex_alloc(2);
+  ins_vector_complex_set(x, 0, make_complex(1.0, 2.0));
+  ins_vector_complex_set(x, 1, make_complex(3.0, -1.0));
+  ins_vector_complex_set(y, 0, make_complex(0.5, 1.0));
+  ins_vector_complex_set(y, 1, make_complex(-2.0, 4.0));
+
+  // dotu = (-1.5 + 2i) + (-2 + 14i), dotc = (2.5 - 0i) + (-10 + 10i)
+  ins_complex d = ins_vector_complex_dotu(x, y);
+  assert_double_equal(INS_REAL(d), -3.5, 1e-12);
+  assert_double_equal(INS_IMAG(d), 16.0, 1e-12);
+  d = ins_vector_complex_dotc(x, y);
+  assert_double_equal(INS_REAL(d), -7.5, 1e-12);
+  assert_double_equal(INS_IMAG(d), 10.0, 1e-12);
+
+  assert_double_equal(ins_vector_complex_nrm2(x), sqrt(15.0), 1e-12);
+
+  // alpha = i rotates x by 90 degrees: y <- i * x + y.
+  assert_int_equal(ins_vector_complex_axpy(make_complex(0.0, 1.0), x, y),
+                   INS_SUCCESS);
+  const double axpy[] = {-1.5, 2.0, -1.0, 7.0};
+  assert_memory_equal(y->data, axpy, 4 * sizeof(double));
+
+  assert_int_equal(ins_vector_complex_scale(y, make_complex(2.0, 0.0)),
+                   INS_SUCCESS);
+  const double scaled[] = {-3.0, 4.0, -2.0, 14.0};
+  assert_memory_equal(y->data, scaled, 4 * sizeof(double));
+
+  // Copy through a reversed view.
+  ins_vector_complex *r = ins_vector_complex_alloc_reverse(y);
+  assert_int_equal(ins_vector_complex_copy(x, r), INS_SUCCESS);
+  const double copied[] = {-2.0, 14.0, -3.0, 4.0};
+  assert_memory_equal(x->data, copied, 4 * sizeof(double));
+
+  assert_int_equal(ins_vector_complex_swap(x, y), INS_SUCCESS);
+  assert_memory_equal(x->data, scaled, 4 * sizeof(double));
+  assert_memory_equal(y->data, copied, 4 * sizeof(double));
+
+  ins_vector_complex_free(r);
+  ins_vector_complex_free(y);
+  ins_vector_complex_free(x);
+}
+
+static void test_complex_float(void **state) {
+  (void) state;
+
+  ins_vector_complex_float *x = ins_vector_complex_float_calloc(3);
+  ins_complex_float z;
+  INS_SET_COMPLEX(&z, 3.0F, 4.0F);
+  ins_vector_complex_float_set(x, 2, z);
+  assert_float_equal(ins_vector_complex_float_nrm2(x), 5.0F, 1e-6F);
+
+  ins_complex_float d = ins_vector_complex_float_dotc(x, x);
+  assert_float_equal(INS_REAL(d), 25.0F, 1e-5F);
+  assert_float_equal(INS_IMAG(d), 0.0F, 0.0F);
+
+  ins_vector_complex_float_free(x);
+}
+
+static void test_block_fprintf_fscanf(void **state) {
+  (void) state;
+
+  ins_block_complex *b = ins_block_complex_alloc(2);
+  b->data[0] = 1.5;
+  b->data[1] = -2.0;
+  b->data[2] = 0.0;
+  b->data[3] = 4.25;
+
+  FILE *stream = tmpfile();
+  assert_non_null(stream);
+  assert_int_equal(ins_block_complex_fprintf(b, stream, "%g"), INS_SUCCESS);
+  rewind(stream);
+
+  ins_block_complex *c = ins_block_complex_calloc(2);
+  assert_int_equal(ins_block_complex_fscanf(c, stream), INS_SUCCESS);
+  assert_memory_equal(c->data, b->data, 4 * sizeof(double));
+
+  rewind(stream);
+  assert_int_equal(ins_block_complex_fwrite(b, stream), INS_SUCCESS);
+  rewind(stream);
+  ins_block_complex *e = ins_block_complex_calloc(2);
+  assert_int_equal(ins_block_complex_fread(e, stream), INS_SUCCESS);
+  assert_memory_equal(e->data, b->data, 4 * sizeof(double));
+
+  fclose(stream);
+  ins_block_complex_free(e);
+  ins_block_complex_free(c);
+  ins_block_complex_free(b);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_alloc_success),
+    cmocka_unit_test(test_views_and_set),
+    cmocka_unit_test(test_elementwise_ops),
+    cmocka_unit_test(test_blas_ops),
+    cmocka_unit_test(test_complex_float),
+    cmocka_unit_test(test_block_fprintf_fscanf)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -1,6 +1,7 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <math.h>
 #include <setjmp.h>
 #include <cmocka.h>
 #include <ins/ins_vector.h>
@@ -224,6 +225,250 @@ static void test_ins_vector_fscanf_stride_two(void **state) {
   ins_vector_free(v);
 }
 
+static void test_vector_fwrite_fread_reversed(void **state) {
+  (void) state;
+
+  ins_vector *v = ins_vector_alloc(3);
+
+  v->data[0] = 0.5;
+  v->data[1] = 2.0;
+  v->data[2] = 4.0;
+
+  ins_vector *r = ins_vector_alloc_reverse(v);
+
+  FILE *file = fopen("vector_double_fwrite_reversed.dat", "wb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_fwrite(r, file), INS_SUCCESS);
+  fclose(file);
+
+  // The reversed elements were written, so reading them back in order
+  // gives the reversed vector.
+  ins_vector *w = ins_vector_alloc(3);
+
+  file = fopen("vector_double_fwrite_reversed.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_fread(w, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_double_equal(w->data[0], 4.0, 0.0);
+  assert_double_equal(w->data[1], 2.0, 0.0);
+  assert_double_equal(w->data[2], 0.5, 0.0);
+
+  // Reading through the reversed view restores the original order.
+  file = fopen("vector_double_fwrite_reversed.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_fread(r, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_double_equal(v->data[0], 0.5, 0.0);
+  assert_double_equal(v->data[1], 2.0, 0.0);
+  assert_double_equal(v->data[2], 4.0, 0.0);
+
+  ins_vector_free(w);
+  ins_vector_free(r);
+  ins_vector_free(v);
+}
+
+static void test_vector_fwrite_fread_strided_chunks(void **state) {
+  (void) state;
+
+  // Large enough to span several staging chunks, with a partial last one.
+  const size_t n = 20003;
+  ins_vector *v = ins_vector_alloc(3 * n);
+  ins_vector *s = ins_vector_alloc_from_vector(v, 0, n, 3);
+  size_t i;
+
+  for (i = 0; i < 3 * n; ++i) {
+    v->data[i] = -1.0;
+  }
+  for (i = 0; i < n; ++i) {
+    ins_vector_set(s, i, (double) i);
+  }
+
+  FILE *file = fopen("vector_double_fwrite_strided_chunks.dat", "wb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_fwrite(s, file), INS_SUCCESS);
+  fclose(file);
+
+  // The file holds the elements contiguously.
+  ins_vector *w = ins_vector_alloc(n);
+  file = fopen("vector_double_fwrite_strided_chunks.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_fread(w, file), INS_SUCCESS);
+  fclose(file);
+
+  for (i = 0; i < n; ++i) {
+    assert_double_equal(ins_vector_get(w, i), (double) i, 0.0);
+  }
+
+  // Read back through a negative stride, leaving the gaps untouched.
+  ins_vector *u = ins_vector_calloc(2 * n);
+  ins_vector *t = ins_vector_alloc_from_vector(u, 2 * n - 1, n, -2);
+  file = fopen("vector_double_fwrite_strided_chunks.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_fread(t, file), INS_SUCCESS);
+  fclose(file);
+
+  for (i = 0; i < n; ++i) {
+    assert_double_equal(u->data[2 * n - 1 - 2 * i], (double) i, 0.0);
+    assert_double_equal(u->data[2 * n - 2 - 2 * i], 0.0, 0.0);
+  }
+
+  // A short file fails part way through.
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+  ins_vector *l = ins_vector_alloc_from_vector(v, 0, n + 1, 2);
+  file = fopen("vector_double_fwrite_strided_chunks.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_fread(l, file), INS_EFAILED);
+  fclose(file);
+  ins_set_error_handler(handler);
+
+  ins_vector_free(l);
+  ins_vector_free(t);
+  ins_vector_free(u);
+  ins_vector_free(w);
+  ins_vector_free(s);
+  ins_vector_free(v);
+}
+
+static void test_vector_mmap(void **state) {
+  (void) state;
+
+  // Writes a small header followed by the raw vector elements, as produced
+  // by `ins_vector_fwrite`.
+  ins_vector *v = ins_vector_alloc(4);
+  ins_vector_set(v, 0, 1.0);
+  ins_vector_set(v, 1, -2.0);
+  ins_vector_set(v, 2, 3.5);
+  ins_vector_set(v, 3, 4.0);
+
+  const double header = 42.0;
+  FILE *file = fopen("vector_double_mmap.dat", "wb");
+  assert_int_equal(fwrite(&header, sizeof(double), 1, file), 1);
+  assert_int_equal(ins_vector_fwrite(v, file), INS_SUCCESS);
+  fclose(file);
+
+  // Read-only mapping of the elements after the header.
+  ins_vector *m = ins_vector_mmap("vector_double_mmap.dat", sizeof(double), 4,
+                                  INS_MMAP_READ | INS_MMAP_SEQUENTIAL);
+  assert_non_null(m);
+  assert_int_equal(m->size, 4);
+  assert_int_equal(m->stride, 1);
+  assert_int_equal(m->owner, 1);
+  assert_memory_equal(m->data, v->data, 4 * sizeof(double));
+  assert_double_equal(ins_vector_sum(m), 6.5, 0.0);
+  ins_vector_free(m);
+
+  // Stores through a read-write mapping end up in the file.
+  m = ins_vector_mmap("vector_double_mmap.dat", 2 * sizeof(double), 3,
+                      INS_MMAP_WRITE | INS_MMAP_POPULATE);
+  assert_non_null(m);
+  assert_double_equal(ins_vector_get(m, 0), -2.0, 0.0);
+  ins_vector_scale(m, 2.0);
+  ins_vector_free(m);
+
+  ins_vector *w = ins_vector_alloc(5);
+  file = fopen("vector_double_mmap.dat", "rb");
+  assert_int_equal(ins_vector_fread(w, file), INS_SUCCESS);
+  fclose(file);
+
+  const double expected[] = {42.0, 1.0, -4.0, 7.0, 8.0};
+  assert_memory_equal(w->data, expected, 5 * sizeof(double));
+
+  // Misaligned offsets, short files and missing files are rejected.
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+  assert_null(ins_vector_mmap("vector_double_mmap.dat", 3, 1, INS_MMAP_READ));
+  assert_null(ins_vector_mmap("vector_double_mmap.dat", 0, 6, INS_MMAP_READ));
+  assert_null(ins_vector_mmap("vector_double_mmap.missing", 0, 1,
+                              INS_MMAP_READ));
+  ins_set_error_handler(handler);
+
+  ins_vector_free(w);
+  ins_vector_free(v);
+}
+
+static void test_vector_file_reductions(void **state) {
+  (void) state;
+
+  // Enough elements for several chunks, after a header of one double.
+  const size_t n = 1300001;
+  ins_vector *v = ins_vector_alloc(n);
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    ins_vector_set(v, i, (double) ((i * 7919) % 1000) - 500.0);
+  }
+  ins_vector_set(v, 777777, 600.0);
+  ins_vector_set(v, 1200000, 600.0);
+  ins_vector_set(v, 3, -501.0);
+
+  const double header = 42.0;
+  FILE *file = fopen("vector_double_reduce.dat", "wb");
+  assert_int_equal(fwrite(&header, sizeof(double), 1, file), 1);
+  assert_int_equal(ins_vector_fwrite(v, file), INS_SUCCESS);
+  fclose(file);
+
+  const char *path = "vector_double_reduce.dat";
+  const size_t offset = sizeof(double);
+  double result, min, max;
+  size_t imin, imax;
+
+  assert_int_equal(ins_vector_file_sum(path, offset, n, &result), INS_SUCCESS);
+  assert_double_equal(result, ins_vector_sum(v), 1e-6);
+
+  assert_int_equal(ins_vector_file_dot(path, offset, path, offset, n,
+                                       &result), INS_SUCCESS);
+  assert_double_equal(result, ins_vector_dot(v, v), 1e-3);
+
+  assert_int_equal(ins_vector_file_nrm2(path, offset, n, &result),
+                   INS_SUCCESS);
+  assert_double_equal(result, ins_vector_nrm2(v), 1e-6);
+
+  assert_int_equal(ins_vector_file_minmax(path, offset, n, &min, &max),
+                   INS_SUCCESS);
+  assert_double_equal(min, -501.0, 0.0);
+  assert_double_equal(max, 600.0, 0.0);
+
+  // Indices are global, and ties resolve to the lowest index even across
+  // chunks.
+  assert_int_equal(ins_vector_file_minmax_index(path, offset, n, &imin,
+                                                &imax), INS_SUCCESS);
+  assert_int_equal(imin, 3);
+  assert_int_equal(imax, 777777);
+  assert_int_equal(ins_vector_file_max_index(path, offset + 777778 * 8,
+                                             n - 777778, &imax),
+                   INS_SUCCESS);
+  assert_int_equal(imax, 1200000 - 777778);
+
+  // Infinities in several chunks keep the norm infinite.
+  ins_vector_set(v, 5, INFINITY);
+  ins_vector_set(v, 1000000, -INFINITY);
+  file = fopen(path, "wb");
+  assert_int_equal(fwrite(&header, sizeof(double), 1, file), 1);
+  assert_int_equal(ins_vector_fwrite(v, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_int_equal(ins_vector_file_nrm2(path, offset, n, &result),
+                   INS_SUCCESS);
+  assert_true(isinf(result) && result > 0.0);
+  assert_true(isinf(ins_vector_nrm2(v)));
+
+  // The range may start anywhere, e.g. at the header.
+  assert_int_equal(ins_vector_file_sum(path, 0, 1, &result), INS_SUCCESS);
+  assert_double_equal(result, 42.0, 0.0);
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+  assert_int_equal(ins_vector_file_sum(path, offset, n + 1, &result),
+                   INS_EINVAL);
+  assert_int_equal(ins_vector_file_minmax(path, offset, 0, &min, &max),
+                   INS_EINVAL);
+  assert_int_equal(ins_vector_file_sum("vector_double_reduce.missing", 0, 1,
+                                       &result), INS_EFAILED);
+  ins_set_error_handler(handler);
+
+  ins_vector_free(v);
+}
+
 int main(void) {
   const struct CMUnitTest tests[] = {
     cmocka_unit_test(test_vector_fwrite_stride_one),
@@ -233,7 +478,11 @@ int main(void) {
     cmocka_unit_test(test_ins_vector_fprintf_stride_one),
     cmocka_unit_test(test_ins_vector_fprintf_stride_two),
     cmocka_unit_test(test_ins_vector_fscanf_stride_one),
-    cmocka_unit_test(test_ins_vector_fscanf_stride_two)
+    cmocka_unit_test(test_ins_vector_fscanf_stride_two),
+    cmocka_unit_test(test_vector_fwrite_fread_reversed),
+    cmocka_unit_test(test_vector_fwrite_fread_strided_chunks),
+    cmocka_unit_test(test_vector_mmap),
+    cmocka_unit_test(test_vector_file_reductions)
   };
 
   return cmocka_run_group_tests(tests, NULL, NULL);
@@ -242,6 +242,146 @@ static void test_alloc_from_block_and_vector(void **state) {
   ins_block_free(b);
 }
 
+static void test_alloc_from_block_negative_stride(void **state) {
+  (void) state; /* unused */
+
+  ins_block *b = ins_block_alloc(5);
+  ins_vector *v = ins_vector_alloc_from_block(b, 4, 3, -2);
+
+  assert_non_null(v);
+  assert_int_equal(v->size, 3);
+  assert_int_equal(v->stride, -2);
+  assert_ptr_equal(v->data, b->data + 4);
+  assert_ptr_equal(v->block, b);
+  assert_int_equal(v->owner, 0);
+
+  assert_ptr_equal(&ins_vector_get(v, 0), b->data + 4);
+  assert_ptr_equal(&ins_vector_get(v, 1), b->data + 2);
+  assert_ptr_equal(&ins_vector_get(v, 2), b->data);
+
+  ins_vector_free(v);
+  ins_block_free(b);
+}
+
+static void test_alloc_from_block_negative_stride_out_of_range(void **state) {
+  (void) state; /* unused */
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+
+  ins_block *b = ins_block_alloc(5);
+  assert_ptr_equal(ins_vector_alloc_from_block(b, 3, 3, -2), NULL);
+  assert_ptr_equal(ins_vector_alloc_from_block(b, 5, 1, -1), NULL);
+  assert_ptr_equal(ins_vector_alloc_from_block(b, 0, 1, 0), NULL);
+
+  ins_block_free(b);
+  ins_set_error_handler(handler);
+}
+
+static void test_alloc_from_vector_negative_stride(void **state) {
+  (void) state; /* unused */
+
+  ins_vector *v = ins_vector_alloc(7);
+  ins_vector *w = ins_vector_alloc_from_vector(v, 5, 3, -2);
+
+  assert_non_null(w);
+  assert_int_equal(w->size, 3);
+  assert_int_equal(w->stride, -2);
+  assert_ptr_equal(w->data, v->data + 5);
+  assert_ptr_equal(w->block, v->block);
+  assert_int_equal(w->owner, 0);
+
+  ins_vector *u = ins_vector_alloc_from_vector(w, 2, 2, -1);
+
+  assert_non_null(u);
+  assert_int_equal(u->size, 2);
+  assert_int_equal(u->stride, 2);
+  assert_ptr_equal(u->data, v->data + 1);
+
+  ins_vector_free(u);
+  ins_vector_free(w);
+  ins_vector_free(v);
+}
+
+static void test_alloc_reverse(void **state) {
+  (void) state; /* unused */
+
+  ins_block *b = ins_block_alloc(7);
+  ins_vector *v = ins_vector_alloc_from_block(b, 1, 3, 2);
+  ins_vector *r = ins_vector_alloc_reverse(v);
+
+  assert_non_null(r);
+  assert_int_equal(r->size, 3);
+  assert_int_equal(r->stride, -2);
+  assert_ptr_equal(r->data, b->data + 5);
+  assert_ptr_equal(r->block, b);
+  assert_int_equal(r->owner, 0);
+
+  ins_vector_set(v, 0, 1.0);
+  ins_vector_set(v, 1, 2.0);
+  ins_vector_set(v, 2, 3.0);
+
+  assert_double_equal(ins_vector_get(r, 0), 3.0, 0.0);
+  assert_double_equal(ins_vector_get(r, 1), 2.0, 0.0);
+  assert_double_equal(ins_vector_get(r, 2), 1.0, 0.0);
+
+  ins_vector *rr = ins_vector_alloc_reverse(r);
+  assert_int_equal(rr->stride, 2);
+  assert_ptr_equal(rr->data, v->data);
+
+  ins_vector_free(rr);
+  ins_vector_free(r);
+  ins_vector_free(v);
+  ins_block_free(b);
+}
+
+static void test_wrap(void **state) {
+  (void) state; /* unused */
+
+  double data[] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+
+  ins_vector *v = ins_vector_wrap(data, 4, 2);
+  assert_non_null(v);
+  assert_int_equal(v->size, 4);
+  assert_ptr_equal(v->data, data);
+  assert_ptr_equal(v->block->data, data);
+  assert_int_equal(v->block->size, 7);
+  assert_double_equal(ins_vector_get(v, 3), 7.0, 0.0);
+
+  // Writes go to the caller's memory, which outlives the vector.
+  ins_vector_set(v, 1, -3.0);
+  ins_vector_free(v);
+  assert_double_equal(data[2], -3.0, 0.0);
+
+  // A negative stride starts at `data` and walks backwards.
+  v = ins_vector_wrap(data + 6, 3, -3);
+  assert_non_null(v);
+  assert_ptr_equal(v->block->data, data);
+  assert_int_equal(v->block->size, 7);
+  assert_double_equal(ins_vector_get(v, 0), 7.0, 0.0);
+  assert_double_equal(ins_vector_get(v, 2), 1.0, 0.0);
+  ins_vector_free(v);
+
+  ins_error_handler_t *h = ins_set_error_handler_off();
+  assert_null(ins_vector_wrap(data, 3, 0));
+  ins_set_error_handler(h);
+}
+
+static void test_reverse_set_basis(void **state) {
+  (void) state; /* unused */
+
+  ins_vector *v = ins_vector_alloc(3);
+  ins_vector *r = ins_vector_alloc_reverse(v);
+
+  ins_vector_set_basis(r, 0);
+
+  assert_double_equal(v->data[0], 0.0, 0.0);
+  assert_double_equal(v->data[1], 0.0, 0.0);
+  assert_double_equal(v->data[2], 1.0, 0.0);
+
+  ins_vector_free(r);
+  ins_vector_free(v);
+}
+
 static void test_set_zero(void **state) {
   (void) state; /* unused */
 
@@ -901,6 +1041,12 @@ int main(void) {
     cmocka_unit_test(test_alloc_from_vector_offset_one_stride_one),
     cmocka_unit_test(test_alloc_from_vector_offset_two_stride_two),
     cmocka_unit_test(test_alloc_from_block_and_vector),
+    cmocka_unit_test(test_alloc_from_block_negative_stride),
+    cmocka_unit_test(test_alloc_from_block_negative_stride_out_of_range),
+    cmocka_unit_test(test_alloc_from_vector_negative_stride),
+    cmocka_unit_test(test_alloc_reverse),
+    cmocka_unit_test(test_wrap),
+    cmocka_unit_test(test_reverse_set_basis),
     cmocka_unit_test(test_set_zero),
     cmocka_unit_test(test_init_from_block_stride_one_set_zero),
     cmocka_unit_test(test_init_from_block_stride_two_set_zero),
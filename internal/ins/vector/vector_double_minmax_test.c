@@ -443,6 +443,36 @@ static void test_vector_minmax_index_nan(void **state) {
   ins_vector_free(v);
 }
 
+static void test_vector_minmax_index_reversed(void **state) {
+  (void) state;
+
+  ins_vector *v = ins_vector_alloc(4);
+
+  ins_vector_set(v, 0, 2.0);
+  ins_vector_set(v, 1, -1.0);
+  ins_vector_set(v, 2, 5.0);
+  ins_vector_set(v, 3, 0.5);
+
+  ins_vector *r = ins_vector_alloc_reverse(v);
+
+  double min, max;
+  size_t imin, imax;
+
+  ins_vector_minmax(r, &min, &max);
+  assert_double_equal(min, -1.0, 0.0);
+  assert_double_equal(max, 5.0, 0.0);
+
+  ins_vector_minmax_index(r, &imin, &imax);
+  assert_int_equal(imin, 2);
+  assert_int_equal(imax, 1);
+
+  assert_int_equal(ins_vector_min_index(r), 2);
+  assert_int_equal(ins_vector_max_index(r), 1);
+
+  ins_vector_free(r);
+  ins_vector_free(v);
+}
+
 int main(void) {
   const struct CMUnitTest tests[] = {
     cmocka_unit_test(test_vector_min_stride_one),
@@ -462,7 +492,8 @@ int main(void) {
     cmocka_unit_test(test_vector_max_index_nan),
     cmocka_unit_test(test_vector_minmax_index_stride_one),
     cmocka_unit_test(test_vector_minmax_index_stride_two),
-    cmocka_unit_test(test_vector_minmax_index_nan)
+    cmocka_unit_test(test_vector_minmax_index_nan),
+    cmocka_unit_test(test_vector_minmax_index_reversed)
   };
 
   return cmocka_run_group_tests(tests, NULL, NULL);
@@ -1790,6 +1790,94 @@ static void test_vector_nrm2_stride_two(void **state) {
   ins_vector_free(v);
 }
 
+static void test_vector_reversed_blas_ops(void **state) {
+  (void) state;
+
+  ins_vector *x = ins_vector_alloc(3);
+  ins_vector *y = ins_vector_alloc(3);
+
+  ins_vector_set(x, 0, 1.0);
+  ins_vector_set(x, 1, 2.0);
+  ins_vector_set(x, 2, 3.0);
+
+  ins_vector_set(y, 0, 4.0);
+  ins_vector_set(y, 1, 5.0);
+  ins_vector_set(y, 2, 6.0);
+
+  ins_vector *rx = ins_vector_alloc_reverse(x);
+
+  // dot(reverse(x), y) = 3 * 4 + 2 * 5 + 1 * 6
+  assert_double_equal(ins_vector_dot(rx, y), 28.0, 0.0);
+  assert_double_equal(ins_vector_dot(y, rx), 28.0, 0.0);
+  assert_double_equal(ins_vector_nrm2(rx), ins_vector_nrm2(x), 0.0);
+  assert_double_equal(ins_vector_sum(rx), 6.0, 0.0);
+
+  // y <- 2 * reverse(x) + y
+  assert_int_equal(ins_vector_axpy(2.0, rx, y), INS_SUCCESS);
+  assert_double_equal(ins_vector_get(y, 0), 10.0, 0.0);
+  assert_double_equal(ins_vector_get(y, 1), 9.0, 0.0);
+  assert_double_equal(ins_vector_get(y, 2), 8.0, 0.0);
+
+  // x <- reverse(x) * 0.5, written through the view.
+  assert_int_equal(ins_vector_scale(rx, 0.5), INS_SUCCESS);
+  assert_double_equal(ins_vector_get(x, 0), 0.5, 0.0);
+  assert_double_equal(ins_vector_get(x, 1), 1.0, 0.0);
+  assert_double_equal(ins_vector_get(x, 2), 1.5, 0.0);
+
+  // reverse(x) <- y
+  assert_int_equal(ins_vector_copy(rx, y), INS_SUCCESS);
+  assert_double_equal(ins_vector_get(x, 0), 8.0, 0.0);
+  assert_double_equal(ins_vector_get(x, 1), 9.0, 0.0);
+  assert_double_equal(ins_vector_get(x, 2), 10.0, 0.0);
+
+  // y <-> reverse(x) leaves `x` reversed in `y`.
+  ins_vector_set(y, 0, 1.0);
+  ins_vector_set(y, 1, 2.0);
+  ins_vector_set(y, 2, 3.0);
+  assert_int_equal(ins_vector_swap(y, rx), INS_SUCCESS);
+  assert_double_equal(ins_vector_get(y, 0), 10.0, 0.0);
+  assert_double_equal(ins_vector_get(y, 1), 9.0, 0.0);
+  assert_double_equal(ins_vector_get(y, 2), 8.0, 0.0);
+  assert_double_equal(ins_vector_get(x, 0), 3.0, 0.0);
+  assert_double_equal(ins_vector_get(x, 1), 2.0, 0.0);
+  assert_double_equal(ins_vector_get(x, 2), 1.0, 0.0);
+
+  ins_vector_free(rx);
+  ins_vector_free(y);
+  ins_vector_free(x);
+}
+
+static void test_vector_reversed_elementwise_ops(void **state) {
+  (void) state;
+
+  ins_vector *x = ins_vector_alloc(3);
+  ins_vector *y = ins_vector_alloc(3);
+
+  ins_vector_set(x, 0, 1.0);
+  ins_vector_set(x, 1, 2.0);
+  ins_vector_set(x, 2, 4.0);
+
+  ins_vector_set(y, 0, 8.0);
+  ins_vector_set(y, 1, 8.0);
+  ins_vector_set(y, 2, 8.0);
+
+  ins_vector *rx = ins_vector_alloc_reverse(x);
+
+  assert_int_equal(ins_vector_div(y, rx), INS_SUCCESS);
+  assert_double_equal(ins_vector_get(y, 0), 2.0, 0.0);
+  assert_double_equal(ins_vector_get(y, 1), 4.0, 0.0);
+  assert_double_equal(ins_vector_get(y, 2), 8.0, 0.0);
+
+  assert_int_equal(ins_vector_sub(rx, y), INS_SUCCESS);
+  assert_double_equal(ins_vector_get(x, 0), -7.0, 0.0);
+  assert_double_equal(ins_vector_get(x, 1), -2.0, 0.0);
+  assert_double_equal(ins_vector_get(x, 2), 2.0, 0.0);
+
+  ins_vector_free(rx);
+  ins_vector_free(y);
+  ins_vector_free(x);
+}
+
 int main(void) {
   const struct CMUnitTest tests[] = {
     cmocka_unit_test(test_scale_when_stride_is_one),
@@ -1832,7 +1920,9 @@ int main(void) {
     cmocka_unit_test(test_vector_dot_diff_strides),
     cmocka_unit_test(test_vector_dot_diff_lengths),
     cmocka_unit_test(test_vector_nrm2_stride_one),
-    cmocka_unit_test(test_vector_nrm2_stride_two)
+    cmocka_unit_test(test_vector_nrm2_stride_two),
+    cmocka_unit_test(test_vector_reversed_blas_ops),
+    cmocka_unit_test(test_vector_reversed_elementwise_ops)
   };
 
   return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,295 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+
+static void test_alloc_success(void **state) {
+  (void) state;
+
+  ins_vector_float *v = ins_vector_float_alloc(3);
+  assert_non_null(v);
+  assert_int_equal(v->size, 3);
+  assert_int_equal(v->stride, 1);
+  assert_non_null(v->block);
+  assert_ptr_equal(v->data, v->block->data);
+  assert_int_equal(v->owner, 1);
+
+  ins_vector_float_free(v);
+}
+
+static void test_calloc_success(void **state) {
+  (void) state;
+
+  ins_vector_float *v = ins_vector_float_calloc(3);
+  assert_non_null(v);
+
+  const float expected_mem[] = {0.0F, 0.0F, 0.0F};
+  assert_memory_equal(v->data, expected_mem, 3 * sizeof(float));
+
+  ins_vector_float_free(v);
+}
+
+static void test_alloc_from_block_stride_two(void **state) {
+  (void) state;
+
+  ins_block_float *b = ins_block_float_calloc(5);
+  ins_vector_float *v = ins_vector_float_alloc_from_block(b, 1, 2, 2);
+
+  assert_non_null(v);
+  assert_int_equal(v->size, 2);
+  assert_int_equal(v->stride, 2);
+  assert_ptr_equal(v->data, b->data + 1);
+  assert_ptr_equal(v->block, b);
+  assert_int_equal(v->owner, 0);
+
+  ins_vector_float_set_all(v, 1.5F);
+  assert_float_equal(b->data[0], 0.0F, 0.0F);
+  assert_float_equal(b->data[1], 1.5F, 0.0F);
+  assert_float_equal(b->data[2], 0.0F, 0.0F);
+  assert_float_equal(b->data[3], 1.5F, 0.0F);
+  assert_float_equal(b->data[4], 0.0F, 0.0F);
+
+  ins_vector_float_free(v);
+  ins_block_float_free(b);
+}
+
+static void test_set_basis(void **state) {
+  (void) state;
+
+  ins_vector_float *v = ins_vector_float_alloc(3);
+  ins_vector_float_set_basis(v, 1);
+
+  assert_float_equal(ins_vector_float_get(v, 0), 0.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(v, 1), 1.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(v, 2), 0.0F, 0.0F);
+
+  ins_vector_float_free(v);
+}
+
+static void test_elementwise_ops(void **state) {
+  (void) state;
+
+  ins_vector_float *x = ins_vector_float_alloc(3);
+  ins_vector_float *y = ins_vector_float_alloc(3);
+
+  ins_vector_float_set(x, 0, 1.0F);
+  ins_vector_float_set(x, 1, 2.0F);
+  ins_vector_float_set(x, 2, 3.0F);
+
+  ins_vector_float_set(y, 0, 2.0F);
+  ins_vector_float_set(y, 1, 4.0F);
+  ins_vector_float_set(y, 2, 8.0F);
+
+  assert_int_equal(ins_vector_float_add(x, y), INS_SUCCESS);
+  assert_float_equal(ins_vector_float_get(x, 0), 3.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(x, 1), 6.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(x, 2), 11.0F, 0.0F);
+
+  assert_int_equal(ins_vector_float_sub(x, y), INS_SUCCESS);
+  assert_int_equal(ins_vector_float_mul(x, y), INS_SUCCESS);
+  assert_float_equal(ins_vector_float_get(x, 0), 2.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(x, 1), 8.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(x, 2), 24.0F, 0.0F);
+
+  assert_int_equal(ins_vector_float_div(x, y), INS_SUCCESS);
+  assert_int_equal(ins_vector_float_add_constant(x, 0.5F), INS_SUCCESS);
+  assert_float_equal(ins_vector_float_get(x, 0), 1.5F, 0.0F);
+  assert_float_equal(ins_vector_float_get(x, 1), 2.5F, 0.0F);
+  assert_float_equal(ins_vector_float_get(x, 2), 3.5F, 0.0F);
+
+  assert_float_equal(ins_vector_float_sum(x), 7.5F, 0.0F);
+
+  ins_vector_float_free(y);
+  ins_vector_float_free(x);
+}
+
+static void test_blas_ops(void **state) {
+  (void) state;
+
+  ins_block_float *b = ins_block_float_alloc(6);
+  ins_vector_float *x = ins_vector_float_alloc_from_block(b, 0, 3, 2);
+  ins_vector_float *y = ins_vector_float_alloc(3);
+
+  ins_vector_float_set(x, 0, 3.0F);
+  ins_vector_float_set(x, 1, 0.0F);
+  ins_vector_float_set(x, 2, 4.0F);
+
+  ins_vector_float_set(y, 0, 1.0F);
+  ins_vector_float_set(y, 1, 2.0F);
+  ins_vector_float_set(y, 2, 3.0F);
+
+  assert_float_equal(ins_vector_float_nrm2(x), 5.0F, 0.0F);
+  assert_float_equal(ins_vector_float_dot(x, y), 15.0F, 0.0F);
+
+  assert_int_equal(ins_vector_float_scale(x, 2.0F), INS_SUCCESS);
+  assert_int_equal(ins_vector_float_axpy(0.5F, x, y), INS_SUCCESS);
+  assert_float_equal(ins_vector_float_get(y, 0), 4.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(y, 1), 2.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(y, 2), 7.0F, 0.0F);
+
+  assert_int_equal(ins_vector_float_swap(x, y), INS_SUCCESS);
+  assert_float_equal(ins_vector_float_get(x, 2), 7.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(y, 2), 8.0F, 0.0F);
+
+  assert_int_equal(ins_vector_float_copy(y, x), INS_SUCCESS);
+  assert_float_equal(ins_vector_float_get(y, 0), 4.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(y, 1), 2.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(y, 2), 7.0F, 0.0F);
+
+  ins_vector_float_free(y);
+  ins_vector_float_free(x);
+  ins_block_float_free(b);
+}
+
+static void test_minmax(void **state) {
+  (void) state;
+
+  ins_vector_float *v = ins_vector_float_alloc(4);
+
+  ins_vector_float_set(v, 0, 2.0F);
+  ins_vector_float_set(v, 1, -1.0F);
+  ins_vector_float_set(v, 2, 5.0F);
+  ins_vector_float_set(v, 3, -1.0F);
+
+  float min, max;
+  size_t imin, imax;
+
+  assert_float_equal(ins_vector_float_min(v), -1.0F, 0.0F);
+  assert_float_equal(ins_vector_float_max(v), 5.0F, 0.0F);
+
+  ins_vector_float_minmax(v, &min, &max);
+  assert_float_equal(min, -1.0F, 0.0F);
+  assert_float_equal(max, 5.0F, 0.0F);
+
+  assert_int_equal(ins_vector_float_min_index(v), 1);
+  assert_int_equal(ins_vector_float_max_index(v), 2);
+
+  ins_vector_float_minmax_index(v, &imin, &imax);
+  assert_int_equal(imin, 1);
+  assert_int_equal(imax, 2);
+
+  ins_vector_float_free(v);
+}
+
+static void test_fwrite_fread(void **state) {
+  (void) state;
+
+  ins_vector_float *v = ins_vector_float_alloc(3);
+
+  ins_vector_float_set(v, 0, 0.5F);
+  ins_vector_float_set(v, 1, 2.0F);
+  ins_vector_float_set(v, 2, -4.0F);
+
+  FILE *file = fopen("vector_float_fwrite.dat", "wb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_float_fwrite(v, file), INS_SUCCESS);
+  fclose(file);
+
+  ins_block_float *b = ins_block_float_calloc(6);
+  ins_vector_float *w = ins_vector_float_alloc_from_block(b, 0, 3, 2);
+
+  file = fopen("vector_float_fwrite.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_float_fread(w, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_float_equal(b->data[0], 0.5F, 0.0F);
+  assert_float_equal(b->data[2], 2.0F, 0.0F);
+  assert_float_equal(b->data[4], -4.0F, 0.0F);
+
+  ins_vector_float_free(w);
+  ins_block_float_free(b);
+  ins_vector_float_free(v);
+}
+
+static void test_fprintf_fscanf(void **state) {
+  (void) state;
+
+  ins_vector_float *v = ins_vector_float_alloc(3);
+
+  ins_vector_float_set(v, 0, 0.5F);
+  ins_vector_float_set(v, 1, 2.0F);
+  ins_vector_float_set(v, 2, -4.0F);
+
+  FILE *file = fopen("vector_float_fprintf.dat", "wb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_float_fprintf(v, file, "%g"), INS_SUCCESS);
+  fclose(file);
+
+  ins_vector_float *w = ins_vector_float_calloc(3);
+
+  file = fopen("vector_float_fprintf.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_float_fscanf(w, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_float_equal(ins_vector_float_get(w, 0), 0.5F, 0.0F);
+  assert_float_equal(ins_vector_float_get(w, 1), 2.0F, 0.0F);
+  assert_float_equal(ins_vector_float_get(w, 2), -4.0F, 0.0F);
+
+  ins_vector_float_free(w);
+  ins_vector_float_free(v);
+}
+
+static void test_mixed_precision_reductions(void **state) {
+  (void) state;
+
+  ins_vector_float *x = ins_vector_float_alloc(5);
+
+  ins_vector_float_set(x, 0, 1.0e8F);
+  ins_vector_float_set(x, 1, 1.0F);
+  ins_vector_float_set(x, 2, 1.0F);
+  ins_vector_float_set(x, 3, 1.0F);
+  ins_vector_float_set(x, 4, -1.0e8F);
+
+  // Single precision accumulation loses the small elements.
+  assert_double_equal(ins_vector_float_dsum(x), 3.0, 0.0);
+
+  ins_vector_float *r = ins_vector_float_alloc_reverse(x);
+  assert_double_equal(ins_vector_float_dsum(r), 3.0, 0.0);
+
+  // The BLAS may sum the products in any order, so dsdot is only checked to
+  // a relative tolerance. The product with ones still shows that the small
+  // elements are kept.
+  ins_vector_float *ones = ins_vector_float_alloc(5);
+  ins_vector_float_set_all(ones, 1.0F);
+  assert_double_equal(ins_vector_float_dsdot(x, ones), 3.0, 3.0 * 1e-12);
+  assert_double_equal(ins_vector_float_dsdot(x, r), -2.0e16 + 3.0,
+                      2.0e16 * 1e-12);
+  ins_vector_float_free(ones);
+
+  assert_double_equal(ins_vector_float_dnrm2(r),
+                      sqrt(2.0e16 + 3.0), 0.0);
+
+  ins_block_float *b = ins_block_float_calloc(4);
+  ins_vector_float *y = ins_vector_float_alloc_from_block(b, 0, 2, 3);
+  ins_vector_float_set(y, 0, 3.0F);
+  ins_vector_float_set(y, 1, 4.0F);
+  assert_double_equal(ins_vector_float_dnrm2(y), 5.0, 0.0);
+  assert_double_equal(ins_vector_float_dsum(y), 7.0, 0.0);
+
+  ins_vector_float_free(y);
+  ins_block_float_free(b);
+  ins_vector_float_free(r);
+  ins_vector_float_free(x);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_alloc_success),
+    cmocka_unit_test(test_calloc_success),
+    cmocka_unit_test(test_alloc_from_block_stride_two),
+    cmocka_unit_test(test_set_basis),
+    cmocka_unit_test(test_elementwise_ops),
+    cmocka_unit_test(test_blas_ops),
+    cmocka_unit_test(test_minmax),
+    cmocka_unit_test(test_fwrite_fread),
+    cmocka_unit_test(test_fprintf_fscanf),
+    cmocka_unit_test(test_mixed_precision_reductions)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,234 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+#include <ins/ins_block.h>
+#include <ins/ins_vector.h>
+
+static void test_f16_get_set(void **state) {
+  (void) state;
+
+  ins_vector_f16 *v = ins_vector_f16_alloc(6);
+
+  ins_vector_f16_set(v, 0, 1.0F);
+  ins_vector_f16_set(v, 1, -2.0F);
+  ins_vector_f16_set(v, 2, 65504.0F);
+  ins_vector_f16_set(v, 3, 1e6F);
+  ins_vector_f16_set(v, 4, 5.9604645e-8F);
+  ins_vector_f16_set(v, 5, 1.0F + 1.0F / 4096.0F);
+
+  // Raw bit patterns of the stored elements.
+  assert_int_equal(v->data[0], 0x3C00);
+  assert_int_equal(v->data[1], 0xC000);
+  assert_int_equal(v->data[2], 0x7BFF);
+  assert_int_equal(v->data[3], 0x7C00);
+  assert_int_equal(v->data[4], 0x0001);
+  assert_int_equal(v->data[5], 0x3C00);
+
+  assert_float_equal(ins_vector_f16_get(v, 0), 1.0F, 0.0F);
+  assert_float_equal(ins_vector_f16_get(v, 1), -2.0F, 0.0F);
+  assert_float_equal(ins_vector_f16_get(v, 2), 65504.0F, 0.0F);
+  assert_true(isinf(ins_vector_f16_get(v, 3)));
+  assert_float_equal(ins_vector_f16_get(v, 4), 5.9604645e-8F, 0.0F);
+
+  ins_vector_f16_set(v, 0, NAN);
+  assert_true(isnan(ins_vector_f16_get(v, 0)));
+
+  ins_vector_f16_free(v);
+}
+
+static void test_bf16_get_set(void **state) {
+  (void) state;
+
+  ins_vector_bf16 *v = ins_vector_bf16_alloc(4);
+
+  ins_vector_bf16_set(v, 0, 1.0F);
+  ins_vector_bf16_set(v, 1, -3.0e38F);
+  ins_vector_bf16_set(v, 2, 1.0F + 1.0F / 256.0F);
+  ins_vector_bf16_set(v, 3, NAN);
+
+  assert_int_equal(v->data[0], 0x3F80);
+  assert_int_equal(v->data[2], 0x3F80);
+
+  assert_float_equal(ins_vector_bf16_get(v, 0), 1.0F, 0.0F);
+  assert_float_equal(ins_vector_bf16_get(v, 1), -3.0e38F, 1e36F);
+  assert_true(isnan(ins_vector_bf16_get(v, 3)));
+
+  ins_vector_bf16_free(v);
+}
+
+static void test_f16_set_all_and_basis(void **state) {
+  (void) state;
+
+  ins_block_f16 *b = ins_block_f16_calloc(5);
+  ins_vector_f16 *v = ins_vector_f16_alloc_from_block(b, 0, 3, 2);
+
+  ins_vector_f16_set_all(v, 0.5F);
+  assert_int_equal(b->data[0], 0x3800);
+  assert_int_equal(b->data[1], 0x0000);
+  assert_int_equal(b->data[2], 0x3800);
+  assert_int_equal(b->data[4], 0x3800);
+
+  ins_vector_f16_set_basis(v, 1);
+  assert_float_equal(ins_vector_f16_get(v, 0), 0.0F, 0.0F);
+  assert_float_equal(ins_vector_f16_get(v, 1), 1.0F, 0.0F);
+  assert_float_equal(ins_vector_f16_get(v, 2), 0.0F, 0.0F);
+
+  ins_vector_f16_free(v);
+  ins_block_f16_free(b);
+}
+
+static void test_f16_float_round_trip(void **state) {
+  (void) state;
+
+  const size_t n = 1000;
+
+  ins_vector_float *x = ins_vector_float_alloc(n);
+  ins_vector_float *y = ins_vector_float_alloc(n);
+  ins_vector_f16 *h = ins_vector_f16_alloc(n);
+
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    ins_vector_float_set(x, i, (float) i - 500.0F);
+  }
+
+  assert_int_equal(ins_vector_f16_from_float(h, x), INS_SUCCESS);
+  assert_int_equal(ins_vector_f16_to_float(y, h), INS_SUCCESS);
+
+  // Integers of this magnitude are exact in half precision.
+  for (i = 0; i < n; ++i) {
+    assert_float_equal(ins_vector_float_get(y, i), (float) i - 500.0F, 0.0F);
+    assert_float_equal(ins_vector_f16_get(h, i), (float) i - 500.0F, 0.0F);
+  }
+
+  ins_vector_f16_free(h);
+  ins_vector_float_free(y);
+  ins_vector_float_free(x);
+}
+
+static void test_f16_ops(void **state) {
+  (void) state;
+
+  const size_t n = 1500;
+
+  ins_vector_f16 *x = ins_vector_f16_alloc(n);
+  ins_block_f16 *b = ins_block_f16_alloc(2 * n);
+  ins_vector_f16 *y = ins_vector_f16_alloc_from_block(b, 0, n, 2);
+
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    ins_vector_f16_set(x, i, (float) (i % 4));
+    ins_vector_f16_set(y, i, 1.0F);
+  }
+
+  // sum(x) = 375 * (0 + 1 + 2 + 3)
+  assert_float_equal(ins_vector_f16_sum(x), 2250.0F, 0.0F);
+  assert_float_equal(ins_vector_f16_dot(x, y), 2250.0F, 0.0F);
+
+  // nrm2(x) = sqrt(375 * (0 + 1 + 4 + 9))
+  assert_float_equal(ins_vector_f16_nrm2(x), sqrtf(5250.0F), 1e-3F);
+
+  assert_int_equal(ins_vector_f16_axpy(2.0F, x, y), INS_SUCCESS);
+  for (i = 0; i < n; ++i) {
+    assert_float_equal(ins_vector_f16_get(y, i), 1.0F + 2.0F * (i % 4), 0.0F);
+  }
+
+  ins_vector_f16_free(y);
+  ins_block_f16_free(b);
+  ins_vector_f16_free(x);
+}
+
+static void test_bf16_ops(void **state) {
+  (void) state;
+
+  const size_t n = 1500;
+
+  ins_vector_bf16 *x = ins_vector_bf16_alloc(n);
+  ins_vector_bf16 *y = ins_vector_bf16_alloc(n);
+  ins_vector_bf16 *r = ins_vector_bf16_alloc_reverse(y);
+
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    ins_vector_bf16_set(x, i, (float) (i % 4));
+    ins_vector_bf16_set(y, i, (float) ((n - 1 - i) % 4));
+  }
+
+  assert_float_equal(ins_vector_bf16_sum(x), 2250.0F, 0.0F);
+  assert_float_equal(ins_vector_bf16_dot(x, r), 5250.0F, 0.0F);
+  assert_float_equal(ins_vector_bf16_nrm2(r), sqrtf(5250.0F), 1e-3F);
+
+  // The squares overflow single precision, the norm does not.
+  ins_vector_bf16_set_all(x, 1.0e36F);
+  assert_float_equal(ins_vector_bf16_nrm2(x) / ins_vector_bf16_get(x, 0),
+                     sqrtf(1500.0F), 1e-3F);
+
+  ins_vector_bf16_free(r);
+  ins_vector_bf16_free(y);
+  ins_vector_bf16_free(x);
+}
+
+static void test_f16_diff_lengths(void **state) {
+  (void) state;
+
+  ins_error_handler_t *handler = ins_set_error_handler_off();
+
+  ins_vector_f16 *x = ins_vector_f16_alloc(3);
+  ins_vector_f16 *y = ins_vector_f16_alloc(4);
+  ins_vector_float *f = ins_vector_float_alloc(4);
+
+  assert_int_equal(ins_vector_f16_axpy(1.0F, x, y), INS_EBADLEN);
+  assert_int_equal(ins_vector_f16_from_float(x, f), INS_EBADLEN);
+  assert_int_equal(ins_vector_f16_to_float(f, x), INS_EBADLEN);
+
+  ins_vector_float_free(f);
+  ins_vector_f16_free(y);
+  ins_vector_f16_free(x);
+
+  ins_set_error_handler(handler);
+}
+
+static void test_block_f16_fprintf_fscanf(void **state) {
+  (void) state;
+
+  ins_block_f16 *b = ins_block_f16_alloc(3);
+  b->data[0] = 0x3C00;
+  b->data[1] = 0xC100;
+  b->data[2] = 0x3555;
+
+  FILE *file = fopen("block_f16_fprintf_test.dat", "wb");
+  assert_non_null(file);
+  assert_int_equal(ins_block_f16_fprintf(b, file, "%.8g"), INS_SUCCESS);
+  fclose(file);
+
+  ins_block_f16 *c = ins_block_f16_calloc(3);
+
+  file = fopen("block_f16_fprintf_test.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_block_f16_fscanf(c, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_memory_equal(c->data, b->data, 3 * sizeof(uint16_t));
+
+  ins_block_f16_free(c);
+  ins_block_f16_free(b);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_f16_get_set),
+    cmocka_unit_test(test_bf16_get_set),
+    cmocka_unit_test(test_f16_set_all_and_basis),
+    cmocka_unit_test(test_f16_float_round_trip),
+    cmocka_unit_test(test_f16_ops),
+    cmocka_unit_test(test_bf16_ops),
+    cmocka_unit_test(test_f16_diff_lengths),
+    cmocka_unit_test(test_block_f16_fprintf_fscanf)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,250 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <ins/ins_vector.h>
+
+static void test_alloc_success(void **state) {
+  (void) state;
+
+  ins_vector_int *v = ins_vector_int_alloc(3);
+  assert_non_null(v);
+  assert_int_equal(v->size, 3);
+  assert_int_equal(v->stride, 1);
+  assert_non_null(v->block);
+  assert_ptr_equal(v->data, v->block->data);
+  assert_int_equal(v->owner, 1);
+
+  ins_vector_int_free(v);
+}
+
+static void test_calloc_success(void **state) {
+  (void) state;
+
+  ins_vector_int *v = ins_vector_int_calloc(3);
+  assert_non_null(v);
+
+  const int expected_mem[] = {0, 0, 0};
+  assert_memory_equal(v->data, expected_mem, 3 * sizeof(int));
+
+  ins_vector_int_free(v);
+}
+
+static void test_alloc_from_block_stride_two(void **state) {
+  (void) state;
+
+  ins_block_int *b = ins_block_int_calloc(5);
+  ins_vector_int *v = ins_vector_int_alloc_from_block(b, 1, 2, 2);
+
+  assert_non_null(v);
+  assert_int_equal(v->size, 2);
+  assert_int_equal(v->stride, 2);
+  assert_ptr_equal(v->data, b->data + 1);
+  assert_ptr_equal(v->block, b);
+  assert_int_equal(v->owner, 0);
+
+  ins_vector_int_set_all(v, 7);
+  assert_int_equal(b->data[0], 0);
+  assert_int_equal(b->data[1], 7);
+  assert_int_equal(b->data[2], 0);
+  assert_int_equal(b->data[3], 7);
+  assert_int_equal(b->data[4], 0);
+
+  ins_vector_int_free(v);
+  ins_block_int_free(b);
+}
+
+static void test_set_basis(void **state) {
+  (void) state;
+
+  ins_vector_int *v = ins_vector_int_alloc(3);
+  ins_vector_int_set_basis(v, 1);
+
+  assert_int_equal(ins_vector_int_get(v, 0), 0);
+  assert_int_equal(ins_vector_int_get(v, 1), 1);
+  assert_int_equal(ins_vector_int_get(v, 2), 0);
+
+  ins_vector_int_free(v);
+}
+
+static void test_elementwise_ops(void **state) {
+  (void) state;
+
+  ins_vector_int *x = ins_vector_int_alloc(3);
+  ins_vector_int *y = ins_vector_int_alloc(3);
+
+  ins_vector_int_set(x, 0, 1);
+  ins_vector_int_set(x, 1, 2);
+  ins_vector_int_set(x, 2, 3);
+
+  ins_vector_int_set(y, 0, 2);
+  ins_vector_int_set(y, 1, 4);
+  ins_vector_int_set(y, 2, 8);
+
+  assert_int_equal(ins_vector_int_add(x, y), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_get(x, 0), 3);
+  assert_int_equal(ins_vector_int_get(x, 1), 6);
+  assert_int_equal(ins_vector_int_get(x, 2), 11);
+
+  assert_int_equal(ins_vector_int_sub(x, y), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_mul(x, y), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_get(x, 0), 2);
+  assert_int_equal(ins_vector_int_get(x, 1), 8);
+  assert_int_equal(ins_vector_int_get(x, 2), 24);
+
+  assert_int_equal(ins_vector_int_div(x, y), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_add_constant(x, 2), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_get(x, 0), 3);
+  assert_int_equal(ins_vector_int_get(x, 1), 4);
+  assert_int_equal(ins_vector_int_get(x, 2), 5);
+
+  assert_int_equal(ins_vector_int_sum(x), 12);
+
+  ins_vector_int_free(y);
+  ins_vector_int_free(x);
+}
+
+static void test_blas_ops(void **state) {
+  (void) state;
+
+  ins_block_int *b = ins_block_int_alloc(6);
+  ins_vector_int *x = ins_vector_int_alloc_from_block(b, 0, 3, 2);
+  ins_vector_int *y = ins_vector_int_alloc(3);
+
+  ins_vector_int_set(x, 0, 3);
+  ins_vector_int_set(x, 1, 0);
+  ins_vector_int_set(x, 2, 4);
+
+  ins_vector_int_set(y, 0, 1);
+  ins_vector_int_set(y, 1, 2);
+  ins_vector_int_set(y, 2, 3);
+
+  assert_double_equal(ins_vector_int_nrm2(x), 5.0, 0.0);
+  assert_int_equal(ins_vector_int_dot(x, y), 15);
+
+  assert_int_equal(ins_vector_int_scale(x, 2), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_axpy(1, x, y), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_get(y, 0), 7);
+  assert_int_equal(ins_vector_int_get(y, 1), 2);
+  assert_int_equal(ins_vector_int_get(y, 2), 11);
+
+  assert_int_equal(ins_vector_int_swap(x, y), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_get(x, 2), 11);
+  assert_int_equal(ins_vector_int_get(y, 2), 8);
+
+  assert_int_equal(ins_vector_int_copy(y, x), INS_SUCCESS);
+  assert_int_equal(ins_vector_int_get(y, 0), 7);
+  assert_int_equal(ins_vector_int_get(y, 1), 2);
+  assert_int_equal(ins_vector_int_get(y, 2), 11);
+
+  ins_vector_int_free(y);
+  ins_vector_int_free(x);
+  ins_block_int_free(b);
+}
+
+static void test_minmax(void **state) {
+  (void) state;
+
+  ins_vector_int *v = ins_vector_int_alloc(4);
+
+  ins_vector_int_set(v, 0, 2);
+  ins_vector_int_set(v, 1, -1);
+  ins_vector_int_set(v, 2, 5);
+  ins_vector_int_set(v, 3, -1);
+
+  int min, max;
+  size_t imin, imax;
+
+  assert_int_equal(ins_vector_int_min(v), -1);
+  assert_int_equal(ins_vector_int_max(v), 5);
+
+  ins_vector_int_minmax(v, &min, &max);
+  assert_int_equal(min, -1);
+  assert_int_equal(max, 5);
+
+  assert_int_equal(ins_vector_int_min_index(v), 1);
+  assert_int_equal(ins_vector_int_max_index(v), 2);
+
+  ins_vector_int_minmax_index(v, &imin, &imax);
+  assert_int_equal(imin, 1);
+  assert_int_equal(imax, 2);
+
+  ins_vector_int_free(v);
+}
+
+static void test_fwrite_fread(void **state) {
+  (void) state;
+
+  ins_vector_int *v = ins_vector_int_alloc(3);
+
+  ins_vector_int_set(v, 0, 9);
+  ins_vector_int_set(v, 1, 2);
+  ins_vector_int_set(v, 2, -4);
+
+  FILE *file = fopen("vector_int_fwrite.dat", "wb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_int_fwrite(v, file), INS_SUCCESS);
+  fclose(file);
+
+  ins_block_int *b = ins_block_int_calloc(6);
+  ins_vector_int *w = ins_vector_int_alloc_from_block(b, 0, 3, 2);
+
+  file = fopen("vector_int_fwrite.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_int_fread(w, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_int_equal(b->data[0], 9);
+  assert_int_equal(b->data[2], 2);
+  assert_int_equal(b->data[4], -4);
+
+  ins_vector_int_free(w);
+  ins_block_int_free(b);
+  ins_vector_int_free(v);
+}
+
+static void test_fprintf_fscanf(void **state) {
+  (void) state;
+
+  ins_vector_int *v = ins_vector_int_alloc(3);
+
+  ins_vector_int_set(v, 0, 9);
+  ins_vector_int_set(v, 1, 2);
+  ins_vector_int_set(v, 2, -4);
+
+  FILE *file = fopen("vector_int_fprintf.dat", "wb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_int_fprintf(v, file, "%d"), INS_SUCCESS);
+  fclose(file);
+
+  ins_vector_int *w = ins_vector_int_calloc(3);
+
+  file = fopen("vector_int_fprintf.dat", "rb");
+  assert_non_null(file);
+  assert_int_equal(ins_vector_int_fscanf(w, file), INS_SUCCESS);
+  fclose(file);
+
+  assert_int_equal(ins_vector_int_get(w, 0), 9);
+  assert_int_equal(ins_vector_int_get(w, 1), 2);
+  assert_int_equal(ins_vector_int_get(w, 2), -4);
+
+  ins_vector_int_free(w);
+  ins_vector_int_free(v);
+}
+
+int main(void) {
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(test_alloc_success),
+    cmocka_unit_test(test_calloc_success),
+    cmocka_unit_test(test_alloc_from_block_stride_two),
+    cmocka_unit_test(test_set_basis),
+    cmocka_unit_test(test_elementwise_ops),
+    cmocka_unit_test(test_blas_ops),
+    cmocka_unit_test(test_minmax),
+    cmocka_unit_test(test_fwrite_fread),
+    cmocka_unit_test(test_fprintf_fscanf)
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}